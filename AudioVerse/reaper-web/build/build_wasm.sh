@@ -119,6 +119,12 @@ SOURCES=(
     "$SRC_DIR/core/reaper_engine.cpp"
     "$SRC_DIR/core/audio_engine.cpp"
     "$SRC_DIR/core/track_manager.cpp"
+    "$SRC_DIR/core/tempo_map.cpp"
+    "$SRC_DIR/core/metronome.cpp"
+    "$SRC_DIR/core/loop_playback.cpp"
+    "$SRC_DIR/core/fft.cpp"
+    "$SRC_DIR/core/master_limiter.cpp"
+    "$SRC_DIR/core/analyzer_service.cpp"
     "$SRC_DIR/core/audio_buffer.cpp"
     
     # Audio processing
@@ -127,12 +133,16 @@ SOURCES=(
     # Effects processing
     "$SRC_DIR/effects/reaper_effects.cpp"
     "$SRC_DIR/effects/effect_chain.cpp"
+    "$SRC_DIR/effects/native_effects.cpp"
+    "$SRC_DIR/effects/convolution_engine.cpp"
+    "$SRC_DIR/effects/oversampler.cpp"
     
     # JSFX interpreter
     "$SRC_DIR/jsfx/jsfx_interpreter.cpp"
     
     # Media handling
     "$SRC_DIR/media/media_item.cpp"
+    "$SRC_DIR/media/recording_pipeline.cpp"
     
     # UI components
     "$SRC_DIR/ui/timeline_view.cpp"
@@ -105,10 +105,20 @@ SOURCE_FILES=(
     "${SRC_DIR}/core/audio_buffer.cpp"
     "${SRC_DIR}/core/project_manager.cpp"
     "${SRC_DIR}/core/track_manager.cpp"
+    "${SRC_DIR}/core/tempo_map.cpp"
+    "${SRC_DIR}/core/metronome.cpp"
+    "${SRC_DIR}/core/loop_playback.cpp"
+    "${SRC_DIR}/core/fft.cpp"
+    "${SRC_DIR}/core/master_limiter.cpp"
+    "${SRC_DIR}/core/analyzer_service.cpp"
     "${SRC_DIR}/media/media_item.cpp"
+    "${SRC_DIR}/media/recording_pipeline.cpp"
         "src/jsfx/jsfx_interpreter.cpp"
     "src/effects/reaper_effects.cpp"
     "src/effects/effect_chain.cpp"
+    "${SRC_DIR}/effects/native_effects.cpp"
+    "${SRC_DIR}/effects/convolution_engine.cpp"
+    "${SRC_DIR}/effects/oversampler.cpp"
 )
     "${SRC_DIR}/wasm/reaper_wasm_interface.cpp"
     "${SRC_DIR}/effects/reaper_effects.cpp"
@@ -0,0 +1,98 @@
+/*
+ * REAPER Web - JSFX Profiler
+ * Runs a script over a test signal and prints its hot spots per source line
+ *
+ * Usage: jsfx_profile <script file | built-in effect name> [seconds] [--nodes] [--rows N]
+ */
+
+#include "src/effects/reaper_effects.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+    constexpr double kSampleRate = 48000.0;
+    constexpr int kBlockSize = 512;
+
+    void PrintUsage() {
+        std::cout << "Usage: jsfx_profile <script file | built-in effect name> [seconds] [--nodes] [--rows N]\n"
+                  << "  seconds    Length of the test signal (default 10)\n"
+                  << "  --nodes    One row per AST node instead of per source line\n"
+                  << "  --rows N   Rows to print (default 20)\n";
+    }
+
+    // Swept sine with a little noise, so dynamics and filters take every branch
+    void FillTestSignal(AudioBuffer& buffer, int64_t startSample) {
+        for (int i = 0; i < buffer.GetSampleCount(); ++i) {
+            double t = static_cast<double>(startSample + i) / kSampleRate;
+            double envelope = 0.5 + 0.5 * std::sin(2.0 * M_PI * 0.5 * t);
+            double noise = (std::rand() / static_cast<double>(RAND_MAX) - 0.5) * 0.02;
+            double sample = envelope * std::sin(2.0 * M_PI * (100.0 + 50.0 * t) * t) + noise;
+            for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
+                buffer.GetChannelData(ch)[i] = static_cast<float>(sample);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::string target = argv[1];
+    double seconds = 10.0;
+    bool perLine = true;
+    size_t rows = 20;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--nodes") == 0) {
+            perLine = false;
+        } else if (std::strcmp(argv[i], "--rows") == 0 && i + 1 < argc) {
+            rows = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            seconds = std::max(0.01, std::atof(argv[i]));
+        }
+    }
+
+    // A built-in by name, else a script file; never the native replacement
+    BuiltinEffectsManager effectsManager;
+    std::unique_ptr<JSFXEffect> effect;
+    if (!effectsManager.GetEffectScript(target).empty()) {
+        effect = effectsManager.CreateEffect(target, false);
+    } else {
+        effect = std::make_unique<JSFXEffect>();
+        if (!effect->LoadEffectFromFile(target)) {
+            std::cerr << "Cannot load '" << target << "': not a built-in effect or readable script\n";
+            return 1;
+        }
+    }
+
+    effect->SetProfilingEnabled(true);
+    effect->Initialize(kSampleRate, kBlockSize);
+
+    AudioBuffer buffer(2, kBlockSize);
+    const int64_t totalSamples = static_cast<int64_t>(seconds * kSampleRate);
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t position = 0; position < totalSamples; position += kBlockSize) {
+        FillTestSignal(buffer, position);
+        effect->ProcessBlock(buffer);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "REAPER Web - JSFX Profile: " << (effect->GetName().empty() ? target : effect->GetName()) << "\n"
+              << std::fixed << std::setprecision(1) << seconds << " s of stereo audio at 48 kHz in "
+              << 1e3 * elapsed << " ms (profiled)\n";
+    std::cout.unsetf(std::ios::fixed);
+    if (effect->IsWatchdogTripped()) {
+        std::cout << "Watchdog tripped: " << effect->GetLastError() << "\n";
+    }
+    std::cout << "\n" << effect->GetProfileReport(rows, perLine);
+    return 0;
+}
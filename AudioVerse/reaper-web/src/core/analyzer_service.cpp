@@ -0,0 +1,419 @@
+/*
+ * REAPER Web - Analyzer Service Implementation
+ * Tap rings, analysis thread and triple-buffered snapshots
+ */
+
+#include "analyzer_service.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// JS reads the header as eight 32-bit words
+static_assert(offsetof(AnalyzerService::Snapshot, bandsDb) == 32, "Snapshot layout is shared with JS");
+
+namespace {
+    constexpr int kReadChunk = 4096;
+    constexpr double kRingSeconds = 0.5;          // Covers analysis-thread stalls
+
+    // out[i] = window[i] * (left[i] + right[i]); the window carries the 1/2
+    void WindowMid(const float* left, const float* right, const float* window, float* out, int count) {
+        int i = 0;
+#if defined(__SSE__)
+        for (; i + 4 <= count; i += 4) {
+            __m128 mid = _mm_add_ps(_mm_loadu_ps(left + i), _mm_loadu_ps(right + i));
+            _mm_storeu_ps(out + i, _mm_mul_ps(mid, _mm_loadu_ps(window + i)));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = window[i] * (left[i] + right[i]);
+        }
+    }
+
+    // In place: re[k] = re[k]^2 + im[k]^2
+    void PowerSpectrum(float* re, const float* im, int count) {
+        int k = 0;
+#if defined(__SSE__)
+        for (; k + 4 <= count; k += 4) {
+            __m128 r = _mm_loadu_ps(re + k);
+            __m128 j = _mm_loadu_ps(im + k);
+            _mm_storeu_ps(re + k, _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(j, j)));
+        }
+#endif
+        for (; k < count; ++k) {
+            re[k] = re[k] * re[k] + im[k] * im[k];
+        }
+    }
+
+    // Peaks and the LL/RR/LR sums of one window, in partial sums of 1024
+    // frames so float accumulation stays accurate for long windows
+    void WindowStatistics(const float* left, const float* right, int count,
+                          float peak[2], double& sumLL, double& sumRR, double& sumLR) {
+        peak[0] = peak[1] = 0.0f;
+        sumLL = sumRR = sumLR = 0.0;
+        for (int start = 0; start < count; start += 1024) {
+            int end = std::min(count, start + 1024);
+            int i = start;
+            float ll = 0.0f, rr = 0.0f, lr = 0.0f;
+#if defined(__SSE__)
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            __m128 accLL = _mm_setzero_ps(), accRR = _mm_setzero_ps(), accLR = _mm_setzero_ps();
+            __m128 peakL = _mm_setzero_ps(), peakR = _mm_setzero_ps();
+            for (; i + 4 <= end; i += 4) {
+                __m128 l = _mm_loadu_ps(left + i);
+                __m128 r = _mm_loadu_ps(right + i);
+                accLL = _mm_add_ps(accLL, _mm_mul_ps(l, l));
+                accRR = _mm_add_ps(accRR, _mm_mul_ps(r, r));
+                accLR = _mm_add_ps(accLR, _mm_mul_ps(l, r));
+                peakL = _mm_max_ps(peakL, _mm_andnot_ps(signMask, l));
+                peakR = _mm_max_ps(peakR, _mm_andnot_ps(signMask, r));
+            }
+            alignas(16) float lanes[5][4];
+            _mm_store_ps(lanes[0], accLL);
+            _mm_store_ps(lanes[1], accRR);
+            _mm_store_ps(lanes[2], accLR);
+            _mm_store_ps(lanes[3], peakL);
+            _mm_store_ps(lanes[4], peakR);
+            for (int lane = 0; lane < 4; ++lane) {
+                ll += lanes[0][lane];
+                rr += lanes[1][lane];
+                lr += lanes[2][lane];
+                peak[0] = std::max(peak[0], lanes[3][lane]);
+                peak[1] = std::max(peak[1], lanes[4][lane]);
+            }
+#endif
+            for (; i < end; ++i) {
+                ll += left[i] * left[i];
+                rr += right[i] * right[i];
+                lr += left[i] * right[i];
+                peak[0] = std::max(peak[0], std::abs(left[i]));
+                peak[1] = std::max(peak[1], std::abs(right[i]));
+            }
+            sumLL += ll;
+            sumRR += rr;
+            sumLR += lr;
+        }
+    }
+
+    float PowerToDb(double power) {
+        return power > 0.0 ? std::max(AnalyzerService::kFloorDb, static_cast<float>(10.0 * std::log10(power)))
+                           : AnalyzerService::kFloorDb;
+    }
+
+    // One-pole coefficient for a time constant over 'seconds' of audio
+    float SmoothingCoefficient(float timeMs, double seconds) {
+        return timeMs > 0.0f ? static_cast<float>(std::exp(-seconds * 1000.0 / timeMs)) : 0.0f;
+    }
+}
+
+AnalyzerService::AnalyzerService()
+    : m_readLeft(kReadChunk), m_readRight(kReadChunk), m_windowed(kMaxFftSize),
+      m_re(kMaxFftSize / 2 + 1), m_im(kMaxFftSize / 2 + 1) {
+    m_tapTable.Publish(std::make_unique<TapTable>());
+}
+
+AnalyzerService::~AnalyzerService() {
+    Stop();
+}
+
+void AnalyzerService::Prepare(double sampleRate) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sampleRate = sampleRate;
+}
+
+void AnalyzerService::Stop() {
+    if (m_thread.joinable()) {
+        m_running.store(false, std::memory_order_release);
+        m_thread.join();
+    }
+}
+
+int AnalyzerService::CreateAnalyzer(const Track* source, const Settings& requested) {
+    auto analyzer = std::make_unique<Analyzer>();
+    Settings& settings = analyzer->settings;
+    settings = requested;
+
+    int fftSize = kMinFftSize;
+    while (fftSize < requested.fftSize && fftSize < kMaxFftSize) fftSize <<= 1;
+    settings.fftSize = fftSize;
+    settings.hopSize = requested.hopSize > 0 ? std::min(requested.hopSize, kMaxFftSize) : fftSize / 4;
+    settings.numBands = std::max(1, std::min(requested.numBands, kMaxBands));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    analyzer->id = m_nextAnalyzerId++;
+    analyzer->sampleRate = m_sampleRate;
+
+    // Log-spaced band edges; each band takes the loudest bin inside it, so
+    // tones read at their level however wide the band is
+    double binHz = m_sampleRate / fftSize;
+    int lastBin = fftSize / 2;
+    settings.maxHz = std::min(settings.maxHz, static_cast<float>(m_sampleRate / 2.0));
+    settings.minHz = std::max(1.0f, std::min(settings.minHz, settings.maxHz * 0.5f));
+    double ratio = std::pow(static_cast<double>(settings.maxHz) / settings.minHz, 1.0 / settings.numBands);
+    for (int b = 0; b < settings.numBands; ++b) {
+        double low = settings.minHz * std::pow(ratio, b);
+        double high = low * ratio;
+        int first = std::max(1, static_cast<int>(std::ceil(low / binHz)));
+        int last = std::min(lastBin, static_cast<int>(std::ceil(high / binHz)) - 1);
+        analyzer->firstBin.push_back(first);
+        analyzer->lastBin.push_back(last);
+        analyzer->centreBin.push_back(static_cast<float>(std::sqrt(low * high) / binHz));
+        analyzer->centreHz.push_back(static_cast<float>(std::sqrt(low * high)));
+    }
+    analyzer->smoothedDb.assign(settings.numBands, kFloorDb);
+    for (Snapshot& snapshot : analyzer->buffers) {
+        snapshot.numBands = settings.numBands;
+        std::fill(snapshot.bandsDb, snapshot.bandsDb + kMaxBands, kFloorDb);
+    }
+
+    if (!m_ffts.count(fftSize)) {
+        m_ffts[fftSize] = std::make_unique<FFT>(fftSize);
+
+        // Hann scaled so the mid (L+R)/2 of a full-scale sine peaks at |X| = 1
+        std::vector<float>& window = m_windows[fftSize];
+        window.resize(fftSize);
+        double sum = 0.0;
+        for (int i = 0; i < fftSize; ++i) {
+            double value = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / fftSize);
+            window[i] = static_cast<float>(value);
+            sum += value;
+        }
+        for (float& value : window) value = static_cast<float>(value / sum);
+    }
+
+    // One tap per source, shared by all its analyzers
+    auto it = std::find_if(m_taps.begin(), m_taps.end(), [source](const std::shared_ptr<Tap>& tap) {
+        return source ? tap->source == source : tap->isMaster;
+    });
+    if (it == m_taps.end()) {
+        auto tap = std::make_shared<Tap>();
+        tap->source = source;
+        tap->isMaster = (source == nullptr);
+        size_t ringFrames = std::max<size_t>(kMaxFftSize, static_cast<size_t>(m_sampleRate * kRingSeconds));
+        tap->left = std::make_unique<LockFreeRingBuffer<float>>(ringFrames);
+        tap->right = std::make_unique<LockFreeRingBuffer<float>>(ringFrames);
+        tap->historyLeft.assign(kMaxFftSize * 2, 0.0f);
+        tap->historyRight.assign(kMaxFftSize * 2, 0.0f);
+        m_taps.push_back(tap);
+        it = m_taps.end() - 1;
+        PublishTapTable();
+    }
+    analyzer->tap = *it;
+    analyzer->lastUpdate = (*it)->framesReceived;
+
+    int id = analyzer->id;
+    (*it)->analyzers.push_back(analyzer.get());
+    m_analyzers[id] = std::move(analyzer);
+
+    if (!m_thread.joinable()) {
+        m_running.store(true, std::memory_order_release);
+        m_thread = std::thread(&AnalyzerService::AnalysisLoop, this);
+    }
+    return id;
+}
+
+void AnalyzerService::DestroyAnalyzer(int analyzerId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_analyzers.find(analyzerId);
+    if (it == m_analyzers.end()) return;
+
+    Tap& tap = *it->second->tap;
+    tap.analyzers.erase(std::remove(tap.analyzers.begin(), tap.analyzers.end(), it->second.get()),
+                        tap.analyzers.end());
+    if (tap.analyzers.empty()) {
+        // The retired table keeps the tap alive until the audio thread is past it
+        m_taps.erase(std::remove(m_taps.begin(), m_taps.end(), it->second->tap), m_taps.end());
+        PublishTapTable();
+    }
+    m_analyzers.erase(it);
+}
+
+const AnalyzerService::Snapshot* AnalyzerService::AcquireSnapshot(int analyzerId) {
+    auto it = m_analyzers.find(analyzerId);
+    if (it == m_analyzers.end()) return nullptr;
+
+    Analyzer& analyzer = *it->second;
+    if (analyzer.middle.load(std::memory_order_acquire) & kFreshBit) {
+        analyzer.front = analyzer.middle.exchange(analyzer.front, std::memory_order_acq_rel) & ~kFreshBit;
+    }
+    return &analyzer.buffers[analyzer.front];
+}
+
+const float* AnalyzerService::GetBandFrequencies(int analyzerId) const {
+    auto it = m_analyzers.find(analyzerId);
+    return it == m_analyzers.end() ? nullptr : it->second->centreHz.data();
+}
+
+void AnalyzerService::PublishTapTable() {
+    auto table = std::make_unique<TapTable>();
+    for (const auto& tap : m_taps) {
+        if (tap->isMaster) {
+            table->master = tap;
+        } else {
+            table->tracks.emplace_back(tap->source, tap);
+        }
+    }
+    m_tapTable.Publish(std::move(table));
+}
+
+void AnalyzerService::Push(Tap& tap, const AudioBuffer& buffer) {
+    int numSamples = buffer.GetSampleCount();
+    if (buffer.GetChannelCount() == 0 || numSamples == 0) return;
+
+    const float* left = buffer.GetChannelData(0);
+    const float* right = buffer.GetChannelCount() > 1 ? buffer.GetChannelData(1) : left;
+    size_t count = std::min({static_cast<size_t>(numSamples), tap.left->GetWriteAvailable(),
+                             tap.right->GetWriteAvailable()});
+    tap.left->Write(left, count);
+    tap.right->Write(right, count);
+    if (count < static_cast<size_t>(numSamples)) {
+        tap.droppedFrames.fetch_add(static_cast<uint32_t>(numSamples - count), std::memory_order_relaxed);
+    }
+}
+
+void AnalyzerService::CaptureTrack(const Track* track, const AudioBuffer& buffer) {
+    const TapTable* table = m_tapTable.Acquire();
+    if (!table) return;
+    for (const auto& entry : table->tracks) {
+        if (entry.first == track) {
+            Push(*entry.second, buffer);
+            return;
+        }
+    }
+}
+
+void AnalyzerService::CaptureMaster(const AudioBuffer& buffer) {
+    const TapTable* table = m_tapTable.Acquire();
+    if (table && table->master) {
+        Push(*table->master, buffer);
+    }
+}
+
+void AnalyzerService::AnalysisLoop() {
+    while (m_running.load(std::memory_order_acquire)) {
+        if (!ProcessPending()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
+bool AnalyzerService::ProcessPending() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tapTable.CollectRetired();
+
+    bool received = false;
+    for (const auto& tap : m_taps) {
+        uint64_t before = tap->framesReceived;
+        DrainTap(*tap);
+        if (tap->framesReceived == before) continue;
+        received = true;
+
+        for (Analyzer* analyzer : tap->analyzers) {
+            if (tap->framesReceived - analyzer->lastUpdate >= static_cast<uint64_t>(analyzer->settings.hopSize)) {
+                UpdateAnalyzer(*analyzer);
+            }
+        }
+    }
+    return received;
+}
+
+void AnalyzerService::DrainTap(Tap& tap) {
+    size_t available = std::min(tap.left->GetReadAvailable(), tap.right->GetReadAvailable());
+    while (available > 0) {
+        size_t count = std::min(available, static_cast<size_t>(kReadChunk));
+        tap.left->Read(m_readLeft.data(), count);
+        tap.right->Read(m_readRight.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            tap.historyLeft[tap.historyPosition] = tap.historyLeft[tap.historyPosition + kMaxFftSize] = m_readLeft[i];
+            tap.historyRight[tap.historyPosition] = tap.historyRight[tap.historyPosition + kMaxFftSize] = m_readRight[i];
+            if (++tap.historyPosition == kMaxFftSize) tap.historyPosition = 0;
+        }
+        tap.framesReceived += count;
+        available -= count;
+    }
+}
+
+const AnalyzerService::SpectrumCache& AnalyzerService::ComputeSpectrum(Tap& tap, int fftSize) {
+    auto cache = std::find_if(tap.spectra.begin(), tap.spectra.end(),
+                              [fftSize](const SpectrumCache& entry) { return entry.fftSize == fftSize; });
+    if (cache == tap.spectra.end()) {
+        tap.spectra.emplace_back();
+        cache = tap.spectra.end() - 1;
+        cache->fftSize = fftSize;
+        cache->power.resize(fftSize / 2 + 1);
+    }
+    if (cache->windowEnd == tap.framesReceived) {
+        return *cache;
+    }
+
+    // The newest fftSize frames, contiguous thanks to the double write
+    const float* left = tap.historyLeft.data() + tap.historyPosition + kMaxFftSize - fftSize;
+    const float* right = tap.historyRight.data() + tap.historyPosition + kMaxFftSize - fftSize;
+
+    FFT& fft = *m_ffts[fftSize];
+    WindowMid(left, right, m_windows[fftSize].data(), m_windowed.data(), fftSize);
+    fft.Forward(m_windowed.data(), m_re.data(), m_im.data());
+    PowerSpectrum(m_re.data(), m_im.data(), fft.GetNumBins());
+    std::copy(m_re.begin(), m_re.begin() + fft.GetNumBins(), cache->power.begin());
+
+    WindowStatistics(left, right, fftSize, cache->peak, cache->sumLL, cache->sumRR, cache->sumLR);
+    cache->windowEnd = tap.framesReceived;
+    return *cache;
+}
+
+void AnalyzerService::UpdateAnalyzer(Analyzer& analyzer) {
+    Tap& tap = *analyzer.tap;
+    const Settings& settings = analyzer.settings;
+    const SpectrumCache& spectrum = ComputeSpectrum(tap, settings.fftSize);
+
+    // Smoothing follows the audio time since the last update, not wall time
+    double elapsed = static_cast<double>(tap.framesReceived - analyzer.lastUpdate) / analyzer.sampleRate;
+    analyzer.lastUpdate = tap.framesReceived;
+    float attack = SmoothingCoefficient(settings.attackMs, elapsed);
+    float release = SmoothingCoefficient(settings.releaseMs, elapsed);
+
+    Snapshot& snapshot = analyzer.buffers[analyzer.back];
+    const float* power = spectrum.power.data();
+    for (int b = 0; b < settings.numBands; ++b) {
+        float bandPower;
+        if (analyzer.firstBin[b] <= analyzer.lastBin[b]) {
+            bandPower = *std::max_element(power + analyzer.firstBin[b], power + analyzer.lastBin[b] + 1);
+        } else {
+            // Narrower than a bin: interpolate between the bins either side
+            float position = analyzer.centreBin[b];
+            int bin = std::min(static_cast<int>(position), settings.fftSize / 2 - 1);
+            float fraction = position - bin;
+            bandPower = power[bin] + (power[bin + 1] - power[bin]) * fraction;
+        }
+
+        float target = PowerToDb(bandPower);
+        float& smoothed = analyzer.smoothedDb[b];
+        float coefficient = target > smoothed ? attack : release;
+        smoothed = target + (smoothed - target) * coefficient;
+        snapshot.bandsDb[b] = smoothed;
+    }
+
+    // Silence counts as uncorrelated rather than mono
+    double energy = std::sqrt(spectrum.sumLL * spectrum.sumRR);
+    float correlation = energy > 1e-12 ? static_cast<float>(spectrum.sumLR / energy) : 0.0f;
+    float correlationCoefficient = SmoothingCoefficient(settings.correlationMs, elapsed);
+    analyzer.correlation = correlation + (analyzer.correlation - correlation) * correlationCoefficient;
+
+    snapshot.sequence++;
+    snapshot.numBands = settings.numBands;
+    snapshot.correlation = analyzer.correlation;
+    snapshot.peakDb[0] = PowerToDb(static_cast<double>(spectrum.peak[0]) * spectrum.peak[0]);
+    snapshot.peakDb[1] = PowerToDb(static_cast<double>(spectrum.peak[1]) * spectrum.peak[1]);
+    snapshot.rmsDb[0] = PowerToDb(spectrum.sumLL / settings.fftSize);
+    snapshot.rmsDb[1] = PowerToDb(spectrum.sumRR / settings.fftSize);
+    snapshot.droppedFrames = tap.droppedFrames.load(std::memory_order_relaxed);
+
+    // Hand the filled buffer to the reader; the next update starts from its sequence
+    uint32_t sequence = snapshot.sequence;
+    analyzer.back = analyzer.middle.exchange(analyzer.back | kFreshBit, std::memory_order_acq_rel) & ~kFreshBit;
+    analyzer.buffers[analyzer.back].sequence = sequence;
+}
@@ -0,0 +1,186 @@
+/*
+ * REAPER Web - Analyzer Service
+ * Off-thread spectrum, level and stereo correlation analysis of track and
+ * master taps for UI meters
+ */
+
+#pragma once
+
+#include "audio_buffer.hpp"
+#include "fft.hpp"
+#include "lockfree_ring_buffer.hpp"
+#include "realtime_snapshot.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Track;
+
+/**
+ * AnalyzerService - spectrum analyzers fed from lock-free taps
+ *
+ * Audio thread: CaptureTrack()/CaptureMaster() copy the block of a tapped
+ * source into that source's SPSC rings. There is one tap per source no
+ * matter how many analyzers watch it, so the audio-thread cost is two ring
+ * writes per tapped source; untapped sources cost one table lookup.
+ *
+ * Analysis thread: drains the rings and, once per hop, computes a Hann-
+ * windowed FFT of the mid signal, peak/RMS levels and L/R correlation over
+ * the same window (SSE/SIMD128 with scalar fallbacks). Analyzers on one tap
+ * with the same FFT size share that work; each then bins the power spectrum
+ * into log-spaced bands and applies attack/release smoothing.
+ *
+ * UI thread: every analyzer publishes through a triple buffer. The pointer
+ * from AcquireSnapshot() stays valid and unchanged until the next call for
+ * that analyzer, so the WASM bridge hands it to JS as-is. Create, destroy
+ * and acquire must all come from the same (UI) thread.
+ */
+class AnalyzerService {
+public:
+    static constexpr int kMaxBands = 256;
+    static constexpr int kMinFftSize = 256;
+    static constexpr int kMaxFftSize = 16384;
+    static constexpr float kFloorDb = -144.0f;
+
+    struct Settings {
+        int fftSize = 4096;             // Power of two, kMinFftSize to kMaxFftSize
+        int hopSize = 0;                // Samples between updates; 0 is fftSize / 4
+        int numBands = 96;
+        float minHz = 20.0f;
+        float maxHz = 20000.0f;         // Clamped to Nyquist
+        float attackMs = 0.0f;          // Band smoothing; 0 follows rises at once
+        float releaseMs = 250.0f;
+        float correlationMs = 300.0f;
+    };
+
+    // Fixed layout, read in place by JS: header of eight 32-bit words, then bands
+    struct Snapshot {
+        uint32_t sequence = 0;          // Bumped on every update
+        int32_t numBands = 0;
+        float correlation = 0.0f;       // -1 (out of phase) to +1 (mono), smoothed
+        float peakDb[2] = {kFloorDb, kFloorDb};
+        float rmsDb[2] = {kFloorDb, kFloorDb};
+        uint32_t droppedFrames = 0;     // Frames the tap lost to a full ring
+        float bandsDb[kMaxBands] = {};  // Smoothed band levels, 0 dB = full-scale sine
+    };
+
+public:
+    AnalyzerService();
+    ~AnalyzerService();
+
+    AnalyzerService(const AnalyzerService&) = delete;
+    AnalyzerService& operator=(const AnalyzerService&) = delete;
+
+    // Non-realtime: session sample rate for analyzers created afterwards
+    void Prepare(double sampleRate);
+    void Stop();
+
+    // UI thread. A null source is the master bus; returns an analyzer id
+    int CreateAnalyzer(const Track* source, const Settings& settings);
+    int CreateAnalyzer(const Track* source) { return CreateAnalyzer(source, Settings()); }
+    void DestroyAnalyzer(int analyzerId);
+    const Snapshot* AcquireSnapshot(int analyzerId);
+    const float* GetBandFrequencies(int analyzerId) const;     // Centre of each band in Hz
+    int GetAnalyzerCount() const { return static_cast<int>(m_analyzers.size()); }
+
+    // Audio thread: the block of a source after its processing
+    void CaptureTrack(const Track* track, const AudioBuffer& buffer);
+    void CaptureMaster(const AudioBuffer& buffer);
+    void EndBlock() { m_tapTable.EndBlock(); }
+
+    // Analysis thread, or any thread while it is not running (tests, offline
+    // render); returns true if any tap had new audio
+    bool ProcessPending();
+
+private:
+    struct Analyzer;
+
+    // Most recent power spectrum and window statistics at one FFT size
+    struct SpectrumCache {
+        int fftSize = 0;
+        uint64_t windowEnd = UINT64_MAX;    // Tap position the window ends at
+        std::vector<float> power;           // Relative to a full-scale sine
+        float peak[2] = {};
+        double sumLL = 0.0, sumRR = 0.0, sumLR = 0.0;
+    };
+
+    struct Tap {
+        const Track* source = nullptr;
+        bool isMaster = false;
+        std::unique_ptr<LockFreeRingBuffer<float>> left;
+        std::unique_ptr<LockFreeRingBuffer<float>> right;
+        std::atomic<uint32_t> droppedFrames{0};
+
+        // Analysis thread: last kMaxFftSize frames, each written twice
+        std::vector<float> historyLeft;
+        std::vector<float> historyRight;
+        int historyPosition = 0;
+        uint64_t framesReceived = 0;
+
+        std::vector<Analyzer*> analyzers;
+        std::vector<SpectrumCache> spectra;
+    };
+
+    // What the audio thread sees: the taps by source
+    struct TapTable {
+        std::shared_ptr<Tap> master;
+        std::vector<std::pair<const Track*, std::shared_ptr<Tap>>> tracks;
+    };
+
+    struct Analyzer {
+        int id = 0;
+        Settings settings;
+        std::shared_ptr<Tap> tap;
+        double sampleRate = 48000.0;
+
+        // Band b covers bins [firstBin, lastBin]; an empty band interpolates at centreBin
+        std::vector<int> firstBin;
+        std::vector<int> lastBin;
+        std::vector<float> centreBin;
+        std::vector<float> centreHz;
+        std::vector<float> smoothedDb;
+        float correlation = 0.0f;
+        uint64_t lastUpdate = 0;
+
+        // Triple buffer: the analysis thread fills 'back', the UI reads 'front'
+        Snapshot buffers[3];
+        int back = 0;
+        int front = 2;
+        std::atomic<int> middle{1};         // Index, plus kFreshBit once written
+    };
+
+    static constexpr int kFreshBit = 4;
+
+    double m_sampleRate = 48000.0;
+    int m_nextAnalyzerId = 1;
+
+    // Control state, shared by the UI and the analysis pass
+    mutable std::mutex m_mutex;
+    std::map<int, std::unique_ptr<Analyzer>> m_analyzers;
+    std::vector<std::shared_ptr<Tap>> m_taps;
+    RealtimeSnapshot<TapTable> m_tapTable;
+
+    // Analysis thread scratch, one FFT per size in use
+    std::map<int, std::unique_ptr<FFT>> m_ffts;
+    std::map<int, std::vector<float>> m_windows;     // Hann, pre-scaled to read a full-scale sine as 1
+    std::vector<float> m_readLeft;
+    std::vector<float> m_readRight;
+    std::vector<float> m_windowed;
+    std::vector<float> m_re;
+    std::vector<float> m_im;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    void AnalysisLoop();
+    void PublishTapTable();
+    void DrainTap(Tap& tap);
+    const SpectrumCache& ComputeSpectrum(Tap& tap, int fftSize);
+    void UpdateAnalyzer(Analyzer& analyzer);
+    void Push(Tap& tap, const AudioBuffer& buffer);
+};
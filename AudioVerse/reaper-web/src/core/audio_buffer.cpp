@@ -398,7 +398,8 @@ void AudioBufferPool::ReleaseAll() {
 
 void AudioBufferPool::PreallocateBuffers(int numChannels, int numSamples, int count) {
     for (int i = 0; i < count && static_cast<int>(m_bufferPool.size()) < m_maxBuffers; ++i) {
-        CreateNewBuffer(numChannels, numSamples);
+        // Created in use; hand it straight back so AcquireBuffer can find it
+        ReleaseBuffer(CreateNewBuffer(numChannels, numSamples));
     }
 }
 
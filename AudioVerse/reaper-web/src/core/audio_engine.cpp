@@ -5,11 +5,49 @@
 
 #include "audio_engine.hpp"
 #include "track_manager.hpp"
+#include "../effects/effect_chain.hpp"
 #include "../media/media_item.hpp"
 #include <algorithm>
 #include <chrono>
 #include <cmath>
 
+/**
+ * PDC Delay Line - fixed delay for one track
+ * Immutable delay; a track whose compensation changes gets a new line. The
+ * history is only touched by the audio thread.
+ */
+class AudioEngine::PDCDelayLine {
+public:
+    PDCDelayLine(int numChannels, int delay)
+        : m_delay(delay), m_history(numChannels, std::vector<float>(delay, 0.0f)) {}
+    
+    int GetDelay() const { return m_delay; }
+    
+    void Process(AudioBuffer& buffer) {
+        int channels = std::min(buffer.GetChannelCount(), static_cast<int>(m_history.size()));
+        int numSamples = buffer.GetSampleCount();
+        for (int ch = 0; ch < channels; ++ch) {
+            float* samples = buffer.GetChannelData(ch);
+            float* history = m_history[ch].data();
+            int position = m_position;
+            for (int i = 0; i < numSamples; ++i) {
+                float delayed = history[position];
+                history[position] = samples[i];
+                samples[i] = delayed;
+                if (++position == m_delay) {
+                    position = 0;
+                }
+            }
+        }
+        m_position = (m_position + numSamples) % m_delay;
+    }
+    
+private:
+    int m_delay;
+    int m_position = 0;
+    std::vector<std::vector<float>> m_history;
+};
+
 AudioEngine::AudioEngine() {
     // Initialize performance stats
     m_stats.cpuUsage = 0.0;
@@ -18,9 +56,13 @@ AudioEngine::AudioEngine() {
     m_stats.activePlugins = 0;
     m_stats.samplesProcessed = 0;
     m_stats.latencyMs = 0.0;
+    m_stats.watchdogTrips = 0;
     
     // Initialize buffer pool
     m_bufferPool = std::make_unique<AudioBufferPool>(32); // 32 buffer max pool
+    
+    m_masterLimiter = std::make_unique<MasterLimiter>();
+    m_analyzerService = std::make_unique<AnalyzerService>();
 }
 
 AudioEngine::~AudioEngine() {
@@ -41,11 +83,14 @@ bool AudioEngine::Initialize(double sampleRate, int bufferSize, int maxChannels)
     // Allocate buffer pool for real-time processing
     AllocateBufferPool();
     
-    // Initialize PDC system
-    m_trackDelays.resize(64, 0); // Support up to 64 tracks initially
+    // Initialize PDC system: no track delayed until latencies are known
+    m_pdc.Publish(std::make_unique<PDCState>());
+    m_masterLimiter->Prepare(sampleRate, maxChannels);
+    m_masterPDCDelay = m_masterLimiter->GetLatencySamples();
+    m_analyzerService->Prepare(sampleRate);
     
     // Set latency calculation
-    m_stats.latencyMs = (static_cast<double>(bufferSize) / sampleRate) * 1000.0;
+    m_stats.latencyMs = (static_cast<double>(bufferSize + m_masterPDCDelay) / sampleRate) * 1000.0;
     
     m_initialized = true;
     return true;
@@ -58,6 +103,7 @@ void AudioEngine::Shutdown() {
     
     StopPlayback();
     StopRecording();
+    m_analyzerService->Stop();
     
     // Clear tracks
     {
@@ -98,61 +144,9 @@ void AudioEngine::SetPlayPosition(double seconds) {
 }
 
 void AudioEngine::ProcessBlock(float** inputs, float** outputs, int numChannels, int numSamples) {
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    if (!m_initialized.load()) {
-        // Output silence if not initialized
-        for (int ch = 0; ch < numChannels; ++ch) {
-            std::fill(outputs[ch], outputs[ch] + numSamples, 0.0f);
-        }
-        return;
-    }
-    
-    // Acquire buffer for processing
-    AudioBuffer* masterBuffer = AcquireBuffer(numChannels, numSamples);
-    if (!masterBuffer) {
-        // Fallback: output silence
-        for (int ch = 0; ch < numChannels; ++ch) {
-            std::fill(outputs[ch], outputs[ch] + numSamples, 0.0f);
-        }
-        m_stats.dropouts++;
-        return;
-    }
-    
-    // Clear master buffer
-    masterBuffer->Clear();
-    
-    // Copy input to master buffer if monitoring
-    if (inputs && m_settings.inputMonitoring.load()) {
-        for (int ch = 0; ch < std::min(numChannels, masterBuffer->GetChannelCount()); ++ch) {
-            std::copy(inputs[ch], inputs[ch] + numSamples, masterBuffer->GetChannelData(ch));
-        }
-    }
-    
-    // Process all tracks
-    ProcessTracks(*masterBuffer);
-    
-    // Process master bus
-    ProcessMasterBus(*masterBuffer);
-    
-    // Copy to outputs
-    for (int ch = 0; ch < std::min(numChannels, masterBuffer->GetChannelCount()); ++ch) {
-        std::copy(masterBuffer->GetChannelData(ch), 
-                 masterBuffer->GetChannelData(ch) + numSamples, outputs[ch]);
-    }
-    
-    // Release buffer
-    ReleaseBuffer(masterBuffer);
-    
-    // Update performance stats
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-    double processingTime = duration.count() / 1000.0; // Convert to milliseconds
-    
-    UpdatePerformanceStats(processingTime);
-    
-    // Update sample counter
-    m_stats.samplesProcessed += numSamples;
+    // No timeline to render: input monitoring through the master bus only
+    ProcessBlock(inputs, outputs, numChannels, numSamples, nullptr, nullptr,
+                 m_playPosition, numSamples / m_settings.sampleRate);
 }
 
 void AudioEngine::ProcessBlock(float** inputs, float** outputs, int numChannels, int numSamples,
@@ -219,10 +213,11 @@ void AudioEngine::ProcessTracks(MediaItemManager* mediaManager, TrackManager* tr
                               double startTime, double length, AudioBuffer& masterBuffer) {
     if (!mediaManager || !trackManager) return;
     
-    // Get all tracks
-    auto tracks = trackManager->GetAllTracks();
+    // One set of compensation delays for the whole block
+    const PDCState* pdc = m_pdc.Acquire();
     
-    for (Track* track : tracks) {
+    for (int i = 0; i < trackManager->GetTrackCount(); ++i) {
+        Track* track = trackManager->GetTrack(i);
         if (!track) continue;
         
         // Get a buffer for this track
@@ -246,75 +241,173 @@ void AudioEngine::ProcessTracks(MediaItemManager* mediaManager, TrackManager* tr
             }
         }
         
-        // Apply track volume, pan, mute, solo, and effects
+        // Apply track volume, pan, mute, solo
         // (Track processing would be implemented here)
         
+        // Effects run before compensation: their latency is what the delays offset
+        track->ProcessEffects(*trackBuffer, startTime);
+        
+        // Line the track up with the most delayed one before anything sees it
+        ApplyTrackDelay(pdc, track, *trackBuffer);
+        
+        m_analyzerService->CaptureTrack(track, *trackBuffer);
+        
         // Mix track into master buffer
         masterBuffer.AddFrom(*trackBuffer);
         
         // Release track buffer
         ReleaseBuffer(trackBuffer);
     }
+    
+    m_pdc.EndBlock();
 }
-        
-        // Mix into master buffer
-        masterBuffer.AddFrom(*trackBuffer, 1.0f);
-        
-        ReleaseBuffer(trackBuffer);
+
+void AudioEngine::ApplyTrackDelay(const PDCState* pdc, const Track* track, AudioBuffer& buffer) {
+    if (!pdc) {
+        return;
+    }
+    for (const auto& entry : pdc->trackDelays) {
+        if (entry.first == track) {
+            entry.second->Process(buffer);
+            return;
+        }
     }
 }
 
 void AudioEngine::ProcessMasterBus(AudioBuffer& buffer) {
-    if (!buffer.isValid) return;
-    
-    // Apply master volume
-    float masterVol = m_masterVolume.load();
-    bool masterMute = m_realtimeSettings.masterMute.load();
+    if (buffer.GetChannelCount() == 0 || buffer.GetSampleCount() == 0) return;
     
-    if (masterMute) {
+    if (m_masterMute.load()) {
         buffer.Clear();
-        return;
     }
     
+    // Apply master volume
+    float masterVol = m_masterVolume.load();
     if (masterVol != 1.0f) {
-        for (int ch = 0; ch < buffer.numChannels; ++ch) {
-            for (int i = 0; i < buffer.numSamples; ++i) {
-                buffer.channels[ch][i] *= masterVol;
-            }
-        }
+        buffer.ApplyGain(masterVol);
     }
     
     // Apply master pan (for stereo)
-    if (buffer.numChannels >= 2) {
+    if (buffer.GetChannelCount() >= 2) {
         float pan = m_masterPan.load();
         if (pan != 0.0f) {
-            float leftGain = PanToGainLeft(pan);
-            float rightGain = PanToGainRight(pan);
-            
-            for (int i = 0; i < buffer.numSamples; ++i) {
-                buffer.channels[0][i] *= leftGain;
-                buffer.channels[1][i] *= rightGain;
+            buffer.ApplyChannelGain(0, PanToGainLeft(pan));
+            buffer.ApplyChannelGain(1, PanToGainRight(pan));
+        }
+    }
+}
+
+void AudioEngine::ProcessMasterOutput(float** outputs, int numChannels, int numSamples) {
+    if (!m_initialized.load() || numChannels <= 0 || numSamples <= 0) return;
+    
+    AudioBuffer* buffer = AcquireBuffer(numChannels, numSamples);
+    if (!buffer) {
+        m_stats.dropouts++;
+        return;
+    }
+    for (int ch = 0; ch < numChannels; ++ch) {
+        std::copy(outputs[ch], outputs[ch] + numSamples, buffer->GetChannelData(ch));
+    }
+    
+    // Nothing is added after this, so nothing can push the output over the
+    // ceiling; it runs even when muted to keep its delay line continuous
+    m_masterLimiter->Process(*buffer);
+    
+    // Analyzers see what leaves the engine; the device block ends here
+    m_analyzerService->CaptureMaster(*buffer);
+    m_analyzerService->EndBlock();
+    
+    for (int ch = 0; ch < numChannels; ++ch) {
+        std::copy(buffer->GetChannelData(ch), buffer->GetChannelData(ch) + numSamples, outputs[ch]);
+    }
+    ReleaseBuffer(buffer);
+}
+
+void AudioEngine::SetMasterLimiterEnabled(bool enabled) {
+    // The delay stays in place when disabled, so compensation is unchanged
+    m_masterLimiter->SetEnabled(enabled);
+}
+
+void AudioEngine::SetMasterLimiterLookahead(float lookaheadMs) {
+    m_masterLimiter->SetLookahead(lookaheadMs);
+    CompensateLatency();
+}
+
+int AudioEngine::CalculatePDCDelay() const {
+    if (!m_settings.enablePDC) {
+        return 0;
+    }
+    
+    // The most delayed track sets the delay every other track is aligned to;
+    // the master limiter's delay is common to all and is added separately
+    std::lock_guard<std::mutex> lock(m_tracksMutex);
+    int maxDelay = 0;
+    for (Track* track : m_tracks) {
+        EffectChain* chain = track ? track->GetEffectsChain() : nullptr;
+        if (chain) {
+            maxDelay = std::max(maxDelay, chain->GetLatencySamples());
+        }
+    }
+    return std::min(maxDelay, m_settings.maxPDCDelay);
+}
+
+void AudioEngine::CompensateLatency() {
+    int compensatedDelay = CalculatePDCDelay();
+    
+    std::lock_guard<std::mutex> lock(m_tracksMutex);
+    const PDCState* current = m_pdc.Acquire();
+    auto next = std::make_unique<PDCState>();
+    for (Track* track : m_tracks) {
+        EffectChain* chain = track ? track->GetEffectsChain() : nullptr;
+        int latency = chain ? chain->GetLatencySamples() : 0;
+        int delay = std::max(0, compensatedDelay - latency);
+        if (delay == 0) {
+            continue;
+        }
+        
+        // An unchanged delay keeps its line and the audio already in it
+        std::shared_ptr<PDCDelayLine> line;
+        for (size_t i = 0; current && i < current->trackDelays.size(); ++i) {
+            if (current->trackDelays[i].first == track && current->trackDelays[i].second->GetDelay() == delay) {
+                line = current->trackDelays[i].second;
             }
         }
+        if (!line) {
+            line = std::make_shared<PDCDelayLine>(m_settings.maxChannels, delay);
+        }
+        next->trackDelays.emplace_back(track, std::move(line));
     }
+    m_pdc.Publish(std::move(next));
+    m_masterPDCDelay = compensatedDelay + m_masterLimiter->GetLatencySamples();
+    
+    m_stats.latencyMs = (static_cast<double>(m_settings.bufferSize + m_masterPDCDelay) / m_settings.sampleRate) * 1000.0;
 }
 
 void AudioEngine::AddTrack(Track* track) {
-    std::lock_guard<std::mutex> lock(m_tracksMutex);
-    m_tracks.push_back(track);
+    {
+        std::lock_guard<std::mutex> lock(m_tracksMutex);
+        m_tracks.push_back(track);
+    }
+    CompensateLatency();
 }
 
 void AudioEngine::RemoveTrack(Track* track) {
-    std::lock_guard<std::mutex> lock(m_tracksMutex);
-    auto it = std::find(m_tracks.begin(), m_tracks.end(), track);
-    if (it != m_tracks.end()) {
-        m_tracks.erase(it);
+    {
+        std::lock_guard<std::mutex> lock(m_tracksMutex);
+        auto it = std::find(m_tracks.begin(), m_tracks.end(), track);
+        if (it != m_tracks.end()) {
+            m_tracks.erase(it);
+        }
     }
+    CompensateLatency();
 }
 
 void AudioEngine::ClearTracks() {
-    std::lock_guard<std::mutex> lock(m_tracksMutex);
-    m_tracks.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_tracksMutex);
+        m_tracks.clear();
+    }
+    CompensateLatency();
 }
 
 AudioBuffer* AudioEngine::AcquireBuffer(int channels, int samples) {
@@ -328,20 +421,16 @@ void AudioEngine::ReleaseBuffer(AudioBuffer* buffer) {
 void AudioEngine::AllocateBufferPool() {
     std::lock_guard<std::mutex> lock(m_bufferMutex);
     
-    // Allocate a pool of buffers for real-time use
+    // Master and track buffers for full device blocks, so the audio thread
+    // normally never has to create one
     const int poolSize = 16; // Number of buffers in pool
-    
-    for (int i = 0; i < poolSize; ++i) {
-        auto buffer = std::make_unique<AudioBuffer>(m_settings.maxChannels, m_settings.bufferSize * 2);
-        m_availableBuffers.push_back(buffer.get());
-        m_bufferPool.push_back(std::move(buffer));
-    }
+    m_bufferPool->PreallocateBuffers(2, m_settings.bufferSize, poolSize);
 }
 
 void AudioEngine::DeallocateBufferPool() {
     std::lock_guard<std::mutex> lock(m_bufferMutex);
-    m_availableBuffers.clear();
-    m_bufferPool.clear();
+    m_bufferPool->ReleaseAll();
+    m_bufferPool->ClearUnusedBuffers();
 }
 
 void AudioEngine::UpdatePerformanceStats(double processingTime) {
@@ -358,6 +447,7 @@ void AudioEngine::UpdatePerformanceStats(double processingTime) {
         
         m_stats.cpuUsage = std::min(cpuUsage, 100.0);
         m_stats.peakCpuUsage = std::max(m_stats.peakCpuUsage.load(), cpuUsage);
+        m_stats.watchdogTrips = JSFXEffect::GetWatchdogTripTotal();
         
         // Reset counters
         m_processingTimeAccumulator = 0.0;
@@ -7,16 +7,19 @@
 #pragma once
 
 #include "audio_buffer.hpp"
+#include "master_limiter.hpp"
+#include "analyzer_service.hpp"
+#include "realtime_snapshot.hpp"
 #include <memory>
 #include <vector>
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <chrono>
 
 // Forward declarations
 class Track;
 class EffectsChain;
-class AudioDevice;
 class MediaItemManager;
 class TrackManager;
 
@@ -51,6 +54,7 @@ public:
         std::atomic<int> activePlugins{0};
         std::atomic<long long> samplesProcessed{0};
         std::atomic<double> latencyMs{0.0};
+        std::atomic<int> watchdogTrips{0};      // JSFX effects bypassed for overrunning their budget
     };
 
 public:
@@ -93,6 +97,11 @@ public:
     void ProcessTracks(MediaItemManager* mediaManager, TrackManager* trackManager, 
                       double startTime, double length, AudioBuffer& masterBuffer);
     
+    // Last stage of every device block, once the host has added everything it
+    // mixes on top of ProcessBlock (master gain, clicks, splice fades): the
+    // master limiter, then the master analyzer tap
+    void ProcessMasterOutput(float** outputs, int numChannels, int numSamples);
+    
     // Track management for audio routing
     void AddTrack(Track* track);
     void RemoveTrack(Track* track);
@@ -103,6 +112,14 @@ public:
     void SetMasterPan(float pan);
     void SetMasterMute(bool mute);
     
+    // Master limiter: true-peak brickwall in ProcessMasterOutput; on by default
+    MasterLimiter* GetMasterLimiter() { return m_masterLimiter.get(); }
+    void SetMasterLimiterEnabled(bool enabled);
+    void SetMasterLimiterLookahead(float lookaheadMs);
+    
+    // Spectrum/correlation analyzers on any track or the master (post-limiter)
+    AnalyzerService* GetAnalyzerService() { return m_analyzerService.get(); }
+    
     // Plugin Delay Compensation (PDC) - REAPER's automatic latency compensation
     void EnablePDC(bool enable) { m_settings.enablePDC = enable; }
     int CalculatePDCDelay() const;
@@ -145,14 +162,13 @@ private:
     std::atomic<float> m_masterVolume{1.0f};
     std::atomic<float> m_masterPan{0.0f};
     std::atomic<bool> m_masterMute{false};
+    std::unique_ptr<MasterLimiter> m_masterLimiter;
+    std::unique_ptr<AnalyzerService> m_analyzerService;
     
     // Track management
     std::vector<Track*> m_tracks;
     mutable std::mutex m_tracksMutex;
     
-    // Audio device
-    std::unique_ptr<AudioDevice> m_audioDevice;
-    
     // Buffer management for real-time processing
     std::unique_ptr<AudioBufferPool> m_bufferPool;
     mutable std::mutex m_bufferMutex;
@@ -160,9 +176,14 @@ private:
     // Thread safety
     std::thread::id m_realtimeThreadId;
     
-    // PDC system
-    std::vector<int> m_trackDelays;  // Per-track delay compensation
-    int m_masterPDCDelay = 0;
+    // PDC system: each track is delayed by what it lacks of the most delayed
+    // track's latency, on the audio thread, before it is mixed
+    class PDCDelayLine;
+    struct PDCState {
+        std::vector<std::pair<const Track*, std::shared_ptr<PDCDelayLine>>> trackDelays;   // Delayed tracks only
+    };
+    RealtimeSnapshot<PDCState> m_pdc;
+    int m_masterPDCDelay = 0;       // Output latency: compensation plus the master limiter
     
     // Performance monitoring
     std::chrono::high_resolution_clock::time_point m_lastStatsUpdate;
@@ -170,16 +191,12 @@ private:
     int m_processCallCount = 0;
     
     // Internal processing methods
-    void ProcessTracks(AudioBuffer& masterBuffer);
     void ProcessMasterBus(AudioBuffer& buffer);
+    static void ApplyTrackDelay(const PDCState* pdc, const Track* track, AudioBuffer& buffer);
     void UpdatePerformanceStats(double processingTime);
     void AllocateBufferPool();
     void DeallocateBufferPool();
     
-    // Sample rate conversion
-    class SampleRateConverter;
-    std::unique_ptr<SampleRateConverter> m_srcConverter;
-    
     // Zero-allocation helpers for real-time thread
     void ClearBuffer(float* buffer, int samples);
     void MixBuffers(float* dest, const float* src, int samples, float gain);
@@ -0,0 +1,166 @@
+/*
+ * REAPER Web - FFT Implementation
+ * Iterative decimation-in-time butterflies on split complex arrays
+ */
+
+#include "fft.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+FFT::FFT(int size) : m_size(size), m_half(size / 2) {
+    // Bit-reversal permutation of the half-size complex FFT
+    int bits = 0;
+    while ((1 << bits) < m_half) bits++;
+    m_bitReverse.resize(m_half);
+    for (int i = 0; i < m_half; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    m_twiddleRe.assign(std::max(m_half, 1), 1.0f);
+    m_twiddleIm.assign(std::max(m_half, 1), 0.0f);
+    for (int span = 1; span < m_half; span <<= 1) {
+        for (int j = 0; j < span; ++j) {
+            double angle = -M_PI * j / span;
+            m_twiddleRe[span + j] = static_cast<float>(std::cos(angle));
+            m_twiddleIm[span + j] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    m_realTwiddleRe.resize(m_half + 1);
+    m_realTwiddleIm.resize(m_half + 1);
+    for (int k = 0; k <= m_half; ++k) {
+        double angle = -2.0 * M_PI * k / m_size;
+        m_realTwiddleRe[k] = static_cast<float>(std::cos(angle));
+        m_realTwiddleIm[k] = static_cast<float>(std::sin(angle));
+    }
+
+    m_workRe.resize(m_half);
+    m_workIm.resize(m_half);
+}
+
+void FFT::Transform(float* re, float* im) {
+    for (int span = 1; span < m_half; span <<= 1) {
+        const float* twRe = m_twiddleRe.data() + span;
+        const float* twIm = m_twiddleIm.data() + span;
+
+        for (int group = 0; group < m_half; group += span * 2) {
+            float* aRe = re + group;
+            float* aIm = im + group;
+            float* bRe = aRe + span;
+            float* bIm = aIm + span;
+
+            int j = 0;
+#if defined(__SSE__)
+            for (; j + 4 <= span; j += 4) {
+                __m128 wr = _mm_loadu_ps(twRe + j);
+                __m128 wi = _mm_loadu_ps(twIm + j);
+                __m128 br = _mm_loadu_ps(bRe + j);
+                __m128 bi = _mm_loadu_ps(bIm + j);
+                __m128 tr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+                __m128 ti = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+                __m128 ar = _mm_loadu_ps(aRe + j);
+                __m128 ai = _mm_loadu_ps(aIm + j);
+                _mm_storeu_ps(bRe + j, _mm_sub_ps(ar, tr));
+                _mm_storeu_ps(bIm + j, _mm_sub_ps(ai, ti));
+                _mm_storeu_ps(aRe + j, _mm_add_ps(ar, tr));
+                _mm_storeu_ps(aIm + j, _mm_add_ps(ai, ti));
+            }
+#endif
+            for (; j < span; ++j) {
+                float tr = bRe[j] * twRe[j] - bIm[j] * twIm[j];
+                float ti = bRe[j] * twIm[j] + bIm[j] * twRe[j];
+                bRe[j] = aRe[j] - tr;
+                bIm[j] = aIm[j] - ti;
+                aRe[j] += tr;
+                aIm[j] += ti;
+            }
+        }
+    }
+}
+
+void FFT::Forward(const float* input, float* re, float* im) {
+    // Even samples as real part, odd samples as imaginary part
+    for (int i = 0; i < m_half; ++i) {
+        int source = m_bitReverse[i];
+        m_workRe[i] = input[source * 2];
+        m_workIm[i] = input[source * 2 + 1];
+    }
+    Transform(m_workRe.data(), m_workIm.data());
+
+    // Split into even/odd spectra and combine: X[k] = E[k] + W^k O[k]
+    for (int k = 0; k <= m_half; ++k) {
+        int a = (k == m_half) ? 0 : k;
+        int b = (k == 0) ? 0 : m_half - k;
+        float zr = m_workRe[a], zi = m_workIm[a];
+        float cr = m_workRe[b], ci = -m_workIm[b];
+
+        float evenRe = 0.5f * (zr + cr);
+        float evenIm = 0.5f * (zi + ci);
+        float oddRe = 0.5f * (zi - ci);
+        float oddIm = -0.5f * (zr - cr);
+
+        float wr = m_realTwiddleRe[k], wi = m_realTwiddleIm[k];
+        re[k] = evenRe + wr * oddRe - wi * oddIm;
+        im[k] = evenIm + wr * oddIm + wi * oddRe;
+    }
+}
+
+void FFT::Inverse(const float* re, const float* im, float* output) {
+    // Rebuild the half-size complex spectrum Z = E + iO; the inverse runs as a
+    // forward transform with real and imaginary parts swapped
+    for (int k = 0; k < m_half; ++k) {
+        float xr = re[k], xi = im[k];
+        float cr = re[m_half - k], ci = -im[m_half - k];
+
+        float evenRe = 0.5f * (xr + cr);
+        float evenIm = 0.5f * (xi + ci);
+        float dr = 0.5f * (xr - cr);
+        float di = 0.5f * (xi - ci);
+
+        // O = D * conj(W^k)
+        float wr = m_realTwiddleRe[k], wi = m_realTwiddleIm[k];
+        float oddRe = dr * wr + di * wi;
+        float oddIm = di * wr - dr * wi;
+
+        int target = m_bitReverse[k];
+        m_workIm[target] = evenRe - oddIm;      // Swapped: real part into the imaginary array
+        m_workRe[target] = evenIm + oddRe;
+    }
+    Transform(m_workRe.data(), m_workIm.data());
+
+    float scale = 1.0f / m_half;
+    for (int i = 0; i < m_half; ++i) {
+        output[i * 2] = m_workIm[i] * scale;
+        output[i * 2 + 1] = m_workRe[i] * scale;
+    }
+}
+
+void FFT::MultiplyAccumulate(float* accRe, float* accIm,
+                             const float* aRe, const float* aIm,
+                             const float* bRe, const float* bIm, int count) {
+    int i = 0;
+#if defined(__SSE__)
+    for (; i + 4 <= count; i += 4) {
+        __m128 ar = _mm_loadu_ps(aRe + i);
+        __m128 ai = _mm_loadu_ps(aIm + i);
+        __m128 br = _mm_loadu_ps(bRe + i);
+        __m128 bi = _mm_loadu_ps(bIm + i);
+        __m128 real = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+        __m128 imag = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+        _mm_storeu_ps(accRe + i, _mm_add_ps(_mm_loadu_ps(accRe + i), real));
+        _mm_storeu_ps(accIm + i, _mm_add_ps(_mm_loadu_ps(accIm + i), imag));
+    }
+#endif
+    for (; i < count; ++i) {
+        accRe[i] += aRe[i] * bRe[i] - aIm[i] * bIm[i];
+        accIm[i] += aRe[i] * bIm[i] + aIm[i] * bRe[i];
+    }
+}
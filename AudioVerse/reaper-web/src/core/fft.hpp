@@ -0,0 +1,51 @@
+/*
+ * REAPER Web - FFT
+ * Real-input radix-2 FFT for convolution and analysis
+ */
+
+#pragma once
+
+#include <vector>
+
+/**
+ * FFT - real-input FFT of power-of-two size
+ *
+ * Spectra are split into real and imaginary arrays of size/2 + 1 bins.
+ * The real transform runs as a half-size complex FFT plus a post-pass;
+ * butterflies and spectral multiply-accumulate process four values per
+ * SSE register (SIMD128 in wasm builds) with scalar fallbacks.
+ * An instance holds scratch memory, so each thread needs its own.
+ */
+class FFT {
+public:
+    explicit FFT(int size);
+
+    int GetSize() const { return m_size; }
+    int GetNumBins() const { return m_size / 2 + 1; }
+
+    // Unscaled forward transform of 'size' real samples
+    void Forward(const float* input, float* re, float* im);
+
+    // Inverse transform including the 1/size scale
+    void Inverse(const float* re, const float* im, float* output);
+
+    // acc += a * b over 'count' complex bins
+    static void MultiplyAccumulate(float* accRe, float* accIm,
+                                   const float* aRe, const float* aIm,
+                                   const float* bRe, const float* bIm, int count);
+
+private:
+    int m_size;
+    int m_half;                                 // Complex FFT size
+
+    std::vector<int> m_bitReverse;
+    std::vector<float> m_twiddleRe;             // Span h uses entries [h, 2h)
+    std::vector<float> m_twiddleIm;
+    std::vector<float> m_realTwiddleRe;         // e^(-2 pi i k / size), k <= size/2
+    std::vector<float> m_realTwiddleIm;
+
+    std::vector<float> m_workRe;
+    std::vector<float> m_workIm;
+
+    void Transform(float* re, float* im);
+};
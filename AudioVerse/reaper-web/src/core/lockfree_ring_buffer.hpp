@@ -0,0 +1,94 @@
+/*
+ * REAPER Web - Lock-free Ring Buffer
+ * Single-producer/single-consumer FIFO for audio-thread handoff
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+/**
+ * LockFreeRingBuffer - wait-free SPSC queue of trivially copyable items
+ *
+ * One thread writes, one thread reads; neither ever blocks or allocates.
+ * Capacity is rounded up to a power of two and indices run freely, so the
+ * full/empty distinction needs no spare slot. Read and write indices live on
+ * separate cache lines to avoid false sharing between the two threads.
+ */
+template <typename T>
+class LockFreeRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "LockFreeRingBuffer holds trivially copyable items");
+
+public:
+    explicit LockFreeRingBuffer(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        m_capacity = capacity;
+        m_mask = capacity - 1;
+        m_data = std::make_unique<T[]>(capacity);
+    }
+
+    LockFreeRingBuffer(const LockFreeRingBuffer&) = delete;
+    LockFreeRingBuffer& operator=(const LockFreeRingBuffer&) = delete;
+
+    size_t GetCapacity() const { return m_capacity; }
+
+    // Producer side
+    size_t GetWriteAvailable() const {
+        size_t write = m_writeIndex.load(std::memory_order_relaxed);
+        size_t read = m_readIndex.load(std::memory_order_acquire);
+        return m_capacity - (write - read);
+    }
+
+    // Writes up to 'count' items; returns how many fit
+    size_t Write(const T* items, size_t count) {
+        size_t write = m_writeIndex.load(std::memory_order_relaxed);
+        size_t read = m_readIndex.load(std::memory_order_acquire);
+        count = std::min(count, m_capacity - (write - read));
+
+        size_t start = write & m_mask;
+        size_t first = std::min(count, m_capacity - start);
+        std::memcpy(m_data.get() + start, items, first * sizeof(T));
+        std::memcpy(m_data.get(), items + first, (count - first) * sizeof(T));
+
+        m_writeIndex.store(write + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side
+    size_t GetReadAvailable() const {
+        size_t write = m_writeIndex.load(std::memory_order_acquire);
+        size_t read = m_readIndex.load(std::memory_order_relaxed);
+        return write - read;
+    }
+
+    // Reads up to 'count' items; returns how many were available
+    size_t Read(T* items, size_t count) {
+        size_t write = m_writeIndex.load(std::memory_order_acquire);
+        size_t read = m_readIndex.load(std::memory_order_relaxed);
+        count = std::min(count, write - read);
+
+        size_t start = read & m_mask;
+        size_t first = std::min(count, m_capacity - start);
+        std::memcpy(items, m_data.get() + start, first * sizeof(T));
+        std::memcpy(items + first, m_data.get(), (count - first) * sizeof(T));
+
+        m_readIndex.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::unique_ptr<T[]> m_data;
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+
+    alignas(64) std::atomic<size_t> m_writeIndex{0};
+    alignas(64) std::atomic<size_t> m_readIndex{0};
+};
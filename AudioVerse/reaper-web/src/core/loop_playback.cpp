@@ -0,0 +1,94 @@
+/*
+ * REAPER Web - Loop Playback Implementation
+ * Segmenting at the loop-end sample and the splice fade
+ */
+
+#include "loop_playback.hpp"
+#include <algorithm>
+#include <cmath>
+
+void LoopPlayback::Prepare(double sampleRate) {
+    m_sampleRate = sampleRate > 0.0 ? sampleRate : 48000.0;
+    Reset();
+}
+
+void LoopPlayback::Reset() {
+    m_fadeInPosition = 0;
+    m_fadeInLength = 0;
+}
+
+void LoopPlayback::BeginBlock(double position, int numSamples, bool loopEnabled, double loopStart, double loopEnd) {
+    m_looping = loopEnabled && (loopEnd - loopStart) * m_sampleRate >= 1.0 && position < loopEnd;
+    m_loopStart = loopStart;
+    m_loopEnd = loopEnd;
+    m_position = position;
+    m_offset = 0;
+    m_numSamples = numSamples;
+}
+
+bool LoopPlayback::NextSegment(Segment& segment) {
+    if (m_offset >= m_numSamples) {
+        return false;
+    }
+
+    segment.offset = m_offset;
+    segment.numSamples = m_numSamples - m_offset;
+    segment.startTime = m_position;
+    segment.wraps = false;
+
+    // A segment that reaches the loop end exactly at the block end wraps too,
+    // so the next block starts back at loopStart
+    if (m_looping) {
+        double samplesToLoopEnd = std::ceil((m_loopEnd - m_position) * m_sampleRate - 1e-6);
+        if (samplesToLoopEnd <= segment.numSamples) {
+            segment.numSamples = static_cast<int>(std::max(samplesToLoopEnd, 0.0));
+            segment.wraps = true;
+        }
+    }
+
+    m_offset += segment.numSamples;
+    m_position = segment.wraps ? m_loopStart : m_position + segment.numSamples / m_sampleRate;
+    return true;
+}
+
+void LoopPlayback::ApplySpliceFade(float** outputs, int numChannels, const Segment& segment) {
+    if (!m_looping) {
+        return;
+    }
+
+    int fadeLength = static_cast<int>(m_spliceFadeSeconds * m_sampleRate);
+    if (fadeLength <= 0) {
+        Reset();
+        return;
+    }
+
+    // sin^2 ramps: x = 0 silent, x = 1 unity
+    auto curve = [](double x) {
+        double s = std::sin(0.5 * M_PI * x);
+        return static_cast<float>(s * s);
+    };
+
+    // Fade in from the loop start, continuing across segments and blocks
+    for (int i = 0; i < segment.numSamples && m_fadeInPosition < m_fadeInLength; ++i) {
+        float gain = curve(static_cast<double>(m_fadeInPosition + 1) / m_fadeInLength);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            outputs[ch][segment.offset + i] *= gain;
+        }
+        m_fadeInPosition++;
+    }
+
+    // Fade out over the last samples before the loop end; positional, so it spans blocks
+    int endOffset = static_cast<int>(std::ceil((m_loopEnd - segment.startTime) * m_sampleRate - 1e-6));
+    for (int i = std::max(0, endOffset - fadeLength); i < std::min(endOffset, segment.numSamples); ++i) {
+        float gain = curve(static_cast<double>(endOffset - i) / fadeLength);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            outputs[ch][segment.offset + i] *= gain;
+        }
+    }
+
+    // The next segment starts at the loop start
+    if (segment.wraps) {
+        m_fadeInPosition = 0;
+        m_fadeInLength = fadeLength;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * REAPER Web - Loop Playback
+ * Splits transport blocks at loop wraps and declicks the loop splice
+ */
+
+#pragma once
+
+/**
+ * Loop Playback - block splitting for the transport loop
+ *
+ * BeginBlock() takes the loop region for one audio block; NextSegment() then
+ * hands the block out in segments that end either at the block end or on the
+ * exact loop-end sample, each with the timeline position it starts at. A loop
+ * shorter than the block yields several segments per block.
+ *
+ * ApplySpliceFade() shapes a rendered segment with the optional splice fade:
+ * a sin^2 fade-out over the samples before the loop end and a fade-in after
+ * each wrap. Both are tracked in samples, so they span segment and block
+ * boundaries. All state is audio-thread only.
+ */
+class LoopPlayback {
+public:
+    struct Segment {
+        int offset = 0;                 // First sample in the block
+        int numSamples = 0;             // May be 0 for a wrap exactly at the block start
+        double startTime = 0.0;         // Timeline position of the first sample
+        bool wraps = false;             // Ends on the loop end; the next segment starts at loopStart
+    };
+
+    void Prepare(double sampleRate);
+
+    // Drop a pending fade-in (transport stopped or relocated)
+    void Reset();
+
+    // Splice fade length in seconds, 0 = hard splice
+    void SetSpliceFade(double seconds) { m_spliceFadeSeconds = seconds; }
+
+    /**
+     * Start a block of numSamples at timeline 'position'. Loops shorter than
+     * one sample, and blocks starting at or past loopEnd, play straight through.
+     */
+    void BeginBlock(double position, int numSamples, bool loopEnabled, double loopStart, double loopEnd);
+    bool NextSegment(Segment& segment);
+
+    // Timeline position after the segments handed out so far
+    double GetPosition() const { return m_position; }
+    bool IsLooping() const { return m_looping; }
+
+    // Fade outputs[ch][segment.offset ..) of a looping block; a no-op otherwise
+    void ApplySpliceFade(float** outputs, int numChannels, const Segment& segment);
+
+private:
+    double m_sampleRate = 48000.0;
+    double m_spliceFadeSeconds = 0.0;
+
+    // Current block
+    bool m_looping = false;
+    double m_loopStart = 0.0;
+    double m_loopEnd = 0.0;
+    double m_position = 0.0;
+    int m_offset = 0;
+    int m_numSamples = 0;
+
+    // Splice fade-in progress after a wrap
+    int m_fadeInPosition = 0;
+    int m_fadeInLength = 0;
+};
@@ -0,0 +1,210 @@
+/*
+ * REAPER Web - Master Limiter Implementation
+ * True-peak detection, sliding-window hold and moving-average gain ramp
+ */
+
+#include "master_limiter.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace {
+    int MsToSamples(double ms, double sampleRate) {
+        return std::max(1, static_cast<int>(std::lround(ms * sampleRate / 1000.0)));
+    }
+}
+
+MasterLimiter::MasterLimiter() {
+    // 48-tap windowed-sinc interpolator: phase p, tap m is h[p + 4m]; each
+    // phase is normalised to unity gain at DC
+    const int length = kPhases * kTapsPerPhase;
+    const double centre = (length - 1) / 2.0;
+    const double beta = 6.0;
+    auto besselI0 = [](double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    };
+
+    for (int p = 0; p < kPhases; ++p) {
+        double taps[kTapsPerPhase];
+        double sum = 0.0;
+        for (int m = 0; m < kTapsPerPhase; ++m) {
+            int k = p + kPhases * m;
+            double x = (k - centre) / kPhases;
+            double ratio = 2.0 * k / (length - 1) - 1.0;
+            double window = besselI0(beta * std::sqrt(1.0 - ratio * ratio)) / besselI0(beta);
+            taps[m] = std::sin(M_PI * x) / (M_PI * x) * window;
+            sum += taps[m];
+        }
+        for (int m = 0; m < kTapsPerPhase; ++m) {
+            m_phaseTaps[m][p] = static_cast<float>(taps[m] / sum);
+        }
+    }
+}
+
+void MasterLimiter::Prepare(double sampleRate, int numChannels) {
+    m_sampleRate = sampleRate;
+    m_numChannels = std::max(numChannels, 1);
+    m_maxLookahead = MsToSamples(kMaxLookaheadMs, sampleRate);
+
+    m_detectorHistory.assign(m_numChannels, std::vector<float>(kTapsPerPhase * 2, 0.0f));
+    m_delayLength = m_maxLookahead + kDetectorDelay + 1;
+    m_delay.assign(m_numChannels, std::vector<float>(m_delayLength, 0.0f));
+    m_dequeIndex.assign(m_maxLookahead + 2, 0);
+    m_dequePeak.assign(m_maxLookahead + 2, 0.0f);
+    m_rampHistory.assign(m_maxLookahead, 1.0f);
+
+    SetLookahead(m_lookaheadMs.load());
+    ApplyLookahead();
+}
+
+void MasterLimiter::SetLookahead(float lookaheadMs) {
+    lookaheadMs = std::max(0.05f, std::min(lookaheadMs, static_cast<float>(kMaxLookaheadMs)));
+    m_lookaheadMs.store(lookaheadMs);
+    m_latency.store(MsToSamples(lookaheadMs, m_sampleRate) + kDetectorDelay);
+}
+
+void MasterLimiter::ApplyLookahead() {
+    m_lookahead = std::min(m_latency.load() - kDetectorDelay, m_maxLookahead);
+    m_appliedLookahead = m_lookahead;
+    Reset();
+}
+
+void MasterLimiter::Reset() {
+    for (auto& history : m_detectorHistory) {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+    for (auto& delay : m_delay) {
+        std::fill(delay.begin(), delay.end(), 0.0f);
+    }
+    std::fill(m_rampHistory.begin(), m_rampHistory.end(), 1.0f);
+    m_detectorPosition = 0;
+    m_delayPosition = 0;
+    m_dequeHead = 0;
+    m_dequeSize = 0;
+    m_sampleIndex = 0;
+    m_rampPosition = 0;
+    m_rampSum = m_lookahead;
+    m_releaseGain = 1.0f;
+    m_gainReductionDb.store(0.0f);
+}
+
+float MasterLimiter::DetectPeak(int channel, float sample) {
+    // Newest sample last; window[11 - m] is x[n - m]
+    float* history = m_detectorHistory[channel].data();
+    history[m_detectorPosition] = sample;
+    history[m_detectorPosition + kTapsPerPhase] = sample;
+    const float* window = history + m_detectorPosition + 1;
+
+    // The four phases lie between x[n-6] and x[n-5]; x[n-5] closes the interval
+    float peak = std::abs(window[kTapsPerPhase - 1 - kDetectorDelay]);
+#if defined(__SSE__)
+    __m128 acc = _mm_setzero_ps();
+    for (int m = 0; m < kTapsPerPhase; ++m) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(m_phaseTaps[m]), _mm_set1_ps(window[kTapsPerPhase - 1 - m])));
+    }
+    acc = _mm_andnot_ps(_mm_set1_ps(-0.0f), acc);
+    acc = _mm_max_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_max_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+    peak = std::max(peak, _mm_cvtss_f32(acc));
+#else
+    for (int p = 0; p < kPhases; ++p) {
+        float value = 0.0f;
+        for (int m = 0; m < kTapsPerPhase; ++m) {
+            value += m_phaseTaps[m][p] * window[kTapsPerPhase - 1 - m];
+        }
+        peak = std::max(peak, std::abs(value));
+    }
+#endif
+    return peak;
+}
+
+float MasterLimiter::PushPeak(float peak) {
+    const int capacity = static_cast<int>(m_dequePeak.size());
+
+    // Peaks no larger than the new one can never be the maximum again
+    while (m_dequeSize > 0) {
+        int back = (m_dequeHead + m_dequeSize - 1) % capacity;
+        if (m_dequePeak[back] > peak) break;
+        m_dequeSize--;
+    }
+    int slot = (m_dequeHead + m_dequeSize) % capacity;
+    m_dequeIndex[slot] = m_sampleIndex;
+    m_dequePeak[slot] = peak;
+    m_dequeSize++;
+
+    // Window of L + 1 peaks: the interval either side of each delayed sample
+    while (m_dequeIndex[m_dequeHead] < m_sampleIndex - m_lookahead) {
+        m_dequeHead = (m_dequeHead + 1) % capacity;
+        m_dequeSize--;
+    }
+
+    m_sampleIndex++;
+    return m_dequePeak[m_dequeHead];
+}
+
+void MasterLimiter::Process(AudioBuffer& buffer) {
+    if (m_delay.empty()) return;
+    if (m_latency.load() - kDetectorDelay != m_appliedLookahead) {
+        ApplyLookahead();
+    }
+
+    const bool enabled = m_enabled.load();
+    const float ceiling = std::pow(10.0f, m_ceilingDb.load() / 20.0f);
+    const float release = 1.0f - std::exp(-1.0f / std::max(1.0f, m_releaseMs.load() * static_cast<float>(m_sampleRate) / 1000.0f));
+    const int channels = std::min(buffer.GetChannelCount(), m_numChannels);
+    const int delaySamples = m_lookahead + kDetectorDelay;
+    float* const* samples = buffer.GetChannelPointers();
+
+    float minGain = 1.0f;
+    for (int i = 0; i < buffer.GetSampleCount(); ++i) {
+        float gain = 1.0f;
+        if (enabled) {
+            float peak = 0.0f;
+            for (int ch = 0; ch < channels; ++ch) {
+                peak = std::max(peak, DetectPeak(ch, samples[ch][i]));
+            }
+            float held = PushPeak(peak);
+            float target = held > ceiling ? ceiling / held : 1.0f;
+
+            // Moving average over L: every term already honours the peak
+            // L samples ahead, so the ramp reaches it on time
+            m_rampSum += target - m_rampHistory[m_rampPosition];
+            m_rampHistory[m_rampPosition] = target;
+            if (++m_rampPosition == m_lookahead) {
+                m_rampPosition = 0;
+                m_rampSum = 0.0;        // Resum once per window to cancel drift
+                for (int k = 0; k < m_lookahead; ++k) m_rampSum += m_rampHistory[k];
+            }
+            float ramp = static_cast<float>(m_rampSum / m_lookahead);
+
+            m_releaseGain = ramp < m_releaseGain ? ramp : m_releaseGain + (ramp - m_releaseGain) * release;
+            gain = m_releaseGain;
+            minGain = std::min(minGain, gain);
+        } else {
+            for (int ch = 0; ch < channels; ++ch) {
+                DetectPeak(ch, samples[ch][i]);
+            }
+            PushPeak(0.0f);
+        }
+        m_detectorPosition = (m_detectorPosition + 1 == kTapsPerPhase) ? 0 : m_detectorPosition + 1;
+
+        int readPosition = m_delayPosition - delaySamples;
+        if (readPosition < 0) readPosition += m_delayLength;
+        for (int ch = 0; ch < channels; ++ch) {
+            float delayed = m_delay[ch][readPosition];
+            m_delay[ch][m_delayPosition] = samples[ch][i];
+            samples[ch][i] = delayed * gain;
+        }
+        if (++m_delayPosition == m_delayLength) m_delayPosition = 0;
+    }
+
+    m_gainReductionDb.store(20.0f * std::log10(minGain));
+}
@@ -0,0 +1,101 @@
+/*
+ * REAPER Web - Master Limiter
+ * Look-ahead true-peak brickwall limiter for the master bus
+ */
+
+#pragma once
+
+#include "audio_buffer.hpp"
+#include <atomic>
+#include <vector>
+
+/**
+ * MasterLimiter - look-ahead true-peak limiter, O(1) per sample
+ *
+ * Peaks are detected on a 4x polyphase interpolation of every channel
+ * (inter-sample peaks, as in ITU-R BS.1770), computed as four phases per
+ * SIMD register. A sliding-window maximum over the look-ahead, kept in a
+ * monotonic deque, holds each peak long enough for a moving-average ramp
+ * of the same length to bring the gain down before the peak leaves the
+ * delay line. Release is exponential and can only raise the gain towards
+ * that ramp, never above it, so the ceiling holds for every sample.
+ *
+ * Settings are atomics that may change from any thread; they are picked up
+ * at the next block. The delay stays in place while disabled so the
+ * latency reported to PDC never changes with the switch.
+ */
+class MasterLimiter {
+public:
+    static constexpr double kMaxLookaheadMs = 20.0;
+
+    MasterLimiter();
+
+    // Non-realtime: allocates for the session format
+    void Prepare(double sampleRate, int numChannels);
+    void Reset();
+
+    // Audio thread
+    void Process(AudioBuffer& buffer);
+
+    // Any thread
+    void SetEnabled(bool enabled) { m_enabled.store(enabled); }
+    bool IsEnabled() const { return m_enabled.load(); }
+    void SetCeiling(float ceilingDb) { m_ceilingDb.store(ceilingDb); }
+    float GetCeiling() const { return m_ceilingDb.load(); }
+    void SetLookahead(float lookaheadMs);
+    float GetLookahead() const { return m_lookaheadMs.load(); }
+    void SetRelease(float releaseMs) { m_releaseMs.store(releaseMs); }
+    float GetRelease() const { return m_releaseMs.load(); }
+
+    // Gain reduction of the last block in dB (0 or negative), for metering
+    float GetGainReduction() const { return m_gainReductionDb.load(); }
+
+    // Total delay in samples: look-ahead plus the true-peak detector
+    int GetLatencySamples() const { return m_latency.load(); }
+
+private:
+    static constexpr int kPhases = 4;
+    static constexpr int kTapsPerPhase = 12;
+    static constexpr int kDetectorDelay = 5;    // Samples until a peak is fully seen
+
+    std::atomic<bool> m_enabled{true};
+    std::atomic<float> m_ceilingDb{-1.0f};
+    std::atomic<float> m_lookaheadMs{1.5f};
+    std::atomic<float> m_releaseMs{100.0f};
+    std::atomic<float> m_gainReductionDb{0.0f};
+    std::atomic<int> m_latency{0};
+
+    double m_sampleRate = 48000.0;
+    int m_numChannels = 0;
+    int m_lookahead = 0;                        // Window length L in samples
+    int m_appliedLookahead = -1;
+    int m_maxLookahead = 0;
+
+    // Interpolator taps: tap m for all four phases side by side
+    alignas(16) float m_phaseTaps[kTapsPerPhase][kPhases] = {};
+    std::vector<std::vector<float>> m_detectorHistory;   // Per channel, written twice
+    int m_detectorPosition = 0;
+
+    // Audio delay line, per channel
+    std::vector<std::vector<float>> m_delay;
+    int m_delayLength = 0;
+    int m_delayPosition = 0;
+
+    // Monotonic deque of (sample index, peak) over the last L+1 peaks
+    std::vector<int64_t> m_dequeIndex;
+    std::vector<float> m_dequePeak;
+    int m_dequeHead = 0;
+    int m_dequeSize = 0;
+    int64_t m_sampleIndex = 0;
+
+    // Moving average of the held gain over L samples
+    std::vector<float> m_rampHistory;
+    int m_rampPosition = 0;
+    double m_rampSum = 0.0;
+
+    float m_releaseGain = 1.0f;
+
+    void ApplyLookahead();
+    float DetectPeak(int channel, float sample);
+    float PushPeak(float peak);
+};
@@ -0,0 +1,116 @@
+/*
+ * REAPER Web - Metronome Implementation
+ * Click synthesis and tempo-map based onset scheduling
+ */
+
+#include "metronome.hpp"
+#include "tempo_map.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr double kClickLength = 0.025;        // seconds
+    constexpr double kAccentFrequency = 1500.0;
+    constexpr double kNormalFrequency = 1000.0;
+    constexpr int kClickChannels = 2;             // Clicks go to the first stereo pair
+}
+
+Metronome::Metronome() {
+    Prepare(m_sampleRate);
+}
+
+void Metronome::Prepare(double sampleRate) {
+    m_sampleRate = sampleRate > 0.0 ? sampleRate : 48000.0;
+    RenderClick(m_accentClick, m_sampleRate, kAccentFrequency, 1.0f);
+    RenderClick(m_normalClick, m_sampleRate, kNormalFrequency, 0.7f);
+    Reset();
+}
+
+void Metronome::Reset() {
+    m_tail = nullptr;
+    m_tailPosition = 0;
+}
+
+void Metronome::RenderClick(std::vector<float>& click, double sampleRate, double frequency, float amplitude) {
+    int length = std::max(1, static_cast<int>(kClickLength * sampleRate));
+    int attack = std::max(1, static_cast<int>(0.001 * sampleRate));
+    double decay = std::exp(-6.0 / length);      // ~-52 dB at the end of the click
+
+    click.assign(length, 0.0f);
+    double envelope = 1.0;
+    for (int i = 0; i < length; ++i) {
+        double ramp = std::min(1.0, static_cast<double>(i) / attack);
+        click[i] = static_cast<float>(amplitude * ramp * envelope * std::sin(2.0 * M_PI * frequency * i / sampleRate));
+        envelope *= decay;
+    }
+}
+
+void Metronome::MixTail(float** outputs, int numChannels, int offset, int numSamples, float gain) {
+    int count = std::min(static_cast<int>(m_tail->size()) - m_tailPosition, numSamples);
+    const float* source = m_tail->data() + m_tailPosition;
+
+    for (int ch = 0; ch < std::min(numChannels, kClickChannels); ++ch) {
+        float* dest = outputs[ch] + offset;
+        for (int i = 0; i < count; ++i) {
+            dest[i] += source[i] * gain;
+        }
+    }
+
+    m_tailPosition += count;
+    if (m_tailPosition >= static_cast<int>(m_tail->size())) {
+        Reset();
+    }
+}
+
+void Metronome::Render(float** outputs, int numChannels, int offset, int numSamples,
+                       double startSeconds, const TempoMap& tempoMap, float gain) {
+    if (numSamples <= 0) return;
+
+    // Finish a click started in an earlier range
+    if (m_tail) {
+        MixTail(outputs, numChannels, offset, numSamples, gain);
+    }
+
+    // Walk click positions bar by bar; a bar has 'numerator' clicks of 4/denominator beats
+    double bars = tempoMap.BeatsToBars(tempoMap.SecondsToBeats(startSeconds));
+    double bar = std::floor(bars);
+
+    // Start one click early: whether a click belongs here is decided in samples below,
+    // so a click on the boundary lands in exactly one of two adjacent ranges
+    bool firstBar = true;
+    for (;;) {
+        double barBeat = tempoMap.BarsToBeats(bar);
+        int numerator = 4;
+        int denominator = 4;
+        tempoMap.GetTimeSignatureAt(tempoMap.BeatsToSeconds(barBeat), numerator, denominator);
+        double clickBeats = 4.0 / denominator;
+
+        int first = firstBar ? std::max(0, static_cast<int>(std::ceil((bars - bar) * numerator)) - 1) : 0;
+        firstBar = false;
+
+        for (int click = first; click < numerator; ++click) {
+            double onset = tempoMap.BeatsToSeconds(barBeat + click * clickBeats);
+            int position = static_cast<int>(std::ceil((onset - startSeconds) * m_sampleRate - 1e-6));
+            if (position >= numSamples) {
+                return;
+            }
+            if (position < 0) {
+                continue;
+            }
+
+            // A new click cuts off the previous one
+            m_tail = (click == 0) ? &m_accentClick : &m_normalClick;
+            m_tailPosition = 0;
+            MixTail(outputs, numChannels, offset + position, numSamples - position, gain);
+        }
+        bar += 1.0;
+    }
+}
+
+double Metronome::GetCountInDuration(const TempoMap& tempoMap, double seconds, int bars) {
+    if (bars <= 0) return 0.0;
+
+    double endBar = tempoMap.BeatsToBars(tempoMap.SecondsToBeats(seconds));
+    double startBeat = tempoMap.BarsToBeats(endBar - bars);
+    return seconds - tempoMap.BeatsToSeconds(startBeat);
+}
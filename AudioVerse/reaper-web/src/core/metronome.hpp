@@ -0,0 +1,56 @@
+/*
+ * REAPER Web - Metronome
+ * Sample-accurate click generator driven by the tempo map
+ */
+
+#pragma once
+
+#include <vector>
+
+class TempoMap;
+
+/**
+ * Metronome - schedules accented (bar) and normal (beat) clicks
+ *
+ * Click sounds are rendered once in Prepare(); Render() only finds the click
+ * onsets inside the requested range and mixes the pre-rendered samples, so the
+ * audio thread never allocates and touches no samples outside click windows.
+ * A click that runs past the end of a range continues in the next call, which
+ * lets the engine split a block (loop wrap, count-in) without audible seams.
+ */
+class Metronome {
+public:
+    Metronome();
+    ~Metronome() = default;
+
+    // Non-realtime: (re)render the click samples for a sample rate
+    void Prepare(double sampleRate);
+
+    // Audio thread: drop a click tail (transport stopped or relocated)
+    void Reset();
+
+    /**
+     * Audio thread: mix the clicks falling in
+     * [startSeconds, startSeconds + numSamples / sampleRate)
+     * into outputs[ch][offset .. offset + numSamples)
+     */
+    void Render(float** outputs, int numChannels, int offset, int numSamples,
+                double startSeconds, const TempoMap& tempoMap, float gain);
+
+    // Length of 'bars' bars of count-in ending at 'seconds' (follows the tempo map)
+    static double GetCountInDuration(const TempoMap& tempoMap, double seconds, int bars);
+
+    double GetSampleRate() const { return m_sampleRate; }
+
+private:
+    double m_sampleRate = 48000.0;
+    std::vector<float> m_accentClick;
+    std::vector<float> m_normalClick;
+
+    // Click still sounding from a previous range
+    const std::vector<float>* m_tail = nullptr;
+    int m_tailPosition = 0;
+
+    static void RenderClick(std::vector<float>& click, double sampleRate, double frequency, float amplitude);
+    void MixTail(float** outputs, int numChannels, int offset, int numSamples, float gain);
+};
@@ -0,0 +1,119 @@
+/*
+ * REAPER Web - Realtime Snapshot
+ * Publishes immutable state from UI/worker threads to the audio thread
+ * without locks or allocation on the audio side
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * RealtimeSnapshot - single-writer RCU-style handoff of immutable objects
+ *
+ * The audio thread calls Acquire() at the start of a block and may use the
+ * pointer until it calls EndBlock(). Publishers swap in a new object and keep
+ * the old one on a retired list; it is destroyed on a later Publish() or
+ * CollectRetired() once the audio thread has finished a block since the swap,
+ * so no destructor ever runs on the audio thread.
+ *
+ * The pointer and the block counter are seq_cst on both sides: Publish()
+ * stores the pointer then reads the counter while the audio thread bumps the
+ * counter then reads the pointer, and with release/acquire each side could
+ * miss the other's store.
+ */
+template <typename T>
+class RealtimeSnapshot {
+public:
+    RealtimeSnapshot() = default;
+    explicit RealtimeSnapshot(std::unique_ptr<T> initial) { Publish(std::move(initial)); }
+    ~RealtimeSnapshot() = default;
+
+    RealtimeSnapshot(const RealtimeSnapshot&) = delete;
+    RealtimeSnapshot& operator=(const RealtimeSnapshot&) = delete;
+
+    // Audio thread (or the publishing thread): current object, may be null
+    const T* Acquire() const { return m_current.load(std::memory_order_seq_cst); }
+
+    // Audio thread: Acquire() that also marks a block in flight, for readers
+    // whose publishers need Synchronize()
+    const T* BeginBlock() {
+        m_inBlock.store(true, std::memory_order_seq_cst);
+        return Acquire();
+    }
+
+    // Audio thread: marks the end of a block; pointers acquired before are released
+    void EndBlock() {
+        m_blocksCompleted.fetch_add(1, std::memory_order_seq_cst);
+        m_inBlock.store(false, std::memory_order_seq_cst);
+    }
+
+    // Non-realtime threads, after Publish(): returns once no block started with
+    // BeginBlock() can still use an earlier object. Waits at most one block, and
+    // not at all while the audio thread is between blocks or stopped.
+    void Synchronize() const {
+        uint64_t started = m_blocksCompleted.load(std::memory_order_seq_cst);
+        while (m_inBlock.load(std::memory_order_seq_cst) &&
+               m_blocksCompleted.load(std::memory_order_seq_cst) == started) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Non-realtime threads: swap in a new object and reclaim what is safe
+    void Publish(std::unique_ptr<T> next) {
+        std::lock_guard<std::mutex> lock(m_publishMutex);
+        m_current.store(next.get(), std::memory_order_seq_cst);
+        if (m_live) {
+            uint64_t retiredAt = m_blocksCompleted.load(std::memory_order_seq_cst);
+            m_retired.push_back({std::move(m_live), retiredAt});
+        }
+        m_live = std::move(next);
+        CollectRetiredLocked();
+    }
+
+    // Non-realtime threads: free retired objects the audio thread can no longer see
+    void CollectRetired() {
+        std::lock_guard<std::mutex> lock(m_publishMutex);
+        CollectRetiredLocked();
+    }
+
+    // Only valid while no audio thread is running (shutdown, offline render)
+    void CollectAllRetired() {
+        std::lock_guard<std::mutex> lock(m_publishMutex);
+        m_retired.clear();
+    }
+
+    size_t GetRetiredCount() const {
+        std::lock_guard<std::mutex> lock(m_publishMutex);
+        return m_retired.size();
+    }
+
+private:
+    struct Retired {
+        std::unique_ptr<T> object;
+        uint64_t retiredAt;
+    };
+
+    std::atomic<const T*> m_current{nullptr};
+    std::atomic<uint64_t> m_blocksCompleted{0};
+    std::atomic<bool> m_inBlock{false};
+    std::unique_ptr<T> m_live;
+    std::vector<Retired> m_retired;
+    mutable std::mutex m_publishMutex;
+
+    void CollectRetiredLocked() {
+        // A block that read the old pointer ends by bumping the counter past retiredAt
+        uint64_t completed = m_blocksCompleted.load(std::memory_order_seq_cst);
+        m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(),
+                                       [completed](const Retired& entry) {
+                                           return completed > entry.retiredAt;
+                                       }),
+                        m_retired.end());
+    }
+};
@@ -8,6 +8,7 @@
 #include "project_manager.hpp"
 #include "track_manager.hpp"
 #include "../media/media_item.hpp"
+#include "../media/recording_pipeline.hpp"
 #include <algorithm>
 #include <chrono>
 #include <cmath>
@@ -23,10 +24,15 @@ ReaperEngine::ReaperEngine() {
     m_projectManager = std::make_unique<ProjectManager>();
     m_trackManager = std::make_unique<TrackManager>();
     m_mediaItemManager = std::make_unique<MediaItemManager>();
+    m_recordingPipeline = std::make_unique<RecordingPipeline>();
     
     // Reserve undo stack capacity
     m_undoStack.reserve(m_globalSettings.undoLevels);
     m_redoStack.reserve(m_globalSettings.undoLevels);
+    
+    // Default project tempo: 120 BPM, 4/4
+    m_tempoMarkers.push_back(TempoMarker{0.0, 120.0, false, 4, 4});
+    PublishTempoMap();
 }
 
 ReaperEngine::~ReaperEngine() {
@@ -60,12 +66,19 @@ bool ReaperEngine::Initialize(const GlobalSettings& settings) {
         return false;
     }
     
+    // Click samples are rendered here, never on the audio thread
+    m_metronome.Prepare(settings.sampleRate);
+    m_loopPlayback.Prepare(settings.sampleRate);
+    
+    // Items render split blocks (loop wrap) into buffers sized once here
+    m_mediaItemManager->SetMaxBlockSize(std::max(settings.bufferSize, 4096), 2);
+    
     // Set up transport state defaults
     m_transportState.playState = PlayState::STOPPED;
     m_transportState.playPosition = 0.0;
-    m_transportState.tempo = 120.0;
-    m_transportState.timeSigNumerator = 4;
-    m_transportState.timeSigDenominator = 4;
+    m_transportState.tempo = m_tempoMarkers.front().bpm;
+    m_transportState.timeSigNumerator = m_tempoMarkers.front().timeSigNumerator;
+    m_transportState.timeSigDenominator = m_tempoMarkers.front().timeSigDenominator;
     
     // Set up realtime settings
     m_realtimeSettings.masterVolume = 1.0;
@@ -100,6 +113,9 @@ void ReaperEngine::Shutdown() {
         m_audioEngine->Shutdown();
     }
     
+    // No audio thread left to read retired tempo maps
+    m_tempoMap.CollectAllRetired();
+    
     // Clear global instance
     g_reaperEngine = nullptr;
     
@@ -118,6 +134,7 @@ bool ReaperEngine::NewProject() {
     m_transportState.playPosition = 0.0;
     m_transportState.loopStart = 0.0;
     m_transportState.loopEnd = 60.0;
+    SetTempoMarkers({TempoMarker{0.0, 120.0, false, 4, 4}});
     
     // Clear tracks and reset project state
     m_trackManager->ClearAllTracks();
@@ -174,11 +191,11 @@ bool ReaperEngine::SaveProject(const std::string& filePath) {
 }
 
 void ReaperEngine::Play() {
-    if (m_transportState.playState == PlayState::PAUSED) {
-        m_transportState.playState = PlayState::PLAYING;
-    } else {
-        m_transportState.playState = PlayState::PLAYING;
-        // Start from current position
+    // Play continues from the current position; out of record it ends the take
+    bool wasRecording = m_transportState.playState == PlayState::RECORDING;
+    m_transportState.playState = PlayState::PLAYING;
+    if (wasRecording) {
+        FinishRecording();
     }
     
     m_audioEngine->StartPlayback();
@@ -186,7 +203,9 @@ void ReaperEngine::Play() {
 
 void ReaperEngine::Stop() {
     m_transportState.playState = PlayState::STOPPED;
+    m_leadInSamples = 0;
     m_audioEngine->StopPlayback();
+    FinishRecording();
     
     // Reset to beginning if not looping or if we hit the end
     if (!m_transportState.loop) {
@@ -203,10 +222,98 @@ void ReaperEngine::Pause() {
 }
 
 void ReaperEngine::Record() {
+    PlayState state = m_transportState.playState.load();
+    if (state == PlayState::RECORDING) {
+        return;
+    }
+    
+    // From stop the lead-in rolls up to the record point; from play or pause
+    // the transport carries on and capture punches in where it is now
+    double recordStart = m_transportState.playPosition.load();
+    if (state == PlayState::STOPPED) {
+        StartLeadIn(recordStart);
+    }
+    StartRecordingPipeline(recordStart);
     m_transportState.playState = PlayState::RECORDING;
     m_audioEngine->StartRecording();
 }
 
+void ReaperEngine::StartLeadIn(double recordStart) {
+    const TempoMap* tempoMap = GetTempoMap();
+    double sampleRate = m_globalSettings.sampleRate;
+    
+    // Pre-roll plays material before the record point; the part of it that
+    // would start before the project has nothing to play and joins the count-in
+    double preRoll = m_globalSettings.enablePreRoll ? std::max(0.0, m_globalSettings.preRollTime) : 0.0;
+    double rollStart = recordStart - preRoll;
+    double countIn = m_realtimeSettings.countIn.load()
+        ? Metronome::GetCountInDuration(*tempoMap, rollStart, m_realtimeSettings.countInBars.load())
+        : 0.0;
+    double playStart = std::max(0.0, rollStart);
+    double leadIn = playStart - (rollStart - countIn);
+    
+    m_transportState.playPosition = playStart;
+    m_audioEngine->SetPlayPosition(playStart);
+    m_leadInPosition = rollStart - countIn;
+    m_leadInSamples = static_cast<int64_t>(std::llround(leadIn * sampleRate));
+}
+
+void ReaperEngine::StartRecordingPipeline(double recordStart) {
+    m_trackManager->StartRecording();
+    std::vector<Track*> armedTracks = m_trackManager->GetArmedTracks();
+    if (armedTracks.empty()) {
+        return;
+    }
+    
+    // Takes go next to the project file
+    std::string directory = ".";
+    size_t slash = m_currentProjectPath.find_last_of("/\\");
+    if (slash != std::string::npos) {
+        directory = m_currentProjectPath.substr(0, slash);
+    }
+    auto stamp = std::chrono::system_clock::now().time_since_epoch().count();
+    
+    std::vector<RecordingPipeline::TrackInput> inputs;
+    for (Track* track : armedTracks) {
+        RecordingPipeline::TrackInput input;
+        input.trackIndex = m_trackManager->GetTrackIndex(track);
+        input.firstInputChannel = track->GetInputChannel();
+        input.numChannels = 1;
+        input.filePath = directory + "/rec_" + std::to_string(input.trackIndex + 1) + "_" + std::to_string(stamp) + ".wav";
+        inputs.push_back(input);
+    }
+    
+    RecordingPipeline::Settings settings;
+    settings.sampleRate = m_globalSettings.sampleRate;
+    settings.maxBlockSize = std::max(m_globalSettings.bufferSize, 4096);
+    
+    // Capture starts at the record point, after any pre-roll, or at a later punch-in
+    double punchInTime = std::max(recordStart, m_transportState.punchIn.load());
+    double punchOutTime = m_transportState.punchOut.load();
+    int64_t punchIn = static_cast<int64_t>(std::llround(punchInTime * m_globalSettings.sampleRate));
+    int64_t punchOut = punchOutTime >= 0.0
+        ? static_cast<int64_t>(std::llround(punchOutTime * m_globalSettings.sampleRate))
+        : RecordingPipeline::kNoPunchOut;
+    m_recordingPipeline->Start(settings, inputs, punchIn, punchOut);
+}
+
+void ReaperEngine::FinishRecording() {
+    if (!m_recordingPipeline->IsActive()) {
+        return;
+    }
+    
+    m_trackManager->StopRecording();
+    auto takes = m_recordingPipeline->Stop();
+    
+    for (const auto& take : takes) {
+        Track* track = m_trackManager->GetTrack(take.trackIndex);
+        if (track && take.lengthSamples > 0 && !take.writeError) {
+            m_mediaItemManager->CreateItem(track, take.filePath, take.startSample / m_globalSettings.sampleRate);
+        }
+    }
+    SetProjectDirty();
+}
+
 void ReaperEngine::TogglePlayPause() {
     switch (m_transportState.playState.load()) {
         case PlayState::STOPPED:
@@ -232,9 +339,22 @@ void ReaperEngine::SetLoopPoints(double start, double end) {
     }
 }
 
+void ReaperEngine::SetPunchPoints(double punchIn, double punchOut) {
+    m_transportState.punchIn = punchIn;
+    m_transportState.punchOut = punchOut;
+    
+    // A take in progress stops at the new punch-out
+    if (m_recordingPipeline->IsActive()) {
+        m_recordingPipeline->SetPunchOut(punchOut >= 0.0
+            ? static_cast<int64_t>(std::llround(punchOut * m_globalSettings.sampleRate))
+            : RecordingPipeline::kNoPunchOut);
+    }
+}
+
 void ReaperEngine::SetTempo(double bpm) {
     if (bpm >= 20.0 && bpm <= 999.0) {
-        m_transportState.tempo = bpm;
+        m_tempoMarkers.front().bpm = bpm;
+        PublishTempoMap();
         SetProjectDirty();
     }
 }
@@ -243,20 +363,76 @@ void ReaperEngine::SetTimeSignature(int numerator, int denominator) {
     if (numerator >= 1 && numerator <= 32 && 
         (denominator == 1 || denominator == 2 || denominator == 4 || 
          denominator == 8 || denominator == 16 || denominator == 32)) {
-        m_transportState.timeSigNumerator = numerator;
-        m_transportState.timeSigDenominator = denominator;
+        m_tempoMarkers.front().timeSigNumerator = numerator;
+        m_tempoMarkers.front().timeSigDenominator = denominator;
+        PublishTempoMap();
         SetProjectDirty();
     }
 }
 
+void ReaperEngine::SetTempoMarkers(const std::vector<TempoMarker>& markers) {
+    m_tempoMarkers = markers;
+    PublishTempoMap();
+    SetProjectDirty();
+}
+
+void ReaperEngine::AddTempoMarker(const TempoMarker& marker) {
+    if (marker.bpm >= 20.0 && marker.bpm <= 999.0 && marker.beat >= 0.0) {
+        m_tempoMarkers.push_back(marker);
+        PublishTempoMap();
+        SetProjectDirty();
+    }
+}
+
+bool ReaperEngine::RemoveTempoMarker(int index) {
+    // The first marker is the project tempo and always exists
+    if (index <= 0 || index >= static_cast<int>(m_tempoMarkers.size())) {
+        return false;
+    }
+    m_tempoMarkers.erase(m_tempoMarkers.begin() + index);
+    PublishTempoMap();
+    SetProjectDirty();
+    return true;
+}
+
+void ReaperEngine::PublishTempoMap() {
+    auto tempoMap = std::make_unique<TempoMap>(m_tempoMarkers);
+    
+    // Keep the canonical (sorted, beat 0 anchored) marker list
+    m_tempoMarkers = tempoMap->GetMarkers();
+    
+    // Beat-timebase items follow tempo edits
+    if (m_mediaItemManager) {
+        m_mediaItemManager->UpdateTempoMap(*tempoMap);
+    }
+    
+    // Transport shows the tempo at the playhead until the audio thread refreshes it
+    double position = m_transportState.playPosition.load();
+    int numerator = 4;
+    int denominator = 4;
+    tempoMap->GetTimeSignatureAt(position, numerator, denominator);
+    m_transportState.tempo = tempoMap->GetTempoAt(position);
+    m_transportState.timeSigNumerator = numerator;
+    m_transportState.timeSigDenominator = denominator;
+    
+    m_tempoMap.Publish(std::move(tempoMap));
+}
+
 double ReaperEngine::BeatsToSeconds(double beats) const {
-    double bpm = m_transportState.tempo.load();
-    return beats * (60.0 / bpm);
+    return GetTempoMap()->BeatsToSeconds(beats);
 }
 
 double ReaperEngine::SecondsToBeats(double seconds) const {
-    double bpm = m_transportState.tempo.load();
-    return seconds * (bpm / 60.0);
+    return GetTempoMap()->SecondsToBeats(seconds);
+}
+
+double ReaperEngine::CalculateBeatPosition(double seconds) const {
+    return GetTempoMap()->SecondsToBeats(seconds);
+}
+
+double ReaperEngine::CalculateBarPosition(double seconds) const {
+    const TempoMap* tempoMap = GetTempoMap();
+    return tempoMap->BeatsToBars(tempoMap->SecondsToBeats(seconds));
 }
 
 std::string ReaperEngine::FormatTime(double seconds, TimeFormat format) const {
@@ -272,9 +448,11 @@ std::string ReaperEngine::FormatTime(double seconds, TimeFormat format) const {
             break;
             
         case TimeFormat::MEASURES_BEATS: {
-            double beats = SecondsToBeats(seconds);
-            int measure = static_cast<int>(beats / m_transportState.timeSigNumerator) + 1;
-            double beat = fmod(beats, m_transportState.timeSigNumerator) + 1.0;
+            const TempoMap* tempoMap = GetTempoMap();
+            double beats = tempoMap->SecondsToBeats(seconds);
+            double bars = tempoMap->BeatsToBars(beats);
+            int measure = static_cast<int>(std::floor(bars)) + 1;
+            double beat = (bars - std::floor(bars)) * tempoMap->GetBeatsPerBarAt(beats) + 1.0;
             ss << measure << ":" << std::fixed << std::setprecision(3) << beat;
             break;
         }
@@ -318,6 +496,19 @@ void ReaperEngine::SetMetronome(bool enabled) {
     m_realtimeSettings.metronomeEnabled = enabled;
 }
 
+void ReaperEngine::SetClickVolume(int volume) {
+    m_realtimeSettings.clickVolume = std::clamp(volume, 0, 100);
+}
+
+void ReaperEngine::SetCountIn(bool enabled, int bars) {
+    m_realtimeSettings.countIn = enabled;
+    m_realtimeSettings.countInBars = std::clamp(bars, 1, 16);
+}
+
+void ReaperEngine::SetLoopSpliceFade(double seconds) {
+    m_realtimeSettings.loopSpliceFade = std::clamp(seconds, 0.0, 0.05);
+}
+
 void ReaperEngine::ProcessAudioBlock(float** inputs, float** outputs, int numChannels, int numSamples) {
     if (!m_initialized.load() || !m_audioEngine) {
         // Output silence if not initialized
@@ -327,41 +518,133 @@ void ReaperEngine::ProcessAudioBlock(float** inputs, float** outputs, int numCha
         return;
     }
     
-    // Update playback position
-    if (m_transportState.playState == PlayState::PLAYING || 
-        m_transportState.playState == PlayState::RECORDING) {
-        double deltaTime = static_cast<double>(numSamples) / m_globalSettings.sampleRate;
-        double newPosition = m_transportState.playPosition.load() + deltaTime;
-        
-        // Handle looping
-        if (m_transportState.loop && newPosition >= m_transportState.loopEnd) {
-            newPosition = m_transportState.loopStart;
+    // One tempo map for the whole block; released by EndBlock() below
+    const TempoMap* tempoMap = m_tempoMap.Acquire();
+    double sampleRate = m_globalSettings.sampleRate;
+    PlayState playState = m_transportState.playState.load();
+    bool rolling = playState == PlayState::PLAYING || playState == PlayState::RECORDING;
+    float clickGain = static_cast<float>(m_realtimeSettings.clickVolume.load()) / 100.0f;
+    
+    if (!rolling) {
+        m_metronome.Reset();
+    }
+    
+    // Lead-in: silence plus count-in clicks, the transport does not move yet
+    int leadIn = 0;
+    int64_t leadInRemaining = rolling ? m_leadInSamples.load() : 0;
+    if (leadInRemaining > 0) {
+        leadIn = static_cast<int>(std::min<int64_t>(leadInRemaining, numSamples));
+        for (int ch = 0; ch < numChannels; ++ch) {
+            std::fill(outputs[ch], outputs[ch] + leadIn, 0.0f);
         }
+        double leadInPosition = m_leadInPosition.load();
+        m_metronome.Render(outputs, numChannels, 0, leadIn, leadInPosition, *tempoMap, clickGain);
+        m_leadInPosition = leadInPosition + leadIn / sampleRate;
+        m_leadInSamples = leadInRemaining - leadIn;
         
-        m_transportState.playPosition = newPosition;
+        if (leadIn == numSamples) {
+            m_audioEngine->ProcessMasterOutput(outputs, std::min(numChannels, kMaxBlockChannels), numSamples);
+            m_tempoMap.EndBlock();
+            return;
+        }
     }
     
-    // Process audio through the engine with track and media item integration
-    double blockLength = static_cast<double>(numSamples) / m_globalSettings.sampleRate;
-    m_audioEngine->ProcessBlock(inputs, outputs, numChannels, numSamples, 
-                               m_mediaItemManager.get(), m_trackManager.get(), 
-                               m_transportState.playPosition.load(), blockLength);
+    // The rest of the block runs on the transport timeline
+    int blockChannels = std::min(numChannels, kMaxBlockChannels);
+    int blockSamples = numSamples - leadIn;
+    float* blockInputs[kMaxBlockChannels];
+    float* blockOutputs[kMaxBlockChannels];
+    for (int ch = 0; ch < blockChannels; ++ch) {
+        blockInputs[ch] = inputs ? inputs[ch] + leadIn : nullptr;
+        blockOutputs[ch] = outputs[ch] + leadIn;
+    }
     
-    // Apply master volume and pan
+    // Split the block at every loop-end sample it crosses: a loop shorter
+    // than the block wraps several times in one callback
     double masterVol = m_realtimeSettings.masterVolume.load();
     bool masterMute = m_realtimeSettings.masterMute.load();
-    
-    if (masterMute) {
-        for (int ch = 0; ch < numChannels; ++ch) {
-            std::fill(outputs[ch], outputs[ch] + numSamples, 0.0f);
+    bool capturing = rolling && playState == PlayState::RECORDING && m_recordingPipeline->IsActive();
+    // The metronome is the master click; the count-in above ignores this switch
+    bool clickEnabled = rolling && m_realtimeSettings.metronomeEnabled.load();
+    
+    m_loopPlayback.SetSpliceFade(m_realtimeSettings.loopSpliceFade.load());
+    m_loopPlayback.BeginBlock(m_transportState.playPosition.load(), blockSamples, rolling && m_transportState.loop,
+                              m_transportState.loopStart.load(), m_transportState.loopEnd.load());
+    
+    LoopPlayback::Segment segment;
+    while (m_loopPlayback.NextSegment(segment)) {
+        int offset = segment.offset;
+        int segmentSamples = segment.numSamples;
+        double position = segment.startTime;
+        
+        float* segmentInputs[kMaxBlockChannels];
+        float* segmentOutputs[kMaxBlockChannels];
+        for (int ch = 0; ch < blockChannels; ++ch) {
+            segmentInputs[ch] = inputs ? blockInputs[ch] + offset : nullptr;
+            segmentOutputs[ch] = blockOutputs[ch] + offset;
         }
-    } else if (masterVol != 1.0) {
-        for (int ch = 0; ch < numChannels; ++ch) {
-            for (int i = 0; i < numSamples; ++i) {
-                outputs[ch][i] *= static_cast<float>(masterVol);
+        RenderTransportSegment(inputs ? blockInputs : nullptr, blockOutputs, blockChannels, offset, segmentSamples, position);
+        
+        // Apply master volume and pan
+        if (masterMute) {
+            for (int ch = 0; ch < blockChannels; ++ch) {
+                std::fill(segmentOutputs[ch], segmentOutputs[ch] + segmentSamples, 0.0f);
+            }
+        } else if (masterVol != 1.0) {
+            for (int ch = 0; ch < blockChannels; ++ch) {
+                for (int i = 0; i < segmentSamples; ++i) {
+                    segmentOutputs[ch][i] *= static_cast<float>(masterVol);
+                }
             }
         }
+        
+        m_loopPlayback.ApplySpliceFade(blockOutputs, blockChannels, segment);
+        
+        // Armed inputs are captured on the same split as the transport
+        if (capturing && segmentSamples > 0) {
+            int64_t startSample = static_cast<int64_t>(std::llround(position * sampleRate));
+            m_recordingPipeline->Capture(inputs ? segmentInputs : nullptr, blockChannels, startSample, segmentSamples);
+        }
+        
+        if (clickEnabled) {
+            m_metronome.Render(blockOutputs, blockChannels, offset, segmentSamples, position, *tempoMap, clickGain);
+        }
+    }
+    double position = m_loopPlayback.GetPosition();
+    
+    // Master gain, clicks and splice fades are all in: limit the whole block
+    m_audioEngine->ProcessMasterOutput(outputs, blockChannels, numSamples);
+    
+    // Update playback position
+    if (rolling) {
+        m_transportState.playPosition = position;
+        
+        // Follow tempo/meter changes at the playhead
+        int numerator = 4;
+        int denominator = 4;
+        tempoMap->GetTimeSignatureAt(position, numerator, denominator);
+        m_transportState.tempo = tempoMap->GetTempoAt(position);
+        m_transportState.timeSigNumerator = numerator;
+        m_transportState.timeSigDenominator = denominator;
     }
+    
+    m_tempoMap.EndBlock();
+}
+
+void ReaperEngine::RenderTransportSegment(float** inputs, float** outputs, int numChannels,
+                                          int offset, int numSamples, double startTime) {
+    if (numSamples <= 0) return;
+    
+    float* segmentInputs[kMaxBlockChannels];
+    float* segmentOutputs[kMaxBlockChannels];
+    for (int ch = 0; ch < numChannels; ++ch) {
+        segmentInputs[ch] = inputs ? inputs[ch] + offset : nullptr;
+        segmentOutputs[ch] = outputs[ch] + offset;
+    }
+    
+    double length = static_cast<double>(numSamples) / m_globalSettings.sampleRate;
+    m_audioEngine->ProcessBlock(inputs ? segmentInputs : nullptr, segmentOutputs, numChannels, numSamples,
+                               m_mediaItemManager.get(), m_trackManager.get(), startTime, length);
 }
 
 void ReaperEngine::BeginUndoBlock(const std::string& description) {
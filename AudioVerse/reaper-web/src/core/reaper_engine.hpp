@@ -13,6 +13,10 @@
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include "realtime_snapshot.hpp"
+#include "tempo_map.hpp"
+#include "metronome.hpp"
+#include "loop_playback.hpp"
 
 // Forward declarations
 class AudioEngine;
@@ -20,6 +24,7 @@ class ProjectManager;
 class TrackManager;
 class MediaItemManager;
 class EffectsProcessor;
+class RecordingPipeline;
 
 /**
  * Main REAPER-style DAW Engine
@@ -62,6 +67,8 @@ public:
         std::atomic<bool> loop{false};
         std::atomic<double> loopStart{0.0};
         std::atomic<double> loopEnd{60.0};
+        std::atomic<double> punchIn{-1.0};         // seconds, < 0 = from the play position
+        std::atomic<double> punchOut{-1.0};        // seconds, < 0 = until stopped
         std::atomic<bool> metronomeEnabled{false};
         std::atomic<double> tempo{120.0};
         std::atomic<int> timeSigNumerator{4};
@@ -78,6 +85,7 @@ public:
         std::atomic<bool> metronomeEnabled{false};
         std::atomic<bool> countIn{false};
         std::atomic<int> countInBars{1};
+        std::atomic<double> loopSpliceFade{0.0};   // seconds, 0 = hard loop splice
     };
 
 public:
@@ -109,11 +117,26 @@ public:
     void SetPlayPosition(double seconds);
     void SetLoopPoints(double start, double end);
     
+    // Punch range: Record() captures only between the two points, whatever
+    // state it is called from. A negative point is open; the punch-out may
+    // move while recording.
+    void SetPunchPoints(double punchIn, double punchOut);
+    void ClearPunchPoints() { SetPunchPoints(-1.0, -1.0); }
+    
     // Time and tempo
     void SetTempo(double bpm);
     void SetTimeSignature(int numerator, int denominator);
     double BeatsToSeconds(double beats) const;
     double SecondsToBeats(double seconds) const;
+
+    // Tempo map - edits rebuild an immutable map and publish it to the audio thread.
+    // SetTempo/SetTimeSignature edit the first marker (the project tempo).
+    void SetTempoMarkers(const std::vector<TempoMarker>& markers);
+    void AddTempoMarker(const TempoMarker& marker);
+    bool RemoveTempoMarker(int index);
+    const std::vector<TempoMarker>& GetTempoMarkers() const { return m_tempoMarkers; }
+    // Valid for the current block on the audio thread, or until the next tempo edit elsewhere
+    const TempoMap* GetTempoMap() const { return m_tempoMap.Acquire(); }
     std::string FormatTime(double seconds, TimeFormat format) const;
 
     // Master controls
@@ -121,6 +144,9 @@ public:
     void SetMasterPan(double pan);
     void ToggleMasterMute();
     void SetMetronome(bool enabled);
+    void SetClickVolume(int volume);                // 0-100
+    void SetCountIn(bool enabled, int bars);        // Applies when recording starts
+    void SetLoopSpliceFade(double seconds);         // Declick fade at the loop boundary
 
     // Audio processing coordination
     void ProcessAudioBlock(float** inputs, float** outputs, int numChannels, int numSamples);
@@ -139,6 +165,7 @@ public:
     ProjectManager* GetProjectManager() const { return m_projectManager.get(); }
     TrackManager* GetTrackManager() const { return m_trackManager.get(); }
     MediaItemManager* GetMediaItemManager() const { return m_mediaItemManager.get(); }
+    RecordingPipeline* GetRecordingPipeline() const { return m_recordingPipeline.get(); }
     
     // State access
     const TransportState& GetTransportState() const { return m_transportState; }
@@ -160,11 +187,27 @@ private:
     std::unique_ptr<ProjectManager> m_projectManager;
     std::unique_ptr<TrackManager> m_trackManager;
     std::unique_ptr<MediaItemManager> m_mediaItemManager;
+    std::unique_ptr<RecordingPipeline> m_recordingPipeline;
     
     // State
     GlobalSettings m_globalSettings;
     TransportState m_transportState;
     RealtimeSettings m_realtimeSettings;
+
+    // Tempo map (markers are edited on the UI thread, the map is read everywhere)
+    std::vector<TempoMarker> m_tempoMarkers;
+    RealtimeSnapshot<TempoMap> m_tempoMap;
+    
+    // Metronome and lead-in (count-in plus any pre-roll before project start).
+    // During lead-in the transport holds and only the click runs, on a virtual
+    // timeline that ends exactly where playback starts.
+    Metronome m_metronome;
+    std::atomic<int64_t> m_leadInSamples{0};
+    std::atomic<double> m_leadInPosition{0.0};
+    static constexpr int kMaxBlockChannels = 64;
+    
+    // Loop wrap splitting and splice fade (audio thread only)
+    LoopPlayback m_loopPlayback;
     
     // Project state
     std::atomic<bool> m_projectDirty{false};
@@ -195,6 +238,12 @@ private:
     void SaveUndoState(const std::string& description);
     void RestoreUndoState(const UndoState& state);
     void ProcessTransportUpdate();
+    void PublishTempoMap();
+    void StartLeadIn(double recordStart);
+    void StartRecordingPipeline(double recordStart);
+    void RenderTransportSegment(float** inputs, float** outputs, int numChannels,
+                                int offset, int numSamples, double startTime);
+    void FinishRecording();
     
     // REAPER-style time calculations
     double CalculateBeatPosition(double seconds) const;
@@ -0,0 +1,162 @@
+/*
+ * REAPER Web - Tempo Map Implementation
+ * Segment compilation and closed-form beat/time conversion
+ */
+
+#include "tempo_map.hpp"
+#include <algorithm>
+#include <cmath>
+
+TempoMap::TempoMap() : TempoMap(std::vector<TempoMarker>{}) {
+}
+
+TempoMap::TempoMap(std::vector<TempoMarker> markers) : m_markers(std::move(markers)) {
+    BuildSegments();
+}
+
+void TempoMap::BuildSegments() {
+    // Sort by position; a later marker at the same beat replaces the earlier one
+    std::stable_sort(m_markers.begin(), m_markers.end(),
+                     [](const TempoMarker& a, const TempoMarker& b) { return a.beat < b.beat; });
+    std::vector<TempoMarker> unique;
+    for (const auto& marker : m_markers) {
+        if (!unique.empty() && unique.back().beat == marker.beat) {
+            unique.back() = marker;
+        } else {
+            unique.push_back(marker);
+        }
+    }
+    m_markers = std::move(unique);
+
+    // The map always starts at beat 0 with an explicit meter
+    if (m_markers.empty() || m_markers.front().beat > 0.0) {
+        TempoMarker first;
+        if (!m_markers.empty()) {
+            first.bpm = m_markers.front().bpm;
+        }
+        m_markers.insert(m_markers.begin(), first);
+    }
+    m_markers.front().beat = 0.0;
+    if (m_markers.front().timeSigNumerator <= 0 || m_markers.front().timeSigDenominator <= 0) {
+        m_markers.front().timeSigNumerator = 4;
+        m_markers.front().timeSigDenominator = 4;
+    }
+
+    m_segments.clear();
+    m_segments.reserve(m_markers.size());
+    for (size_t i = 0; i < m_markers.size(); ++i) {
+        const TempoMarker& marker = m_markers[i];
+        Segment segment;
+        segment.startBeat = marker.beat;
+        segment.startBpm = std::max(marker.bpm, 1.0);
+
+        if (i == 0) {
+            segment.timeSigNumerator = marker.timeSigNumerator;
+            segment.timeSigDenominator = marker.timeSigDenominator;
+        } else {
+            const Segment& previous = m_segments.back();
+            double beats = segment.startBeat - previous.startBeat;
+            segment.startTime = previous.startTime + SecondsIntoSegment(previous, beats);
+            segment.startBar = previous.startBar + beats / previous.beatsPerBar;
+            bool meterChange = marker.timeSigNumerator > 0 && marker.timeSigDenominator > 0;
+            segment.timeSigNumerator = meterChange ? marker.timeSigNumerator : previous.timeSigNumerator;
+            segment.timeSigDenominator = meterChange ? marker.timeSigDenominator : previous.timeSigDenominator;
+        }
+        segment.beatsPerBar = segment.timeSigNumerator * 4.0 / segment.timeSigDenominator;
+
+        // Linear-in-time ramp: the segment lasts 2*60*beats/(T0+T1) seconds
+        if (marker.rampToNext && i + 1 < m_markers.size()) {
+            double endBpm = std::max(m_markers[i + 1].bpm, 1.0);
+            double beats = m_markers[i + 1].beat - marker.beat;
+            double duration = 120.0 * beats / (segment.startBpm + endBpm);
+            segment.slope = (endBpm - segment.startBpm) / duration;
+        }
+        m_segments.push_back(segment);
+    }
+}
+
+// b(τ) = (T0·τ + a·τ²/2) / 60
+double TempoMap::BeatsIntoSegment(const Segment& segment, double secondsIntoSegment) {
+    double tau = secondsIntoSegment;
+    return (segment.startBpm * tau + 0.5 * segment.slope * tau * tau) / 60.0;
+}
+
+// Inverse of the above in the cancellation-free form τ = 120Δb / (T0 + sqrt(T0² + 120·a·Δb))
+double TempoMap::SecondsIntoSegment(const Segment& segment, double beatsIntoSegment) {
+    if (segment.slope == 0.0) {
+        return beatsIntoSegment * 60.0 / segment.startBpm;
+    }
+    double discriminant = segment.startBpm * segment.startBpm + 120.0 * segment.slope * beatsIntoSegment;
+    return 120.0 * beatsIntoSegment / (segment.startBpm + std::sqrt(std::max(discriminant, 0.0)));
+}
+
+size_t TempoMap::FindSegmentByBeat(double beats) const {
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), beats,
+                               [](double value, const Segment& s) { return value < s.startBeat; });
+    return it == m_segments.begin() ? 0 : static_cast<size_t>(it - m_segments.begin()) - 1;
+}
+
+size_t TempoMap::FindSegmentByTime(double seconds) const {
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), seconds,
+                               [](double value, const Segment& s) { return value < s.startTime; });
+    return it == m_segments.begin() ? 0 : static_cast<size_t>(it - m_segments.begin()) - 1;
+}
+
+size_t TempoMap::FindSegmentByBar(double bars) const {
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), bars,
+                               [](double value, const Segment& s) { return value < s.startBar; });
+    return it == m_segments.begin() ? 0 : static_cast<size_t>(it - m_segments.begin()) - 1;
+}
+
+double TempoMap::BeatsToSeconds(double beats) const {
+    const Segment& segment = m_segments[FindSegmentByBeat(beats)];
+    return segment.startTime + SecondsIntoSegment(segment, beats - segment.startBeat);
+}
+
+double TempoMap::SecondsToBeats(double seconds) const {
+    const Segment& segment = m_segments[FindSegmentByTime(seconds)];
+    return segment.startBeat + BeatsIntoSegment(segment, seconds - segment.startTime);
+}
+
+double TempoMap::BeatsToBars(double beats) const {
+    const Segment& segment = m_segments[FindSegmentByBeat(beats)];
+    return segment.startBar + (beats - segment.startBeat) / segment.beatsPerBar;
+}
+
+double TempoMap::BarsToBeats(double bars) const {
+    const Segment& segment = m_segments[FindSegmentByBar(bars)];
+    return segment.startBeat + (bars - segment.startBar) * segment.beatsPerBar;
+}
+
+double TempoMap::GetTempoAt(double seconds) const {
+    const Segment& segment = m_segments[FindSegmentByTime(seconds)];
+    return segment.startBpm + segment.slope * std::max(seconds - segment.startTime, 0.0);
+}
+
+void TempoMap::GetTimeSignatureAt(double seconds, int& numerator, int& denominator) const {
+    const Segment& segment = m_segments[FindSegmentByTime(seconds)];
+    numerator = segment.timeSigNumerator;
+    denominator = segment.timeSigDenominator;
+}
+
+double TempoMap::GetBeatsPerBarAt(double beats) const {
+    return m_segments[FindSegmentByBeat(beats)].beatsPerBar;
+}
+
+TempoMap::BlockCursor TempoMap::GetBlockCursor(double seconds, double sampleRate) const {
+    const Segment& segment = m_segments[FindSegmentByTime(seconds)];
+    double tau = seconds - segment.startTime;
+
+    BlockCursor cursor;
+    cursor.beat = segment.startBeat + BeatsIntoSegment(segment, tau);
+    cursor.tempo = segment.startBpm + segment.slope * std::max(tau, 0.0);
+    cursor.timeSigNumerator = segment.timeSigNumerator;
+    cursor.timeSigDenominator = segment.timeSigDenominator;
+
+    // Sampled quadratic: first step carries half the curvature so the
+    // two-addition recurrence reproduces b(n/sr) exactly
+    double secondsPerSample = 1.0 / sampleRate;
+    cursor.incrementDelta = segment.slope * secondsPerSample * secondsPerSample / 60.0;
+    cursor.increment = cursor.tempo * secondsPerSample / 60.0 + 0.5 * cursor.incrementDelta;
+    return cursor;
+}
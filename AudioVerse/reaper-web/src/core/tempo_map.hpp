@@ -0,0 +1,89 @@
+/*
+ * REAPER Web - Tempo Map
+ * Tempo and time signature changes with O(log n) beat/time conversion
+ * Shared by the engine, the timeline view and JSFX transport variables
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Tempo marker - REAPER-style tempo/time signature envelope point
+ * Beats are quarter notes counted from project start
+ */
+struct TempoMarker {
+    double beat = 0.0;              // Marker position in beats
+    double bpm = 120.0;             // Tempo at the marker
+    bool rampToNext = false;        // Tempo changes linearly (in time) to the next marker
+    int timeSigNumerator = 0;       // 0 = keep the previous time signature
+    int timeSigDenominator = 0;
+};
+
+/**
+ * Tempo Map - immutable once built
+ * Markers are compiled into segments with precomputed start times and bar
+ * numbers, so every conversion is a binary search plus a closed-form
+ * evaluation. Constant segments are linear; ramps are quadratic in time.
+ * The engine publishes a new map per edit and never mutates a live one.
+ */
+class TempoMap {
+public:
+    TempoMap();                                     // 120 BPM, 4/4
+    explicit TempoMap(std::vector<TempoMarker> markers);
+
+    // Beat/time conversion
+    double BeatsToSeconds(double beats) const;
+    double SecondsToBeats(double seconds) const;
+
+    // Bars are zero-based and fractional (bar 0 beat 0 = project start)
+    double BeatsToBars(double beats) const;
+    double BarsToBeats(double bars) const;
+
+    // Tempo and meter at a point in time
+    double GetTempoAt(double seconds) const;
+    void GetTimeSignatureAt(double seconds, int& numerator, int& denominator) const;
+    double GetBeatsPerBarAt(double beats) const;
+
+    /**
+     * Per-sample beat stepping for a block starting at 'seconds'
+     * beat(n) = beat + n*increment + n(n-1)/2*incrementDelta holds exactly
+     * inside one segment, so callers advance with two additions per sample.
+     */
+    struct BlockCursor {
+        double beat = 0.0;
+        double increment = 0.0;         // Beats per sample at the block start
+        double incrementDelta = 0.0;    // Change of increment per sample (ramps)
+        double tempo = 120.0;
+        int timeSigNumerator = 4;
+        int timeSigDenominator = 4;
+    };
+    BlockCursor GetBlockCursor(double seconds, double sampleRate) const;
+
+    const std::vector<TempoMarker>& GetMarkers() const { return m_markers; }
+    size_t GetSegmentCount() const { return m_segments.size(); }
+
+private:
+    struct Segment {
+        double startBeat = 0.0;
+        double startTime = 0.0;
+        double startBar = 0.0;
+        double startBpm = 120.0;
+        double slope = 0.0;             // BPM per second (0 for constant tempo)
+        double beatsPerBar = 4.0;
+        int timeSigNumerator = 4;
+        int timeSigDenominator = 4;
+    };
+
+    std::vector<TempoMarker> m_markers;
+    std::vector<Segment> m_segments;
+
+    void BuildSegments();
+    size_t FindSegmentByBeat(double beats) const;
+    size_t FindSegmentByTime(double seconds) const;
+    size_t FindSegmentByBar(double bars) const;
+
+    static double SecondsIntoSegment(const Segment& segment, double beatsIntoSegment);
+    static double BeatsIntoSegment(const Segment& segment, double secondsIntoSegment);
+};
@@ -5,6 +5,7 @@
 
 #include "track_manager.hpp"
 #include "audio_engine.hpp"
+#include "reaper_engine.hpp"
 #include "../effects/effect_chain.hpp"
 #include <algorithm>
 #include <chrono>
@@ -362,8 +363,14 @@ Track::Track(TrackManager* manager, const std::string& name)
     m_state.folderDepth = 0;
     m_state.folderOpen = true;
     
-    // Create effects processor
+    // Create effects processor; oversampling changes move delay compensation
     m_effectProcessor = std::make_unique<TrackEffectProcessor>();
+    m_effectProcessor->SetLatencyCallback([] {
+        ReaperEngine* engine = REAPER_ENGINE();
+        if (engine && engine->GetAudioEngine()) {
+            engine->GetAudioEngine()->CompensateLatency();
+        }
+    });
 }
 
 Track::~Track() {
@@ -432,7 +439,8 @@ void Track::ProcessAudio(AudioBuffer& inputBuffer, AudioBuffer& outputBuffer) {
     ApplyVolumeAndPan(outputBuffer);
     
     // Process effects chain
-    ProcessEffects(outputBuffer);
+    ReaperEngine* engine = REAPER_ENGINE();
+    ProcessEffects(outputBuffer, engine ? engine->GetTransportState().playPosition.load() : 0.0);
     
     // Apply mute
     if (m_state.mute) {
@@ -490,36 +498,40 @@ std::string Track::GenerateGUID() const {
 }
 
 void Track::ApplyVolumeAndPan(AudioBuffer& buffer) {
-    if (!buffer.isValid) return;
+    if (buffer.GetChannelCount() == 0 || buffer.GetSampleCount() == 0) return;
     
     // Apply volume
     float volume = static_cast<float>(m_state.volume);
     if (volume != 1.0f) {
-        for (int ch = 0; ch < buffer.numChannels; ++ch) {
-            for (int i = 0; i < buffer.numSamples; ++i) {
-                buffer.channels[ch][i] *= volume;
-            }
-        }
+        buffer.ApplyGain(volume);
     }
     
     // Apply pan (for stereo tracks)
-    if (buffer.numChannels >= 2 && m_state.pan != 0.0) {
+    if (buffer.GetChannelCount() >= 2 && m_state.pan != 0.0) {
         float pan = static_cast<float>(m_state.pan);
-        float leftGain = std::sqrt((1.0f - pan) * 0.5f);
-        float rightGain = std::sqrt((1.0f + pan) * 0.5f);
-        
-        for (int i = 0; i < buffer.numSamples; ++i) {
-            buffer.channels[0][i] *= leftGain;
-            buffer.channels[1][i] *= rightGain;
-        }
+        buffer.ApplyChannelGain(0, std::sqrt((1.0f - pan) * 0.5f));
+        buffer.ApplyChannelGain(1, std::sqrt((1.0f + pan) * 0.5f));
     }
 }
 
-void Track::ProcessEffects(AudioBuffer& buffer) {
+void Track::ProcessEffects(AudioBuffer& buffer, double startTime) {
     // Process through effects processor
     if (m_effectProcessor) {
-        // Get current time position from manager or audio engine
-        double timePosition = 0.0; // TODO: Get actual time position
-        m_effectProcessor->ProcessTrackAudio(buffer, timePosition);
+        // JSFX transport variables anchored to the tempo map at this segment;
+        // a block split at a loop wrap or lead-in has several start times
+        EffectChain::BlockInfo info;
+        ReaperEngine* engine = REAPER_ENGINE();
+        const TempoMap* tempoMap = engine ? engine->GetTempoMap() : nullptr;
+        if (tempoMap) {
+            info.hasTransport = true;
+            info.transport = tempoMap->GetBlockCursor(startTime, GET_SAMPLE_RATE());
+            switch (engine->GetTransportState().playState.load()) {
+                case ReaperEngine::PlayState::PLAYING:   info.playState = 1.0; break;
+                case ReaperEngine::PlayState::PAUSED:    info.playState = 2.0; break;
+                case ReaperEngine::PlayState::RECORDING: info.playState = 5.0; break;
+                default: break;
+            }
+        }
+        m_effectProcessor->ProcessTrackAudio(buffer, info);
     }
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include <atomic>
 #include <mutex>
 
@@ -250,6 +251,8 @@ public:
     
     // Processing
     void ProcessAudio(AudioBuffer& inputBuffer, AudioBuffer& outputBuffer);
+    // startTime: timeline position of the buffer's first sample
+    void ProcessEffects(AudioBuffer& buffer, double startTime);
     
     // State management
     const TrackState& GetState() const { return m_state; }
@@ -277,5 +280,4 @@ private:
     
     // Internal processing helpers
     void ApplyVolumeAndPan(AudioBuffer& buffer);
-    void ProcessEffects(AudioBuffer& buffer);
 };
\ No newline at end of file
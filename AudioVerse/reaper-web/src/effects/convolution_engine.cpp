@@ -0,0 +1,329 @@
+/*
+ * REAPER Web - Convolution Engine Implementation
+ * Direct FIR head, inline short stage and threaded long stages
+ */
+
+#include "convolution_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace {
+    // Stage layout: partition sizes and the tap each stage starts at. A stage
+    // of size P must start at tap >= 2P to run off the audio thread.
+    constexpr int kStageSizes[] = {64, 512, 4096, 32768};
+    constexpr int kStageOffsets[] = {64, 1024, 8192, 65536};
+    constexpr int kNumStageSizes = 4;
+
+    float DotProduct(const float* a, const float* b, int count) {
+        int i = 0;
+        float sum = 0.0f;
+#if defined(__SSE__)
+        __m128 acc = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, acc);
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+        for (; i < count; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+}
+
+ConvolutionEngine::ConvolutionEngine() {
+}
+
+ConvolutionEngine::~ConvolutionEngine() {
+    StopWorkers();
+}
+
+bool ConvolutionEngine::Load(const std::vector<std::vector<float>>& impulse, int numChannels,
+                             const Settings& settings) {
+    StopWorkers();
+    m_stages.clear();
+    m_numChannels = 0;
+
+    if (impulse.empty() || numChannels <= 0) {
+        return false;
+    }
+
+    m_impulseLength = 0;
+    for (const auto& channel : impulse) {
+        m_impulseLength = std::max(m_impulseLength, channel.size());
+    }
+    if (m_impulseLength == 0) {
+        return false;
+    }
+    m_numChannels = numChannels;
+
+    auto tap = [&](int responseChannel, size_t index) {
+        const auto& channel = impulse[responseChannel];
+        return index < channel.size() ? channel[index] : 0.0f;
+    };
+    int responseChannels = static_cast<int>(impulse.size());
+
+    // Direct head, reversed so each output is one contiguous dot product
+    m_headTaps.assign(responseChannels, std::vector<float>(kHeadLength, 0.0f));
+    for (int r = 0; r < responseChannels; ++r) {
+        for (int j = 0; j < kHeadLength; ++j) {
+            m_headTaps[r][j] = tap(r, kHeadLength - 1 - j);
+        }
+    }
+    m_history.assign(numChannels, std::vector<float>(kHeadLength * 2, 0.0f));
+
+    for (int s = 0; s < kNumStageSizes; ++s) {
+        size_t start = kStageOffsets[s];
+        if (start >= m_impulseLength) break;
+        size_t end = (s + 1 < kNumStageSizes) ? std::min(m_impulseLength, static_cast<size_t>(kStageOffsets[s + 1]))
+                                              : m_impulseLength;
+
+        auto stage = std::make_unique<Stage>();
+        int size = kStageSizes[s];
+        stage->partitionSize = size;
+        stage->numPartitions = static_cast<int>((end - start + size - 1) / size);
+        stage->numBins = size + 1;
+        stage->delayed = s > 0;
+        stage->threaded = settings.backgroundThreads && stage->delayed;
+        stage->fft = std::make_unique<FFT>(size * 2);
+
+        // Partition spectra: P taps zero-padded to 2P
+        int bins = stage->numBins;
+        std::vector<float> segment(size * 2);
+        stage->filterRe.assign(responseChannels, std::vector<float>(stage->numPartitions * bins));
+        stage->filterIm.assign(responseChannels, std::vector<float>(stage->numPartitions * bins));
+        for (int r = 0; r < responseChannels; ++r) {
+            for (int p = 0; p < stage->numPartitions; ++p) {
+                std::fill(segment.begin(), segment.end(), 0.0f);
+                for (int i = 0; i < size; ++i) {
+                    size_t index = start + static_cast<size_t>(p) * size + i;
+                    if (index < end) segment[i] = tap(r, index);
+                }
+                stage->fft->Forward(segment.data(), stage->filterRe[r].data() + p * bins,
+                                    stage->filterIm[r].data() + p * bins);
+            }
+        }
+
+        stage->channels.resize(numChannels);
+        for (auto& channel : stage->channels) {
+            channel.input.assign(size, 0.0f);
+            channel.jobInput.assign(size, 0.0f);
+            channel.window.assign(size * 2, 0.0f);
+            channel.fdlRe.assign(stage->numPartitions * bins, 0.0f);
+            channel.fdlIm.assign(stage->numPartitions * bins, 0.0f);
+            channel.result.assign(size, 0.0f);
+            channel.playback.assign(size, 0.0f);
+        }
+        stage->accumRe.assign(bins, 0.0f);
+        stage->accumIm.assign(bins, 0.0f);
+        stage->timeDomain.assign(size * 2, 0.0f);
+
+        if (stage->threaded) {
+            stage->worker = std::thread(&ConvolutionEngine::WorkerLoop, this, stage.get());
+        }
+        m_stages.push_back(std::move(stage));
+    }
+
+    Reset();
+    return true;
+}
+
+void ConvolutionEngine::Reset() {
+    for (auto& stage : m_stages) {
+        if (stage->threaded && stage->jobPending) {
+            while (!stage->jobDone.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+        stage->jobPending = false;
+        stage->jobDone.store(false, std::memory_order_relaxed);
+        stage->fdlIndex = 0;
+
+        for (auto& channel : stage->channels) {
+            std::fill(channel.input.begin(), channel.input.end(), 0.0f);
+            std::fill(channel.window.begin(), channel.window.end(), 0.0f);
+            std::fill(channel.fdlRe.begin(), channel.fdlRe.end(), 0.0f);
+            std::fill(channel.fdlIm.begin(), channel.fdlIm.end(), 0.0f);
+            std::fill(channel.playback.begin(), channel.playback.end(), 0.0f);
+        }
+    }
+
+    for (auto& history : m_history) {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+    m_blockPhase = 0;
+    m_blocksCompleted = 0;
+}
+
+int ConvolutionEngine::GetResponseChannel(int channel) const {
+    return std::min(channel, static_cast<int>(m_headTaps.size()) - 1);
+}
+
+void ConvolutionEngine::Process(const float* const* inputs, float* const* outputs, int numSamples) {
+    if (m_numChannels == 0) return;
+
+    int offset = 0;
+    while (offset < numSamples) {
+        int count = std::min(numSamples - offset, kHeadLength - m_blockPhase);
+        ProcessChunk(inputs, outputs, offset, count);
+        offset += count;
+
+        m_blockPhase += count;
+        if (m_blockPhase == kHeadLength) {
+            m_blockPhase = 0;
+            m_blocksCompleted++;
+
+            int64_t samplesCompleted = m_blocksCompleted * kHeadLength;
+            for (auto& stage : m_stages) {
+                if (samplesCompleted % stage->partitionSize == 0) {
+                    OnBlockBoundary(*stage);
+                }
+            }
+        }
+    }
+}
+
+void ConvolutionEngine::ProcessChunk(const float* const* inputs, float* const* outputs, int offset, int numSamples) {
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        const float* input = inputs[ch] + offset;
+        float* output = outputs[ch] + offset;
+        const float* taps = m_headTaps[GetResponseChannel(ch)].data();
+
+        // History holds the previous 63 samples followed by this chunk
+        float* history = m_history[ch].data();
+        std::memcpy(history + kHeadLength - 1, input, numSamples * sizeof(float));
+        for (int i = 0; i < numSamples; ++i) {
+            output[i] = DotProduct(taps, history + i, kHeadLength);
+        }
+        std::memmove(history, history + numSamples, (kHeadLength - 1) * sizeof(float));
+
+        // Feed every stage and mix the results due now
+        for (auto& stage : m_stages) {
+            int blocksPerPartition = stage->partitionSize / kHeadLength;
+            int position = static_cast<int>(m_blocksCompleted % blocksPerPartition) * kHeadLength + m_blockPhase;
+
+            StageChannel& channel = stage->channels[ch];
+            std::memcpy(channel.input.data() + position, input, numSamples * sizeof(float));
+            const float* playback = channel.playback.data() + position;
+            for (int i = 0; i < numSamples; ++i) {
+                output[i] += playback[i];
+            }
+        }
+    }
+}
+
+void ConvolutionEngine::OnBlockBoundary(Stage& stage) {
+    if (!stage.delayed) {
+        for (auto& channel : stage.channels) {
+            std::swap(channel.input, channel.jobInput);
+        }
+        RunJob(stage);
+        for (auto& channel : stage.channels) {
+            std::swap(channel.result, channel.playback);
+        }
+        return;
+    }
+
+    // The previous block's result is due now. Waiting only happens when a
+    // worker has fallen a whole block period behind real time.
+    if (stage.jobPending) {
+        if (stage.threaded) {
+            while (!stage.jobDone.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            stage.jobDone.store(false, std::memory_order_relaxed);
+        }
+        for (auto& channel : stage.channels) {
+            std::swap(channel.result, channel.playback);
+        }
+    }
+
+    for (auto& channel : stage.channels) {
+        std::swap(channel.input, channel.jobInput);
+    }
+    stage.jobPending = true;
+
+    if (stage.threaded) {
+        stage.jobPosted.store(true, std::memory_order_release);
+        stage.wake.notify_one();
+    } else {
+        RunJob(stage);
+    }
+}
+
+void ConvolutionEngine::RunJob(Stage& stage) {
+    int size = stage.partitionSize;
+    int bins = stage.numBins;
+    int partitions = stage.numPartitions;
+
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        StageChannel& channel = stage.channels[ch];
+        int response = GetResponseChannel(ch);
+
+        // Overlap-save window: previous block then the completed one
+        std::memmove(channel.window.data(), channel.window.data() + size, size * sizeof(float));
+        std::memcpy(channel.window.data() + size, channel.jobInput.data(), size * sizeof(float));
+        stage.fft->Forward(channel.window.data(), channel.fdlRe.data() + stage.fdlIndex * bins,
+                           channel.fdlIm.data() + stage.fdlIndex * bins);
+
+        // Partition p of the response meets the input spectrum from p blocks ago
+        std::fill(stage.accumRe.begin(), stage.accumRe.end(), 0.0f);
+        std::fill(stage.accumIm.begin(), stage.accumIm.end(), 0.0f);
+        for (int p = 0; p < partitions; ++p) {
+            int slot = (stage.fdlIndex - p + partitions) % partitions;
+            FFT::MultiplyAccumulate(stage.accumRe.data(), stage.accumIm.data(),
+                                    channel.fdlRe.data() + slot * bins, channel.fdlIm.data() + slot * bins,
+                                    stage.filterRe[response].data() + p * bins,
+                                    stage.filterIm[response].data() + p * bins, bins);
+        }
+
+        stage.fft->Inverse(stage.accumRe.data(), stage.accumIm.data(), stage.timeDomain.data());
+        std::memcpy(channel.result.data(), stage.timeDomain.data() + size, size * sizeof(float));
+    }
+
+    stage.fdlIndex = (stage.fdlIndex + 1) % partitions;
+}
+
+void ConvolutionEngine::WorkerLoop(Stage* stage) {
+    for (;;) {
+        {
+            // The audio thread posts without taking the lock; the timeout
+            // bounds the delay of a wake-up that slips in before the wait
+            std::unique_lock<std::mutex> lock(stage->mutex);
+            stage->wake.wait_for(lock, std::chrono::milliseconds(2), [stage] {
+                return stage->jobPosted.load(std::memory_order_acquire) ||
+                       stage->quit.load(std::memory_order_acquire);
+            });
+        }
+
+        if (stage->quit.load(std::memory_order_acquire)) {
+            return;
+        }
+        if (!stage->jobPosted.exchange(false, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        RunJob(*stage);
+        stage->jobDone.store(true, std::memory_order_release);
+    }
+}
+
+void ConvolutionEngine::StopWorkers() {
+    for (auto& stage : m_stages) {
+        if (stage->worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(stage->mutex);
+                stage->quit.store(true, std::memory_order_release);
+            }
+            stage->wake.notify_one();
+            stage->worker.join();
+        }
+    }
+}
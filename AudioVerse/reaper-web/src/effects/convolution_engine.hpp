@@ -0,0 +1,113 @@
+/*
+ * REAPER Web - Convolution Engine
+ * Zero-latency non-uniformly partitioned FFT convolution for long impulse responses
+ */
+
+#pragma once
+
+#include "../core/fft.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Convolution Engine - zero-latency partitioned convolution
+ *
+ * The first 64 taps run as a direct FIR, so output starts on the input
+ * sample. The rest of the impulse response is split into stages of growing
+ * partition size (64, 512, 4096, 32768), each a uniformly partitioned
+ * overlap-save convolver with a frequency-domain delay line (FDL) of input
+ * spectra. A stage of partition P starts at tap 2P (tap 64 for the first),
+ * so its result is due one block after its input is complete. The 64-sample
+ * stage runs inline on the audio thread; each larger stage runs on its own
+ * worker thread with a whole block period as its deadline.
+ */
+class ConvolutionEngine {
+public:
+    static constexpr int kHeadLength = 64;
+
+    struct Settings {
+        bool backgroundThreads = true;      // false: run every stage inline (offline render)
+    };
+
+public:
+    ConvolutionEngine();
+    ~ConvolutionEngine();
+
+    ConvolutionEngine(const ConvolutionEngine&) = delete;
+    ConvolutionEngine& operator=(const ConvolutionEngine&) = delete;
+
+    // Non-realtime: partitions and transforms the impulse response. A mono
+    // response is used for every channel, otherwise channel N uses response N.
+    bool Load(const std::vector<std::vector<float>>& impulse, int numChannels, const Settings& settings);
+
+    // Clears all signal state; not concurrent with Process()
+    void Reset();
+
+    // Audio thread: wet signal of 'numChannels' (as loaded) planar channels.
+    // Inputs and outputs must not alias.
+    void Process(const float* const* inputs, float* const* outputs, int numSamples);
+
+    int GetNumChannels() const { return m_numChannels; }
+    size_t GetImpulseLength() const { return m_impulseLength; }
+    int GetStageCount() const { return static_cast<int>(m_stages.size()); }
+
+private:
+    struct StageChannel {
+        std::vector<float> input;           // Block being filled by the audio thread
+        std::vector<float> jobInput;        // Completed block handed to the job
+        std::vector<float> window;          // Previous + current block (overlap-save)
+        std::vector<float> fdlRe;           // Input spectra, one per partition
+        std::vector<float> fdlIm;
+        std::vector<float> result;          // Job output
+        std::vector<float> playback;        // Output being mixed by the audio thread
+    };
+
+    struct Stage {
+        int partitionSize = 0;
+        int numPartitions = 0;
+        int numBins = 0;
+        bool delayed = false;               // Starts at tap 2P: result due one block after its input
+        bool threaded = false;
+
+        std::unique_ptr<FFT> fft;
+        std::vector<std::vector<float>> filterRe;   // Per response channel: partitions x bins
+        std::vector<std::vector<float>> filterIm;
+        std::vector<StageChannel> channels;
+        std::vector<float> accumRe;
+        std::vector<float> accumIm;
+        std::vector<float> timeDomain;
+        int fdlIndex = 0;
+        bool jobPending = false;
+
+        // Worker thread handshake
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::atomic<bool> jobPosted{false};
+        std::atomic<bool> jobDone{false};
+        std::atomic<bool> quit{false};
+    };
+
+    int m_numChannels = 0;
+    size_t m_impulseLength = 0;
+
+    // Direct FIR head: reversed taps and per-channel input history
+    std::vector<std::vector<float>> m_headTaps;
+    std::vector<std::vector<float>> m_history;
+    int m_blockPhase = 0;                   // Position inside the current 64-sample block
+    int64_t m_blocksCompleted = 0;
+
+    std::vector<std::unique_ptr<Stage>> m_stages;
+
+    int GetResponseChannel(int channel) const;
+    void ProcessChunk(const float* const* inputs, float* const* outputs, int offset, int numSamples);
+    void OnBlockBoundary(Stage& stage);
+    void RunJob(Stage& stage);
+    void WorkerLoop(Stage* stage);
+    void StopWorkers();
+};
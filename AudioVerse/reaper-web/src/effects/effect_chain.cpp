@@ -6,35 +6,222 @@
 #include "effect_chain.hpp"
 #include <algorithm>
 
+// EffectLoader Implementation
+
+EffectLoader& EffectLoader::Instance() {
+    static EffectLoader loader;
+    return loader;
+}
+
+EffectLoader::~EffectLoader() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void EffectLoader::Enqueue(const void* owner, Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return;
+        }
+        m_jobs.emplace_back(owner, std::move(job));
+        
+        // Started on first use: sessions that never load asynchronously pay nothing
+        if (!m_thread.joinable()) {
+            m_thread = std::thread(&EffectLoader::WorkerLoop, this);
+        }
+    }
+    m_wake.notify_one();
+}
+
+void EffectLoader::Cancel(const void* owner) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(),
+                                [owner](const std::pair<const void*, Job>& job) { return job.first == owner; }),
+                 m_jobs.end());
+    m_idle.wait(lock, [this, owner] { return m_runningOwner != owner; });
+}
+
+void EffectLoader::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_jobs.empty() && !m_runningOwner; });
+}
+
+void EffectLoader::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+        if (m_stopping) {
+            break;
+        }
+        
+        auto job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_runningOwner = job.first;
+        
+        lock.unlock();
+        job.second();
+        job.second = nullptr;       // Captured state is released before the owner may go away
+        lock.lock();
+        
+        m_runningOwner = nullptr;
+        m_idle.notify_all();
+    }
+}
+
 // EffectChain Implementation
 
-EffectChain::EffectChain() {
+EffectChain::EffectChain() : m_sampleBuffer(2, 1) {
+    m_chain.Publish(std::make_unique<ChainState>());
 }
 
 EffectChain::~EffectChain() {
+    // A load still in flight would publish into this chain
+    EffectLoader::Instance().Cancel(this);
 }
 
-void EffectChain::AddEffect(std::unique_ptr<JSFXEffect> effect) {
-    if (effect) {
-        m_effects.push_back(std::move(effect));
+void EffectChain::Prepare(double sampleRate, int maxBlockSize, int numChannels) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_format.sampleRate = sampleRate;
+    m_format.maxBlockSize = maxBlockSize;
+    m_format.numChannels = numChannels;
+    m_format.prepared = true;
+    m_format.version++;
+    
+    if (m_effects.empty()) {
+        return;
+    }
+    
+    // Every effect is re-initialized: the chain passes audio through until
+    // the rebuilt slots are published
+    m_chain.Publish(std::make_unique<ChainState>());
+    m_chain.Synchronize();
+    for (auto& slot : m_effects) {
+        slot = RebuildSlotLocked(*slot, slot->oversampler ? slot->oversampler->GetFactor() : 1);
     }
+    PublishLocked();
+}
+
+void EffectChain::InitializeSlot(EffectSlot& slot, const Format& format) {
+    if (!format.prepared || !slot.effect) {
+        return;
+    }
+    
+    int factor = slot.oversampler ? slot.oversampler->GetFactor() : 1;
+    slot.effect->Initialize(format.sampleRate * factor, format.maxBlockSize * factor);
+}
+
+std::shared_ptr<EffectChain::EffectSlot> EffectChain::RebuildSlotLocked(EffectSlot& slot, int factor) {
+    // The audio thread must no longer see 'slot'; it keeps only its old
+    // oversampler and retires with the snapshots that held it
+    auto rebuilt = std::make_shared<EffectSlot>();
+    rebuilt->effect = std::move(slot.effect);
+    if (factor > 1) {
+        rebuilt->oversampler = std::make_unique<Oversampler>(factor, m_format.numChannels, m_format.maxBlockSize);
+    }
+    InitializeSlot(*rebuilt, m_format);
+    return rebuilt;
+}
+
+void EffectChain::PublishLocked() {
+    auto state = std::make_unique<ChainState>();
+    state->slots = m_effects;
+    m_chain.Publish(std::move(state));
+}
+
+void EffectChain::SetLatencyCallback(LatencyCallback callback) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_onLatencyChanged = std::move(callback);
+}
+
+void EffectChain::NotifyLatencyChanged() {
+    // The callback reads GetLatencySamples(); must not be called under m_mutex
+    LatencyCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        callback = m_onLatencyChanged;
+    }
+    if (callback) {
+        callback();
+    }
+}
+
+void EffectChain::AddEffect(std::unique_ptr<JSFXEffect> effect) {
+    InsertEffect(SIZE_MAX, std::move(effect));
 }
 
 void EffectChain::InsertEffect(size_t index, std::unique_ptr<JSFXEffect> effect) {
-    if (effect && index <= m_effects.size()) {
-        m_effects.insert(m_effects.begin() + index, std::move(effect));
+    if (!effect) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index != SIZE_MAX && index > m_effects.size()) {
+        return;
     }
+    auto slot = std::make_shared<EffectSlot>();
+    slot->effect = std::move(effect);
+    InitializeSlot(*slot, m_format);
+    m_effects.insert(m_effects.begin() + std::min(index, m_effects.size()), std::move(slot));
+    PublishLocked();
+}
+
+void EffectChain::LoadEffectAsync(EffectFactory factory, size_t index, LoadCallback onLoaded) {
+    m_pendingLoads.fetch_add(1, std::memory_order_acq_rel);
+    EffectLoader::Instance().Enqueue(this, [this, factory = std::move(factory), index, onLoaded = std::move(onLoaded)]() {
+        auto slot = std::make_shared<EffectSlot>();
+        slot->effect = factory ? factory() : nullptr;
+        
+        if (slot->effect) {
+            // @init runs outside the lock; again if Prepare() changed the format meanwhile
+            std::unique_lock<std::mutex> lock(m_mutex);
+            Format format;
+            do {
+                format = m_format;
+                lock.unlock();
+                InitializeSlot(*slot, format);
+                lock.lock();
+            } while (format.version != m_format.version);
+            
+            m_effects.insert(m_effects.begin() + std::min(index, m_effects.size()), slot);
+            PublishLocked();
+        }
+        
+        m_pendingLoads.fetch_sub(1, std::memory_order_acq_rel);
+        if (onLoaded) {
+            onLoaded(slot->effect != nullptr);
+        }
+    });
 }
 
 void EffectChain::RemoveEffect(size_t index) {
-    if (index < m_effects.size()) {
+    bool latencyChanged = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (index >= m_effects.size()) {
+            return;
+        }
+        latencyChanged = m_effects[index]->oversampler != nullptr;
         m_effects.erase(m_effects.begin() + index);
+        PublishLocked();
+    }
+    
+    if (latencyChanged) {
+        NotifyLatencyChanged();
     }
 }
 
 void EffectChain::MoveEffect(size_t fromIndex, size_t toIndex) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (fromIndex < m_effects.size() && toIndex < m_effects.size() && fromIndex != toIndex) {
-        auto effect = std::move(m_effects[fromIndex]);
+        auto slot = std::move(m_effects[fromIndex]);
         m_effects.erase(m_effects.begin() + fromIndex);
         
         // Adjust toIndex if we removed an element before it
@@ -42,74 +229,220 @@ void EffectChain::MoveEffect(size_t fromIndex, size_t toIndex) {
             toIndex--;
         }
         
-        m_effects.insert(m_effects.begin() + toIndex, std::move(effect));
+        m_effects.insert(m_effects.begin() + toIndex, std::move(slot));
+        PublishLocked();
     }
 }
 
 void EffectChain::ClearEffects() {
-    m_effects.clear();
+    bool latencyChanged = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        latencyChanged = std::any_of(m_effects.begin(), m_effects.end(),
+                                     [](const std::shared_ptr<EffectSlot>& slot) { return slot->oversampler != nullptr; });
+        m_effects.clear();
+        PublishLocked();
+    }
+    
+    if (latencyChanged) {
+        NotifyLatencyChanged();
+    }
 }
 
-void EffectChain::ProcessAudio(AudioBuffer& buffer) {
-    if (m_bypass || m_effects.empty()) {
+void EffectChain::ProcessSlot(EffectSlot& slot, AudioBuffer& buffer) {
+    // A bypassed oversampled effect still delays by its latency, so the
+    // compensation computed for the chain stays valid
+    if (!slot.effect || slot.effect->IsBypassed()) {
+        if (slot.oversampler) {
+            slot.oversampler->ProcessBypassed(buffer);
+        }
         return;
     }
     
-    // Process each effect in sequence
-    for (auto& effect : m_effects) {
-        if (effect && !effect->IsBypassed()) {
-            effect->ProcessBuffer(buffer);
+    if (slot.oversampler) {
+        slot.effect->ProcessBlock(slot.oversampler->Upsample(buffer));
+        slot.oversampler->Downsample(buffer);
+    } else {
+        slot.effect->ProcessBlock(buffer);
+    }
+}
+
+void EffectChain::ProcessAudio(AudioBuffer& buffer, const BlockInfo& info) {
+    // One chain snapshot for the whole block, transport included; released
+    // by EndBlock() below
+    const ChainState* chain = m_chain.BeginBlock();
+    if (!m_bypass && chain) {
+        for (const auto& slot : chain->slots) {
+            if (info.hasTransport && slot->effect) {
+                if (slot->oversampler) {
+                    // The effect runs N samples per session sample: per-sample
+                    // steps shrink by N, their per-sample change by N^2, and on
+                    // a ramp the first step is trimmed so every N-th inner
+                    // sample lands on the session's beat
+                    double factor = slot->oversampler->GetFactor();
+                    TempoMap::BlockCursor transport = info.transport;
+                    transport.increment = (transport.increment -
+                                           0.5 * transport.incrementDelta * (1.0 - 1.0 / factor)) / factor;
+                    transport.incrementDelta /= factor * factor;
+                    slot->effect->SetTransport(transport, info.playState);
+                } else {
+                    slot->effect->SetTransport(info.transport, info.playState);
+                }
+            }
+            ProcessSlot(*slot, buffer);
         }
     }
+    m_chain.EndBlock();
+}
+
+void EffectChain::ProcessAudio(AudioBuffer& buffer) {
+    ProcessAudio(buffer, BlockInfo());
 }
 
 void EffectChain::ProcessSample(double& left, double& right) {
-    if (m_bypass || m_effects.empty()) {
+    const ChainState* chain = m_chain.BeginBlock();
+    if (m_bypass || !chain) {
+        m_chain.EndBlock();
         return;
     }
     
-    // Process each effect in sequence
-    for (auto& effect : m_effects) {
-        if (effect && !effect->IsBypassed()) {
-            effect->ProcessSample(left, right);
+    // Process each effect in sequence; oversampled effects take a one-frame block
+    for (const auto& slot : chain->slots) {
+        if (slot->oversampler) {
+            m_sampleBuffer.GetChannelData(0)[0] = static_cast<float>(left);
+            m_sampleBuffer.GetChannelData(1)[0] = static_cast<float>(right);
+            ProcessSlot(*slot, m_sampleBuffer);
+            left = m_sampleBuffer.GetChannelData(0)[0];
+            right = m_sampleBuffer.GetChannelData(1)[0];
+        } else if (slot->effect && !slot->effect->IsBypassed()) {
+            slot->effect->ProcessSample(left, right, left, right);
         }
     }
+    m_chain.EndBlock();
+}
+
+size_t EffectChain::GetEffectCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_effects.size();
 }
 
 JSFXEffect* EffectChain::GetEffect(size_t index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (index < m_effects.size()) {
-        return m_effects[index].get();
+        return m_effects[index]->effect.get();
     }
     return nullptr;
 }
 
 const JSFXEffect* EffectChain::GetEffect(size_t index) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (index < m_effects.size()) {
-        return m_effects[index].get();
+        return m_effects[index]->effect.get();
     }
     return nullptr;
 }
 
 void EffectChain::SetEffectBypass(size_t index, bool bypass) {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (index < m_effects.size()) {
-        m_effects[index]->SetBypass(bypass);
+        m_effects[index]->effect->SetBypassed(bypass);
     }
 }
 
 bool EffectChain::IsEffectBypassed(size_t index) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index < m_effects.size()) {
+        return m_effects[index]->effect->IsBypassed();
+    }
+    return false;
+}
+
+bool EffectChain::IsEffectWatchdogTripped(size_t index) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (index < m_effects.size()) {
-        return m_effects[index]->IsBypassed();
+        return m_effects[index]->effect->IsWatchdogTripped();
     }
     return false;
 }
 
-void EffectChain::UpdateAutomation(double timePosition) {
-    // Update automation for all effects
-    for (auto& effect : m_effects) {
-        if (effect) {
-            effect->UpdateAutomation(timePosition);
+void EffectChain::ResetEffectWatchdog(size_t index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index < m_effects.size()) {
+        m_effects[index]->effect->ResetWatchdog();
+    }
+}
+
+void EffectChain::SetEffectProfiling(size_t index, bool enabled) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index < m_effects.size()) {
+        m_effects[index]->effect->SetProfilingEnabled(enabled);
+    }
+}
+
+void EffectChain::ResetEffectProfile(size_t index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index < m_effects.size()) {
+        m_effects[index]->effect->ResetProfile();
+    }
+}
+
+std::string EffectChain::GetEffectProfileReport(size_t index, size_t maxRows) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index < m_effects.size()) {
+        return m_effects[index]->effect->GetProfileReport(maxRows);
+    }
+    return std::string();
+}
+
+bool EffectChain::SetEffectOversampling(size_t index, int factor) {
+    if (factor != 1 && factor != 2 && factor != 4 && factor != 8) {
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (index >= m_effects.size()) {
+            return false;
+        }
+        
+        EffectSlot& slot = *m_effects[index];
+        if ((slot.oversampler ? slot.oversampler->GetFactor() : 1) == factor) {
+            return true;
         }
+        
+        // Take the effect out of the running chain before re-initializing it
+        auto detached = std::make_unique<ChainState>();
+        detached->slots = m_effects;
+        detached->slots.erase(detached->slots.begin() + index);
+        m_chain.Publish(std::move(detached));
+        m_chain.Synchronize();
+        
+        m_effects[index] = RebuildSlotLocked(slot, factor);
+        PublishLocked();
+    }
+    
+    // The chain's latency changed
+    NotifyLatencyChanged();
+    return true;
+}
+
+int EffectChain::GetEffectOversampling(size_t index) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index < m_effects.size() && m_effects[index]->oversampler) {
+        return m_effects[index]->oversampler->GetFactor();
     }
+    return 1;
+}
+
+int EffectChain::GetLatencySamples() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int latency = 0;
+    for (const auto& slot : m_effects) {
+        if (slot->oversampler) {
+            latency += slot->oversampler->GetLatencySamples();
+        }
+    }
+    return latency;
 }
 
 // TrackEffectProcessor Implementation
@@ -123,6 +456,16 @@ TrackEffectProcessor::~TrackEffectProcessor() {
 
 void TrackEffectProcessor::SetEffectChain(std::unique_ptr<EffectChain> chain) {
     m_effectChain = std::move(chain);
+    if (m_effectChain) {
+        m_effectChain->SetLatencyCallback(m_onLatencyChanged);
+    }
+}
+
+void TrackEffectProcessor::SetLatencyCallback(EffectChain::LatencyCallback callback) {
+    m_onLatencyChanged = std::move(callback);
+    if (m_effectChain) {
+        m_effectChain->SetLatencyCallback(m_onLatencyChanged);
+    }
 }
 
 void TrackEffectProcessor::SetBuiltinEffectsManager(std::shared_ptr<BuiltinEffectsManager> manager) {
@@ -143,16 +486,26 @@ bool TrackEffectProcessor::AddBuiltinEffect(const std::string& effectName) {
     return true;
 }
 
-void TrackEffectProcessor::ProcessTrackAudio(AudioBuffer& buffer, double timePosition) {
-    if (!m_effectChain) {
-        return;
+bool TrackEffectProcessor::AddBuiltinEffectAsync(const std::string& effectName, size_t index) {
+    if (!m_builtinManager || !m_effectChain) {
+        return false;
     }
     
-    // Update automation before processing
-    m_effectChain->UpdateAutomation(timePosition);
+    auto names = m_builtinManager->GetAvailableEffects();
+    if (std::find(names.begin(), names.end(), effectName) == names.end()) {
+        return false;
+    }
     
-    // Process through effect chain
-    m_effectChain->ProcessAudio(buffer);
+    // The manager is only read after construction, so the loader may use it
+    std::shared_ptr<BuiltinEffectsManager> manager = m_builtinManager;
+    m_effectChain->LoadEffectAsync([manager, effectName] { return manager->CreateEffect(effectName); }, index);
+    return true;
+}
+
+void TrackEffectProcessor::ProcessTrackAudio(AudioBuffer& buffer, const EffectChain::BlockInfo& info) {
+    if (m_effectChain) {
+        m_effectChain->ProcessAudio(buffer, info);
+    }
 }
 
 void TrackEffectProcessor::SetSendLevel(int sendIndex, double level) {
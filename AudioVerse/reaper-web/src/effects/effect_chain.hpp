@@ -7,32 +7,109 @@
 
 #include "../jsfx/jsfx_interpreter.hpp"
 #include "reaper_effects.hpp"
-#include "../audio/audio_buffer.hpp"
+#include "oversampler.hpp"
+#include "../core/audio_buffer.hpp"
+#include "../core/realtime_snapshot.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <memory>
 
+/**
+ * Effect Loader - background thread that builds effects for EffectChain
+ * Jobs run in order on one lazily started thread shared by all chains, so
+ * parsing, compiling and @init never run on the UI or audio thread.
+ */
+class EffectLoader {
+public:
+    using Job = std::function<void()>;
+    
+    static EffectLoader& Instance();
+    ~EffectLoader();
+    
+    void Enqueue(const void* owner, Job job);
+    // Drops the owner's queued jobs and waits out one already running
+    void Cancel(const void* owner);
+    // Blocks until the queue is empty and no job runs (tests, offline render)
+    void WaitIdle();
+    
+private:
+    EffectLoader() = default;
+    
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::deque<std::pair<const void*, Job>> m_jobs;
+    const void* m_runningOwner = nullptr;
+    bool m_stopping = false;
+    std::thread m_thread;
+    
+    void WorkerLoop();
+};
+
 /**
  * Effect Chain - Manages multiple effects in series
- * Processes audio through chain of JSFX effects
+ * Processes audio through chain of JSFX effects. Any effect can run
+ * oversampled (see Oversampler); the chain's latency is the sum of its
+ * oversamplers' and is reported to PDC through GetLatencySamples().
+ *
+ * The audio thread runs an immutable snapshot of the chain, swapped in with
+ * RealtimeSnapshot at a block boundary, so effects can be added, removed
+ * and reordered during playback. Removed effects are destroyed on a later
+ * edit or CollectRetired(), never on the audio thread. An effect that has to
+ * be re-initialized is first taken out of the running chain.
  */
 class EffectChain {
 public:
+    using EffectFactory = std::function<std::unique_ptr<JSFXEffect>()>;
+    using LoadCallback = std::function<void(bool loaded)>;
+    using LatencyCallback = std::function<void()>;
+    
+    // What the track knows about the block being rendered. Parameter
+    // automation needs nothing here: each effect steps its own per block.
+    struct BlockInfo {
+        bool hasTransport = false;              // False: transport variables keep their values
+        TempoMap::BlockCursor transport;        // tempo, beat_position and meter at the block start
+        double playState = 0.0;                 // JSFX play_state
+    };
+    
     EffectChain();
     ~EffectChain();
     
-    // Effect management
+    // Session format: initializes every effect (at its oversampled rate).
+    // Effects added later are initialized when added.
+    void Prepare(double sampleRate, int maxBlockSize, int numChannels = 2);
+    
+    // Effect management; safe while the audio thread runs, but effects are
+    // initialized on the calling thread
     void AddEffect(std::unique_ptr<JSFXEffect> effect);
     void InsertEffect(size_t index, std::unique_ptr<JSFXEffect> effect);
     void RemoveEffect(size_t index);
     void MoveEffect(size_t fromIndex, size_t toIndex);
     void ClearEffects();
     
-    // Processing
+    // Asynchronous loading: the factory runs and the effect is initialized on
+    // the EffectLoader thread, then it is inserted at 'index' (appended if past
+    // the end at that time). The callback runs on the loader thread.
+    void LoadEffectAsync(EffectFactory factory, size_t index = SIZE_MAX, LoadCallback onLoaded = nullptr);
+    int GetPendingLoadCount() const { return m_pendingLoads.load(std::memory_order_acquire); }
+    
+    // Control threads: free effects the audio thread has stopped using
+    void CollectRetired() { m_chain.CollectRetired(); }
+    
+    // Processing; the chain snapshot is acquired once per call
+    void ProcessAudio(AudioBuffer& buffer, const BlockInfo& info);
     void ProcessAudio(AudioBuffer& buffer);
     void ProcessSample(double& left, double& right);
     
     // Effect access
-    size_t GetEffectCount() const { return m_effects.size(); }
+    size_t GetEffectCount() const;
     JSFXEffect* GetEffect(size_t index);
     const JSFXEffect* GetEffect(size_t index) const;
     
@@ -43,12 +120,60 @@ public:
     void SetEffectBypass(size_t index, bool bypass);
     bool IsEffectBypassed(size_t index) const;
     
-    // Automation
-    void UpdateAutomation(double timePosition);
+    // Effects the JSFX watchdog bypassed; reset puts one back in the signal path
+    bool IsEffectWatchdogTripped(size_t index) const;
+    void ResetEffectWatchdog(size_t index);
+    
+    // JSFX profiler per effect (see JSFXInterpreter::SetProfilingEnabled)
+    void SetEffectProfiling(size_t index, bool enabled);
+    void ResetEffectProfile(size_t index);
+    std::string GetEffectProfileReport(size_t index, size_t maxRows = 20) const;
+    
+    // Oversampling: factor 1 (off), 2, 4 or 8. Non-realtime; re-initializes
+    // the effect at the new rate, and it is silent for the blocks that takes.
+    bool SetEffectOversampling(size_t index, int factor);
+    int GetEffectOversampling(size_t index) const;
+    
+    // Plugin delay compensation: samples of delay the chain adds. The
+    // callback runs on the editing thread whenever that changes.
+    int GetLatencySamples() const;
+    void SetLatencyCallback(LatencyCallback callback);
     
 private:
-    std::vector<std::unique_ptr<JSFXEffect>> m_effects;
+    struct EffectSlot {
+        std::unique_ptr<JSFXEffect> effect;
+        std::unique_ptr<Oversampler> oversampler;   // Null at 1x
+    };
+    
+    // What the audio thread runs; slots are shared between successive snapshots
+    struct ChainState {
+        std::vector<std::shared_ptr<EffectSlot>> slots;
+    };
+    
+    // Control state, edited under m_mutex and published as a ChainState
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<EffectSlot>> m_effects;
+    RealtimeSnapshot<ChainState> m_chain;
+    std::atomic<int> m_pendingLoads{0};
     bool m_bypass = false;
+    LatencyCallback m_onLatencyChanged;
+    
+    // Session format from Prepare()
+    struct Format {
+        bool prepared = false;
+        double sampleRate = 48000.0;
+        int maxBlockSize = 512;
+        int numChannels = 2;
+        uint64_t version = 0;                   // Bumped by Prepare()
+    };
+    Format m_format;
+    AudioBuffer m_sampleBuffer;                 // One frame, for ProcessSample(); sized at construction
+    
+    static void InitializeSlot(EffectSlot& slot, const Format& format);
+    std::shared_ptr<EffectSlot> RebuildSlotLocked(EffectSlot& slot, int factor);
+    void ProcessSlot(EffectSlot& slot, AudioBuffer& buffer);
+    void PublishLocked();
+    void NotifyLatencyChanged();
 };
 
 /**
@@ -66,10 +191,15 @@ public:
     
     // Built-in effects access
     void SetBuiltinEffectsManager(std::shared_ptr<BuiltinEffectsManager> manager);
+    // Kept across SetEffectChain(); see EffectChain::SetLatencyCallback
+    void SetLatencyCallback(EffectChain::LatencyCallback callback);
     bool AddBuiltinEffect(const std::string& effectName);
+    // Loads on the EffectLoader thread; false if the effect is unknown
+    bool AddBuiltinEffectAsync(const std::string& effectName, size_t index = SIZE_MAX);
     
     // Processing
-    void ProcessTrackAudio(AudioBuffer& buffer, double timePosition);
+    void ProcessTrackAudio(AudioBuffer& buffer, const EffectChain::BlockInfo& info);
+    int GetLatencySamples() const { return m_effectChain ? m_effectChain->GetLatencySamples() : 0; }
     
     // Send/Return support (for future implementation)
     void SetSendLevel(int sendIndex, double level);
@@ -78,6 +208,7 @@ public:
 private:
     std::unique_ptr<EffectChain> m_effectChain;
     std::shared_ptr<BuiltinEffectsManager> m_builtinManager;
+    EffectChain::LatencyCallback m_onLatencyChanged;
     
     // Send levels for future send/return implementation
     std::array<double, 8> m_sendLevels = {0.0};
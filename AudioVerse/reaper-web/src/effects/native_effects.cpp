@@ -0,0 +1,759 @@
+/*
+ * REAPER Web - Native Built-in Effects Implementation
+ * Each Process() mirrors the @sample code of its BuiltinJSFX script
+ */
+
+#include "native_effects.hpp"
+#include "reaper_effects.hpp"
+#include "../core/audio_buffer.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace {
+#if defined(__SSE2__)
+    // Two channels in one register; wasm builds map SSE2 onto SIMD128
+    struct ChannelPair {
+        __m128d v;
+
+        ChannelPair(__m128d value) : v(value) {}
+        explicit ChannelPair(double value) : v(_mm_set1_pd(value)) {}
+
+        static ChannelPair Load(const double* state) { return _mm_loadu_pd(state); }
+        void Store(double* state) const { _mm_storeu_pd(state, v); }
+
+        static ChannelPair Gather(const float* a, const float* b, int i) {
+            return _mm_set_pd(b[i], a[i]);
+        }
+        void Scatter(float* a, float* b, int i) const {
+            double lanes[2];
+            _mm_storeu_pd(lanes, v);
+            b[i] = static_cast<float>(lanes[1]);
+            a[i] = static_cast<float>(lanes[0]);    // Low lane wins when a == b
+        }
+    };
+
+    inline ChannelPair operator+(ChannelPair a, ChannelPair b) { return _mm_add_pd(a.v, b.v); }
+    inline ChannelPair operator-(ChannelPair a, ChannelPair b) { return _mm_sub_pd(a.v, b.v); }
+    inline ChannelPair operator*(ChannelPair a, ChannelPair b) { return _mm_mul_pd(a.v, b.v); }
+#else
+    struct ChannelPair {
+        double lo, hi;
+
+        ChannelPair(double l, double h) : lo(l), hi(h) {}
+        explicit ChannelPair(double value) : lo(value), hi(value) {}
+
+        static ChannelPair Load(const double* state) { return {state[0], state[1]}; }
+        void Store(double* state) const { state[0] = lo; state[1] = hi; }
+
+        static ChannelPair Gather(const float* a, const float* b, int i) { return {a[i], b[i]}; }
+        void Scatter(float* a, float* b, int i) const {
+            b[i] = static_cast<float>(hi);
+            a[i] = static_cast<float>(lo);
+        }
+    };
+
+    inline ChannelPair operator+(ChannelPair a, ChannelPair b) { return {a.lo + b.lo, a.hi + b.hi}; }
+    inline ChannelPair operator-(ChannelPair a, ChannelPair b) { return {a.lo - b.lo, a.hi - b.hi}; }
+    inline ChannelPair operator*(ChannelPair a, ChannelPair b) { return {a.lo * b.lo, a.hi * b.hi}; }
+#endif
+
+#if defined(__SSE__)
+    // Four delay lines in one register
+    struct LineQuad {
+        __m128 v;
+
+        LineQuad(__m128 value) : v(value) {}
+        explicit LineQuad(float value) : v(_mm_set1_ps(value)) {}
+
+        static LineQuad Load(const float* lines) { return _mm_loadu_ps(lines); }
+        void Store(float* lines) const { _mm_storeu_ps(lines, v); }
+
+        float Sum() const {
+            __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+            return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+        }
+
+        // Unnormalised 4-point Hadamard transform across the lanes
+        LineQuad Hadamard() const {
+            __m128 even = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+            __m128 odd = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+            __m128 pairs = _mm_add_ps(even, _mm_mul_ps(odd, _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f)));
+            __m128 low = _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 1, 0));
+            __m128 high = _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(3, 2, 3, 2));
+            return _mm_add_ps(low, _mm_mul_ps(high, _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f)));
+        }
+    };
+
+    inline LineQuad operator+(LineQuad a, LineQuad b) { return _mm_add_ps(a.v, b.v); }
+    inline LineQuad operator-(LineQuad a, LineQuad b) { return _mm_sub_ps(a.v, b.v); }
+    inline LineQuad operator*(LineQuad a, LineQuad b) { return _mm_mul_ps(a.v, b.v); }
+#else
+    struct LineQuad {
+        float v[4];
+
+        LineQuad(float a, float b, float c, float d) : v{a, b, c, d} {}
+        explicit LineQuad(float value) : v{value, value, value, value} {}
+
+        static LineQuad Load(const float* lines) { return {lines[0], lines[1], lines[2], lines[3]}; }
+        void Store(float* lines) const { std::copy(v, v + 4, lines); }
+
+        float Sum() const { return (v[0] + v[2]) + (v[1] + v[3]); }
+
+        LineQuad Hadamard() const {
+            float a = v[0] + v[1], b = v[0] - v[1], c = v[2] + v[3], d = v[2] - v[3];
+            return {a + c, b + d, a - c, b - d};
+        }
+    };
+
+    inline LineQuad operator+(LineQuad a, LineQuad b) {
+        return {a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]};
+    }
+    inline LineQuad operator-(LineQuad a, LineQuad b) {
+        return {a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]};
+    }
+    inline LineQuad operator*(LineQuad a, LineQuad b) {
+        return {a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]};
+    }
+#endif
+
+    int NearestPrime(int value) {
+        auto isPrime = [](int n) {
+            if (n < 2) return false;
+            for (int d = 2; d * d <= n; ++d) {
+                if (n % d == 0) return false;
+            }
+            return true;
+        };
+        for (int offset = 0;; ++offset) {
+            if (isPrime(value - offset)) return value - offset;
+            if (isPrime(value + offset)) return value + offset;
+        }
+    }
+
+    // Runs 'kernel(firstChannel, a, b)' per channel pair; an odd last channel
+    // is paired with itself and its spare state lane is ignored
+    template <typename Kernel>
+    void ForEachChannelPair(float* const* channels, int numChannels, Kernel&& kernel) {
+        for (int ch = 0; ch < numChannels; ch += 2) {
+            float* a = channels[ch];
+            float* b = (ch + 1 < numChannels) ? channels[ch + 1] : a;
+            kernel(ch, a, b);
+        }
+    }
+
+    // The JSFX interpreter evaluates x/0 as 0
+    double ScriptDivide(double numerator, double denominator) {
+        return denominator != 0.0 ? numerator / denominator : 0.0;
+    }
+}
+
+// NativeEffect Implementation
+
+NativeEffect::NativeEffect(const std::string& script)
+    : JSFXEffect(NoInterpreter{}), m_program(JSFXProgramCache::Instance().GetProgram(script)) {
+    m_name = GetInfo().description;
+    for (const auto& slider : GetInfo().sliders) {
+        m_sliders.push_back(slider.defaultValue);
+    }
+}
+
+void NativeEffect::Initialize(double sampleRate, int) {
+    m_sampleRate = sampleRate;
+    Reset();
+    UpdateParameters();
+    m_initialized = true;
+}
+
+void NativeEffect::SetParameter(int index, double value) {
+    if (index >= 0 && index < static_cast<int>(m_sliders.size())) {
+        m_sliders[index] = value;
+        if (m_initialized) {
+            UpdateParameters();
+        }
+    }
+}
+
+double NativeEffect::GetParameter(int index) const {
+    if (index >= 0 && index < static_cast<int>(m_sliders.size())) {
+        return m_sliders[index];
+    }
+    return 0.0;
+}
+
+void NativeEffect::RenderSample(double inputL, double inputR, double& outputL, double& outputR) {
+    float left = static_cast<float>(inputL);
+    float right = static_cast<float>(inputR);
+    float* channels[2] = {&left, &right};
+    Process(channels, 2, 1);
+    outputL = left;
+    outputR = right;
+}
+
+void NativeEffect::RenderBlock(AudioBuffer& buffer) {
+    int numChannels = std::min(buffer.GetChannelCount(), kMaxChannels);
+    Process(buffer.GetChannelPointers(), numChannels, buffer.GetSampleCount());
+}
+
+// NativeGainEffect Implementation
+
+NativeGainEffect::NativeGainEffect() : NativeEffect(BuiltinJSFX::SIMPLE_GAIN) {
+}
+
+void NativeGainEffect::UpdateParameters() {
+    m_gain = std::pow(10.0, GetSlider(0) / 20.0);
+}
+
+void NativeGainEffect::Process(float* const* channels, int numChannels, int numSamples) {
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* samples = channels[ch];
+        for (int i = 0; i < numSamples; ++i) {
+            samples[i] = static_cast<float>(samples[i] * m_gain);
+        }
+    }
+}
+
+// NativeResonantLowpassEffect Implementation
+
+NativeResonantLowpassEffect::NativeResonantLowpassEffect() : NativeEffect(BuiltinJSFX::RESONANT_LOWPASS) {
+}
+
+void NativeResonantLowpassEffect::UpdateParameters() {
+    m_cutoff = GetSlider(0) * 2.0 / m_sampleRate;
+    double resonance = GetSlider(1);
+    m_feedback = resonance + ScriptDivide(resonance, 1.0 - m_cutoff);
+}
+
+void NativeResonantLowpassEffect::Reset() {
+    std::fill(std::begin(m_stage1), std::end(m_stage1), 0.0);
+    std::fill(std::begin(m_stage2), std::end(m_stage2), 0.0);
+}
+
+void NativeResonantLowpassEffect::Process(float* const* channels, int numChannels, int numSamples) {
+    const ChannelPair cutoff(m_cutoff);
+    const ChannelPair feedback(m_feedback);
+
+    ForEachChannelPair(channels, numChannels, [&](int ch, float* a, float* b) {
+        ChannelPair n3 = ChannelPair::Load(m_stage1 + ch);
+        ChannelPair n4 = ChannelPair::Load(m_stage2 + ch);
+
+        for (int i = 0; i < numSamples; ++i) {
+            ChannelPair x = ChannelPair::Gather(a, b, i);
+            n3 = n3 + cutoff * (x - n3 + feedback * (n3 - n4));
+            n4 = n4 + cutoff * (n3 - n4);
+            n4.Scatter(a, b, i);
+        }
+
+        n3.Store(m_stage1 + ch);
+        n4.Store(m_stage2 + ch);
+    });
+}
+
+// NativeDelayEffect Implementation
+
+NativeDelayEffect::NativeDelayEffect() : NativeEffect(BuiltinJSFX::SIMPLE_DELAY) {
+}
+
+void NativeDelayEffect::Initialize(double sampleRate, int maxBlockSize) {
+    // Sized once for the slider maximum so slider moves never allocate
+    double maxDelayMs = GetInfo().sliders.empty() ? 4000.0 : GetInfo().sliders[0].maxValue;
+    size_t capacity = static_cast<size_t>(std::ceil(std::min(maxDelayMs * sampleRate / 1000.0, 500000.0))) + 1;
+    for (auto& line : m_buffer) {
+        line.assign(capacity, 0.0f);
+    }
+    NativeEffect::Initialize(sampleRate, maxBlockSize);
+}
+
+void NativeDelayEffect::UpdateParameters() {
+    // The script wraps when the position reaches the length, so a fractional
+    // length rounds up and a zero length still delays by one frame
+    double length = std::min(GetSlider(0) * m_sampleRate / 1000.0, 500000.0);
+    int capacity = static_cast<int>(m_buffer[0].size());
+    m_length = std::max(1, std::min(static_cast<int>(std::ceil(length)), capacity));
+
+    m_feedback = std::pow(10.0, GetSlider(1) / 20.0);
+    m_mixIn = std::pow(10.0, GetSlider(2) / 20.0);
+    m_wetGain = std::pow(10.0, GetSlider(3) / 20.0);
+    m_dryGain = std::pow(10.0, GetSlider(4) / 20.0);
+}
+
+void NativeDelayEffect::Reset() {
+    for (auto& line : m_buffer) {
+        std::fill(line.begin(), line.end(), 0.0f);
+    }
+    m_position = 0;
+}
+
+void NativeDelayEffect::Process(float* const* channels, int numChannels, int numSamples) {
+    if (numChannels <= 0 || m_buffer[0].empty()) return;
+
+    // Mono input feeds both sides like the JSFX version, which only has spl0/spl1
+    float* left = channels[0];
+    float* right = numChannels > 1 ? channels[1] : nullptr;
+    float* lineL = m_buffer[0].data();
+    float* lineR = m_buffer[1].data();
+
+    int position = m_position;
+    for (int i = 0; i < numSamples; ++i) {
+        if (position >= m_length) {
+            position = 0;
+        }
+
+        double inputL = left[i];
+        double inputR = right ? right[i] : inputL;
+        double delayedL = lineL[position];
+        double delayedR = lineR[position];
+
+        lineL[position] = static_cast<float>(inputL * m_mixIn + delayedL * m_feedback);
+        lineR[position] = static_cast<float>(inputR * m_mixIn + delayedR * m_feedback);
+
+        left[i] = static_cast<float>(inputL * m_dryGain + delayedL * m_wetGain);
+        if (right) {
+            right[i] = static_cast<float>(inputR * m_dryGain + delayedR * m_wetGain);
+        }
+        position++;
+    }
+    m_position = position;
+}
+
+// NativeCompressorEffect Implementation
+
+NativeCompressorEffect::NativeCompressorEffect() : NativeEffect(BuiltinJSFX::SIMPLE_COMPRESSOR) {
+}
+
+void NativeCompressorEffect::UpdateParameters() {
+    // A 0 ms time constant is instantaneous (exp(-inf) in EEL2)
+    double attackSamples = GetSlider(2) * m_sampleRate / 1000.0;
+    double releaseSamples = GetSlider(3) * m_sampleRate / 1000.0;
+
+    m_threshold = std::pow(10.0, GetSlider(0) / 20.0);
+    m_ratio = GetSlider(1);
+    m_attack = attackSamples > 0.0 ? std::exp(-1.0 / attackSamples) : 0.0;
+    m_release = releaseSamples > 0.0 ? std::exp(-1.0 / releaseSamples) : 0.0;
+    m_makeup = std::pow(10.0, GetSlider(4) / 20.0);
+}
+
+void NativeCompressorEffect::Process(float* const* channels, int numChannels, int numSamples) {
+    double envelope = m_envelope;
+
+    for (int i = 0; i < numSamples; ++i) {
+        double peak = 0.0;
+        for (int ch = 0; ch < numChannels; ++ch) {
+            peak = std::max(peak, static_cast<double>(std::abs(channels[ch][i])));
+        }
+
+        envelope = peak > envelope ? peak * (1.0 - m_attack) + envelope * m_attack
+                                   : peak * (1.0 - m_release) + envelope * m_release;
+
+        double over = envelope > m_threshold ? envelope / m_threshold : 1.0;
+        over = over > 1.0 ? 1.0 + ScriptDivide(over - 1.0, m_ratio) : over;
+        double gain = (over > 1.0 ? 1.0 / over : 1.0) * m_makeup;
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            channels[ch][i] = static_cast<float>(channels[ch][i] * gain);
+        }
+    }
+
+    m_envelope = envelope;
+}
+
+// NativeHighPassEffect Implementation
+
+NativeHighPassEffect::NativeHighPassEffect() : NativeEffect(BuiltinJSFX::HIGH_PASS) {
+}
+
+void NativeHighPassEffect::UpdateParameters() {
+    double w = 2.0 * M_PI * GetSlider(0) / m_sampleRate;
+    double cosw = std::cos(w);
+    double alpha = ScriptDivide(std::sin(w), 2.0 * GetSlider(1));
+
+    double a0 = 1.0 + alpha;
+    m_b0 = ScriptDivide((1.0 + cosw) / 2.0, a0);
+    m_b1 = ScriptDivide(-(1.0 + cosw), a0);
+    m_b2 = ScriptDivide((1.0 + cosw) / 2.0, a0);
+    m_a1 = ScriptDivide(-2.0 * cosw, a0);
+    m_a2 = ScriptDivide(1.0 - alpha, a0);
+}
+
+void NativeHighPassEffect::Reset() {
+    std::fill(std::begin(m_x1), std::end(m_x1), 0.0);
+    std::fill(std::begin(m_x2), std::end(m_x2), 0.0);
+    std::fill(std::begin(m_y1), std::end(m_y1), 0.0);
+    std::fill(std::begin(m_y2), std::end(m_y2), 0.0);
+}
+
+void NativeHighPassEffect::Process(float* const* channels, int numChannels, int numSamples) {
+    const ChannelPair b0(m_b0), b1(m_b1), b2(m_b2), a1(m_a1), a2(m_a2);
+
+    ForEachChannelPair(channels, numChannels, [&](int ch, float* a, float* b) {
+        ChannelPair x1 = ChannelPair::Load(m_x1 + ch);
+        ChannelPair x2 = ChannelPair::Load(m_x2 + ch);
+        ChannelPair y1 = ChannelPair::Load(m_y1 + ch);
+        ChannelPair y2 = ChannelPair::Load(m_y2 + ch);
+
+        for (int i = 0; i < numSamples; ++i) {
+            ChannelPair x = ChannelPair::Gather(a, b, i);
+            ChannelPair y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            y.Scatter(a, b, i);
+        }
+
+        x1.Store(m_x1 + ch);
+        x2.Store(m_x2 + ch);
+        y1.Store(m_y1 + ch);
+        y2.Store(m_y2 + ch);
+    });
+}
+
+// NativeDCRemoveEffect Implementation
+
+NativeDCRemoveEffect::NativeDCRemoveEffect() : NativeEffect(BuiltinJSFX::DC_REMOVE) {
+}
+
+void NativeDCRemoveEffect::Reset() {
+    std::fill(std::begin(m_x1), std::end(m_x1), 0.0);
+    std::fill(std::begin(m_y1), std::end(m_y1), 0.0);
+}
+
+void NativeDCRemoveEffect::Process(float* const* channels, int numChannels, int numSamples) {
+    // Fixed pole as in the script; its Cutoff slider is exposed but unused
+    const ChannelPair pole(0.995);
+
+    ForEachChannelPair(channels, numChannels, [&](int ch, float* a, float* b) {
+        ChannelPair x1 = ChannelPair::Load(m_x1 + ch);
+        ChannelPair y1 = ChannelPair::Load(m_y1 + ch);
+
+        for (int i = 0; i < numSamples; ++i) {
+            ChannelPair x = ChannelPair::Gather(a, b, i);
+            y1 = x - x1 + pole * y1;
+            x1 = x;
+            y1.Scatter(a, b, i);
+        }
+
+        x1.Store(m_x1 + ch);
+        y1.Store(m_y1 + ch);
+    });
+}
+
+// NativeConvolutionEffect Implementation
+
+NativeConvolutionEffect::NativeConvolutionEffect() : NativeEffect(BuiltinJSFX::CONVOLUTION_REVERB) {
+}
+
+void NativeConvolutionEffect::Initialize(double sampleRate, int maxBlockSize) {
+    for (auto& wet : m_wet) {
+        wet.assign(std::max(maxBlockSize, 1), 0.0f);
+    }
+
+    bool rateChanged = sampleRate != m_sampleRate;
+    NativeEffect::Initialize(sampleRate, maxBlockSize);
+    if (!m_sourceImpulse.empty() && (rateChanged || !m_impulse.Acquire())) {
+        BuildEngine();
+    }
+}
+
+bool NativeConvolutionEffect::LoadImpulseResponse(const std::vector<std::vector<float>>& channels, double sampleRate,
+                                                  const ConvolutionEngine::Settings& settings) {
+    if (channels.empty() || channels.size() > kChannels || sampleRate <= 0.0) {
+        return false;
+    }
+
+    m_sourceImpulse = channels;
+    m_sourceRate = sampleRate;
+    m_engineSettings = settings;
+    return !m_initialized || BuildEngine();
+}
+
+size_t NativeConvolutionEffect::GetImpulseLength() const {
+    const LoadedImpulse* impulse = m_impulse.Acquire();
+    return impulse ? impulse->engine->GetImpulseLength() : 0;
+}
+
+bool NativeConvolutionEffect::BuildEngine() {
+    // Linear resampling to the session rate; the r/R gain keeps the summed
+    // energy of the response independent of its rate
+    std::vector<std::vector<float>> response = m_sourceImpulse;
+    if (m_sourceRate != m_sampleRate) {
+        double step = m_sourceRate / m_sampleRate;
+        float gain = static_cast<float>(m_sampleRate > 0.0 ? step : 1.0);
+        for (size_t r = 0; r < m_sourceImpulse.size(); ++r) {
+            const auto& source = m_sourceImpulse[r];
+            size_t length = static_cast<size_t>(source.size() / step);
+            response[r].assign(length, 0.0f);
+            for (size_t i = 0; i < length; ++i) {
+                double position = i * step;
+                size_t index = static_cast<size_t>(position);
+                float frac = static_cast<float>(position - index);
+                float next = index + 1 < source.size() ? source[index + 1] : 0.0f;
+                response[r][i] = gain * (source[index] + frac * (next - source[index]));
+            }
+        }
+    }
+
+    auto engine = std::make_unique<ConvolutionEngine>();
+    if (!engine->Load(response, kChannels, m_engineSettings)) {
+        return false;
+    }
+    auto impulse = std::make_unique<LoadedImpulse>();
+    impulse->engine = std::move(engine);
+    m_impulse.Publish(std::move(impulse));
+    return true;
+}
+
+void NativeConvolutionEffect::UpdateParameters() {
+    m_wetGain = std::pow(10.0, GetSlider(0) / 20.0);
+    m_dryGain = std::pow(10.0, GetSlider(1) / 20.0);
+}
+
+void NativeConvolutionEffect::Reset() {
+    // Only reached from Initialize(), never concurrent with Process()
+    if (const LoadedImpulse* impulse = m_impulse.Acquire()) {
+        impulse->engine->Reset();
+    }
+}
+
+void NativeConvolutionEffect::Process(float* const* channels, int numChannels, int numSamples) {
+    const LoadedImpulse* impulse = m_impulse.Acquire();
+    int blockSize = static_cast<int>(m_wet[0].size());
+    numChannels = std::min(numChannels, static_cast<int>(kChannels));
+
+    if (!impulse || blockSize == 0) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            for (int i = 0; i < numSamples; ++i) {
+                channels[ch][i] = static_cast<float>(channels[ch][i] * m_dryGain);
+            }
+        }
+        m_impulse.EndBlock();
+        return;
+    }
+
+    const float wetGain = static_cast<float>(m_wetGain);
+    const float dryGain = static_cast<float>(m_dryGain);
+    for (int offset = 0; offset < numSamples; offset += blockSize) {
+        int count = std::min(blockSize, numSamples - offset);
+        const float* inputs[kChannels] = {channels[0] + offset, channels[numChannels - 1] + offset};
+        float* outputs[kChannels] = {m_wet[0].data(), m_wet[1].data()};
+        impulse->engine->Process(inputs, outputs, count);
+
+        if (numChannels == 1) {
+            float* samples = channels[0] + offset;
+            for (int i = 0; i < count; ++i) {
+                samples[i] = samples[i] * dryGain + 0.5f * (m_wet[0][i] + m_wet[1][i]) * wetGain;
+            }
+            continue;
+        }
+        for (int ch = 0; ch < kChannels; ++ch) {
+            float* samples = channels[ch] + offset;
+            const float* wet = m_wet[ch].data();
+            for (int i = 0; i < count; ++i) {
+                samples[i] = samples[i] * dryGain + wet[i] * wetGain;
+            }
+        }
+    }
+    m_impulse.EndBlock();
+}
+
+// NativeFDNReverbEffect Implementation
+
+namespace {
+    constexpr double kLongestLineSeconds = 0.1;     // At Size 1
+    constexpr double kShortestLineRatio = 0.3;
+    constexpr double kMaxDepthSeconds = 0.003;      // Modulation Depth slider maximum
+}
+
+NativeFDNReverbEffect::NativeFDNReverbEffect() : NativeEffect(BuiltinJSFX::FDN_REVERB) {
+}
+
+void NativeFDNReverbEffect::Initialize(double sampleRate, int maxBlockSize) {
+    int frames = 1;
+    while (frames < GetMaxDelayFrames(sampleRate)) frames <<= 1;
+    m_memory.assign(static_cast<size_t>(frames) * kMaxLines, 0.0f);
+    m_frameMask = frames - 1;
+
+    NativeEffect::Initialize(sampleRate, maxBlockSize);
+}
+
+int NativeFDNReverbEffect::GetMaxDelayFrames(double sampleRate) const {
+    // Longest line rounded up to a prime, plus modulation and interpolation
+    return static_cast<int>((kLongestLineSeconds + kMaxDepthSeconds) * sampleRate) + 64;
+}
+
+void NativeFDNReverbEffect::SetLineCount(int numLines) {
+    if (numLines == m_numLines) return;
+    m_numLines = numLines;
+    Reset();
+}
+
+void NativeFDNReverbEffect::UpdateParameters() {
+    SetLineCount(GetSlider(7) >= 0.5 ? 16 : 8);
+    m_hadamard = GetSlider(8) >= 0.5;
+
+    double decay = std::max(GetSlider(0), 0.01);
+    double longest = kLongestLineSeconds * GetSlider(1) * m_sampleRate;
+    double depth = GetSlider(3) * m_sampleRate / 1000.0;
+    double rate = GetSlider(4);
+    float scale = 1.0f / std::sqrt(static_cast<float>(m_numLines));
+
+    for (int line = 0; line < kMaxLines; ++line) {
+        if (line >= m_numLines) {
+            m_gain[line] = m_inLeft[line] = m_inRight[line] = m_outLeft[line] = m_outRight[line] = 0.0f;
+            continue;
+        }
+
+        // Geometric spread of mutually prime lengths
+        double position = static_cast<double>(line) / (m_numLines - 1);
+        double length = longest * std::pow(kShortestLineRatio, 1.0 - position);
+        int samples = NearestPrime(std::max(static_cast<int>(length), 8));
+        m_length[line] = static_cast<float>(samples);
+        m_depth[line] = static_cast<float>(std::min(depth, samples - 2.0));
+        m_gain[line] = static_cast<float>(std::pow(10.0, -3.0 * samples / (decay * m_sampleRate)));
+
+        // Slightly detuned LFOs so the lines do not move together
+        double angle = 2.0 * M_PI * rate * (1.0 + 0.5 * position) / m_sampleRate;
+        m_rotateSin[line] = static_cast<float>(std::sin(angle));
+        m_rotateCos[line] = static_cast<float>(std::cos(angle));
+
+        // Orthogonal sign patterns keep left and right decorrelated
+        auto sign = [](int bit) { return bit ? -1.0f : 1.0f; };
+        m_inLeft[line] = sign(line & 1) * scale;
+        m_inRight[line] = sign((line >> 1) & 1) * scale;
+        m_outLeft[line] = sign((line ^ (line >> 2)) & 1) * scale;
+        m_outRight[line] = sign(((line >> 1) ^ (line >> 2)) & 1) * scale;
+    }
+
+    m_damping = static_cast<float>(GetSlider(2));
+    m_wetGain = std::pow(10.0, GetSlider(5) / 20.0);
+    m_dryGain = std::pow(10.0, GetSlider(6) / 20.0);
+}
+
+void NativeFDNReverbEffect::Reset() {
+    std::fill(m_memory.begin(), m_memory.end(), 0.0f);
+    std::fill(std::begin(m_lowpass), std::end(m_lowpass), 0.0f);
+    for (int line = 0; line < kMaxLines; ++line) {
+        double phase = 2.0 * M_PI * line / m_numLines;
+        m_lfoSin[line] = static_cast<float>(std::sin(phase));
+        m_lfoCos[line] = static_cast<float>(std::cos(phase));
+    }
+    m_writeFrame = 0;
+}
+
+void NativeFDNReverbEffect::Process(float* const* channels, int numChannels, int numSamples) {
+    if (m_memory.empty() || numChannels < 1) return;
+
+    float* left = channels[0];
+    float* right = numChannels > 1 ? channels[1] : channels[0];
+    const int quads = m_numLines / 4;
+    const float frames = static_cast<float>(m_frameMask + 1);
+    const float wetGain = static_cast<float>(m_wetGain);
+    const float dryGain = static_cast<float>(m_dryGain);
+    const float normalise = 1.0f / std::sqrt(static_cast<float>(m_numLines));
+    const float householder = 2.0f / m_numLines;
+    const LineQuad damping(m_damping);
+
+    alignas(16) float delays[kMaxLines];
+    alignas(16) float delayed[kMaxLines];
+    float* memory = m_memory.data();
+
+    for (int i = 0; i < numSamples; ++i) {
+        // Advance the LFO phasors and derive each line's read delay
+        for (int q = 0; q < quads; ++q) {
+            int base = q * 4;
+            LineQuad s = LineQuad::Load(m_lfoSin + base);
+            LineQuad c = LineQuad::Load(m_lfoCos + base);
+            LineQuad rs = LineQuad::Load(m_rotateSin + base);
+            LineQuad rc = LineQuad::Load(m_rotateCos + base);
+            LineQuad nextSin = s * rc + c * rs;
+            (c * rc - s * rs).Store(m_lfoCos + base);
+            nextSin.Store(m_lfoSin + base);
+            (LineQuad::Load(m_length + base) + LineQuad::Load(m_depth + base) * nextSin).Store(delays + base);
+        }
+
+        // Interpolated reads are the only per-line scalar step
+        for (int line = 0; line < m_numLines; ++line) {
+            float position = m_writeFrame - delays[line];
+            if (position < 0.0f) position += frames;
+            int index = static_cast<int>(position);
+            float frac = position - index;
+            float a = memory[(index & m_frameMask) * kMaxLines + line];
+            float b = memory[((index + 1) & m_frameMask) * kMaxLines + line];
+            delayed[line] = a + frac * (b - a);
+        }
+
+        // Decay, damping and the stereo output taps
+        LineQuad lines[kMaxLines / 4] = {LineQuad(0.0f), LineQuad(0.0f), LineQuad(0.0f), LineQuad(0.0f)};
+        LineQuad sumLeft(0.0f), sumRight(0.0f);
+        for (int q = 0; q < quads; ++q) {
+            int base = q * 4;
+            LineQuad input = LineQuad::Load(delayed + base) * LineQuad::Load(m_gain + base);
+            LineQuad state = input + damping * (LineQuad::Load(m_lowpass + base) - input);
+            state.Store(m_lowpass + base);
+            lines[q] = state;
+            sumLeft = sumLeft + state * LineQuad::Load(m_outLeft + base);
+            sumRight = sumRight + state * LineQuad::Load(m_outRight + base);
+        }
+
+        // Lossless feedback matrix
+        if (m_hadamard) {
+            for (int q = 0; q < quads; ++q) {
+                lines[q] = lines[q].Hadamard();
+            }
+            for (int span = 1; span < quads; span <<= 1) {
+                for (int q = 0; q < quads; q += span * 2) {
+                    for (int j = q; j < q + span; ++j) {
+                        LineQuad a = lines[j], b = lines[j + span];
+                        lines[j] = a + b;
+                        lines[j + span] = a - b;
+                    }
+                }
+            }
+            for (int q = 0; q < quads; ++q) {
+                lines[q] = lines[q] * LineQuad(normalise);
+            }
+        } else {
+            float total = 0.0f;
+            for (int q = 0; q < quads; ++q) {
+                total += lines[q].Sum();
+            }
+            LineQuad reflect(total * householder);
+            for (int q = 0; q < quads; ++q) {
+                lines[q] = lines[q] - reflect;
+            }
+        }
+
+        // One frame of all lines is contiguous: whole-register writes
+        float inputLeft = left[i];
+        float inputRight = right[i];
+        LineQuad injectLeft(inputLeft), injectRight(inputRight);
+        float* frame = memory + m_writeFrame * kMaxLines;
+        for (int q = 0; q < quads; ++q) {
+            int base = q * 4;
+            (lines[q] + injectLeft * LineQuad::Load(m_inLeft + base) +
+             injectRight * LineQuad::Load(m_inRight + base)).Store(frame + base);
+        }
+        m_writeFrame = (m_writeFrame + 1) & m_frameMask;
+
+        float wetLeft = sumLeft.Sum();
+        float wetRight = sumRight.Sum();
+        if (numChannels > 1) {
+            left[i] = inputLeft * dryGain + wetLeft * wetGain;
+            right[i] = inputRight * dryGain + wetRight * wetGain;
+        } else {
+            left[i] = inputLeft * dryGain + 0.5f * (wetLeft + wetRight) * wetGain;
+        }
+    }
+
+    // Keep the phasors on the unit circle
+    for (int line = 0; line < m_numLines; ++line) {
+        float magnitude = std::sqrt(m_lfoSin[line] * m_lfoSin[line] + m_lfoCos[line] * m_lfoCos[line]);
+        m_lfoSin[line] /= magnitude;
+        m_lfoCos[line] /= magnitude;
+    }
+}
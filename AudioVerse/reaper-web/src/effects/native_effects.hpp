@@ -0,0 +1,262 @@
+/*
+ * REAPER Web - Native Built-in Effects
+ * C++ implementations of the built-in JSFX effects with SIMD filters
+ */
+
+#pragma once
+
+#include "../jsfx/jsfx_interpreter.hpp"
+#include "../core/realtime_snapshot.hpp"
+#include "convolution_engine.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Native Effect - built-in effect compiled to C++
+ * Takes its slider layout from the JSFX script it replaces, so presets,
+ * automation and the UI see the same parameters. Output matches the JSFX
+ * version to within float rounding; the script remains the reference.
+ * Filters keep per-channel state side by side and run two channels per
+ * SIMD register.
+ */
+class NativeEffect : public JSFXEffect {
+public:
+    static constexpr int kMaxChannels = 64;
+
+    explicit NativeEffect(const std::string& script);
+
+    void Initialize(double sampleRate, int maxBlockSize) override;
+    void SetTransport(const TempoMap::BlockCursor&, double) override {}
+
+    void SetParameter(int index, double value) override;
+    double GetParameter(int index) const override;
+
+    const JSFXInterpreter::ScriptInfo& GetInfo() const override { return m_program->GetScriptInfo(); }
+    bool IsNative() const override { return true; }
+
+protected:
+    // Equivalent of @slider: derive coefficients from the slider values
+    virtual void UpdateParameters() = 0;
+    // Clear filter and delay state
+    virtual void Reset() = 0;
+    virtual void Process(float* const* channels, int numChannels, int numSamples) = 0;
+
+    void RenderSample(double inputL, double inputR, double& outputL, double& outputR) override;
+    void RenderBlock(AudioBuffer& buffer) override;
+
+    double GetSlider(int index) const { return m_sliders[index]; }
+
+private:
+    std::shared_ptr<const JSFXProgram> m_program;     // Shared header metadata, never executed
+    std::vector<double> m_sliders;
+};
+
+class NativeGainEffect : public NativeEffect {
+public:
+    NativeGainEffect();
+
+protected:
+    void UpdateParameters() override;
+    void Reset() override {}
+    void Process(float* const* channels, int numChannels, int numSamples) override;
+
+private:
+    double m_gain = 1.0;
+};
+
+class NativeResonantLowpassEffect : public NativeEffect {
+public:
+    NativeResonantLowpassEffect();
+
+protected:
+    void UpdateParameters() override;
+    void Reset() override;
+    void Process(float* const* channels, int numChannels, int numSamples) override;
+
+private:
+    double m_cutoff = 0.0;
+    double m_feedback = 0.0;
+
+    // Two one-pole stages per channel (+1 lane for an odd channel count)
+    double m_stage1[kMaxChannels + 1] = {};
+    double m_stage2[kMaxChannels + 1] = {};
+};
+
+/**
+ * Native Delay - stereo like the JSFX version's pins; the delay line is
+ * allocated in Initialize() for the longest delay the slider allows.
+ */
+class NativeDelayEffect : public NativeEffect {
+public:
+    static constexpr int kChannels = 2;
+
+    NativeDelayEffect();
+    void Initialize(double sampleRate, int maxBlockSize) override;
+
+protected:
+    void UpdateParameters() override;
+    void Reset() override;
+    void Process(float* const* channels, int numChannels, int numSamples) override;
+
+private:
+    std::vector<float> m_buffer[kChannels];
+    int m_length = 1;                   // Delay in frames
+    int m_position = 0;
+    double m_feedback = 0.0;
+    double m_mixIn = 1.0;
+    double m_wetGain = 0.0;
+    double m_dryGain = 1.0;
+};
+
+class NativeCompressorEffect : public NativeEffect {
+public:
+    NativeCompressorEffect();
+
+protected:
+    void UpdateParameters() override;
+    void Reset() override { m_envelope = 0.0; }
+    void Process(float* const* channels, int numChannels, int numSamples) override;
+
+private:
+    double m_threshold = 1.0;
+    double m_ratio = 1.0;
+    double m_attack = 0.0;
+    double m_release = 0.0;
+    double m_makeup = 1.0;
+    double m_envelope = 0.0;            // Linked across all channels
+};
+
+class NativeHighPassEffect : public NativeEffect {
+public:
+    NativeHighPassEffect();
+
+protected:
+    void UpdateParameters() override;
+    void Reset() override;
+    void Process(float* const* channels, int numChannels, int numSamples) override;
+
+private:
+    double m_b0 = 1.0, m_b1 = 0.0, m_b2 = 0.0, m_a1 = 0.0, m_a2 = 0.0;
+
+    // Direct form I history per channel
+    double m_x1[kMaxChannels + 1] = {};
+    double m_x2[kMaxChannels + 1] = {};
+    double m_y1[kMaxChannels + 1] = {};
+    double m_y2[kMaxChannels + 1] = {};
+};
+
+class NativeDCRemoveEffect : public NativeEffect {
+public:
+    NativeDCRemoveEffect();
+
+protected:
+    void UpdateParameters() override {}
+    void Reset() override;
+    void Process(float* const* channels, int numChannels, int numSamples) override;
+
+private:
+    double m_x1[kMaxChannels + 1] = {};
+    double m_y1[kMaxChannels + 1] = {};
+};
+
+/**
+ * Native Convolution Reverb - native-only, there is no JSFX equivalent.
+ * Impulse responses are loaded off the audio thread, resampled to the
+ * session rate and partitioned into a new ConvolutionEngine, which is
+ * handed to the audio thread through a RealtimeSnapshot. Stereo like the
+ * delay; a mono input feeds both engine channels and gets their average.
+ */
+class NativeConvolutionEffect : public NativeEffect {
+public:
+    static constexpr int kChannels = 2;
+
+    NativeConvolutionEffect();
+
+    void Initialize(double sampleRate, int maxBlockSize) override;
+
+    // Non-realtime: one vector per response channel (mono or stereo) at
+    // 'sampleRate'. Before Initialize() the response is kept and loaded then.
+    bool LoadImpulseResponse(const std::vector<std::vector<float>>& channels, double sampleRate,
+                             const ConvolutionEngine::Settings& settings = {});
+
+    // Non-realtime: frees engines replaced by earlier loads
+    void CollectRetired() { m_impulse.CollectRetired(); }
+
+    // Length of the loaded response in samples at the session rate, 0 if none
+    size_t GetImpulseLength() const;
+
+protected:
+    void UpdateParameters() override;
+    void Reset() override;
+    void Process(float* const* channels, int numChannels, int numSamples) override;
+
+private:
+    struct LoadedImpulse {
+        std::unique_ptr<ConvolutionEngine> engine;
+    };
+
+    RealtimeSnapshot<LoadedImpulse> m_impulse;
+
+    // Response as supplied, kept for a later Initialize() at another rate
+    std::vector<std::vector<float>> m_sourceImpulse;
+    double m_sourceRate = 0.0;
+    ConvolutionEngine::Settings m_engineSettings;
+
+    std::vector<float> m_wet[kChannels];
+    double m_wetGain = 0.0;
+    double m_dryGain = 1.0;
+
+    bool BuildEngine();
+};
+
+/**
+ * Native FDN Reverb - native-only feedback delay network.
+ * 8 or 16 modulated delay lines are mixed by a Householder or normalised
+ * Hadamard matrix, both lossless, so the decay is set by per-line gains
+ * alone. Line state is processed four lines per SIMD register; the delay
+ * memory is interleaved by line so each sample writes whole registers.
+ */
+class NativeFDNReverbEffect : public NativeEffect {
+public:
+    static constexpr int kChannels = 2;
+    static constexpr int kMaxLines = 16;
+
+    NativeFDNReverbEffect();
+
+    void Initialize(double sampleRate, int maxBlockSize) override;
+
+protected:
+    void UpdateParameters() override;
+    void Reset() override;
+    void Process(float* const* channels, int numChannels, int numSamples) override;
+
+private:
+    int m_numLines = 16;
+    bool m_hadamard = true;
+
+    // Delay memory: frame-major, kMaxLines floats per frame
+    std::vector<float> m_memory;
+    int m_frameMask = 0;
+    int m_writeFrame = 0;
+
+    // Per-line state, padded to whole registers
+    alignas(16) float m_length[kMaxLines] = {};     // Delay in samples
+    alignas(16) float m_depth[kMaxLines] = {};      // Modulation depth in samples
+    alignas(16) float m_gain[kMaxLines] = {};       // Decay gain for one pass of the line
+    alignas(16) float m_lowpass[kMaxLines] = {};    // Damping filter state
+    alignas(16) float m_lfoSin[kMaxLines] = {};     // Quadrature LFO phasors
+    alignas(16) float m_lfoCos[kMaxLines] = {};
+    alignas(16) float m_rotateSin[kMaxLines] = {};
+    alignas(16) float m_rotateCos[kMaxLines] = {};
+    alignas(16) float m_inLeft[kMaxLines] = {};     // Input and output sign patterns
+    alignas(16) float m_inRight[kMaxLines] = {};
+    alignas(16) float m_outLeft[kMaxLines] = {};
+    alignas(16) float m_outRight[kMaxLines] = {};
+    float m_damping = 0.0f;
+    double m_wetGain = 0.0;
+    double m_dryGain = 1.0;
+
+    void SetLineCount(int numLines);
+    int GetMaxDelayFrames(double sampleRate) const;
+};
@@ -0,0 +1,239 @@
+/*
+ * REAPER Web - Oversampler Implementation
+ * Kaiser-windowed half-band FIRs in polyphase form with SIMD branch filters
+ */
+
+#include "oversampler.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace {
+    // Half-band branch length K per 2x step, first step first
+    constexpr int kStageHalfLengths[] = {16, 8, 6};
+    constexpr double kKaiserBeta = 8.0;             // About 80 dB stopband
+
+    float DotProduct(const float* a, const float* b, int count) {
+        int i = 0;
+        float sum = 0.0f;
+#if defined(__SSE__)
+        __m128 acc = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, acc);
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+        for (; i < count; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    // Zeroth-order modified Bessel function for the Kaiser window
+    double BesselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12) break;
+        }
+        return sum;
+    }
+}
+
+Oversampler::Oversampler(int factor, int numChannels, int maxBlockSize)
+    : m_factor(factor), m_numStages(0), m_numChannels(std::max(numChannels, 1)),
+      m_maxBlockSize(std::max(maxBlockSize, 1)) {
+    while ((1 << m_numStages) < factor && m_numStages < 3) m_numStages++;
+    m_factor = 1 << m_numStages;
+
+    // Round trip in top-rate samples: each step delays 2K-1 samples at its
+    // high rate, once going up and once coming down
+    int topDelay = 0;
+    for (int s = 0; s < m_numStages; ++s) {
+        HalfBand stage;
+        stage.halfLength = kStageHalfLengths[s];
+        std::vector<float> branch = DesignBranch(stage.halfLength);
+        int length = static_cast<int>(branch.size());
+        stage.upTaps.resize(length);
+        stage.downTaps.resize(length);
+        for (int i = 0; i < length; ++i) {
+            stage.upTaps[i] = 2.0f * branch[length - 1 - i];
+            stage.downTaps[i] = branch[length - 1 - i];
+        }
+        m_stages.push_back(std::move(stage));
+
+        topDelay += 2 * (2 * kStageHalfLengths[s] - 1) * (m_factor >> (s + 1));
+    }
+    m_paddingLength = (m_factor - topDelay % m_factor) % m_factor;
+    m_latency = (topDelay + m_paddingLength) / m_factor;
+
+    m_channels.resize(m_numChannels);
+    for (auto& channel : m_channels) {
+        for (const auto& stage : m_stages) {
+            History history;
+            history.samples.assign(stage.halfLength * 4, 0.0f);
+            channel.upHistory.push_back(history);
+            channel.downEven.push_back(history);
+            channel.downOdd.push_back(history);
+        }
+        channel.padding.assign(std::max(m_paddingLength, 1), 0.0f);
+        channel.bypassDelay.assign(std::max(m_latency, 1), 0.0f);
+    }
+
+    m_buffer.SetSize(m_numChannels, m_maxBlockSize * m_factor);
+    for (auto& scratch : m_scratch) {
+        scratch.assign(m_maxBlockSize * m_factor, 0.0f);
+    }
+}
+
+std::vector<float> Oversampler::DesignBranch(int halfLength) {
+    // Half-band prototype of 4K-1 taps centred on 2K-1. Taps an even distance
+    // from the centre are zero, so the even-indexed taps form the FIR branch
+    // and the centre tap (1/2) is the delay branch.
+    int length = 4 * halfLength - 1;
+    int centre = 2 * halfLength - 1;
+    double norm = BesselI0(kKaiserBeta);
+
+    std::vector<double> taps(2 * halfLength);
+    double sum = 0.0;
+    for (int j = 0; j < 2 * halfLength; ++j) {
+        int offset = 2 * j - centre;
+        double ideal = std::sin(M_PI * offset / 2.0) / (M_PI * offset);
+        double ratio = 2.0 * (2 * j) / (length - 1) - 1.0;
+        double window = BesselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / norm;
+        taps[j] = ideal * window;
+        sum += taps[j];
+    }
+
+    // Unity gain at DC: the branch sums to 1/2, as the centre tap does
+    std::vector<float> branch(taps.size());
+    for (size_t j = 0; j < taps.size(); ++j) {
+        branch[j] = static_cast<float>(taps[j] * 0.5 / sum);
+    }
+    return branch;
+}
+
+const float* Oversampler::History::Push(float value, int length) {
+    samples[position] = value;
+    samples[position + length] = value;
+    position = (position + 1 == length) ? 0 : position + 1;
+    return samples.data() + position;
+}
+
+void Oversampler::Reset() {
+    for (auto& channel : m_channels) {
+        for (auto* histories : {&channel.upHistory, &channel.downEven, &channel.downOdd}) {
+            for (auto& history : *histories) {
+                std::fill(history.samples.begin(), history.samples.end(), 0.0f);
+                history.position = 0;
+            }
+        }
+        std::fill(channel.padding.begin(), channel.padding.end(), 0.0f);
+        std::fill(channel.bypassDelay.begin(), channel.bypassDelay.end(), 0.0f);
+        channel.paddingPosition = 0;
+        channel.bypassPosition = 0;
+    }
+}
+
+void Oversampler::UpsampleStage(const HalfBand& stage, History& history, const float* input, float* output,
+                                int numSamples) {
+    // Even outputs from the FIR branch, odd outputs from the delay branch
+    int length = stage.halfLength * 2;
+    const float* taps = stage.upTaps.data();
+    for (int i = 0; i < numSamples; ++i) {
+        const float* window = history.Push(input[i], length);
+        output[i * 2] = DotProduct(taps, window, length);
+        output[i * 2 + 1] = window[stage.halfLength];
+    }
+}
+
+void Oversampler::DownsampleStage(const HalfBand& stage, History& even, History& odd, const float* input,
+                                  float* output, int numSamples) {
+    int length = stage.halfLength * 2;
+    const float* taps = stage.downTaps.data();
+    for (int i = 0; i < numSamples; ++i) {
+        const float* evenWindow = even.Push(input[i * 2], length);
+        const float* oddWindow = odd.samples.data() + odd.position;
+        output[i] = DotProduct(taps, evenWindow, length) + 0.5f * oddWindow[stage.halfLength];
+        odd.Push(input[i * 2 + 1], length);
+    }
+}
+
+AudioBuffer& Oversampler::Upsample(const AudioBuffer& input) {
+    int numSamples = input.GetSampleCount();
+    int topSamples = numSamples * m_factor;
+    if (numSamples > m_maxBlockSize) {
+        // Longer than promised: correct, but allocates on this thread
+        m_maxBlockSize = numSamples;
+        for (auto& scratch : m_scratch) {
+            scratch.resize(topSamples);
+        }
+    }
+    m_buffer.SetSize(m_numChannels, topSamples);
+
+    int channels = std::min(input.GetChannelCount(), m_numChannels);
+    for (int ch = 0; ch < m_numChannels; ++ch) {
+        float* top = m_buffer.GetChannelData(ch);
+        if (ch >= channels) {
+            std::fill(top, top + topSamples, 0.0f);
+            continue;
+        }
+
+        ChannelState& state = m_channels[ch];
+        const float* source = input.GetChannelData(ch);
+        int length = numSamples;
+        for (int s = 0; s < m_numStages; ++s) {
+            float* target = (s == m_numStages - 1) ? top : m_scratch[s % 2].data();
+            UpsampleStage(m_stages[s], state.upHistory[s], source, target, length);
+            source = target;
+            length *= 2;
+        }
+
+        if (m_paddingLength > 0) {
+            for (int i = 0; i < topSamples; ++i) {
+                float delayed = state.padding[state.paddingPosition];
+                state.padding[state.paddingPosition] = top[i];
+                if (++state.paddingPosition == m_paddingLength) state.paddingPosition = 0;
+                top[i] = delayed;
+            }
+        }
+    }
+    return m_buffer;
+}
+
+void Oversampler::Downsample(AudioBuffer& output) {
+    int numSamples = output.GetSampleCount();
+    int channels = std::min(output.GetChannelCount(), m_numChannels);
+
+    for (int ch = 0; ch < channels; ++ch) {
+        ChannelState& state = m_channels[ch];
+        const float* source = m_buffer.GetChannelData(ch);
+        int length = numSamples * m_factor / 2;
+        for (int s = m_numStages - 1; s >= 0; --s) {
+            float* target = (s == 0) ? output.GetChannelData(ch) : m_scratch[s % 2].data();
+            DownsampleStage(m_stages[s], state.downEven[s], state.downOdd[s], source, target, length);
+            source = target;
+            length /= 2;
+        }
+    }
+}
+
+void Oversampler::ProcessBypassed(AudioBuffer& buffer) {
+    int channels = std::min(buffer.GetChannelCount(), m_numChannels);
+    for (int ch = 0; ch < channels; ++ch) {
+        ChannelState& state = m_channels[ch];
+        float* samples = buffer.GetChannelData(ch);
+        for (int i = 0; i < buffer.GetSampleCount(); ++i) {
+            float delayed = state.bypassDelay[state.bypassPosition];
+            state.bypassDelay[state.bypassPosition] = samples[i];
+            if (++state.bypassPosition == m_latency) state.bypassPosition = 0;
+            samples[i] = delayed;
+        }
+    }
+}
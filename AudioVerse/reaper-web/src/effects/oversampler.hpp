@@ -0,0 +1,87 @@
+/*
+ * REAPER Web - Oversampler
+ * Cascaded polyphase half-band resampling for running effects at 2x/4x/8x
+ */
+
+#pragma once
+
+#include "../core/audio_buffer.hpp"
+#include <vector>
+
+/**
+ * Oversampler - runs a block at 'factor' times the session rate
+ *
+ * Each 2x step is a linear-phase half-band FIR in polyphase form: one
+ * branch is a symmetric FIR, the other a pure delay, so only half the taps
+ * are ever multiplied. The first step has the longest filter; later steps
+ * only need to reject images of an already band-limited signal and get
+ * shorter. A top-rate padding delay makes the round trip a whole number of
+ * session-rate samples, which is what GetLatencySamples() reports for PDC.
+ */
+class Oversampler {
+public:
+    static constexpr int kMaxFactor = 8;
+
+    // factor: 2, 4 or 8. Allocates everything the audio thread will use.
+    Oversampler(int factor, int numChannels, int maxBlockSize);
+
+    int GetFactor() const { return m_factor; }
+    int GetNumChannels() const { return m_numChannels; }
+    int GetLatencySamples() const { return m_latency; }
+
+    // Clears filter and delay state; not concurrent with processing
+    void Reset();
+
+    // Audio thread: upsamples 'input' into the internal buffer and returns
+    // it, sized to the input's sample count times the factor
+    AudioBuffer& Upsample(const AudioBuffer& input);
+
+    // Audio thread: downsamples the internal buffer back into 'output'
+    void Downsample(AudioBuffer& output);
+
+    // Audio thread: delays 'buffer' by the latency, for a bypassed effect
+    // that must keep its place in the compensated timeline
+    void ProcessBypassed(AudioBuffer& buffer);
+
+private:
+    struct HalfBand {
+        int halfLength = 0;                 // K: branch has 2K taps, delay is 2K-1 at the high rate
+        std::vector<float> upTaps;          // Branch taps reversed, times 2 for interpolation gain
+        std::vector<float> downTaps;        // Branch taps reversed
+    };
+
+    // Branch history: 2K samples written twice so every window is contiguous
+    struct History {
+        std::vector<float> samples;
+        int position = 0;
+
+        const float* Push(float value, int length);
+    };
+
+    struct ChannelState {
+        std::vector<History> upHistory;     // Per stage
+        std::vector<History> downEven;
+        std::vector<History> downOdd;
+        std::vector<float> padding;         // Top-rate delay ring
+        int paddingPosition = 0;
+        std::vector<float> bypassDelay;     // Session-rate delay ring
+        int bypassPosition = 0;
+    };
+
+    int m_factor;
+    int m_numStages;
+    int m_numChannels;
+    int m_maxBlockSize;
+    int m_paddingLength = 0;
+    int m_latency = 0;
+
+    std::vector<HalfBand> m_stages;
+    std::vector<ChannelState> m_channels;
+    AudioBuffer m_buffer;                   // Top-rate block handed to the effect
+    std::vector<float> m_scratch[2];        // Intermediate stages
+
+    static std::vector<float> DesignBranch(int halfLength);
+    void UpsampleStage(const HalfBand& stage, History& history, const float* input, float* output, int numSamples);
+    void DownsampleStage(const HalfBand& stage, History& even, History& odd, const float* input, float* output,
+                         int numSamples);
+};
@@ -4,6 +4,7 @@
  */
 
 #include "reaper_effects.hpp"
+#include "native_effects.hpp"
 #include <map>
 
 BuiltinEffectsManager::BuiltinEffectsManager() {
@@ -21,9 +22,28 @@ void BuiltinEffectsManager::RegisterBuiltinEffects() {
     m_effectScripts["Simple Compressor"] = BuiltinJSFX::SIMPLE_COMPRESSOR;
     m_effectScripts["High Pass Filter"] = BuiltinJSFX::HIGH_PASS;
     m_effectScripts["DC Remove"] = BuiltinJSFX::DC_REMOVE;
+    
+    // Native implementations with the same slider layout
+    m_nativeEffects["Simple Gain"] = [] { return std::make_unique<NativeGainEffect>(); };
+    m_nativeEffects["Resonant Lowpass"] = [] { return std::make_unique<NativeResonantLowpassEffect>(); };
+    m_nativeEffects["Simple Delay"] = [] { return std::make_unique<NativeDelayEffect>(); };
+    m_nativeEffects["Simple Compressor"] = [] { return std::make_unique<NativeCompressorEffect>(); };
+    m_nativeEffects["High Pass Filter"] = [] { return std::make_unique<NativeHighPassEffect>(); };
+    m_nativeEffects["DC Remove"] = [] { return std::make_unique<NativeDCRemoveEffect>(); };
+    
+    // Native-only effects
+    m_nativeEffects["Convolution Reverb"] = [] { return std::make_unique<NativeConvolutionEffect>(); };
+    m_nativeEffects["FDN Reverb"] = [] { return std::make_unique<NativeFDNReverbEffect>(); };
 }
 
-std::unique_ptr<JSFXEffect> BuiltinEffectsManager::CreateEffect(const std::string& effectName) {
+std::unique_ptr<JSFXEffect> BuiltinEffectsManager::CreateEffect(const std::string& effectName, bool preferNative) {
+    if (preferNative) {
+        auto native = m_nativeEffects.find(effectName);
+        if (native != m_nativeEffects.end()) {
+            return native->second();
+        }
+    }
+    
     auto it = m_effectScripts.find(effectName);
     if (it == m_effectScripts.end()) {
         return nullptr;
@@ -31,18 +51,27 @@ std::unique_ptr<JSFXEffect> BuiltinEffectsManager::CreateEffect(const std::strin
     
     // Create JSFX effect from script
     auto effect = std::make_unique<JSFXEffect>();
-    if (!effect->LoadFromScript(it->second)) {
+    if (!effect->LoadEffect(it->second)) {
         return nullptr;
     }
     
     return effect;
 }
 
+bool BuiltinEffectsManager::HasNativeEffect(const std::string& effectName) const {
+    return m_nativeEffects.find(effectName) != m_nativeEffects.end();
+}
+
 std::vector<std::string> BuiltinEffectsManager::GetAvailableEffects() const {
     std::vector<std::string> effects;
     for (const auto& pair : m_effectScripts) {
         effects.push_back(pair.first);
     }
+    for (const auto& pair : m_nativeEffects) {
+        if (m_effectScripts.find(pair.first) == m_effectScripts.end()) {
+            effects.push_back(pair.first);
+        }
+    }
     return effects;
 }
 
@@ -73,6 +102,13 @@ std::vector<std::string> BuiltinEffectsManager::GetUtilityEffects() const {
     };
 }
 
+std::vector<std::string> BuiltinEffectsManager::GetReverbEffects() const {
+    return {
+        "Convolution Reverb",
+        "FDN Reverb"
+    };
+}
+
 std::string BuiltinEffectsManager::GetEffectScript(const std::string& effectName) const {
     auto it = m_effectScripts.find(effectName);
     if (it != m_effectScripts.end()) {
@@ -6,13 +6,17 @@
 #pragma once
 
 #include "../jsfx/jsfx_interpreter.hpp"
+#include <functional>
+#include <map>
 #include <memory>
 #include <vector>
 #include <string>
 
 /**
  * Built-in Effects Manager - Provides access to REAPER's standard effects
- * Implements classic effects using JSFX scripts for compatibility
+ * Implements classic effects using JSFX scripts for compatibility.
+ * Effects with a native C++ implementation (native_effects.hpp) are created
+ * natively by default; the JSFX script stays available as the reference.
  */
 class BuiltinEffectsManager {
 public:
@@ -20,7 +24,8 @@ public:
     ~BuiltinEffectsManager();
     
     // Effect creation
-    std::unique_ptr<JSFXEffect> CreateEffect(const std::string& effectName);
+    std::unique_ptr<JSFXEffect> CreateEffect(const std::string& effectName, bool preferNative = true);
+    bool HasNativeEffect(const std::string& effectName) const;
     std::vector<std::string> GetAvailableEffects() const;
     
     // Effect categories
@@ -28,13 +33,17 @@ public:
     std::vector<std::string> GetFilterEffects() const;
     std::vector<std::string> GetDelayEffects() const;
     std::vector<std::string> GetUtilityEffects() const;
+    std::vector<std::string> GetReverbEffects() const;
     
-    // JSFX script loading
+    // JSFX script loading; empty for native-only effects
     std::string GetEffectScript(const std::string& effectName) const;
     
 private:
+    using NativeFactory = std::function<std::unique_ptr<JSFXEffect>()>;
+    
     void RegisterBuiltinEffects();
     std::map<std::string, std::string> m_effectScripts;
+    std::map<std::string, NativeFactory> m_nativeEffects;
 };
 
 // Built-in effect JSFX scripts - based on REAPER's actual effects
@@ -108,7 +117,8 @@ wet_gain = db2gain(slider4);
 dry_gain = db2gain(slider5);
 
 @sample
-delaypos >= delaylen ? delaypos = 0;
+// Two memory slots (left, right) per delayed frame
+delaypos >= delaylen * 2 ? delaypos = 0;
 
 // Read from delay buffer
 delayed_l = delaypos[0];
@@ -230,4 +240,37 @@ x_r = spl1;
 spl1 = y_r;
 )";
 
+// Convolution Reverb - slider layout only. Processing is native
+// (NativeConvolutionEffect); there is no JSFX implementation.
+constexpr const char* CONVOLUTION_REVERB = R"(
+desc:Convolution Reverb
+slider1:-6<-120,12,0.1>Wet (dB)
+slider2:0<-120,12,0.1>Dry (dB)
+
+in_pin:left input
+in_pin:right input
+out_pin:left output
+out_pin:right output
+)";
+
+// FDN Reverb - slider layout only. Processing is native
+// (NativeFDNReverbEffect); there is no JSFX implementation.
+constexpr const char* FDN_REVERB = R"(
+desc:FDN Reverb
+slider1:2.5<0.1,20,0.1>Decay (s)
+slider2:0.7<0.1,1,0.01>Size
+slider3:0.4<0,0.95,0.01>Damping
+slider4:0.5<0,3,0.01>Modulation Depth (ms)
+slider5:0.7<0.05,5,0.01>Modulation Rate (Hz)
+slider6:-12<-120,12,0.1>Wet (dB)
+slider7:0<-120,12,0.1>Dry (dB)
+slider8:1<0,1,1{8,16}>Delay Lines
+slider9:1<0,1,1{Householder,Hadamard}>Mixing Matrix
+
+in_pin:left input
+in_pin:right input
+out_pin:left output
+out_pin:right output
+)";
+
 } // namespace BuiltinJSFX
\ No newline at end of file
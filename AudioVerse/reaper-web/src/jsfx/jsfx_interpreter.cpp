@@ -9,41 +9,66 @@
 #include <algorithm>
 #include <chrono>
 #include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <unordered_set>
 #include <regex>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 // JSFXVariable Implementation
-JSFXVariable& JSFXVariable::operator[](int index) {
+JSFXVariable& JSFXVariable::operator[](int) {
     // This would access global memory space - simplified for now
     static JSFXVariable dummy;
     return dummy;
 }
 
-const JSFXVariable& JSFXVariable::operator[](int index) const {
+const JSFXVariable& JSFXVariable::operator[](int) const {
     static JSFXVariable dummy;
     return dummy;
 }
 
 // JSFXMemory Implementation
 JSFXMemory::JSFXMemory() : m_nextFreeAddress(0) {
-    m_memory.resize(MEMORY_SIZE);
 }
 
 JSFXMemory::~JSFXMemory() = default;
 
 JSFXVariable& JSFXMemory::GetVariable(int address) {
-    if (address >= 0 && address < MEMORY_SIZE) {
-        return m_memory[address];
+    if (address >= 0 && address < MEMORY_SIZE && m_pages[address / PAGE_SIZE]) {
+        return m_pages[address / PAGE_SIZE][address % PAGE_SIZE];
     }
-    static JSFXVariable dummy;
-    return dummy;
+    m_scratch = 0.0;
+    return m_scratch;
 }
 
 const JSFXVariable& JSFXMemory::GetVariable(int address) const {
-    if (address >= 0 && address < MEMORY_SIZE) {
-        return m_memory[address];
+    static const JSFXVariable zero;
+    if (address >= 0 && address < MEMORY_SIZE && m_pages[address / PAGE_SIZE]) {
+        return m_pages[address / PAGE_SIZE][address % PAGE_SIZE];
+    }
+    return zero;
+}
+
+double JSFXMemory::Read(int address) const {
+    if (address >= 0 && address < MEMORY_SIZE && m_pages[address / PAGE_SIZE]) {
+        return m_pages[address / PAGE_SIZE][address % PAGE_SIZE].GetValue();
+    }
+    return 0.0;
+}
+
+int JSFXMemory::GetAllocatedPageCount() const {
+    return static_cast<int>(std::count_if(std::begin(m_pages), std::end(m_pages),
+                                          [](const std::unique_ptr<JSFXVariable[]>& page) { return page != nullptr; }));
+}
+
+void JSFXMemory::AllocatePages() {
+    for (auto& page : m_pages) {
+        if (!page) page = std::make_unique<JSFXVariable[]>(PAGE_SIZE);
     }
-    static JSFXVariable dummy;
-    return dummy;
 }
 
 void JSFXMemory::AllocateArray(const std::string& name, int size) {
@@ -75,14 +100,18 @@ void JSFXMemory::SetNamedVariable(const std::string& name, double value) {
 }
 
 void JSFXMemory::Clear() {
-    std::fill(m_memory.begin(), m_memory.end(), JSFXVariable(0.0));
+    for (auto& page : m_pages) {
+        if (page) std::fill(page.get(), page.get() + PAGE_SIZE, JSFXVariable(0.0));
+    }
 }
 
 void JSFXMemory::Reset() {
     m_namedVariables.clear();
     m_arrays.clear();
     m_nextFreeAddress = 0;
-    Clear();
+    for (auto& page : m_pages) {
+        page.reset();
+    }
 }
 
 // JSFXBuiltins Implementation
@@ -159,6 +188,25 @@ std::string JSFXBuiltins::sprintf(const std::string& format, const std::vector<d
 // JSFXLexer Implementation
 JSFXLexer::JSFXLexer(const std::string& source) 
     : m_source(source), m_position(0), m_line(1), m_column(1) {
+    SkipHeader();
+}
+
+void JSFXLexer::SkipHeader() {
+    // desc:/slider:/pin lines are metadata (see ParseScriptInfo); code starts at
+    // the first @section. Sources without sections are code from the first line.
+    size_t lineStart = 0;
+    int line = 1;
+    while (lineStart < m_source.length()) {
+        if (m_source[lineStart] == '@') {
+            m_position = lineStart;
+            m_line = line;
+            return;
+        }
+        size_t lineEnd = m_source.find('\n', lineStart);
+        if (lineEnd == std::string::npos) break;
+        lineStart = lineEnd + 1;
+        line++;
+    }
 }
 
 JSFXToken JSFXLexer::NextToken() {
@@ -172,11 +220,13 @@ JSFXToken JSFXLexer::NextToken() {
     
     // Comments
     if (c == '/' && PeekChar() == '/') {
+        // The newline is left for the next token so line numbers stay right
+        int startCol = m_column - 1;
         std::string comment;
-        while (m_position < m_source.length() && GetChar() != '\n') {
-            comment += m_source[m_position - 1];
+        while (m_position < m_source.length() && m_source[m_position] != '\n') {
+            comment += GetChar();
         }
-        return {JSFXTokenType::COMMENT, comment, m_line, m_column};
+        return {JSFXTokenType::COMMENT, comment, m_line, startCol};
     }
     
     // Newlines
@@ -186,9 +236,21 @@ JSFXToken JSFXLexer::NextToken() {
         return {JSFXTokenType::NEWLINE, "\n", m_line - 1, m_column};
     }
     
+    // Named constants
+    if (c == '$' && IsAlpha(PeekChar())) {
+        int startCol = m_column - 1;
+        std::string name = ReadIdentifier().value;
+        std::string value = "0";
+        if (name == "pi") value = "3.14159265358979323846";
+        else if (name == "e") value = "2.71828182845904523536";
+        else if (name == "phi") value = "1.61803398874989484820";
+        return {JSFXTokenType::NUMBER, value, m_line, startCol};
+    }
+    
     // Numbers
     if (IsDigit(c) || (c == '.' && IsDigit(PeekChar()))) {
         m_position--; // Back up to re-read the digit
+        m_column--;
         return ReadNumber();
     }
     
@@ -200,6 +262,7 @@ JSFXToken JSFXLexer::NextToken() {
     // Identifiers and keywords
     if (IsAlpha(c) || c == '_' || c == '@') {
         m_position--; // Back up to re-read the character
+        m_column--;
         return ReadIdentifier();
     }
     
@@ -259,7 +322,9 @@ JSFXToken JSFXLexer::ReadNumber() {
     
     while (m_position < m_source.length()) {
         char c = m_source[m_position];
-        if (IsDigit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+        bool exponentSign = (c == '+' || c == '-') && !number.empty() &&
+                            (number.back() == 'e' || number.back() == 'E');
+        if (IsDigit(c) || c == '.' || c == 'e' || c == 'E' || exponentSign) {
             number += GetChar();
         } else {
             break;
@@ -302,7 +367,8 @@ JSFXToken JSFXLexer::ReadIdentifier() {
     
     while (m_position < m_source.length()) {
         char c = m_source[m_position];
-        if (IsAlphaNumeric(c) || c == '_' || c == '@') {
+        // '.' joins namespaces: lp.freq, this.state, lp.init(...)
+        if (IsAlphaNumeric(c) || c == '_' || c == '@' || (c == '.' && !identifier.empty())) {
             identifier += GetChar();
         } else {
             break;
@@ -386,13 +452,28 @@ void JSFXParser::Expect(JSFXTokenType type) {
     Consume();
 }
 
+std::unique_ptr<JSFXNode> JSFXParser::MakeNode(JSFXNodeType type, const std::string& value) const {
+    return MakeNode(type, value, m_currentToken);
+}
+
+std::unique_ptr<JSFXNode> JSFXParser::MakeNode(JSFXNodeType type, const std::string& value, const JSFXToken& at) const {
+    auto node = std::make_unique<JSFXNode>(type, value);
+    node->line = at.line;
+    node->column = at.column;
+    return node;
+}
+
 std::unique_ptr<JSFXNode> JSFXParser::ParseProgram() {
-    auto program = std::make_unique<JSFXNode>(JSFXNodeType::PROGRAM);
+    auto program = MakeNode(JSFXNodeType::PROGRAM);
     
     while (m_currentToken.type != JSFXTokenType::END_OF_FILE) {
         if (m_currentToken.type == JSFXTokenType::IDENTIFIER && 
             m_currentToken.value[0] == '@') {
             program->AddChild(ParseSection());
+        } else if (m_currentToken.type == JSFXTokenType::KEYWORD && m_currentToken.value == "function") {
+            ParseFunctionDefinition();
+        } else if (IsStatementSeparator()) {
+            Consume();
         } else {
             program->AddChild(ParseStatement());
         }
@@ -402,12 +483,20 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseProgram() {
 }
 
 std::unique_ptr<JSFXNode> JSFXParser::ParseSection() {
-    auto section = std::make_unique<JSFXNode>(JSFXNodeType::SECTION, m_currentToken.value);
+    auto section = MakeNode(JSFXNodeType::SECTION, m_currentToken.value);
     Consume(); // Consume section name (@init, @slider, etc.)
     
     // Parse statements until next section or EOF
     while (m_currentToken.type != JSFXTokenType::END_OF_FILE &&
            !(m_currentToken.type == JSFXTokenType::IDENTIFIER && m_currentToken.value[0] == '@')) {
+        if (IsStatementSeparator()) {
+            Consume();
+            continue;
+        }
+        if (m_currentToken.type == JSFXTokenType::KEYWORD && m_currentToken.value == "function") {
+            ParseFunctionDefinition();
+            continue;
+        }
         section->AddChild(ParseStatement());
     }
     
@@ -420,6 +509,11 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseStatement() {
             return ParseIfStatement();
         } else if (m_currentToken.value == "while") {
             return ParseWhileLoop();
+        } else if (m_currentToken.value == "function") {
+            // Nested in a block: defined all the same, evaluates to 0
+            auto placeholder = MakeNode(JSFXNodeType::NUMBER, "0");
+            ParseFunctionDefinition();
+            return placeholder;
         }
     }
     
@@ -431,15 +525,19 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseExpression() {
     return ParseAssignment();
 }
 
+bool JSFXParser::IsStatementSeparator() const {
+    return m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == ";";
+}
+
 std::unique_ptr<JSFXNode> JSFXParser::ParseAssignment() {
-    auto left = ParseBinaryOp();
+    auto left = ParseConditional();
     
     if (m_currentToken.type == JSFXTokenType::OPERATOR && 
         (m_currentToken.value == "=" || m_currentToken.value == "+=" || 
          m_currentToken.value == "-=" || m_currentToken.value == "*=" || 
          m_currentToken.value == "/=")) {
         
-        auto assignment = std::make_unique<JSFXNode>(JSFXNodeType::ASSIGNMENT, m_currentToken.value);
+        auto assignment = MakeNode(JSFXNodeType::ASSIGNMENT, m_currentToken.value);
         Consume();
         
         assignment->AddChild(std::move(left));
@@ -451,25 +549,55 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseAssignment() {
     return left;
 }
 
-std::unique_ptr<JSFXNode> JSFXParser::ParseBinaryOp() {
+std::unique_ptr<JSFXNode> JSFXParser::ParseConditional() {
+    auto condition = ParseBinaryOp();
+    
+    // cond ? a : b, or cond ? a; branches may assign (x >= len ? x = 0;)
+    if (m_currentToken.type == JSFXTokenType::OPERATOR && m_currentToken.value == "?") {
+        auto ifStmt = MakeNode(JSFXNodeType::IF_STATEMENT);
+        Consume();
+        
+        ifStmt->AddChild(std::move(condition));
+        ifStmt->AddChild(ParseAssignment());
+        
+        if (m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == ":") {
+            Consume();
+            ifStmt->AddChild(ParseAssignment());
+        }
+        return ifStmt;
+    }
+    
+    return condition;
+}
+
+int JSFXParser::GetBinaryPrecedence(const std::string& op) {
+    if (op == "||") return 1;
+    if (op == "&&") return 2;
+    if (op == "==" || op == "!=" || op == "<" || op == ">" || op == "<=" || op == ">=") return 3;
+    if (op == "+" || op == "-") return 4;
+    if (op == "*" || op == "/" || op == "%") return 5;
+    if (op == "^") return 6;
+    return 0;
+}
+
+std::unique_ptr<JSFXNode> JSFXParser::ParseBinaryOp(int minPrecedence) {
     auto left = ParseUnaryOp();
     
+    // Precedence climbing; all binary operators are left-associative
     while (m_currentToken.type == JSFXTokenType::OPERATOR) {
         std::string op = m_currentToken.value;
-        if (op == "+" || op == "-" || op == "*" || op == "/" || 
-            op == "==" || op == "!=" || op == "<" || op == ">" ||
-            op == "<=" || op == ">=" || op == "&&" || op == "||") {
-            
-            auto binaryOp = std::make_unique<JSFXNode>(JSFXNodeType::BINARY_OP, op);
-            Consume();
-            
-            binaryOp->AddChild(std::move(left));
-            binaryOp->AddChild(ParseUnaryOp());
-            
-            left = std::move(binaryOp);
-        } else {
+        int precedence = GetBinaryPrecedence(op);
+        if (precedence == 0 || precedence < minPrecedence) {
             break;
         }
+        
+        auto binaryOp = MakeNode(JSFXNodeType::BINARY_OP, op);
+        Consume();
+        
+        binaryOp->AddChild(std::move(left));
+        binaryOp->AddChild(ParseBinaryOp(precedence + 1));
+        
+        left = std::move(binaryOp);
     }
     
     return left;
@@ -479,7 +607,7 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseUnaryOp() {
     if (m_currentToken.type == JSFXTokenType::OPERATOR && 
         (m_currentToken.value == "-" || m_currentToken.value == "!" || m_currentToken.value == "+")) {
         
-        auto unaryOp = std::make_unique<JSFXNode>(JSFXNodeType::UNARY_OP, m_currentToken.value);
+        auto unaryOp = MakeNode(JSFXNodeType::UNARY_OP, m_currentToken.value);
         Consume();
         
         unaryOp->AddChild(ParsePrimary());
@@ -489,14 +617,13 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseUnaryOp() {
     return ParsePrimary();
 }
 
-std::unique_ptr<JSFXNode> JSFXParser::ParseFunctionCall() {
-    auto functionCall = std::make_unique<JSFXNode>(JSFXNodeType::FUNCTION_CALL, m_currentToken.value);
-    Consume(); // Consume function name
-    
+std::unique_ptr<JSFXNode> JSFXParser::ParseFunctionCall(const JSFXToken& name) {
+    auto functionCall = MakeNode(JSFXNodeType::FUNCTION_CALL, name.value, name);
     Expect(JSFXTokenType::PUNCTUATION); // '('
     
     // Parse arguments
     while (m_currentToken.type != JSFXTokenType::PUNCTUATION || m_currentToken.value != ")") {
+        if (m_currentToken.type == JSFXTokenType::END_OF_FILE) break;
         functionCall->AddChild(ParseExpression());
         
         if (m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == ",") {
@@ -511,31 +638,29 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseFunctionCall() {
 
 std::unique_ptr<JSFXNode> JSFXParser::ParsePrimary() {
     if (m_currentToken.type == JSFXTokenType::NUMBER) {
-        auto number = std::make_unique<JSFXNode>(JSFXNodeType::NUMBER, m_currentToken.value);
+        auto number = MakeNode(JSFXNodeType::NUMBER, m_currentToken.value);
         Consume();
         return number;
     }
     
     if (m_currentToken.type == JSFXTokenType::STRING) {
-        auto string = std::make_unique<JSFXNode>(JSFXNodeType::STRING, m_currentToken.value);
+        auto string = MakeNode(JSFXNodeType::STRING, m_currentToken.value);
         Consume();
         return string;
     }
     
     if (m_currentToken.type == JSFXTokenType::IDENTIFIER) {
-        std::string name = m_currentToken.value;
+        JSFXToken nameToken = m_currentToken;
         Consume();
         
         // Check for function call
         if (m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == "(") {
-            m_currentToken.value = name; // Restore name for function call parsing
-            m_currentToken.type = JSFXTokenType::IDENTIFIER;
-            return ParseFunctionCall();
+            return ParseFunctionCall(nameToken);
         }
         
         // Check for array access
         if (m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == "[") {
-            auto arrayAccess = std::make_unique<JSFXNode>(JSFXNodeType::ARRAY_ACCESS, name);
+            auto arrayAccess = MakeNode(JSFXNodeType::ARRAY_ACCESS, nameToken.value, nameToken);
             Consume(); // '['
             arrayAccess->AddChild(ParseExpression());
             Expect(JSFXTokenType::PUNCTUATION); // ']'
@@ -543,22 +668,39 @@ std::unique_ptr<JSFXNode> JSFXParser::ParsePrimary() {
         }
         
         // Regular variable
-        return std::make_unique<JSFXNode>(JSFXNodeType::VARIABLE, name);
+        return MakeNode(JSFXNodeType::VARIABLE, nameToken.value, nameToken);
     }
     
     if (m_currentToken.type == JSFXTokenType::PUNCTUATION && m_currentToken.value == "(") {
         Consume(); // '('
-        auto expr = ParseExpression();
+        
+        // ( a; b; c ) is a statement block whose value is the last statement
+        auto block = MakeNode(JSFXNodeType::BLOCK);
+        while (m_currentToken.type != JSFXTokenType::END_OF_FILE &&
+               (m_currentToken.type != JSFXTokenType::PUNCTUATION || m_currentToken.value != ")")) {
+            if (IsStatementSeparator()) {
+                Consume();
+                continue;
+            }
+            block->AddChild(ParseStatement());
+        }
         Expect(JSFXTokenType::PUNCTUATION); // ')'
-        return expr;
+        
+        if (block->children.size() == 1) {
+            return std::move(block->children[0]);
+        }
+        return block;
     }
     
-    // Error - return dummy node
-    return std::make_unique<JSFXNode>(JSFXNodeType::NUMBER, "0");
+    // Error - skip the unexpected token so parsing always advances
+    if (m_currentToken.type != JSFXTokenType::END_OF_FILE) {
+        Consume();
+    }
+    return MakeNode(JSFXNodeType::NUMBER, "0");
 }
 
 std::unique_ptr<JSFXNode> JSFXParser::ParseIfStatement() {
-    auto ifStmt = std::make_unique<JSFXNode>(JSFXNodeType::IF_STATEMENT);
+    auto ifStmt = MakeNode(JSFXNodeType::IF_STATEMENT);
     Consume(); // 'if'
     
     Expect(JSFXTokenType::PUNCTUATION); // '('
@@ -577,7 +719,7 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseIfStatement() {
 }
 
 std::unique_ptr<JSFXNode> JSFXParser::ParseWhileLoop() {
-    auto whileLoop = std::make_unique<JSFXNode>(JSFXNodeType::WHILE_LOOP);
+    auto whileLoop = MakeNode(JSFXNodeType::WHILE_LOOP);
     Consume(); // 'while'
     
     Expect(JSFXTokenType::PUNCTUATION); // '('
@@ -590,7 +732,7 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseWhileLoop() {
 }
 
 std::unique_ptr<JSFXNode> JSFXParser::ParseBlock() {
-    auto block = std::make_unique<JSFXNode>(JSFXNodeType::BLOCK);
+    auto block = MakeNode(JSFXNodeType::BLOCK);
     Expect(JSFXTokenType::PUNCTUATION); // '{'
     
     while (m_currentToken.type != JSFXTokenType::PUNCTUATION || m_currentToken.value != "}") {
@@ -602,59 +744,204 @@ std::unique_ptr<JSFXNode> JSFXParser::ParseBlock() {
     return block;
 }
 
-// JSFXContext Implementation
-JSFXContext::JSFXContext() {
-    slider.resize(64, 0.0); // REAPER supports 64 sliders
-    RegisterBuiltins();
+void JSFXParser::ParseFunctionDefinition() {
+    JSFXFunction function;
+    function.line = m_currentToken.line;
+    Consume(); // 'function'
+    
+    function.name = m_currentToken.value;
+    Consume();
+    function.params = ParseNameList();
+    
+    // local(...), instance(...) and global(...) in any order
+    while (m_currentToken.type == JSFXTokenType::IDENTIFIER) {
+        const std::string kind = m_currentToken.value;
+        if (kind == "local") {
+            Consume();
+            function.locals = ParseNameList();
+        } else if (kind == "instance") {
+            Consume();
+            function.instances = ParseNameList();
+        } else if (kind == "global" || kind == "globals") {
+            Consume();
+            ParseNameList(); // Undeclared names are global anyway
+        } else {
+            break;
+        }
+    }
+    
+    function.body = ParsePrimary();
+    m_functions[function.name] = std::move(function);
 }
 
-JSFXContext::~JSFXContext() = default;
+std::vector<std::string> JSFXParser::ParseNameList() {
+    std::vector<std::string> names;
+    Expect(JSFXTokenType::PUNCTUATION); // '('
+    
+    // Names separated by commas or spaces
+    while (m_currentToken.type != JSFXTokenType::END_OF_FILE &&
+           (m_currentToken.type != JSFXTokenType::PUNCTUATION || m_currentToken.value != ")")) {
+        if (m_currentToken.type == JSFXTokenType::IDENTIFIER) {
+            names.push_back(m_currentToken.value);
+        }
+        Consume();
+    }
+    
+    Expect(JSFXTokenType::PUNCTUATION); // ')'
+    return names;
+}
 
-void JSFXContext::RegisterBuiltins() {
-    // Math functions
-    functions["sin"] = [](const std::vector<double>& args) { 
-        return args.empty() ? 0.0 : JSFXBuiltins::sin(args[0]); 
-    };
-    functions["cos"] = [](const std::vector<double>& args) { 
-        return args.empty() ? 0.0 : JSFXBuiltins::cos(args[0]); 
-    };
-    functions["tan"] = [](const std::vector<double>& args) { 
-        return args.empty() ? 0.0 : JSFXBuiltins::tan(args[0]); 
-    };
-    functions["sqrt"] = [](const std::vector<double>& args) { 
-        return args.empty() ? 0.0 : JSFXBuiltins::sqrt(args[0]); 
-    };
-    functions["abs"] = [](const std::vector<double>& args) { 
-        return args.empty() ? 0.0 : JSFXBuiltins::abs(args[0]); 
-    };
-    functions["min"] = [](const std::vector<double>& args) { 
-        return args.size() < 2 ? 0.0 : JSFXBuiltins::min(args[0], args[1]); 
-    };
-    functions["max"] = [](const std::vector<double>& args) { 
-        return args.size() < 2 ? 0.0 : JSFXBuiltins::max(args[0], args[1]); 
-    };
-    functions["floor"] = [](const std::vector<double>& args) { 
-        return args.empty() ? 0.0 : JSFXBuiltins::floor(args[0]); 
+std::unique_ptr<JSFXNode> JSFXNode::Clone() const {
+    auto copy = std::make_unique<JSFXNode>(type, value);
+    copy->line = line;
+    copy->column = column;
+    for (auto& child : children) {
+        copy->AddChild(child->Clone());
+    }
+    return copy;
+}
+
+// Compiled operators, built-in variables and built-in functions
+namespace {
+    enum Opcode {
+        OP_NONE,
+        OP_ASSIGN, OP_ADD_ASSIGN, OP_SUB_ASSIGN, OP_MUL_ASSIGN, OP_DIV_ASSIGN,
+        OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_POW,
+        OP_EQ, OP_NE, OP_LT, OP_GT, OP_LE, OP_GE, OP_AND, OP_OR,
+        OP_NEGATE, OP_PLUS, OP_NOT
     };
-    functions["ceil"] = [](const std::vector<double>& args) { 
-        return args.empty() ? 0.0 : JSFXBuiltins::ceil(args[0]); 
+    
+    int OperatorOpcode(const std::string& op, bool unary) {
+        static const std::unordered_map<std::string, int> binary = {
+            {"=", OP_ASSIGN}, {"+=", OP_ADD_ASSIGN}, {"-=", OP_SUB_ASSIGN}, {"*=", OP_MUL_ASSIGN},
+            {"/=", OP_DIV_ASSIGN}, {"+", OP_ADD}, {"-", OP_SUB}, {"*", OP_MUL}, {"/", OP_DIV},
+            {"%", OP_MOD}, {"^", OP_POW}, {"==", OP_EQ}, {"!=", OP_NE}, {"<", OP_LT}, {">", OP_GT},
+            {"<=", OP_LE}, {">=", OP_GE}, {"&&", OP_AND}, {"||", OP_OR}
+        };
+        if (unary) {
+            return op == "-" ? OP_NEGATE : op == "+" ? OP_PLUS : op == "!" ? OP_NOT : OP_NONE;
+        }
+        auto it = binary.find(op);
+        return it != binary.end() ? it->second : OP_NONE;
+    }
+    
+    // Built-in variables live in JSFXContext; ids 1..kSliderBase-1, then one per slider
+    enum BuiltinVariable {
+        VAR_NONE, VAR_SPL0, VAR_SPL1, VAR_SPL2, VAR_SPL3, VAR_SRATE, VAR_TEMPO, VAR_BEAT_POSITION,
+        VAR_TS_NUM, VAR_TS_DENOM, VAR_PLAY_STATE, VAR_EXT_TAIL_SIZE, VAR_SLIDER_BASE
     };
+    constexpr int kMaxSliders = 64;
+    
+    int BuiltinVariableId(const std::string& name) {
+        static const std::unordered_map<std::string, int> names = {
+            {"spl0", VAR_SPL0}, {"spl1", VAR_SPL1}, {"spl2", VAR_SPL2}, {"spl3", VAR_SPL3},
+            {"srate", VAR_SRATE}, {"tempo", VAR_TEMPO}, {"beat_position", VAR_BEAT_POSITION},
+            {"ts_num", VAR_TS_NUM}, {"ts_denom", VAR_TS_DENOM}, {"play_state", VAR_PLAY_STATE},
+            {"ext_tail_size", VAR_EXT_TAIL_SIZE}
+        };
+        auto it = names.find(name);
+        if (it != names.end()) return it->second;
+        
+        // slider1..slider64
+        if (name.size() > 6 && name.size() <= 8 && name.compare(0, 6, "slider") == 0 &&
+            std::all_of(name.begin() + 6, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            int sliderNum = std::stoi(name.substr(6)) - 1;
+            if (sliderNum >= 0 && sliderNum < kMaxSliders) {
+                return VAR_SLIDER_BASE + sliderNum;
+            }
+        }
+        return VAR_NONE;
+    }
     
-    // Audio functions
-    functions["db2gain"] = [](const std::vector<double>& args) { 
-        return args.empty() ? 0.0 : JSFXBuiltins::db2gain(args[0]); 
+    // Called with at least 'arity' evaluated arguments
+    struct BuiltinFunction {
+        const char* name;
+        int arity;
+        double (*call)(const double* args);
     };
-    functions["gain2db"] = [](const std::vector<double>& args) { 
-        return args.empty() ? 0.0 : JSFXBuiltins::gain2db(args[0]); 
+    
+    const BuiltinFunction kBuiltinFunctions[] = {
+        {"sin", 1, [](const double* a) { return JSFXBuiltins::sin(a[0]); }},
+        {"cos", 1, [](const double* a) { return JSFXBuiltins::cos(a[0]); }},
+        {"tan", 1, [](const double* a) { return JSFXBuiltins::tan(a[0]); }},
+        {"sqrt", 1, [](const double* a) { return JSFXBuiltins::sqrt(a[0]); }},
+        {"abs", 1, [](const double* a) { return JSFXBuiltins::abs(a[0]); }},
+        {"min", 2, [](const double* a) { return JSFXBuiltins::min(a[0], a[1]); }},
+        {"max", 2, [](const double* a) { return JSFXBuiltins::max(a[0], a[1]); }},
+        {"floor", 1, [](const double* a) { return JSFXBuiltins::floor(a[0]); }},
+        {"ceil", 1, [](const double* a) { return JSFXBuiltins::ceil(a[0]); }},
+        {"exp", 1, [](const double* a) { return JSFXBuiltins::exp(a[0]); }},
+        {"log", 1, [](const double* a) { return JSFXBuiltins::log(a[0]); }},
+        {"log10", 1, [](const double* a) { return JSFXBuiltins::log10(a[0]); }},
+        {"pow", 2, [](const double* a) { return JSFXBuiltins::pow(a[0], a[1]); }},
+        {"atan", 1, [](const double* a) { return JSFXBuiltins::atan(a[0]); }},
+        {"atan2", 2, [](const double* a) { return JSFXBuiltins::atan2(a[0], a[1]); }},
+        {"sign", 1, [](const double* a) { return JSFXBuiltins::sign(a[0]); }},
+        {"db2gain", 1, [](const double* a) { return JSFXBuiltins::db2gain(a[0]); }},
+        {"gain2db", 1, [](const double* a) { return JSFXBuiltins::gain2db(a[0]); }},
     };
+    constexpr int kMaxBuiltinArity = 2;
+    
+    // Index + 1 into kBuiltinFunctions, 0 for host functions
+    int BuiltinFunctionId(const std::string& name) {
+        for (size_t i = 0; i < sizeof(kBuiltinFunctions) / sizeof(kBuiltinFunctions[0]); ++i) {
+            if (name == kBuiltinFunctions[i].name) return static_cast<int>(i) + 1;
+        }
+        return 0;
+    }
+    
+    // Profiler clock: TSC ticks on x86, steady_clock nanoseconds elsewhere
+    inline uint64_t ReadProfileClock() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+    
+    // Short label for a per-node profile row
+    std::string DescribeNode(const JSFXNode* node) {
+        switch (node->type) {
+            case JSFXNodeType::PROGRAM: return "program";
+            case JSFXNodeType::SECTION: return node->value;
+            case JSFXNodeType::ASSIGNMENT: return "assign " + node->value;
+            case JSFXNodeType::BINARY_OP: return "op " + node->value;
+            case JSFXNodeType::UNARY_OP: return "unary " + node->value;
+            case JSFXNodeType::FUNCTION_CALL: return node->value + "()";
+            case JSFXNodeType::VARIABLE: return node->value;
+            case JSFXNodeType::NUMBER: return node->value;
+            case JSFXNodeType::STRING: return "\"" + node->value + "\"";
+            case JSFXNodeType::ARRAY_ACCESS: return node->value + "[]";
+            case JSFXNodeType::IF_STATEMENT: return "if";
+            case JSFXNodeType::WHILE_LOOP: return "while";
+            case JSFXNodeType::BLOCK: return "( ; )";
+        }
+        return "";
+    }
 }
 
+// JSFXContext Implementation
+JSFXContext::JSFXContext() {
+    slider.resize(kMaxSliders, 0.0); // REAPER supports 64 sliders
+}
+
+JSFXContext::~JSFXContext() = default;
+
 JSFXVariable& JSFXContext::GetVariable(const std::string& name) {
-    return memory.GetNamedVariable(name);
+    if (m_variableSlots) {
+        auto it = m_variableSlots->find(name);
+        if (it != m_variableSlots->end()) {
+            return variables[it->second];
+        }
+    }
+    
+    // Named variables live apart from the slot memory indexed by x[i]
+    return m_variables[name];
 }
 
 void JSFXContext::SetVariable(const std::string& name, double value) {
-    memory.SetNamedVariable(name, value);
+    GetVariable(name) = value;
 }
 
 double JSFXContext::CallFunction(const std::string& name, const std::vector<double>& args) {
@@ -671,36 +958,73 @@ JSFXInterpreter::JSFXInterpreter() = default;
 JSFXInterpreter::~JSFXInterpreter() = default;
 
 bool JSFXInterpreter::LoadScript(const std::string& source) {
-    try {
-        // Parse script header for metadata
-        ParseScriptHeader(source);
-        
-        // Parse the script into AST
-        JSFXParser parser(source);
-        m_ast = parser.Parse();
-        
-        // Find and cache section pointers
-        FindSections();
-        
-        m_initialized = true;
-        return true;
-    } catch (const std::exception& e) {
-        ReportError("Failed to load script: " + std::string(e.what()));
+    const char* error = "Failed to load script";
+    auto program = JSFXProgramCache::Instance().GetProgram(source, &error);
+    if (!program) {
+        ReportError(error);
         return false;
     }
+    return LoadProgram(std::move(program));
+}
+
+bool JSFXInterpreter::LoadProgram(std::shared_ptr<const JSFXProgram> program) {
+    if (!program) return false;
+    m_program = std::move(program);
+    
+    // Fresh instance state: one slot per script variable, and memory pages
+    // only if the script writes memory, allocated here so @sample never does
+    m_context.variables.assign(m_program->GetVariableCount(), JSFXVariable(0.0));
+    m_context.BindVariables(&m_program->GetVariableSlots());
+    m_context.memory.Reset();
+    if (m_program->WritesMemory()) {
+        m_context.memory.AllocatePages();
+    }
+    
+    const ScriptInfo& info = m_program->GetScriptInfo();
+    int count = std::min(static_cast<int>(info.sliders.size()), static_cast<int>(m_context.slider.size()));
+    for (int i = 0; i < count; ++i) {
+        m_context.slider[i] = info.sliders[i].defaultValue;
+    }
+    
+    m_initSection = m_program->GetSection("@init");
+    m_sliderSection = m_program->GetSection("@slider");
+    m_sampleSection = m_program->GetSection("@sample");
+    m_blockSection = m_program->GetSection("@block");
+    m_gfxSection = m_program->GetSection("@gfx");
+    
+    // Profile counters follow the program's nodes
+    if (m_profile) {
+        m_profileSize = static_cast<size_t>(m_program->GetNodeCount());
+        m_profile = std::make_unique<NodeProfile[]>(m_profileSize);
+    }
+    
+    m_initialized = true;
+    return true;
 }
 
 bool JSFXInterpreter::LoadScriptFromFile(const std::string& filename) {
-    // File loading would be implemented here
-    // For now, return false
-    return false;
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        ReportError("Failed to open script file");
+        return false;
+    }
+    std::ostringstream source;
+    source << file.rdbuf();
+    return LoadScript(source.str());
+}
+
+const JSFXInterpreter::ScriptInfo& JSFXInterpreter::GetScriptInfo() const {
+    static const ScriptInfo empty;
+    return m_program ? m_program->GetScriptInfo() : empty;
 }
 
 void JSFXInterpreter::ExecuteInit() {
     if (m_initSection) {
+        BeginBudget(kSectionBudgetFrames);
         auto startTime = std::chrono::high_resolution_clock::now();
         ExecuteNode(m_initSection);
         auto endTime = std::chrono::high_resolution_clock::now();
+        EndBudget("Instruction budget exceeded in @init");
         
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
         UpdateCpuUsage(duration.count() / 1000.0);
@@ -709,9 +1033,11 @@ void JSFXInterpreter::ExecuteInit() {
 
 void JSFXInterpreter::ExecuteSlider() {
     if (m_sliderSection) {
+        BeginBudget(kSectionBudgetFrames);
         auto startTime = std::chrono::high_resolution_clock::now();
         ExecuteNode(m_sliderSection);
         auto endTime = std::chrono::high_resolution_clock::now();
+        EndBudget("Instruction budget exceeded in @slider");
         
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
         UpdateCpuUsage(duration.count() / 1000.0);
@@ -729,6 +1055,7 @@ void JSFXInterpreter::ExecuteSample(double inputL, double inputR, double& output
     m_context.spl0 = inputL;
     m_context.spl1 = inputR;
     
+    BeginBudget(1);
     auto startTime = std::chrono::high_resolution_clock::now();
     
     // Execute @sample section
@@ -736,9 +1063,10 @@ void JSFXInterpreter::ExecuteSample(double inputL, double inputR, double& output
     
     auto endTime = std::chrono::high_resolution_clock::now();
     
-    // Get output samples
-    outputL = m_context.spl0;
-    outputR = m_context.spl1;
+    // Get output samples; an abandoned sample passes dry
+    bool completed = EndBudget("Instruction budget exceeded in @sample");
+    outputL = completed ? m_context.spl0 : inputL;
+    outputR = completed ? m_context.spl1 : inputR;
     
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
     UpdateCpuUsage(duration.count() / 1000.0);
@@ -750,26 +1078,53 @@ void JSFXInterpreter::ExecuteBlock(AudioBuffer& buffer) {
     int numSamples = buffer.GetSampleCount();
     int numChannels = buffer.GetChannelCount();
     
+    // One budget and one timing for the whole block
+    BeginBudget(static_cast<uint64_t>(numSamples));
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
     for (int i = 0; i < numSamples; ++i) {
-        double inputL = (numChannels > 0) ? buffer.GetChannelData(0)[i] : 0.0;
-        double inputR = (numChannels > 1) ? buffer.GetChannelData(1)[i] : inputL;
-        
-        double outputL, outputR;
-        ExecuteSample(inputL, inputR, outputL, outputR);
+        if (m_sampleSection) {
+            m_context.spl0 = (numChannels > 0) ? buffer.GetChannelData(0)[i] : 0.0;
+            m_context.spl1 = (numChannels > 1) ? buffer.GetChannelData(1)[i] : m_context.spl0;
+            
+            ExecuteNode(m_sampleSection);
+            
+            // Out of budget: this and the remaining samples stay dry
+            if (m_instructionsLeft < 0) break;
+            
+            if (numChannels > 0) buffer.GetChannelData(0)[i] = static_cast<float>(m_context.spl0);
+            if (numChannels > 1) buffer.GetChannelData(1)[i] = static_cast<float>(m_context.spl1);
+        }
         
-        if (numChannels > 0) buffer.GetChannelData(0)[i] = static_cast<float>(outputL);
-        if (numChannels > 1) buffer.GetChannelData(1)[i] = static_cast<float>(outputR);
+        // Exact inside a tempo segment; re-anchored by SetBlockTransport each block
+        m_context.beat_position += m_beatIncrement;
+        m_beatIncrement += m_beatIncrementDelta;
     }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    EndBudget("Instruction budget exceeded in @sample");
+    
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+    UpdateCpuUsage(duration.count() / 1000.0);
+}
+
+void JSFXInterpreter::SetBlockTransport(const TempoMap::BlockCursor& cursor, double playState) {
+    m_context.tempo = cursor.tempo;
+    m_context.beat_position = cursor.beat;
+    m_context.ts_num = cursor.timeSigNumerator;
+    m_context.ts_denom = cursor.timeSigDenominator;
+    m_context.play_state = playState;
+    
+    // Stopped transport keeps beat_position still
+    bool rolling = playState == 1.0 || playState == 5.0;
+    m_beatIncrement = rolling ? cursor.increment : 0.0;
+    m_beatIncrementDelta = rolling ? cursor.incrementDelta : 0.0;
 }
 
 void JSFXInterpreter::SetParameter(int index, double value) {
     if (index >= 0 && index < static_cast<int>(m_context.slider.size())) {
         m_context.slider[index] = value;
         
-        // Update named slider variables (slider1, slider2, etc.)
-        std::string sliderName = "slider" + std::to_string(index + 1);
-        m_context.SetVariable(sliderName, value);
-        
         // Execute @slider section when parameter changes
         ExecuteSlider();
     }
@@ -783,12 +1138,32 @@ double JSFXInterpreter::GetParameter(int index) const {
 }
 
 int JSFXInterpreter::GetParameterCount() const {
-    return static_cast<int>(m_scriptInfo.sliders.size());
+    return static_cast<int>(GetScriptInfo().sliders.size());
+}
+
+double JSFXInterpreter::ExecuteNode(const JSFXNode* node) {
+    // Out of budget: everything evaluates to 0, so loops end and the section unwinds
+    if (!node || --m_instructionsLeft < 0) return 0.0;
+    
+    if (m_profiling) {
+        return ExecuteNodeProfiled(node);
+    }
+    return DispatchNode(node);
 }
 
-double JSFXInterpreter::ExecuteNode(JSFXNode* node) {
-    if (!node) return 0.0;
+double JSFXInterpreter::ExecuteNodeProfiled(const JSFXNode* node) {
+    uint64_t start = ReadProfileClock();
+    double result = DispatchNode(node);
+    uint64_t elapsed = ReadProfileClock() - start;
     
+    // Only the audio thread writes, so plain load/store pairs are enough
+    NodeProfile& profile = m_profile[node->id];
+    profile.executions.store(profile.executions.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    profile.cycles.store(profile.cycles.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+    return result;
+}
+
+double JSFXInterpreter::DispatchNode(const JSFXNode* node) {
     switch (node->type) {
         case JSFXNodeType::PROGRAM:
         case JSFXNodeType::SECTION:
@@ -816,7 +1191,7 @@ double JSFXInterpreter::ExecuteNode(JSFXNode* node) {
             return ExecuteVariable(node);
             
         case JSFXNodeType::NUMBER:
-            return ExecuteNumber(node);
+            return node->number;
             
         case JSFXNodeType::ARRAY_ACCESS:
             return ExecuteArrayAccess(node);
@@ -832,73 +1207,88 @@ double JSFXInterpreter::ExecuteNode(JSFXNode* node) {
     }
 }
 
-double JSFXInterpreter::ExecuteAssignment(JSFXNode* node) {
+double JSFXInterpreter::ExecuteAssignment(const JSFXNode* node) {
     if (node->children.size() < 2) return 0.0;
     
     double value = ExecuteNode(node->children[1].get());
     
-    // Get the left-hand side variable
-    JSFXNode* lhs = node->children[0].get();
+    // Resolve the left-hand side: variable slot, built-in or memory slot
+    const JSFXNode* lhs = node->children[0].get();
+    double* target = nullptr;
     if (lhs->type == JSFXNodeType::VARIABLE) {
-        std::string varName = lhs->value;
-        
-        if (node->value == "=") {
-            m_context.SetVariable(varName, value);
-        } else if (node->value == "+=") {
-            double current = m_context.GetVariable(varName).GetValue();
-            m_context.SetVariable(varName, current + value);
-        } else if (node->value == "-=") {
-            double current = m_context.GetVariable(varName).GetValue();
-            m_context.SetVariable(varName, current - value);
-        } else if (node->value == "*=") {
-            double current = m_context.GetVariable(varName).GetValue();
-            m_context.SetVariable(varName, current * value);
-        } else if (node->value == "/=") {
-            double current = m_context.GetVariable(varName).GetValue();
-            m_context.SetVariable(varName, current / value);
-        }
-        
-        return value;
+        target = lhs->slot >= 0 ? m_context.variables[lhs->slot].GetPointer() : GetBuiltinVariable(lhs->opcode);
+    } else if (lhs->type == JSFXNodeType::ARRAY_ACCESS) {
+        target = m_context.memory.GetVariable(GetMemoryAddress(lhs)).GetPointer();
+    }
+    if (!target) return 0.0;
+    
+    switch (node->opcode) {
+        case OP_ASSIGN: *target = value; break;
+        case OP_ADD_ASSIGN: *target += value; break;
+        case OP_SUB_ASSIGN: *target -= value; break;
+        case OP_MUL_ASSIGN: *target *= value; break;
+        case OP_DIV_ASSIGN: *target /= value; break;
+        default: break;
     }
     
-    return 0.0;
+    return *target;
 }
 
-double JSFXInterpreter::ExecuteBinaryOp(JSFXNode* node) {
+double JSFXInterpreter::ExecuteBinaryOp(const JSFXNode* node) {
     if (node->children.size() < 2) return 0.0;
     
     double left = ExecuteNode(node->children[0].get());
     double right = ExecuteNode(node->children[1].get());
     
-    if (node->value == "+") return left + right;
-    if (node->value == "-") return left - right;
-    if (node->value == "*") return left * right;
-    if (node->value == "/") return (right != 0.0) ? left / right : 0.0;
-    if (node->value == "==") return (left == right) ? 1.0 : 0.0;
-    if (node->value == "!=") return (left != right) ? 1.0 : 0.0;
-    if (node->value == "<") return (left < right) ? 1.0 : 0.0;
-    if (node->value == ">") return (left > right) ? 1.0 : 0.0;
-    if (node->value == "<=") return (left <= right) ? 1.0 : 0.0;
-    if (node->value == ">=") return (left >= right) ? 1.0 : 0.0;
-    if (node->value == "&&") return (left != 0.0 && right != 0.0) ? 1.0 : 0.0;
-    if (node->value == "||") return (left != 0.0 || right != 0.0) ? 1.0 : 0.0;
-    
-    return 0.0;
+    switch (node->opcode) {
+        case OP_ADD: return left + right;
+        case OP_SUB: return left - right;
+        case OP_MUL: return left * right;
+        case OP_DIV: return (right != 0.0) ? left / right : 0.0;
+        case OP_MOD: {
+            int divisor = std::abs(static_cast<int>(right));
+            return divisor ? static_cast<double>(std::abs(static_cast<int>(left)) % divisor) : 0.0;
+        }
+        case OP_POW: return std::pow(left, right);
+        case OP_EQ: return (left == right) ? 1.0 : 0.0;
+        case OP_NE: return (left != right) ? 1.0 : 0.0;
+        case OP_LT: return (left < right) ? 1.0 : 0.0;
+        case OP_GT: return (left > right) ? 1.0 : 0.0;
+        case OP_LE: return (left <= right) ? 1.0 : 0.0;
+        case OP_GE: return (left >= right) ? 1.0 : 0.0;
+        case OP_AND: return (left != 0.0 && right != 0.0) ? 1.0 : 0.0;
+        case OP_OR: return (left != 0.0 || right != 0.0) ? 1.0 : 0.0;
+        default: return 0.0;
+    }
 }
 
-double JSFXInterpreter::ExecuteUnaryOp(JSFXNode* node) {
+double JSFXInterpreter::ExecuteUnaryOp(const JSFXNode* node) {
     if (node->children.empty()) return 0.0;
     
     double operand = ExecuteNode(node->children[0].get());
     
-    if (node->value == "-") return -operand;
-    if (node->value == "+") return operand;
-    if (node->value == "!") return (operand == 0.0) ? 1.0 : 0.0;
-    
-    return 0.0;
+    switch (node->opcode) {
+        case OP_NEGATE: return -operand;
+        case OP_PLUS: return operand;
+        case OP_NOT: return (operand == 0.0) ? 1.0 : 0.0;
+        default: return 0.0;
+    }
 }
 
-double JSFXInterpreter::ExecuteFunctionCall(JSFXNode* node) {
+double JSFXInterpreter::ExecuteFunctionCall(const JSFXNode* node) {
+    if (node->opcode > 0) {
+        const BuiltinFunction& function = kBuiltinFunctions[node->opcode - 1];
+        int count = static_cast<int>(node->children.size());
+        
+        // Every argument is evaluated for its side effects, even unused ones
+        double args[kMaxBuiltinArity] = {};
+        for (int i = 0; i < count; ++i) {
+            double value = ExecuteNode(node->children[i].get());
+            if (i < kMaxBuiltinArity) args[i] = value;
+        }
+        return count < function.arity ? 0.0 : function.call(args);
+    }
+    
     std::vector<double> args;
     for (auto& child : node->children) {
         args.push_back(ExecuteNode(child.get()));
@@ -907,46 +1297,57 @@ double JSFXInterpreter::ExecuteFunctionCall(JSFXNode* node) {
     return m_context.CallFunction(node->value, args);
 }
 
-double JSFXInterpreter::ExecuteVariable(JSFXNode* node) {
-    // Handle special built-in variables
-    if (node->value == "spl0") return m_context.spl0;
-    if (node->value == "spl1") return m_context.spl1;
-    if (node->value == "srate") return m_context.srate;
-    if (node->value == "tempo") return m_context.tempo;
-    
-    // Handle slider variables
-    if (node->value.substr(0, 6) == "slider") {
-        int sliderNum = std::stoi(node->value.substr(6)) - 1;
-        if (sliderNum >= 0 && sliderNum < static_cast<int>(m_context.slider.size())) {
-            return m_context.slider[sliderNum];
-        }
+double* JSFXInterpreter::GetBuiltinVariable(int id) {
+    switch (id) {
+        case VAR_SPL0: return &m_context.spl0;
+        case VAR_SPL1: return &m_context.spl1;
+        case VAR_SPL2: return &m_context.spl2;
+        case VAR_SPL3: return &m_context.spl3;
+        case VAR_SRATE: return &m_context.srate;
+        case VAR_TEMPO: return &m_context.tempo;
+        case VAR_BEAT_POSITION: return &m_context.beat_position;
+        case VAR_TS_NUM: return &m_context.ts_num;
+        case VAR_TS_DENOM: return &m_context.ts_denom;
+        case VAR_PLAY_STATE: return &m_context.play_state;
+        case VAR_EXT_TAIL_SIZE: return &m_context.ext_tail_size;
+        default: break;
     }
     
-    return m_context.GetVariable(node->value).GetValue();
+    // slider1..slider64
+    int sliderNum = id - VAR_SLIDER_BASE;
+    if (sliderNum >= 0 && sliderNum < static_cast<int>(m_context.slider.size())) {
+        return &m_context.slider[sliderNum];
+    }
+    return nullptr;
 }
 
-double JSFXInterpreter::ExecuteNumber(JSFXNode* node) {
-    try {
-        return std::stod(node->value);
-    } catch (...) {
-        return 0.0;
+double JSFXInterpreter::ExecuteVariable(const JSFXNode* node) {
+    if (node->slot >= 0) {
+        return m_context.variables[node->slot].GetValue();
     }
+    double* builtin = GetBuiltinVariable(node->opcode);
+    return builtin ? *builtin : 0.0;
 }
 
-double JSFXInterpreter::ExecuteArrayAccess(JSFXNode* node) {
-    if (node->children.empty()) return 0.0;
-    
-    int index = static_cast<int>(ExecuteNode(node->children[0].get()));
-    int address = m_context.memory.GetArrayAddress(node->value);
-    
-    if (address >= 0) {
-        return m_context.memory.GetVariable(address + index).GetValue();
+int JSFXInterpreter::GetMemoryAddress(const JSFXNode* node) {
+    // name[index] addresses memory slot (name + index), as in EEL2
+    double base = 0.0;
+    if (node->slot >= 0) {
+        base = m_context.variables[node->slot].GetValue();
+    } else if (double* builtin = GetBuiltinVariable(node->opcode)) {
+        base = *builtin;
     }
     
-    return 0.0;
+    double index = node->children.empty() ? 0.0 : ExecuteNode(node->children[0].get());
+    return static_cast<int>(std::floor(base + index + 0.00001));
 }
 
-double JSFXInterpreter::ExecuteIfStatement(JSFXNode* node) {
+double JSFXInterpreter::ExecuteArrayAccess(const JSFXNode* node) {
+    return m_context.memory.Read(GetMemoryAddress(node));
+}
+
+double JSFXInterpreter::ExecuteIfStatement(const JSFXNode* node) {
+
     if (node->children.empty()) return 0.0;
     
     double condition = ExecuteNode(node->children[0].get());
@@ -960,7 +1361,7 @@ double JSFXInterpreter::ExecuteIfStatement(JSFXNode* node) {
     return 0.0;
 }
 
-double JSFXInterpreter::ExecuteWhileLoop(JSFXNode* node) {
+double JSFXInterpreter::ExecuteWhileLoop(const JSFXNode* node) {
     if (node->children.size() < 2) return 0.0;
     
     double result = 0.0;
@@ -975,7 +1376,8 @@ double JSFXInterpreter::ExecuteWhileLoop(JSFXNode* node) {
     return result;
 }
 
-void JSFXInterpreter::ParseScriptHeader(const std::string& source) {
+JSFXInterpreter::ScriptInfo JSFXInterpreter::ParseScriptInfo(const std::string& source) {
+    ScriptInfo info;
     std::istringstream iss(source);
     std::string line;
     
@@ -984,11 +1386,11 @@ void JSFXInterpreter::ParseScriptHeader(const std::string& source) {
         
         // Parse desc: line
         if (line.substr(0, 5) == "desc:") {
-            m_scriptInfo.description = line.substr(5);
+            info.description = line.substr(5);
         }
         
         // Parse slider definitions
-        std::regex sliderRegex(R"(slider(\d+):([^<]+)<([^,]+),([^,]+),?([^>]*)>(.*)?)");
+        static const std::regex sliderRegex(R"(slider(\d+):([^<]+)<([^,]+),([^,]+),?([^>]*)>(.*)?)");
         std::smatch match;
         if (std::regex_match(line, match, sliderRegex)) {
             ScriptInfo::SliderInfo slider;
@@ -1000,53 +1402,62 @@ void JSFXInterpreter::ParseScriptHeader(const std::string& source) {
             slider.step = match[5].str().empty() ? 0.01 : std::stod(match[5].str());
             slider.name = match[6].str();
             
-            // Ensure slider vector is large enough
-            while (static_cast<int>(m_scriptInfo.sliders.size()) <= sliderNum) {
-                m_scriptInfo.sliders.emplace_back();
+            // Enumerated slider: <0,2,1{Off,Slow,Fast}>
+            std::string stepText = match[5].str();
+            size_t open = stepText.find('{');
+            size_t close = stepText.find('}');
+            if (open != std::string::npos && close != std::string::npos && close > open) {
+                std::istringstream values(stepText.substr(open + 1, close - open - 1));
+                std::string value;
+                while (std::getline(values, value, ',')) {
+                    slider.enumValues.push_back(value);
+                }
             }
-            m_scriptInfo.sliders[sliderNum] = slider;
             
-            // Set default value
-            if (sliderNum >= 0 && sliderNum < static_cast<int>(m_context.slider.size())) {
-                m_context.slider[sliderNum] = slider.defaultValue;
+            // Ensure slider vector is large enough
+            while (static_cast<int>(info.sliders.size()) <= sliderNum) {
+                info.sliders.emplace_back();
             }
+            info.sliders[sliderNum] = slider;
         }
         
         // Parse in_pin and out_pin
         if (line.substr(0, 7) == "in_pin:") {
-            m_scriptInfo.inPins.push_back(line.substr(7));
+            info.inPins.push_back(line.substr(7));
         } else if (line.substr(0, 8) == "out_pin:") {
-            m_scriptInfo.outPins.push_back(line.substr(8));
+            info.outPins.push_back(line.substr(8));
         }
         
         // Stop parsing header when we hit code sections
         if (line[0] == '@') break;
     }
+    
+    return info;
 }
 
-void JSFXInterpreter::FindSections() {
-    if (!m_ast) return;
+void JSFXInterpreter::BeginBudget(uint64_t frames) {
+    // Sections also latch the profiler, so one section is profiled whole or not at all
+    m_profiling = m_profilingRequested.load(std::memory_order_acquire);
     
-    for (auto& child : m_ast->children) {
-        if (child->type == JSFXNodeType::SECTION) {
-            if (child->value == "@init") {
-                m_initSection = child.get();
-            } else if (child->value == "@slider") {
-                m_sliderSection = child.get();
-            } else if (child->value == "@sample") {
-                m_sampleSection = child.get();
-            } else if (child->value == "@block") {
-                m_blockSection = child.get();
-            } else if (child->value == "@gfx") {
-                m_gfxSection = child.get();
-            }
-        }
+    const uint64_t unlimited = static_cast<uint64_t>(INT64_MAX);
+    if (m_instructionBudget == 0 || frames > unlimited / m_instructionBudget) {
+        m_instructionsLeft = INT64_MAX;
+    } else {
+        m_instructionsLeft = static_cast<int64_t>(m_instructionBudget * frames);
     }
 }
 
-void JSFXInterpreter::ReportError(const std::string& message) {
-    // Error reporting would be implemented here
-    // For now, just ignore
+bool JSFXInterpreter::EndBudget(const char* section) {
+    if (m_instructionsLeft >= 0) {
+        return true;
+    }
+    m_budgetExceeded = true;
+    ReportError(section);
+    return false;
+}
+
+void JSFXInterpreter::ReportError(const char* message) {
+    m_lastError = message;
 }
 
 void JSFXInterpreter::UpdateCpuUsage(double executionTime) {
@@ -1055,13 +1466,503 @@ void JSFXInterpreter::UpdateCpuUsage(double executionTime) {
     m_cpuUsage = alpha * executionTime + (1.0 - alpha) * m_cpuUsage;
 }
 
+void JSFXInterpreter::SetProfilingEnabled(bool enabled) {
+    // Counters exist before the audio thread can see the flag
+    if (enabled && !m_profile && m_program) {
+        m_profileSize = static_cast<size_t>(m_program->GetNodeCount());
+        m_profile = std::make_unique<NodeProfile[]>(m_profileSize);
+    }
+    m_profilingRequested.store(enabled && m_profile, std::memory_order_release);
+}
+
+void JSFXInterpreter::ResetProfile() {
+    for (size_t i = 0; i < m_profileSize; ++i) {
+        m_profile[i].executions.store(0, std::memory_order_relaxed);
+        m_profile[i].cycles.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::vector<JSFXHotSpot> JSFXInterpreter::GetHotSpots(bool perLine) const {
+    std::vector<JSFXHotSpot> spots;
+    if (!m_profile || !m_program) return spots;
+    
+    // Self time: a node's cycles minus its children's
+    std::vector<uint64_t> executions(m_profileSize), selfCycles(m_profileSize);
+    for (size_t i = 0; i < m_profileSize; ++i) {
+        executions[i] = m_profile[i].executions.load(std::memory_order_relaxed);
+        uint64_t cycles = m_profile[i].cycles.load(std::memory_order_relaxed);
+        uint64_t childCycles = 0;
+        for (auto& child : m_program->GetNode(static_cast<int>(i))->children) {
+            childCycles += m_profile[child->id].cycles.load(std::memory_order_relaxed);
+        }
+        selfCycles[i] = cycles > childCycles ? cycles - childCycles : 0;
+    }
+    
+    std::vector<std::string> sourceLines;
+    if (perLine) {
+        std::istringstream source(m_program->GetSource());
+        for (std::string line; std::getline(source, line);) {
+            sourceLines.push_back(line);
+        }
+    }
+    
+    std::map<int, size_t> rowOfLine;
+    uint64_t totalCycles = 0;
+    for (size_t i = 0; i < m_profileSize; ++i) {
+        if (executions[i] == 0) continue;
+        const JSFXNode* node = m_program->GetNode(static_cast<int>(i));
+        totalCycles += selfCycles[i];
+        
+        if (!perLine) {
+            spots.push_back({node->line, node->column, DescribeNode(node), executions[i], selfCycles[i], 0.0});
+            continue;
+        }
+        
+        auto row = rowOfLine.emplace(node->line, spots.size());
+        if (row.second) {
+            std::string code;
+            if (node->line >= 1 && node->line <= static_cast<int>(sourceLines.size())) {
+                code = sourceLines[node->line - 1];
+                size_t first = code.find_first_not_of(" \t");
+                size_t last = code.find_last_not_of(" \t\r");
+                code = first == std::string::npos ? "" : code.substr(first, last - first + 1);
+            }
+            spots.push_back({node->line, 0, code, 0, 0, 0.0});
+        }
+        JSFXHotSpot& spot = spots[row.first->second];
+        spot.executions = std::max(spot.executions, executions[i]);
+        spot.selfCycles += selfCycles[i];
+    }
+    
+    for (auto& spot : spots) {
+        spot.percent = totalCycles ? 100.0 * static_cast<double>(spot.selfCycles) / static_cast<double>(totalCycles) : 0.0;
+    }
+    std::stable_sort(spots.begin(), spots.end(), [](const JSFXHotSpot& a, const JSFXHotSpot& b) {
+        return a.selfCycles > b.selfCycles;
+    });
+    return spots;
+}
+
+std::string JSFXInterpreter::FormatProfileReport(size_t maxRows, bool perLine) const {
+    auto spots = GetHotSpots(perLine);
+    
+    std::ostringstream report;
+    report << std::left << std::setw(9) << (perLine ? "Line" : "Line:Col") << std::right
+           << std::setw(14) << "Executions" << std::setw(16) << "Cycles" << std::setw(8) << "%" << "  Code\n";
+    for (size_t i = 0; i < spots.size() && i < maxRows; ++i) {
+        const JSFXHotSpot& spot = spots[i];
+        std::string where = std::to_string(spot.line);
+        if (!perLine) where += ":" + std::to_string(spot.column);
+        report << std::left << std::setw(9) << where << std::right
+               << std::setw(14) << spot.executions << std::setw(16) << spot.selfCycles
+               << std::setw(8) << std::fixed << std::setprecision(1) << spot.percent << "  " << spot.code << "\n";
+    }
+    if (spots.empty()) {
+        report << "(no samples; enable profiling and process audio)\n";
+    }
+    return report.str();
+}
+
+// User functions: every call is replaced by a copy of the body
+namespace {
+    struct CompileError {
+        const char* message;
+    };
+    
+    // Bounds the copies made for nested calls (f calls g twice, g calls h twice, ...)
+    constexpr int kMaxExpandedNodes = 1 << 20;
+    
+    // What a piece of code reads and writes, to decide what may be substituted
+    struct CodeEffects {
+        std::unordered_set<std::string> reads;
+        std::unordered_set<std::string> writes;
+        bool readsMemory = false;
+        bool writesMemory = false;
+        bool callsHost = false;
+        
+        bool HasSideEffects() const { return !writes.empty() || writesMemory || callsHost; }
+    };
+    
+    void CollectEffects(const JSFXNode* node, CodeEffects& effects) {
+        switch (node->type) {
+            case JSFXNodeType::VARIABLE:
+                effects.reads.insert(node->value);
+                break;
+            case JSFXNodeType::ARRAY_ACCESS:
+                effects.reads.insert(node->value);
+                effects.readsMemory = true;
+                break;
+            case JSFXNodeType::ASSIGNMENT:
+                if (!node->children.empty()) {
+                    const JSFXNode* target = node->children[0].get();
+                    if (target->type == JSFXNodeType::VARIABLE) effects.writes.insert(target->value);
+                    if (target->type == JSFXNodeType::ARRAY_ACCESS) effects.writesMemory = true;
+                }
+                break;
+            case JSFXNodeType::FUNCTION_CALL:
+                // User functions are already expanded here; the rest are built-ins or host calls
+                if (BuiltinFunctionId(node->value) == 0) effects.callsHost = true;
+                break;
+            default:
+                break;
+        }
+        for (auto& child : node->children) {
+            CollectEffects(child.get(), effects);
+        }
+    }
+    
+    // Reads of 'name'; 'inLoop' and 'asArray' report where they happen
+    int CountUses(const JSFXNode* node, const std::string& name, bool loop, bool& inLoop, bool& asArray) {
+        int uses = 0;
+        if ((node->type == JSFXNodeType::VARIABLE || node->type == JSFXNodeType::ARRAY_ACCESS) && node->value == name) {
+            uses++;
+            inLoop |= loop;
+            asArray |= node->type == JSFXNodeType::ARRAY_ACCESS;
+        }
+        loop |= node->type == JSFXNodeType::WHILE_LOOP;
+        for (auto& child : node->children) {
+            uses += CountUses(child.get(), name, loop, inLoop, asArray);
+        }
+        return uses;
+    }
+    
+    int CountNodes(const JSFXNode* node) {
+        int count = 1;
+        for (auto& child : node->children) {
+            count += CountNodes(child.get());
+        }
+        return count;
+    }
+    
+    // Replaces reads of variable 'name' with a copy of 'replacement' (a variable
+    // for array bases)
+    void Substitute(std::unique_ptr<JSFXNode>& node, const std::string& name, const JSFXNode& replacement) {
+        if (node->type == JSFXNodeType::VARIABLE && node->value == name) {
+            node = replacement.Clone();
+            return;
+        }
+        if (node->type == JSFXNodeType::ARRAY_ACCESS && node->value == name) {
+            node->value = replacement.value;
+        }
+        for (auto& child : node->children) {
+            Substitute(child, name, replacement);
+        }
+    }
+    
+    /**
+     * Function Expander - inlines user function calls before names are resolved
+     *
+     * Parameters get variables of their own per call site, locals one set
+     * per function and instance variables become namespace.name, so every
+     * name in the expanded code is an ordinary variable slot. An argument is
+     * substituted for its parameter when that cannot change the result
+     * (constants, variables the body leaves alone, pure expressions used
+     * once), so small pure functions leave no trace of the call.
+     */
+    class FunctionExpander {
+    public:
+        explicit FunctionExpander(const std::unordered_map<std::string, JSFXFunction>& functions)
+            : m_functions(functions) {}
+        
+        void Expand(std::unique_ptr<JSFXNode>& node) {
+            if (!m_functions.empty()) Expand(node, Scope());
+        }
+        
+    private:
+        struct Scope {
+            std::string ns;                                         // For instance variables and this.
+            std::unordered_map<std::string, std::string> names;     // Parameters, locals, instance variables
+        };
+        
+        const std::unordered_map<std::string, JSFXFunction>& m_functions;
+        std::vector<const JSFXFunction*> m_expanding;
+        int m_callSites = 0;
+        int m_expandedNodes = 0;
+        
+        // x, this.x, inst.x: the variable a name refers to in this scope
+        static std::string ResolveName(const std::string& name, const Scope& scope) {
+            if (name == "this") return scope.ns;
+            
+            auto it = scope.names.find(name);
+            if (it != scope.names.end()) return it->second;
+            
+            size_t dot = name.find('.');
+            if (dot != std::string::npos) {
+                std::string head = name.substr(0, dot);
+                if (head == "this") {
+                    return scope.ns.empty() ? name.substr(dot + 1) : scope.ns + name.substr(dot);
+                }
+                auto instance = scope.names.find(head);
+                if (instance != scope.names.end()) return instance->second + name.substr(dot);
+            }
+            return name;
+        }
+        
+        void Expand(std::unique_ptr<JSFXNode>& node, const Scope& scope) {
+            if (node->type == JSFXNodeType::VARIABLE || node->type == JSFXNodeType::ARRAY_ACCESS) {
+                node->value = ResolveName(node->value, scope);
+            }
+            
+            // Arguments first, in the caller's scope
+            for (auto& child : node->children) {
+                Expand(child, scope);
+            }
+            
+            if (node->type == JSFXNodeType::FUNCTION_CALL) {
+                // ns.f() runs f in namespace ns; a plain f() in the namespace "f"
+                size_t dot = node->value.rfind('.');
+                std::string name = dot == std::string::npos ? node->value : node->value.substr(dot + 1);
+                auto function = m_functions.find(name);
+                if (function != m_functions.end()) {
+                    std::string ns = dot == std::string::npos ? name : ResolveName(node->value.substr(0, dot), scope);
+                    if (ns.empty()) ns = name;
+                    node = ExpandCall(*node, function->second, ns);
+                }
+            }
+        }
+        
+        std::unique_ptr<JSFXNode> ExpandCall(JSFXNode& call, const JSFXFunction& function, const std::string& ns) {
+            if (std::find(m_expanding.begin(), m_expanding.end(), &function) != m_expanding.end()) {
+                throw CompileError{"Recursive user function call"};
+            }
+            if (call.children.size() != function.params.size()) {
+                throw CompileError{"Wrong number of arguments to a user function"};
+            }
+            
+            std::string site = "#" + std::to_string(m_callSites++);
+            Scope scope;
+            scope.ns = ns;
+            std::vector<std::string> paramSlots;
+            for (auto& param : function.params) {
+                paramSlots.push_back(function.name + ":" + param + site);
+                scope.names.emplace(param, paramSlots.back());
+            }
+            for (auto& local : function.locals) {
+                scope.names.emplace(local, function.name + ":" + local);
+            }
+            for (auto& instance : function.instances) {
+                scope.names.emplace(instance, ns + "." + instance);
+            }
+            
+            auto body = function.body->Clone();
+            m_expandedNodes += CountNodes(body.get());
+            if (m_expandedNodes > kMaxExpandedNodes) {
+                throw CompileError{"User functions expand to too much code"};
+            }
+            m_expanding.push_back(&function);
+            Expand(body, scope);
+            m_expanding.pop_back();
+            
+            CodeEffects bodyEffects;
+            CollectEffects(body.get(), bodyEffects);
+            std::vector<CodeEffects> argEffects(call.children.size());
+            bool argsHaveSideEffects = false;
+            for (size_t i = 0; i < call.children.size(); ++i) {
+                CollectEffects(call.children[i].get(), argEffects[i]);
+                argsHaveSideEffects |= argEffects[i].HasSideEffects();
+            }
+            
+            // ( param = arg; ... body ) for the arguments that cannot be substituted
+            auto block = std::make_unique<JSFXNode>(JSFXNodeType::BLOCK);
+            block->line = call.line;
+            block->column = call.column;
+            for (size_t i = 0; i < call.children.size(); ++i) {
+                JSFXNode& arg = *call.children[i];
+                if (CanSubstitute(arg, argEffects[i], argsHaveSideEffects, paramSlots[i], body.get(), bodyEffects)) {
+                    Substitute(body, paramSlots[i], arg);
+                    continue;
+                }
+                auto assignment = std::make_unique<JSFXNode>(JSFXNodeType::ASSIGNMENT, "=");
+                auto slot = std::make_unique<JSFXNode>(JSFXNodeType::VARIABLE, paramSlots[i]);
+                assignment->line = slot->line = arg.line;
+                assignment->column = slot->column = arg.column;
+                assignment->AddChild(std::move(slot));
+                assignment->AddChild(std::move(call.children[i]));
+                block->AddChild(std::move(assignment));
+            }
+            
+            if (block->children.empty()) {
+                return body;
+            }
+            if (body->type == JSFXNodeType::BLOCK) {
+                for (auto& statement : body->children) {
+                    block->AddChild(std::move(statement));
+                }
+            } else {
+                block->AddChild(std::move(body));
+            }
+            return block;
+        }
+        
+        static bool CanSubstitute(const JSFXNode& arg, const CodeEffects& argEffects, bool argsHaveSideEffects,
+                                  const std::string& slot, const JSFXNode* body, const CodeEffects& bodyEffects) {
+            if (bodyEffects.writes.count(slot)) return false;
+            
+            bool inLoop = false, asArray = false;
+            int uses = CountUses(body, slot, false, inLoop, asArray);
+            if (arg.type == JSFXNodeType::NUMBER) return !asArray;
+            
+            // Evaluated where the body reads it instead of before the body: it
+            // must read the same values there
+            if (argsHaveSideEffects || bodyEffects.callsHost) return false;
+            for (auto& name : argEffects.reads) {
+                if (bodyEffects.writes.count(name)) return false;
+            }
+            if (argEffects.readsMemory && bodyEffects.writesMemory) return false;
+            if (arg.type == JSFXNodeType::VARIABLE) return true;
+            
+            // Expressions are neither duplicated nor moved into loops
+            return uses <= 1 && !inLoop && !asArray;
+        }
+    };
+}
+
+// JSFXProgram Implementation
+std::shared_ptr<const JSFXProgram> JSFXProgram::Compile(const std::string& source, const char** error) {
+    try {
+        auto program = std::make_shared<JSFXProgram>();
+        program->m_source = source;
+        program->m_scriptInfo = JSFXInterpreter::ParseScriptInfo(source);
+        
+        JSFXParser parser(source);
+        program->m_ast = parser.Parse();
+        FunctionExpander(parser.GetFunctions()).Expand(program->m_ast);
+        program->Resolve(program->m_ast.get());
+        return program;
+    } catch (const CompileError& compileError) {
+        if (error) *error = compileError.message;
+        return nullptr;
+    } catch (const std::exception&) {
+        if (error) *error = "Failed to compile script";
+        return nullptr;
+    }
+}
+
+const JSFXNode* JSFXProgram::GetSection(const std::string& name) const {
+    if (!m_ast) return nullptr;
+    
+    for (auto& child : m_ast->children) {
+        if (child->type == JSFXNodeType::SECTION && child->value == name) {
+            return child.get();
+        }
+    }
+    return nullptr;
+}
+
+void JSFXProgram::Resolve(JSFXNode* node) {
+    node->id = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(node);
+    
+    switch (node->type) {
+        case JSFXNodeType::NUMBER:
+            try {
+                node->number = std::stod(node->value);
+            } catch (...) {
+                node->number = 0.0;
+            }
+            break;
+            
+        case JSFXNodeType::VARIABLE:
+        case JSFXNodeType::ARRAY_ACCESS:
+            node->opcode = BuiltinVariableId(node->value);
+            if (node->opcode == VAR_NONE) {
+                // First use numbers the slot
+                auto inserted = m_variableSlots.emplace(node->value, static_cast<int>(m_variableSlots.size()));
+                node->slot = inserted.first->second;
+            }
+            break;
+            
+        case JSFXNodeType::ASSIGNMENT:
+            if (!node->children.empty() && node->children[0]->type == JSFXNodeType::ARRAY_ACCESS) {
+                m_writesMemory = true;
+            }
+            node->opcode = OperatorOpcode(node->value, false);
+            break;
+            
+        case JSFXNodeType::BINARY_OP:
+            node->opcode = OperatorOpcode(node->value, false);
+            break;
+            
+        case JSFXNodeType::UNARY_OP:
+            node->opcode = OperatorOpcode(node->value, true);
+            break;
+            
+        case JSFXNodeType::FUNCTION_CALL:
+            node->opcode = BuiltinFunctionId(node->value);
+            break;
+            
+        default:
+            break;
+    }
+    
+    for (auto& child : node->children) {
+        Resolve(child.get());
+    }
+}
+
+// JSFXProgramCache Implementation
+JSFXProgramCache& JSFXProgramCache::Instance() {
+    static JSFXProgramCache cache;
+    return cache;
+}
+
+std::shared_ptr<const JSFXProgram> JSFXProgramCache::GetProgram(const std::string& source, const char** error) {
+    size_t hash = std::hash<std::string>()(source);
+    auto find = [&]() -> std::shared_ptr<const JSFXProgram> {
+        auto range = m_programs.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            auto program = it->second.lock();
+            if (program && program->GetSource() == source) return program;
+        }
+        return nullptr;
+    };
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto program = find()) return program;
+    }
+    
+    // Compile outside the lock; a racing load of the same script keeps the first
+    std::shared_ptr<const JSFXProgram> compiled = JSFXProgram::Compile(source, error);
+    if (!compiled) return nullptr;
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (auto program = find()) return program;
+    
+    // Sweep entries whose last instance went away
+    for (auto it = m_programs.begin(); it != m_programs.end();) {
+        if (it->second.expired()) {
+            it = m_programs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_programs.emplace(hash, compiled);
+    return compiled;
+}
+
+size_t JSFXProgramCache::GetProgramCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::count_if(m_programs.begin(), m_programs.end(),
+                         [](const auto& entry) { return !entry.second.expired(); });
+}
+
 // JSFXEffect Implementation
+namespace {
+    std::atomic<int> g_watchdogTrips{0};
+}
+
 JSFXEffect::JSFXEffect() : m_interpreter(std::make_unique<JSFXInterpreter>()) {
 }
 
+JSFXEffect::JSFXEffect(NoInterpreter) {
+}
+
 JSFXEffect::~JSFXEffect() = default;
 
 bool JSFXEffect::LoadEffect(const std::string& source) {
+    if (!m_interpreter) return false;
+    
     bool success = m_interpreter->LoadScript(source);
     if (success) {
         m_name = m_interpreter->GetScriptInfo().description;
@@ -1070,13 +1971,23 @@ bool JSFXEffect::LoadEffect(const std::string& source) {
 }
 
 bool JSFXEffect::LoadEffectFromFile(const std::string& filename) {
-    return m_interpreter->LoadScriptFromFile(filename);
+    if (!m_interpreter) return false;
+    
+    bool success = m_interpreter->LoadScriptFromFile(filename);
+    if (success) {
+        m_name = m_interpreter->GetScriptInfo().description;
+    }
+    return success;
 }
 
-void JSFXEffect::Initialize(double sampleRate, int maxBlockSize) {
+void JSFXEffect::Initialize(double sampleRate, int) {
     m_sampleRate = sampleRate;
     m_interpreter->GetContext().srate = sampleRate;
     m_interpreter->ExecuteInit();
+    
+    // @slider runs once after @init so slider-derived state is valid before audio
+    m_interpreter->ExecuteSlider();
+    CheckWatchdog();
     m_initialized = true;
 }
 
@@ -1091,7 +2002,8 @@ void JSFXEffect::ProcessSample(double inputL, double inputR, double& outputL, do
         return;
     }
     
-    m_interpreter->ExecuteSample(inputL, inputR, outputL, outputR);
+    RenderSample(inputL, inputR, outputL, outputR);
+    CheckWatchdog();
 }
 
 void JSFXEffect::ProcessBlock(AudioBuffer& buffer) {
@@ -1102,7 +2014,8 @@ void JSFXEffect::ProcessBlock(AudioBuffer& buffer) {
     auto startTime = std::chrono::high_resolution_clock::now();
     
     UpdateAutomation();
-    m_interpreter->ExecuteBlock(buffer);
+    RenderBlock(buffer);
+    CheckWatchdog();
     
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
@@ -1113,8 +2026,21 @@ void JSFXEffect::ProcessBlock(AudioBuffer& buffer) {
     m_averageCpuUsage = alpha * currentUsage + (1.0 - alpha) * m_averageCpuUsage;
 }
 
+void JSFXEffect::RenderSample(double inputL, double inputR, double& outputL, double& outputR) {
+    m_interpreter->ExecuteSample(inputL, inputR, outputL, outputR);
+}
+
+void JSFXEffect::RenderBlock(AudioBuffer& buffer) {
+    m_interpreter->ExecuteBlock(buffer);
+}
+
+void JSFXEffect::SetTransport(const TempoMap::BlockCursor& cursor, double playState) {
+    m_interpreter->SetBlockTransport(cursor, playState);
+}
+
 void JSFXEffect::SetParameter(int index, double value) {
     m_interpreter->SetParameter(index, value);
+    CheckWatchdog();
 }
 
 double JSFXEffect::GetParameter(int index) const {
@@ -1144,4 +2070,48 @@ void JSFXEffect::UpdateAutomation() {
             automation.currentIndex++;
         }
     }
-}
\ No newline at end of file
+}
+
+void JSFXEffect::SetInstructionBudget(uint64_t perSample) {
+    if (m_interpreter) {
+        m_interpreter->SetInstructionBudget(perSample);
+    }
+}
+
+void JSFXEffect::ResetWatchdog() {
+    if (m_interpreter) {
+        m_interpreter->ClearBudgetExceeded();
+    }
+    if (m_watchdogTripped.exchange(false, std::memory_order_acq_rel)) {
+        m_bypassed = false;
+    }
+}
+
+void JSFXEffect::SetProfilingEnabled(bool enabled) {
+    if (m_interpreter) {
+        m_interpreter->SetProfilingEnabled(enabled);
+    }
+}
+
+void JSFXEffect::ResetProfile() {
+    if (m_interpreter) {
+        m_interpreter->ResetProfile();
+    }
+}
+
+std::string JSFXEffect::GetProfileReport(size_t maxRows, bool perLine) const {
+    return m_interpreter ? m_interpreter->FormatProfileReport(maxRows, perLine) : std::string();
+}
+
+int JSFXEffect::GetWatchdogTripTotal() {
+    return g_watchdogTrips.load(std::memory_order_relaxed);
+}
+
+void JSFXEffect::CheckWatchdog() {
+    // One overrun block, then the effect stays out of the signal path
+    if (m_interpreter && m_interpreter->HasExceededBudget() && !m_watchdogTripped.load(std::memory_order_relaxed)) {
+        m_bypassed = true;
+        m_watchdogTripped.store(true, std::memory_order_release);
+        g_watchdogTrips.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -6,12 +6,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <unordered_map>
 #include <functional>
 #include <stack>
+#include "../core/tempo_map.hpp"
 
 // Forward declarations
 class AudioBuffer;
@@ -60,6 +64,7 @@ public:
     
     double GetValue() const { return m_value; }
     void SetValue(double value) { m_value = value; }
+    double* GetPointer() { return &m_value; }
 
 private:
     double m_value;
@@ -67,18 +72,26 @@ private:
 
 /**
  * JSFX Memory Manager - Handles JSFX's memory model
- * JSFX uses a flat memory space for variables and arrays
+ * JSFX uses a flat memory space for variables and arrays, held in pages.
+ * AllocatePages() creates them off the audio thread for scripts that write
+ * memory; scripts that never do cost nothing here. Missing pages read as
+ * zero, and writes to them are dropped: no section ever allocates.
  */
 class JSFXMemory {
 public:
-    static constexpr int MEMORY_SIZE = 65536; // 64KB memory space like REAPER
+    static constexpr int MEMORY_SIZE = 65536; // 64K slots like REAPER
+    static constexpr int PAGE_SIZE = 4096;
     
     JSFXMemory();
     ~JSFXMemory();
     
-    // Memory access
+    // Memory access; the non-const overload hands out a scratch slot for
+    // addresses outside the allocated pages
     JSFXVariable& GetVariable(int address);
     const JSFXVariable& GetVariable(int address) const;
+    double Read(int address) const;
+    int GetAllocatedPageCount() const;
+    void AllocatePages();
     
     // Array operations
     void AllocateArray(const std::string& name, int size);
@@ -93,7 +106,8 @@ public:
     void Reset();
     
 private:
-    std::vector<JSFXVariable> m_memory;
+    std::unique_ptr<JSFXVariable[]> m_pages[MEMORY_SIZE / PAGE_SIZE];
+    JSFXVariable m_scratch;
     std::unordered_map<std::string, int> m_namedVariables;
     std::unordered_map<std::string, int> m_arrays;
     int m_nextFreeAddress;
@@ -179,6 +193,7 @@ private:
     char GetChar();
     char PeekChar();
     void SkipWhitespace();
+    void SkipHeader();
     JSFXToken ReadNumber();
     JSFXToken ReadString();
     JSFXToken ReadIdentifier();
@@ -213,12 +228,39 @@ public:
     std::string value;
     std::vector<std::unique_ptr<JSFXNode>> children;
     
+    // Filled in by JSFXProgram when compiling, read-only afterwards
+    int slot = -1;          // Variable slot of VARIABLE/ARRAY_ACCESS, -1 for built-ins
+    int opcode = 0;         // Operator, built-in variable or built-in function
+    double number = 0.0;    // Value of NUMBER
+    int id = -1;            // Index into JSFXProgram::GetNode(), pre-order
+    
+    // Source position of the token the node was built from (1-based)
+    int line = 0;
+    int column = 0;
+    
     JSFXNode(JSFXNodeType t, const std::string& v = "") : type(t), value(v) {}
     virtual ~JSFXNode() = default;
     
     void AddChild(std::unique_ptr<JSFXNode> child) {
         children.push_back(std::move(child));
     }
+    
+    // Deep copy of the parsed tree (type, value, position and children)
+    std::unique_ptr<JSFXNode> Clone() const;
+};
+
+/**
+ * JSFX Function - a user function from `function name(params) local(...)
+ * instance(...) ( body )`. Calls are expanded in place when the program is
+ * compiled (see JSFXProgram), so the body is never executed from here.
+ */
+struct JSFXFunction {
+    std::string name;
+    std::vector<std::string> params;
+    std::vector<std::string> locals;        // Shared by every call, like EEL2
+    std::vector<std::string> instances;     // Resolved to namespace.name per call site
+    std::unique_ptr<JSFXNode> body;
+    int line = 0;
 };
 
 /**
@@ -230,25 +272,39 @@ public:
     
     std::unique_ptr<JSFXNode> Parse();
     
+    // User functions defined anywhere in the script, by name (a later
+    // definition replaces an earlier one)
+    std::unordered_map<std::string, JSFXFunction>& GetFunctions() { return m_functions; }
+    
 private:
     JSFXLexer m_lexer;
     JSFXToken m_currentToken;
+    std::unordered_map<std::string, JSFXFunction> m_functions;
     
     void Consume();
     void Expect(JSFXTokenType type);
+    bool IsStatementSeparator() const;
+    static int GetBinaryPrecedence(const std::string& op);
+    
+    // New node at the current token's (or 'at''s) source position
+    std::unique_ptr<JSFXNode> MakeNode(JSFXNodeType type, const std::string& value = "") const;
+    std::unique_ptr<JSFXNode> MakeNode(JSFXNodeType type, const std::string& value, const JSFXToken& at) const;
     
     std::unique_ptr<JSFXNode> ParseProgram();
     std::unique_ptr<JSFXNode> ParseSection();
     std::unique_ptr<JSFXNode> ParseStatement();
     std::unique_ptr<JSFXNode> ParseExpression();
     std::unique_ptr<JSFXNode> ParseAssignment();
-    std::unique_ptr<JSFXNode> ParseBinaryOp();
+    std::unique_ptr<JSFXNode> ParseConditional();
+    std::unique_ptr<JSFXNode> ParseBinaryOp(int minPrecedence = 1);
     std::unique_ptr<JSFXNode> ParseUnaryOp();
-    std::unique_ptr<JSFXNode> ParseFunctionCall();
+    std::unique_ptr<JSFXNode> ParseFunctionCall(const JSFXToken& name);
     std::unique_ptr<JSFXNode> ParsePrimary();
     std::unique_ptr<JSFXNode> ParseIfStatement();
     std::unique_ptr<JSFXNode> ParseWhileLoop();
     std::unique_ptr<JSFXNode> ParseBlock();
+    void ParseFunctionDefinition();
+    std::vector<std::string> ParseNameList();
 };
 
 /**
@@ -277,26 +333,41 @@ public:
     // Slider variables (parameters)
     std::vector<double> slider;  // slider1, slider2, etc.
     
-    // Memory and variables
+    // Memory and variables; 'variables' holds the script's slots in program order
     JSFXMemory memory;
+    std::vector<JSFXVariable> variables;
     
-    // Function registry
+    // Host functions, called by name when a script calls something that is
+    // not a built-in (built-ins are resolved when the program is compiled)
     std::unordered_map<std::string, std::function<double(const std::vector<double>&)>> functions;
     
-    // Register built-in functions
-    void RegisterBuiltins();
-    
-    // Variable access
+    // Variable access by name: script variables, else a host-side variable
     JSFXVariable& GetVariable(const std::string& name);
     void SetVariable(const std::string& name, double value);
+    void BindVariables(const std::unordered_map<std::string, int>* slots) { m_variableSlots = slots; }
     
     // Function calls
     double CallFunction(const std::string& name, const std::vector<double>& args);
     
 private:
     std::unordered_map<std::string, JSFXVariable> m_variables;
+    const std::unordered_map<std::string, int>* m_variableSlots = nullptr;
 };
 
+/**
+ * JSFX Hot Spot - one row of a profile: a source line, or a single node
+ */
+struct JSFXHotSpot {
+    int line = 0;
+    int column = 0;             // 0 for a whole line
+    std::string code;           // Source line, or a short description of the node
+    uint64_t executions = 0;    // For a line, its most executed node
+    uint64_t selfCycles = 0;    // Excluding the time of nested nodes
+    double percent = 0.0;       // Share of all profiled cycles
+};
+
+class JSFXProgram;
+
 /**
  * JSFX Interpreter - Executes JSFX scripts
  */
@@ -305,9 +376,11 @@ public:
     JSFXInterpreter();
     ~JSFXInterpreter();
     
-    // Script loading and compilation
+    // Script loading; compiled programs are shared through JSFXProgramCache
     bool LoadScript(const std::string& source);
     bool LoadScriptFromFile(const std::string& filename);
+    bool LoadProgram(std::shared_ptr<const JSFXProgram> program);
+    const std::shared_ptr<const JSFXProgram>& GetProgram() const { return m_program; }
     
     // Execution sections
     void ExecuteInit();
@@ -315,6 +388,9 @@ public:
     void ExecuteSample(double inputL, double inputR, double& outputL, double& outputR);
     void ExecuteBlock(AudioBuffer& buffer);
     
+    // Transport for the next block; beat_position advances per sample from here
+    void SetBlockTransport(const TempoMap::BlockCursor& cursor, double playState);
+    
     // Parameter management
     void SetParameter(int index, double value);
     double GetParameter(int index) const;
@@ -338,81 +414,190 @@ public:
         std::vector<SliderInfo> sliders;
     };
     
-    const ScriptInfo& GetScriptInfo() const { return m_scriptInfo; }
+    const ScriptInfo& GetScriptInfo() const;
+    
+    // Header metadata only (desc, sliders, pins) without compiling the code
+    static ScriptInfo ParseScriptInfo(const std::string& source);
     
     // Execution context
     JSFXContext& GetContext() { return m_context; }
+    const JSFXContext& GetContext() const { return m_context; }
     
     // Performance and debugging
     bool IsInitialized() const { return m_initialized; }
     double GetCpuUsage() const { return m_cpuUsage; }
     
+    // Watchdog: node evaluations allowed per sample frame; 0 is unlimited.
+    // @sample gets the budget times the block length for the whole block,
+    // @init and @slider get kSectionBudgetFrames frames' worth. A section
+    // that runs out is abandoned and the rest of the block passes dry.
+    static constexpr uint64_t kDefaultInstructionBudget = 2000;     // Built-in scripts use under 100
+    static constexpr uint64_t kSectionBudgetFrames = 1024;
+    void SetInstructionBudget(uint64_t perSample) { m_instructionBudget = perSample; }
+    uint64_t GetInstructionBudget() const { return m_instructionBudget; }
+    bool HasExceededBudget() const { return m_budgetExceeded; }
+    void ClearBudgetExceeded() { m_budgetExceeded = false; }
+    
+    // Last error; a static string, so reporting never allocates on the audio thread
+    const char* GetLastError() const { return m_lastError; }
+    
+    // Profiler: executions and cycles per AST node, reported per source line
+    // or per node, hottest first. Cycles are TSC ticks on x86, nanoseconds
+    // elsewhere. Takes effect at the next section; while off, the cost is one
+    // branch per node. Reports may be read while the audio thread runs.
+    void SetProfilingEnabled(bool enabled);
+    bool IsProfilingEnabled() const { return m_profilingRequested.load(std::memory_order_relaxed); }
+    void ResetProfile();
+    std::vector<JSFXHotSpot> GetHotSpots(bool perLine = true) const;
+    std::string FormatProfileReport(size_t maxRows = 20, bool perLine = true) const;
+    
 private:
-    std::unique_ptr<JSFXNode> m_ast;
+    std::shared_ptr<const JSFXProgram> m_program;
     JSFXContext m_context;
-    ScriptInfo m_scriptInfo;
     
-    // Execution sections
-    JSFXNode* m_initSection = nullptr;
-    JSFXNode* m_sliderSection = nullptr;
-    JSFXNode* m_sampleSection = nullptr;
-    JSFXNode* m_blockSection = nullptr;
-    JSFXNode* m_gfxSection = nullptr;
+    // Execution sections, owned by the program
+    const JSFXNode* m_initSection = nullptr;
+    const JSFXNode* m_sliderSection = nullptr;
+    const JSFXNode* m_sampleSection = nullptr;
+    const JSFXNode* m_blockSection = nullptr;
+    const JSFXNode* m_gfxSection = nullptr;
     
     bool m_initialized = false;
     double m_cpuUsage = 0.0;
     
+    // Watchdog: ExecuteNode() counts down; below zero every node returns 0
+    uint64_t m_instructionBudget = kDefaultInstructionBudget;
+    int64_t m_instructionsLeft = 0;
+    bool m_budgetExceeded = false;
+    const char* m_lastError = nullptr;
+    
+    // Profiler: counters per program node, allocated on first enable and
+    // kept, so the audio thread never sees them freed
+    struct NodeProfile {
+        std::atomic<uint64_t> executions{0};
+        std::atomic<uint64_t> cycles{0};
+    };
+    std::unique_ptr<NodeProfile[]> m_profile;
+    size_t m_profileSize = 0;
+    std::atomic<bool> m_profilingRequested{false};
+    bool m_profiling = false;   // Latched from m_profilingRequested per section
+    
+    // Per-sample beat stepping (see TempoMap::BlockCursor)
+    double m_beatIncrement = 0.0;
+    double m_beatIncrementDelta = 0.0;
+    
     // Execution methods
-    double ExecuteNode(JSFXNode* node);
-    double ExecuteAssignment(JSFXNode* node);
-    double ExecuteBinaryOp(JSFXNode* node);
-    double ExecuteUnaryOp(JSFXNode* node);
-    double ExecuteFunctionCall(JSFXNode* node);
-    double ExecuteVariable(JSFXNode* node);
-    double ExecuteNumber(JSFXNode* node);
-    double ExecuteArrayAccess(JSFXNode* node);
-    double ExecuteIfStatement(JSFXNode* node);
-    double ExecuteWhileLoop(JSFXNode* node);
-    double ExecuteBlock(JSFXNode* node);
-    
-    // Script parsing
-    void ParseScriptHeader(const std::string& source);
-    void FindSections();
+    double ExecuteNode(const JSFXNode* node);
+    double ExecuteNodeProfiled(const JSFXNode* node);
+    double DispatchNode(const JSFXNode* node);
+    double ExecuteAssignment(const JSFXNode* node);
+    double ExecuteBinaryOp(const JSFXNode* node);
+    double ExecuteUnaryOp(const JSFXNode* node);
+    double ExecuteFunctionCall(const JSFXNode* node);
+    double ExecuteVariable(const JSFXNode* node);
+    double* GetBuiltinVariable(int id);
+    int GetMemoryAddress(const JSFXNode* node);
+    double ExecuteArrayAccess(const JSFXNode* node);
+    double ExecuteIfStatement(const JSFXNode* node);
+    double ExecuteWhileLoop(const JSFXNode* node);
+    
+    // Watchdog: false (and the error reported) if the section ran out
+    void BeginBudget(uint64_t frames);
+    bool EndBudget(const char* message);
     
     // Error handling
-    void ReportError(const std::string& message);
+    void ReportError(const char* message);
     
     // Performance monitoring
     void UpdateCpuUsage(double executionTime);
 };
 
+/**
+ * JSFX Program - a parsed script with every name resolved, immutable once
+ * compiled
+ *
+ * Variables are numbered slots, operators and built-ins are opcodes and
+ * numbers are parsed, so executing a node never touches a string. User
+ * functions are expanded at every call site, so a call costs nothing beyond
+ * its body. All instances of one script share a program; each
+ * JSFXInterpreter holds only its variable slots and memory.
+ */
+class JSFXProgram {
+public:
+    // Returns null if the script does not compile; 'error' then gets a
+    // static message
+    static std::shared_ptr<const JSFXProgram> Compile(const std::string& source, const char** error = nullptr);
+    
+    const std::string& GetSource() const { return m_source; }
+    const JSFXInterpreter::ScriptInfo& GetScriptInfo() const { return m_scriptInfo; }
+    const JSFXNode* GetSection(const std::string& name) const;
+    int GetVariableCount() const { return static_cast<int>(m_variableSlots.size()); }
+    const std::unordered_map<std::string, int>& GetVariableSlots() const { return m_variableSlots; }
+    int GetNodeCount() const { return static_cast<int>(m_nodes.size()); }
+    const JSFXNode* GetNode(int id) const { return m_nodes[id]; }
+    bool WritesMemory() const { return m_writesMemory; }    // Any x[i] = ... in any section
+    
+private:
+    std::string m_source;
+    JSFXInterpreter::ScriptInfo m_scriptInfo;
+    std::unique_ptr<JSFXNode> m_ast;
+    std::unordered_map<std::string, int> m_variableSlots;
+    std::vector<const JSFXNode*> m_nodes;   // By JSFXNode::id
+    bool m_writesMemory = false;
+    
+    void Resolve(JSFXNode* node);
+};
+
+/**
+ * JSFX Program Cache - compiled programs by script hash, shared read-only
+ * Thread-safe; loading an already compiled script costs a hash and a lookup.
+ * The cache does not own programs: one lives as long as an instance runs it,
+ * and its entry is swept by the next compile.
+ */
+class JSFXProgramCache {
+public:
+    static JSFXProgramCache& Instance();
+    
+    std::shared_ptr<const JSFXProgram> GetProgram(const std::string& source, const char** error = nullptr);
+    size_t GetProgramCount() const;     // Programs some instance still runs
+    
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_multimap<size_t, std::weak_ptr<const JSFXProgram>> m_programs;
+};
+
 /**
  * JSFX Effect - A complete JSFX effect instance
- * Combines interpreter with parameter management and I/O
+ * Combines interpreter with parameter management and I/O.
+ * Native effects (see native_effects.hpp) derive from it and replace the
+ * interpreter while keeping the same slider layout and chain interface.
  */
 class JSFXEffect {
 public:
     JSFXEffect();
-    ~JSFXEffect();
+    virtual ~JSFXEffect();
     
     // Effect lifecycle
     bool LoadEffect(const std::string& source);
     bool LoadEffectFromFile(const std::string& filename);
-    void Initialize(double sampleRate, int maxBlockSize);
+    virtual void Initialize(double sampleRate, int maxBlockSize);
     void Shutdown();
     
     // Audio processing
     void ProcessSample(double inputL, double inputR, double& outputL, double& outputR);
     void ProcessBlock(AudioBuffer& buffer);
+    virtual void SetTransport(const TempoMap::BlockCursor& cursor, double playState);
     
     // Parameter automation
-    void SetParameter(int index, double value);
-    double GetParameter(int index) const;
+    virtual void SetParameter(int index, double value);
+    virtual double GetParameter(int index) const;
     void SetParameterAutomation(int index, const std::vector<double>& values);
     
     // Effect information
-    const JSFXInterpreter::ScriptInfo& GetInfo() const;
+    virtual const JSFXInterpreter::ScriptInfo& GetInfo() const;
+    virtual bool IsNative() const { return false; }
     const std::string& GetName() const { return m_name; }
+    const JSFXInterpreter* GetInterpreter() const { return m_interpreter.get(); }    // Null for native effects
     bool IsBypassed() const { return m_bypassed; }
     void SetBypassed(bool bypassed) { m_bypassed = bypassed; }
     
@@ -420,13 +605,40 @@ public:
     double GetCpuUsage() const;
     bool IsInitialized() const { return m_initialized; }
     
-private:
-    std::unique_ptr<JSFXInterpreter> m_interpreter;
+    // Watchdog: a script that runs out of its instruction budget (see
+    // JSFXInterpreter::SetInstructionBudget) is bypassed until ResetWatchdog()
+    void SetInstructionBudget(uint64_t perSample);
+    bool IsWatchdogTripped() const { return m_watchdogTripped.load(std::memory_order_acquire); }
+    void ResetWatchdog();
+    const char* GetLastError() const { return m_interpreter ? m_interpreter->GetLastError() : nullptr; }
+    // Trips across all effects since startup, for PerformanceStats
+    static int GetWatchdogTripTotal();
+    
+    // Profiler (see JSFXInterpreter::SetProfilingEnabled); native effects
+    // have no script and report nothing
+    void SetProfilingEnabled(bool enabled);
+    bool IsProfilingEnabled() const { return m_interpreter && m_interpreter->IsProfilingEnabled(); }
+    void ResetProfile();
+    std::string GetProfileReport(size_t maxRows = 20, bool perLine = true) const;
+    
+protected:
+    // For native effects: no interpreter or script memory is created
+    struct NoInterpreter {};
+    explicit JSFXEffect(NoInterpreter);
+    
+    // Processing core behind the bypass, automation and CPU metering
+    virtual void RenderSample(double inputL, double inputR, double& outputL, double& outputR);
+    virtual void RenderBlock(AudioBuffer& buffer);
+    
     std::string m_name;
     bool m_initialized = false;
-    bool m_bypassed = false;
     double m_sampleRate = 48000.0;
     
+private:
+    std::unique_ptr<JSFXInterpreter> m_interpreter;
+    std::atomic<bool> m_bypassed{false};            // Set by the UI and the watchdog
+    std::atomic<bool> m_watchdogTripped{false};
+    
     // Parameter automation
     struct ParameterAutomation {
         std::vector<double> values;
@@ -439,4 +651,5 @@ private:
     double m_averageCpuUsage = 0.0;
     
     void UpdateAutomation();
+    void CheckWatchdog();
 };
\ No newline at end of file
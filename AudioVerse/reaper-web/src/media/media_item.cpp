@@ -6,6 +6,7 @@
 #include "media_item.hpp"
 #include "../core/audio_engine.hpp"
 #include "../core/track_manager.hpp"
+#include "../core/tempo_map.hpp"
 #include <algorithm>
 #include <random>
 #include <sstream>
@@ -37,6 +38,28 @@ void MediaItem::SetPosition(double seconds) {
     m_state.position = std::max(0.0, seconds);
 }
 
+void MediaItem::SetPositionBeats(double beats, const TempoMap& tempoMap) {
+    m_state.positionBeats = std::max(0.0, beats);
+    m_state.position = tempoMap.BeatsToSeconds(m_state.positionBeats);
+}
+
+double MediaItem::GetPositionBeats(const TempoMap& tempoMap) const {
+    return m_state.beatTimebase ? m_state.positionBeats : tempoMap.SecondsToBeats(m_state.position);
+}
+
+void MediaItem::SetBeatTimebase(bool enabled, const TempoMap& tempoMap) {
+    m_state.beatTimebase = enabled;
+    if (enabled) {
+        m_state.positionBeats = tempoMap.SecondsToBeats(m_state.position);
+    }
+}
+
+void MediaItem::UpdateFromTempoMap(const TempoMap& tempoMap) {
+    if (m_state.beatTimebase) {
+        m_state.position = tempoMap.BeatsToSeconds(m_state.positionBeats);
+    }
+}
+
 void MediaItem::SetLength(double seconds) {
     m_state.length = std::max(0.001, seconds); // Minimum 1ms length
 }
@@ -276,10 +299,16 @@ void MediaItem::ProcessAudio(AudioBuffer& buffer, double startTime, double lengt
     
     if (overlapLength <= 0.0) return;
     
-    // Create process buffer if needed
+    // Round rather than truncate: a block split at the loop end must tile
+    // sample-exactly, with no dropped or repeated sample at the seam
+    int startSample = static_cast<int>(std::llround((overlapStart - startTime) * buffer.GetSampleRate()));
+    int numSamples = static_cast<int>(std::llround(overlapLength * buffer.GetSampleRate()));
+    numSamples = std::min(numSamples, buffer.GetSampleCount() - startSample);
+    if (numSamples <= 0) return;
+    
+    // Create process buffer if needed (normally done by PrepareToPlay)
     if (!m_processBuffer) {
-        m_processBuffer = std::make_unique<AudioBuffer>(buffer.GetChannelCount(), 
-                                                      static_cast<int>(buffer.GetSampleRate() * overlapLength));
+        m_processBuffer = std::make_unique<AudioBuffer>(buffer.GetChannelCount(), numSamples);
     }
     
     // Process the take
@@ -289,10 +318,10 @@ void MediaItem::ProcessAudio(AudioBuffer& buffer, double startTime, double lengt
     ApplyFades(*m_processBuffer, overlapStart - itemStart, overlapLength);
     
     // Apply item volume and mix into output buffer
-    int startSample = static_cast<int>((overlapStart - startTime) * buffer.GetSampleRate());
-    int numSamples = static_cast<int>(overlapLength * buffer.GetSampleRate());
+    numSamples = std::min(numSamples, m_processBuffer->GetSampleCount());
+    int numChannels = std::min(buffer.GetChannelCount(), m_processBuffer->GetChannelCount());
     
-    for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
+    for (int ch = 0; ch < numChannels; ++ch) {
         auto* src = m_processBuffer->GetChannelData(ch);
         auto* dst = buffer.GetChannelData(ch) + startSample;
         
@@ -302,6 +331,15 @@ void MediaItem::ProcessAudio(AudioBuffer& buffer, double startTime, double lengt
     }
 }
 
+void MediaItem::PrepareToPlay(int maxBlockSize, int numChannels) {
+    // AudioBuffer keeps its capacity when shrunk, so sizing once for the
+    // largest block covers every smaller (split) block later
+    if (!m_processBuffer) {
+        m_processBuffer = std::make_unique<AudioBuffer>();
+    }
+    m_processBuffer->SetSize(std::max(numChannels, 1), std::max(maxBlockSize, 1));
+}
+
 void MediaItem::ProcessTake(const Take& take, AudioBuffer& buffer, double startTime, double length) {
     if (!take.source || !take.source->IsValid()) return;
     
@@ -490,10 +528,6 @@ double MediaItem::GetTimeInItem(double globalTime) const {
     return globalTime - m_state.position;
 }
 
-const MediaItem::ItemState& MediaItem::GetState() const {
-    return m_state;
-}
-
 void MediaItem::SetState(const ItemState& state) {
     m_state = state;
 }
@@ -559,8 +593,8 @@ bool AudioSource::ReadAudio(AudioBuffer& buffer, double startTime, double length
         return false;
     }
     
-    int startSample = static_cast<int>(startTime * m_info.sampleRate);
-    int numSamples = static_cast<int>(length * m_info.sampleRate);
+    int startSample = static_cast<int>(std::llround(startTime * m_info.sampleRate));
+    int numSamples = static_cast<int>(std::llround(length * m_info.sampleRate));
     
     return ReadAudioSamples(buffer, startSample, numSamples);
 }
@@ -716,6 +750,7 @@ MediaItemManager::~MediaItemManager() = default;
 MediaItem* MediaItemManager::CreateItem(Track* track, const std::string& sourceFile, double position) {
     auto item = std::make_unique<MediaItem>(track, sourceFile);
     item->SetPosition(position);
+    item->PrepareToPlay(m_maxBlockSize, m_maxChannels);
     
     MediaItem* itemPtr = item.get();
     m_items.push_back(std::move(item));
@@ -728,6 +763,7 @@ MediaItem* MediaItemManager::CreateEmptyItem(Track* track, double position, doub
     auto item = std::make_unique<MediaItem>(track);
     item->SetPosition(position);
     item->SetLength(length);
+    item->PrepareToPlay(m_maxBlockSize, m_maxChannels);
     
     MediaItem* itemPtr = item.get();
     m_items.push_back(std::move(item));
@@ -837,6 +873,20 @@ void MediaItemManager::SetSelectedItemsColor(const std::string& color) {
     }
 }
 
+void MediaItemManager::SetMaxBlockSize(int maxBlockSize, int numChannels) {
+    m_maxBlockSize = std::max(maxBlockSize, 1);
+    m_maxChannels = std::max(numChannels, 1);
+    for (const auto& item : m_items) {
+        item->PrepareToPlay(m_maxBlockSize, m_maxChannels);
+    }
+}
+
+void MediaItemManager::UpdateTempoMap(const TempoMap& tempoMap) {
+    for (const auto& item : m_items) {
+        item->UpdateFromTempoMap(tempoMap);
+    }
+}
+
 void MediaItemManager::GroupSelectedItems() {
     if (m_selectedItems.size() < 2) return;
     
@@ -15,6 +15,7 @@
 class Track;
 class AudioSource;
 class AudioBuffer;
+class TempoMap;
 
 /**
  * Media Item - REAPER-style audio item with takes and non-destructive editing
@@ -103,6 +104,10 @@ public:
         // Loop source
         bool loopSource = false;        // Loop source if item is longer than source
         
+        // Timebase
+        bool beatTimebase = false;      // Position follows the tempo map
+        double positionBeats = 0.0;     // Position in beats (beat timebase only)
+        
         // Takes
         std::vector<Take> takes;
         int activeTake = 0;             // Index of active take
@@ -124,6 +129,13 @@ public:
     double GetLength() const { return m_state.length; }
     double GetEndPosition() const { return m_state.position + m_state.length; }
     
+    // Beat timebase: the item stays on its beat when the tempo map changes
+    void SetPositionBeats(double beats, const TempoMap& tempoMap);
+    double GetPositionBeats(const TempoMap& tempoMap) const;
+    void SetBeatTimebase(bool enabled, const TempoMap& tempoMap);
+    bool IsBeatTimebase() const { return m_state.beatTimebase; }
+    void UpdateFromTempoMap(const TempoMap& tempoMap);
+    
     // Snap offset for precise alignment
     void SetSnapOffset(double offset);
     double GetSnapOffset() const { return m_state.snapOffset; }
@@ -188,6 +200,10 @@ public:
     // Audio processing
     void ProcessAudio(AudioBuffer& buffer, double startTime, double length);
     
+    // Size processing buffers up front so any block or split block (loop wrap)
+    // is rendered without allocating on the audio thread
+    void PrepareToPlay(int maxBlockSize, int numChannels);
+    
     // Time range queries
     bool ContainsTime(double time) const;
     bool OverlapsTimeRange(double start, double end) const;
@@ -348,6 +364,9 @@ public:
     void SetSelectedItemsVolume(double volume);
     void SetSelectedItemsColor(const std::string& color);
     
+    // Re-place beat-timebase items after a tempo map edit
+    void UpdateTempoMap(const TempoMap& tempoMap);
+    
     // Grouping
     void GroupSelectedItems();
     void UngroupSelectedItems();
@@ -361,9 +380,14 @@ public:
     // Cleanup
     void RemoveInvalidItems();
     void OptimizeItems(); // Remove empty items, merge adjacent items, etc.
+    
+    // Playback preparation - new items are prepared for this block size
+    void SetMaxBlockSize(int maxBlockSize, int numChannels);
 
 private:
     std::vector<std::unique_ptr<MediaItem>> m_items;
+    int m_maxBlockSize = 4096;
+    int m_maxChannels = 2;
     std::vector<MediaItem*> m_selectedItems;
     int m_nextGroupId = 1;
     
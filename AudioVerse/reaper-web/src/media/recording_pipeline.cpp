@@ -0,0 +1,363 @@
+/*
+ * REAPER Web - Recording Pipeline Implementation
+ * Audio-thread capture, background WAV/RF64 writer and peak building
+ */
+
+#include "recording_pipeline.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    constexpr uint32_t kHeaderSize = 94;            // RIFF + JUNK(ds64 reserve) + fmt + fact + data header
+    constexpr uint32_t kFactOffset = 74;
+    constexpr uint32_t kDataOffset = 86;
+    constexpr uint64_t kMaxRiffSize = 0xFFFFFFFFull;
+    constexpr size_t kStdioBufferSize = 1 << 20;
+
+    void PutU16(uint8_t* dest, uint16_t value) {
+        dest[0] = static_cast<uint8_t>(value);
+        dest[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    void PutU32(uint8_t* dest, uint32_t value) {
+        for (int i = 0; i < 4; ++i) dest[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+
+    void PutU64(uint8_t* dest, uint64_t value) {
+        for (int i = 0; i < 8; ++i) dest[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+// StdioFileSink Implementation
+StdioFileSink::~StdioFileSink() {
+    Close();
+}
+
+bool StdioFileSink::Open(const std::string& filePath) {
+    Close();
+    m_file = std::fopen(filePath.c_str(), "wb");
+    if (!m_file) return false;
+
+    // Large stdio buffer so the OS sees few, big sequential writes
+    m_streamBuffer.resize(kStdioBufferSize);
+    std::setvbuf(m_file, m_streamBuffer.data(), _IOFBF, m_streamBuffer.size());
+    return true;
+}
+
+bool StdioFileSink::Write(const void* data, size_t bytes) {
+    return m_file && std::fwrite(data, 1, bytes, m_file) == bytes;
+}
+
+bool StdioFileSink::WriteAt(uint64_t offset, const void* data, size_t bytes) {
+    if (!m_file || std::fseek(m_file, static_cast<long>(offset), SEEK_SET) != 0) {
+        return false;
+    }
+    return std::fwrite(data, 1, bytes, m_file) == bytes;
+}
+
+void StdioFileSink::Close() {
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+// RecordingPipeline Implementation
+RecordingPipeline::RecordingPipeline() = default;
+
+RecordingPipeline::~RecordingPipeline() {
+    Stop();
+}
+
+bool RecordingPipeline::Start(const Settings& settings, const std::vector<TrackInput>& inputs,
+                              int64_t punchInSample, int64_t punchOutSample) {
+    Stop();
+
+    m_settings = settings;
+    m_settings.maxBlockSize = std::max(1, settings.maxBlockSize);
+    m_settings.writeChunkFrames = std::max(1, settings.writeChunkFrames);
+    m_settings.samplesPerPeak = std::max(1, settings.samplesPerPeak);
+
+    m_overrunFrames = 0;
+    m_bytesWritten = 0;
+    m_maxRingFill = 0.0;
+    m_firstSample = -1;
+    m_punchIn = punchInSample;
+    m_punchOut = punchOutSample;
+
+    // The ring absorbs disk stalls; it always holds at least two write chunks
+    size_t ringFrames = static_cast<size_t>(m_settings.ringSeconds * m_settings.sampleRate);
+    ringFrames = std::max(ringFrames, static_cast<size_t>(m_settings.writeChunkFrames) * 2);
+    ringFrames = std::max(ringFrames, static_cast<size_t>(m_settings.maxBlockSize) * 2);
+
+    for (const auto& input : inputs) {
+        auto stream = std::make_unique<TrackStream>();
+        stream->input = input;
+        stream->input.numChannels = std::max(1, input.numChannels);
+
+        size_t channels = static_cast<size_t>(stream->input.numChannels);
+        stream->ring = std::make_unique<LockFreeRingBuffer<float>>(ringFrames * channels);
+        stream->interleaveBuffer.resize(static_cast<size_t>(m_settings.maxBlockSize) * channels);
+        stream->writeBuffer.resize(static_cast<size_t>(m_settings.writeChunkFrames) * channels);
+        stream->peaks.samplesPerPeak = m_settings.samplesPerPeak;
+
+        stream->sink = m_sinkFactory ? m_sinkFactory() : std::make_unique<StdioFileSink>();
+        if (!stream->sink || !stream->sink->Open(input.filePath)) {
+            m_streams.clear();
+            return false;
+        }
+        WriteHeader(*stream);
+        m_streams.push_back(std::move(stream));
+    }
+
+    m_writerRunning = true;
+    m_writerThread = std::thread(&RecordingPipeline::WriterLoop, this);
+    m_active.store(true, std::memory_order_seq_cst);
+    return true;
+}
+
+std::vector<RecordingPipeline::RecordedTake> RecordingPipeline::Stop() {
+    std::vector<RecordedTake> takes;
+    if (!m_writerThread.joinable()) {
+        return takes;
+    }
+
+    // Stop accepting input, then wait out a Capture() already in flight.
+    // seq_cst: the store here and the depth increment in Capture() must not
+    // both be missed by the loads that follow them.
+    m_active.store(false, std::memory_order_seq_cst);
+    while (m_captureDepth.load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::yield();
+    }
+
+    // The writer drains every ring before it exits
+    m_writerRunning.store(false, std::memory_order_release);
+    m_writerThread.join();
+
+    int64_t firstSample = m_firstSample.load();
+    for (auto& stream : m_streams) {
+        FinalizeFile(*stream);
+
+        RecordedTake take;
+        take.trackIndex = stream->input.trackIndex;
+        take.filePath = stream->input.filePath;
+        take.numChannels = stream->input.numChannels;
+        take.startSample = std::max<int64_t>(firstSample, 0);
+        take.lengthSamples = static_cast<int64_t>(stream->framesWritten);
+        take.peaks = std::move(stream->peaks);
+        take.writeError = stream->writeError;
+        takes.push_back(std::move(take));
+    }
+    m_streams.clear();
+
+    return takes;
+}
+
+void RecordingPipeline::Capture(const float* const* inputs, int numInputChannels,
+                                int64_t blockStartSample, int numSamples) {
+    if (!m_active.load(std::memory_order_seq_cst)) return;
+
+    m_captureDepth.fetch_add(1, std::memory_order_seq_cst);
+    if (!m_active.load(std::memory_order_seq_cst)) {
+        m_captureDepth.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    // Clip the block to the punch window
+    int64_t begin = std::max(blockStartSample, m_punchIn.load(std::memory_order_acquire));
+    int64_t end = std::min(blockStartSample + numSamples, m_punchOut.load(std::memory_order_acquire));
+
+    if (end > begin) {
+        int64_t expected = -1;
+        m_firstSample.compare_exchange_strong(expected, begin);
+
+        int offset = static_cast<int>(begin - blockStartSample);
+        int count = static_cast<int>(end - begin);
+        double maxFill = m_maxRingFill.load(std::memory_order_relaxed);
+
+        for (auto& stream : m_streams) {
+            int channels = stream->input.numChannels;
+            float* interleaved = stream->interleaveBuffer.data();
+
+            for (int done = 0; done < count; ) {
+                int frames = std::min(count - done, m_settings.maxBlockSize);
+
+                for (int ch = 0; ch < channels; ++ch) {
+                    int inputChannel = stream->input.firstInputChannel + ch;
+                    const float* source = (inputs && inputChannel < numInputChannels) ? inputs[inputChannel] : nullptr;
+                    if (source) {
+                        source += offset + done;
+                        for (int i = 0; i < frames; ++i) interleaved[i * channels + ch] = source[i];
+                    } else {
+                        for (int i = 0; i < frames; ++i) interleaved[i * channels + ch] = 0.0f;
+                    }
+                }
+
+                // Whole frames only, so a full ring never splits a frame
+                size_t writableFrames = stream->ring->GetWriteAvailable() / channels;
+                size_t writeFrames = std::min(static_cast<size_t>(frames), writableFrames);
+                stream->ring->Write(interleaved, writeFrames * channels);
+                if (writeFrames < static_cast<size_t>(frames)) {
+                    m_overrunFrames.fetch_add(frames - writeFrames, std::memory_order_relaxed);
+                }
+                done += frames;
+            }
+
+            double fill = 1.0 - static_cast<double>(stream->ring->GetWriteAvailable()) / stream->ring->GetCapacity();
+            maxFill = std::max(maxFill, fill);
+        }
+        m_maxRingFill.store(maxFill, std::memory_order_relaxed);
+    }
+
+    m_captureDepth.fetch_sub(1, std::memory_order_release);
+}
+
+void RecordingPipeline::WriterLoop() {
+    for (;;) {
+        bool running = m_writerRunning.load(std::memory_order_acquire);
+        bool wrote = false;
+
+        // Round-robin one chunk per track so a slow file cannot starve the others
+        for (auto& stream : m_streams) {
+            wrote |= DrainStream(*stream, !running);
+        }
+
+        if (!wrote) {
+            if (!running) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+}
+
+bool RecordingPipeline::DrainStream(TrackStream& stream, bool flush) {
+    size_t channels = static_cast<size_t>(stream.input.numChannels);
+    size_t available = stream.ring->GetReadAvailable() / channels;
+    size_t chunk = static_cast<size_t>(m_settings.writeChunkFrames);
+
+    // Wait for a full chunk unless this is the final flush
+    if (available == 0 || (!flush && available < chunk)) {
+        return false;
+    }
+
+    size_t frames = std::min(available, chunk);
+    stream.ring->Read(stream.writeBuffer.data(), frames * channels);
+    AccumulatePeaks(stream, stream.writeBuffer.data(), frames);
+
+    if (!stream.writeError) {
+        size_t bytes = frames * channels * sizeof(float);
+        if (stream.sink->Write(stream.writeBuffer.data(), bytes)) {
+            m_bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+        } else {
+            stream.writeError = true;
+        }
+    }
+    stream.framesWritten += frames;
+    return true;
+}
+
+void RecordingPipeline::AccumulatePeaks(TrackStream& stream, const float* frames, size_t numFrames) {
+    int channels = stream.input.numChannels;
+    int samplesPerPeak = stream.peaks.samplesPerPeak;
+
+    for (size_t i = 0; i < numFrames; ++i) {
+        const float* frame = frames + i * channels;
+        for (int ch = 0; ch < channels; ++ch) {
+            if (stream.peakFrames == 0 && ch == 0) {
+                stream.peakMin = frame[0];
+                stream.peakMax = frame[0];
+            }
+            stream.peakMin = std::min(stream.peakMin, frame[ch]);
+            stream.peakMax = std::max(stream.peakMax, frame[ch]);
+        }
+
+        if (++stream.peakFrames == samplesPerPeak) {
+            stream.peaks.minPeaks.push_back(stream.peakMin);
+            stream.peaks.maxPeaks.push_back(stream.peakMax);
+            stream.peaks.numPeaks++;
+            stream.peakFrames = 0;
+        }
+    }
+}
+
+void RecordingPipeline::WriteHeader(TrackStream& stream) {
+    uint8_t header[kHeaderSize] = {};
+    uint16_t channels = static_cast<uint16_t>(stream.input.numChannels);
+    uint32_t sampleRate = static_cast<uint32_t>(m_settings.sampleRate + 0.5);
+    uint16_t blockAlign = static_cast<uint16_t>(channels * sizeof(float));
+
+    std::memcpy(header + 0, "RIFF", 4);
+    PutU32(header + 4, kHeaderSize - 8);
+    std::memcpy(header + 8, "WAVE", 4);
+
+    // JUNK reserves room for a ds64 chunk in case the take outgrows RIFF
+    std::memcpy(header + 12, "JUNK", 4);
+    PutU32(header + 16, 28);
+
+    // Non-PCM: fmt carries cbSize and a fact chunk holds the frame count
+    std::memcpy(header + 48, "fmt ", 4);
+    PutU32(header + 52, 18);
+    PutU16(header + 56, 3);                     // WAVE_FORMAT_IEEE_FLOAT
+    PutU16(header + 58, channels);
+    PutU32(header + 60, sampleRate);
+    PutU32(header + 64, sampleRate * blockAlign);
+    PutU16(header + 68, blockAlign);
+    PutU16(header + 70, 32);
+    PutU16(header + 72, 0);                     // cbSize
+
+    std::memcpy(header + kFactOffset, "fact", 4);
+    PutU32(header + kFactOffset + 4, 4);
+    PutU32(header + kFactOffset + 8, 0);
+
+    std::memcpy(header + kDataOffset, "data", 4);
+    PutU32(header + kDataOffset + 4, 0);
+
+    if (!stream.sink->Write(header, sizeof(header))) {
+        stream.writeError = true;
+    }
+}
+
+void RecordingPipeline::FinalizeFile(TrackStream& stream) {
+    // Flush a partial peak
+    if (stream.peakFrames > 0) {
+        stream.peaks.minPeaks.push_back(stream.peakMin);
+        stream.peaks.maxPeaks.push_back(stream.peakMax);
+        stream.peaks.numPeaks++;
+        stream.peakFrames = 0;
+    }
+
+    uint64_t dataBytes = stream.framesWritten * stream.input.numChannels * sizeof(float);
+    uint64_t riffSize = kHeaderSize - 8 + dataBytes;
+
+    if (!stream.writeError) {
+        bool ok = true;
+        uint8_t field[8];
+        if (riffSize <= kMaxRiffSize) {
+            PutU32(field, static_cast<uint32_t>(riffSize));
+            ok &= stream.sink->WriteAt(4, field, 4);
+            PutU32(field, static_cast<uint32_t>(dataBytes));
+            ok &= stream.sink->WriteAt(kDataOffset + 4, field, 4);
+            PutU32(field, static_cast<uint32_t>(stream.framesWritten));
+            ok &= stream.sink->WriteAt(kFactOffset + 8, field, 4);
+        } else {
+            // RF64: 32-bit sizes and the fact count become 0xFFFFFFFF and the
+            // real ones go in ds64
+            uint8_t ds64[36] = {};
+            std::memcpy(ds64, "ds64", 4);
+            PutU32(ds64 + 4, 28);
+            PutU64(ds64 + 8, riffSize);
+            PutU64(ds64 + 16, dataBytes);
+            PutU64(ds64 + 24, stream.framesWritten);
+
+            ok &= stream.sink->WriteAt(0, "RF64", 4);
+            PutU32(field, 0xFFFFFFFFu);
+            ok &= stream.sink->WriteAt(4, field, 4);
+            ok &= stream.sink->WriteAt(12, ds64, sizeof(ds64));
+            ok &= stream.sink->WriteAt(kDataOffset + 4, field, 4);
+            ok &= stream.sink->WriteAt(kFactOffset + 8, field, 4);
+        }
+        stream.writeError = !ok;
+    }
+
+    stream.sink->Close();
+}
@@ -0,0 +1,155 @@
+/*
+ * REAPER Web - Recording Pipeline
+ * Captures armed track inputs on the audio thread and streams them to disk
+ * from a background writer thread
+ */
+
+#pragma once
+
+#include "media_item.hpp"
+#include "../core/lockfree_ring_buffer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Recording File Sink - destination for one recorded take
+ * The pipeline writes sequentially and patches the header once at the end.
+ * The default sink wraps stdio; tests substitute slow or in-memory sinks.
+ */
+class RecordingFileSink {
+public:
+    virtual ~RecordingFileSink() = default;
+    virtual bool Open(const std::string& filePath) = 0;
+    virtual bool Write(const void* data, size_t bytes) = 0;
+    virtual bool WriteAt(uint64_t offset, const void* data, size_t bytes) = 0;
+    virtual void Close() = 0;
+};
+
+class StdioFileSink : public RecordingFileSink {
+public:
+    ~StdioFileSink() override;
+    bool Open(const std::string& filePath) override;
+    bool Write(const void* data, size_t bytes) override;
+    bool WriteAt(uint64_t offset, const void* data, size_t bytes) override;
+    void Close() override;
+
+private:
+    FILE* m_file = nullptr;
+    std::vector<char> m_streamBuffer;
+};
+
+/**
+ * Recording Pipeline - lock-free multitrack capture
+ *
+ * Audio thread: Capture() copies each armed track's input frames into that
+ * track's SPSC ring buffer, clipped to the punch window in project samples.
+ * It never blocks, locks or allocates; if a ring is full the frames are
+ * dropped and counted as an overrun.
+ *
+ * Writer thread: drains every ring in large chunks, writes 32-bit float WAV
+ * (promoted to RF64 on close when the data passes 4 GB) and builds waveform
+ * peaks on the fly, so takes are displayable as soon as recording stops.
+ */
+class RecordingPipeline {
+public:
+    static constexpr int64_t kNoPunchOut = std::numeric_limits<int64_t>::max();
+
+    struct Settings {
+        double sampleRate = 48000.0;
+        int maxBlockSize = 4096;            // Largest block passed to Capture()
+        double ringSeconds = 2.0;           // Per-track buffering against disk stalls
+        int writeChunkFrames = 32768;       // Frames per sequential write
+        int samplesPerPeak = 1024;
+    };
+
+    struct TrackInput {
+        int trackIndex = -1;
+        int firstInputChannel = 0;
+        int numChannels = 1;
+        std::string filePath;
+    };
+
+    struct RecordedTake {
+        int trackIndex = -1;
+        std::string filePath;
+        int numChannels = 1;
+        int64_t startSample = 0;            // Project sample of the first frame
+        int64_t lengthSamples = 0;
+        AudioSource::PeakData peaks;        // Min/max across channels
+        bool writeError = false;
+    };
+
+    using SinkFactory = std::function<std::unique_ptr<RecordingFileSink>()>;
+
+public:
+    RecordingPipeline();
+    ~RecordingPipeline();
+
+    RecordingPipeline(const RecordingPipeline&) = delete;
+    RecordingPipeline& operator=(const RecordingPipeline&) = delete;
+
+    // Non-realtime control
+    void SetSinkFactory(SinkFactory factory) { m_sinkFactory = std::move(factory); }
+    bool Start(const Settings& settings, const std::vector<TrackInput>& inputs,
+               int64_t punchInSample, int64_t punchOutSample = kNoPunchOut);
+    std::vector<RecordedTake> Stop();
+    bool IsActive() const { return m_active.load(std::memory_order_acquire); }
+
+    // Any thread: move the punch-out point (sample-accurate stop)
+    void SetPunchOut(int64_t sample) { m_punchOut.store(sample, std::memory_order_release); }
+
+    // Audio thread: block of device inputs starting at project sample 'blockStartSample'
+    void Capture(const float* const* inputs, int numInputChannels, int64_t blockStartSample, int numSamples);
+
+    // Statistics
+    uint64_t GetOverrunFrames() const { return m_overrunFrames.load(); }
+    uint64_t GetBytesWritten() const { return m_bytesWritten.load(); }
+    double GetMaxRingFill() const { return m_maxRingFill.load(); }   // 0-1, worst track
+
+private:
+    struct TrackStream {
+        TrackInput input;
+        std::unique_ptr<LockFreeRingBuffer<float>> ring;
+        std::vector<float> interleaveBuffer;        // Audio thread scratch
+        std::vector<float> writeBuffer;             // Writer thread scratch
+        std::unique_ptr<RecordingFileSink> sink;
+        uint64_t framesWritten = 0;
+        bool writeError = false;
+
+        // Peak accumulation
+        AudioSource::PeakData peaks;
+        float peakMin = 0.0f;
+        float peakMax = 0.0f;
+        int peakFrames = 0;
+    };
+
+    Settings m_settings;
+    SinkFactory m_sinkFactory;
+    std::vector<std::unique_ptr<TrackStream>> m_streams;
+
+    std::atomic<bool> m_active{false};
+    std::atomic<bool> m_writerRunning{false};
+    std::atomic<int> m_captureDepth{0};
+    std::thread m_writerThread;
+
+    std::atomic<int64_t> m_punchIn{0};
+    std::atomic<int64_t> m_punchOut{kNoPunchOut};
+    std::atomic<int64_t> m_firstSample{-1};
+
+    std::atomic<uint64_t> m_overrunFrames{0};
+    std::atomic<uint64_t> m_bytesWritten{0};
+    std::atomic<double> m_maxRingFill{0.0};
+
+    void WriterLoop();
+    bool DrainStream(TrackStream& stream, bool flush);
+    void AccumulatePeaks(TrackStream& stream, const float* frames, size_t numFrames);
+    void WriteHeader(TrackStream& stream);
+    void FinalizeFile(TrackStream& stream);
+};
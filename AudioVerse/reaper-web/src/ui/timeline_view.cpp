@@ -5,6 +5,7 @@
 
 #include "timeline_view.hpp"
 #include "reaper_engine.hpp"
+#include "tempo_map.hpp"
 #include <algorithm>
 #include <cmath>
 #include <sstream>
@@ -346,12 +347,16 @@ std::string TimelineView::FormatMinutesSecondsTime(double time) const {
 std::string TimelineView::FormatMeasuresBeatsTime(double time) const {
     if (!m_engine) return "1:1.000";
     
-    double tempo = m_engine->GetTransportState().tempo.load();
-    double beats = SecondsToBeats(time, tempo);
-    int timeSigNum = m_engine->GetTransportState().timeSigNumerator.load();
+    const TempoMap* tempoMap = m_engine->GetTempoMap();
+    if (!tempoMap) return "1:1.000";
     
-    int measure = static_cast<int>(beats / timeSigNum) + 1;
-    double beat = fmod(beats, timeSigNum) + 1.0;
+    // Bars follow the tempo map, so meter changes shift the measure count
+    double beats = tempoMap->SecondsToBeats(time);
+    double bars = tempoMap->BeatsToBars(beats);
+    double barStart = floor(bars + 1e-9);
+    
+    int measure = static_cast<int>(barStart) + 1;
+    double beat = std::max(0.0, beats - tempoMap->BarsToBeats(barStart)) + 1.0;
     
     std::ostringstream oss;
     oss << measure << ":" << std::fixed << std::setprecision(3) << beat;
@@ -402,18 +407,22 @@ void TimelineView::CalculateBeatsGrid(std::vector<GridLine>& lines) const {
         return;
     }
     
-    double tempo = m_engine->GetTransportState().tempo.load();
-    double beatLength = 60.0 / tempo; // Length of one beat in seconds
+    const TempoMap* tempoMap = m_engine->GetTempoMap();
+    if (!tempoMap) {
+        CalculateSecondsGrid(lines);
+        return;
+    }
     
-    double startBeat = floor(m_viewState.timeStart / beatLength);
-    double endBeat = ceil(m_viewState.timeEnd / beatLength);
+    double startBeat = std::max(0.0, floor(tempoMap->SecondsToBeats(m_viewState.timeStart)));
+    double endBeat = ceil(tempoMap->SecondsToBeats(m_viewState.timeEnd));
     
     for (double beat = startBeat; beat <= endBeat; beat += 1.0) {
-        double time = beat * beatLength;
+        double time = tempoMap->BeatsToSeconds(beat);
         if (time >= m_viewState.timeStart && time <= m_viewState.timeEnd) {
+            double bars = tempoMap->BeatsToBars(beat);
             GridLine line;
             line.time = time;
-            line.type = (fmod(beat, 4.0) < 0.001) ? 1 : 0; // Major every 4 beats (measure)
+            line.type = (fabs(bars - round(bars)) < 0.001) ? 1 : 0; // Major on bar lines
             line.label = FormatTime(time);
             lines.push_back(line);
         }
@@ -471,9 +480,20 @@ double TimelineView::SnapToSeconds(double time) const {
 double TimelineView::SnapToBeats(double time) const {
     if (!m_engine) return time;
     
-    double tempo = m_engine->GetTransportState().tempo.load();
-    double beatLength = 60.0 / tempo;
-    return round(time / beatLength) * beatLength;
+    const TempoMap* tempoMap = m_engine->GetTempoMap();
+    if (!tempoMap) return time;
+    
+    return tempoMap->BeatsToSeconds(round(tempoMap->SecondsToBeats(time)));
+}
+
+double TimelineView::SnapToMeasures(double time) const {
+    if (!m_engine) return time;
+    
+    const TempoMap* tempoMap = m_engine->GetTempoMap();
+    if (!tempoMap) return time;
+    
+    double bars = tempoMap->BeatsToBars(tempoMap->SecondsToBeats(time));
+    return tempoMap->BeatsToSeconds(tempoMap->BarsToBeats(round(bars)));
 }
 
 double TimelineView::ClampZoom(double zoom) const {
@@ -11,6 +11,7 @@
 #include "../core/track_manager.hpp"
 #include "../core/project_manager.hpp"
 #include "../media/media_item.hpp"
+#include "../effects/effect_chain.hpp"
 #include "../effects/jsfx_processor.hpp"
 #include <memory>
 #include <vector>
@@ -181,6 +182,52 @@ double reaper_transport_get_tempo() {
     return 120.0;
 }
 
+// Tempo Map
+EMSCRIPTEN_KEEPALIVE
+void reaper_tempo_add_marker(double beat, double bpm, int rampToNext, int timeSigNumerator, int timeSigDenominator) {
+    if (g_reaperEngine) {
+        TempoMarker marker;
+        marker.beat = beat;
+        marker.bpm = bpm;
+        marker.rampToNext = rampToNext != 0;
+        marker.timeSigNumerator = timeSigNumerator;
+        marker.timeSigDenominator = timeSigDenominator;
+        g_reaperEngine->AddTempoMarker(marker);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int reaper_tempo_remove_marker(int index) {
+    if (g_reaperEngine) {
+        return g_reaperEngine->RemoveTempoMarker(index) ? 1 : 0;
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int reaper_tempo_get_marker_count() {
+    if (g_reaperEngine) {
+        return static_cast<int>(g_reaperEngine->GetTempoMarkers().size());
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+double reaper_tempo_beats_to_seconds(double beats) {
+    if (g_reaperEngine) {
+        return g_reaperEngine->BeatsToSeconds(beats);
+    }
+    return beats * 0.5;
+}
+
+EMSCRIPTEN_KEEPALIVE
+double reaper_tempo_seconds_to_beats(double seconds) {
+    if (g_reaperEngine) {
+        return g_reaperEngine->SecondsToBeats(seconds);
+    }
+    return seconds * 2.0;
+}
+
 // Track Management
 EMSCRIPTEN_KEEPALIVE
 int reaper_track_create() {
@@ -322,6 +369,31 @@ int reaper_track_add_effect(int trackId, const char* effectName) {
     return -1;
 }
 
+// Loads off the UI thread; the effect appears in the chain once compiled and
+// initialized. index < 0 appends. Returns false for an unknown effect.
+EMSCRIPTEN_KEEPALIVE
+bool reaper_track_add_effect_async(int trackId, const char* effectName, int index) {
+    if (g_reaperEngine && g_reaperEngine->GetTrackManager()) {
+        auto track = g_reaperEngine->GetTrackManager()->GetTrack(trackId);
+        if (track && track->GetEffectProcessor()) {
+            size_t position = index < 0 ? SIZE_MAX : static_cast<size_t>(index);
+            return track->GetEffectProcessor()->AddBuiltinEffectAsync(std::string(effectName), position);
+        }
+    }
+    return false;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int reaper_track_get_pending_effect_loads(int trackId) {
+    if (g_reaperEngine && g_reaperEngine->GetTrackManager()) {
+        auto track = g_reaperEngine->GetTrackManager()->GetTrack(trackId);
+        if (track && track->GetEffectsChain()) {
+            return track->GetEffectsChain()->GetPendingLoadCount();
+        }
+    }
+    return 0;
+}
+
 EMSCRIPTEN_KEEPALIVE
 void reaper_track_remove_effect(int trackId, int effectId) {
     if (g_reaperEngine && g_reaperEngine->GetTrackManager()) {
@@ -363,6 +435,72 @@ void reaper_effect_set_bypass(int trackId, int effectId, int bypassed) {
     }
 }
 
+// JSFX watchdog: effects bypassed for overrunning their instruction budget
+EMSCRIPTEN_KEEPALIVE
+int reaper_effect_is_watchdog_tripped(int trackId, int effectId) {
+    if (g_reaperEngine && g_reaperEngine->GetTrackManager()) {
+        auto track = g_reaperEngine->GetTrackManager()->GetTrack(trackId);
+        if (track && track->GetEffectsChain() && effectId >= 0) {
+            return track->GetEffectsChain()->IsEffectWatchdogTripped(static_cast<size_t>(effectId)) ? 1 : 0;
+        }
+    }
+    return 0;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void reaper_effect_reset_watchdog(int trackId, int effectId) {
+    if (g_reaperEngine && g_reaperEngine->GetTrackManager()) {
+        auto track = g_reaperEngine->GetTrackManager()->GetTrack(trackId);
+        if (track && track->GetEffectsChain() && effectId >= 0) {
+            track->GetEffectsChain()->ResetEffectWatchdog(static_cast<size_t>(effectId));
+        }
+    }
+}
+
+// JSFX profiler: per-line hot spots of one effect's script
+EMSCRIPTEN_KEEPALIVE
+void reaper_effect_set_profiling(int trackId, int effectId, int enabled) {
+    if (g_reaperEngine && g_reaperEngine->GetTrackManager()) {
+        auto track = g_reaperEngine->GetTrackManager()->GetTrack(trackId);
+        if (track && track->GetEffectsChain() && effectId >= 0) {
+            track->GetEffectsChain()->SetEffectProfiling(static_cast<size_t>(effectId), enabled != 0);
+        }
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+void reaper_effect_reset_profile(int trackId, int effectId) {
+    if (g_reaperEngine && g_reaperEngine->GetTrackManager()) {
+        auto track = g_reaperEngine->GetTrackManager()->GetTrack(trackId);
+        if (track && track->GetEffectsChain() && effectId >= 0) {
+            track->GetEffectsChain()->ResetEffectProfile(static_cast<size_t>(effectId));
+        }
+    }
+}
+
+// Text table, hottest line first; valid until the next call
+EMSCRIPTEN_KEEPALIVE
+const char* reaper_effect_get_profile_report(int trackId, int effectId, int maxRows) {
+    static std::string report;
+    report.clear();
+    if (g_reaperEngine && g_reaperEngine->GetTrackManager()) {
+        auto track = g_reaperEngine->GetTrackManager()->GetTrack(trackId);
+        if (track && track->GetEffectsChain() && effectId >= 0 && maxRows > 0) {
+            report = track->GetEffectsChain()->GetEffectProfileReport(static_cast<size_t>(effectId),
+                                                                       static_cast<size_t>(maxRows));
+        }
+    }
+    return report.c_str();
+}
+
+EMSCRIPTEN_KEEPALIVE
+int reaper_get_watchdog_trips() {
+    if (g_reaperEngine && g_reaperEngine->GetAudioEngine()) {
+        return g_reaperEngine->GetAudioEngine()->GetPerformanceStats().watchdogTrips.load();
+    }
+    return 0;
+}
+
 // Media Items
 EMSCRIPTEN_KEEPALIVE
 int reaper_media_item_create(int trackId, double startTime, double length) {
@@ -508,6 +646,51 @@ void reaper_reset_performance_counters() {
     }
 }
 
+// Analyzers: snapshots are read in place from the heap, see AnalyzerService::Snapshot
+EMSCRIPTEN_KEEPALIVE
+int reaper_analyzer_create(int trackId, int fftSize, int numBands) {
+    if (!g_reaperEngine || !g_reaperEngine->GetAudioEngine()) return -1;
+    
+    // trackId -1 taps the master
+    Track* track = nullptr;
+    if (trackId >= 0) {
+        track = g_reaperEngine->GetTrackManager() ? g_reaperEngine->GetTrackManager()->GetTrack(trackId) : nullptr;
+        if (!track) return -1;
+    }
+    
+    AnalyzerService::Settings settings;
+    settings.fftSize = fftSize;
+    settings.numBands = numBands;
+    return g_reaperEngine->GetAudioEngine()->GetAnalyzerService()->CreateAnalyzer(track, settings);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void reaper_analyzer_destroy(int analyzerId) {
+    if (g_reaperEngine && g_reaperEngine->GetAudioEngine()) {
+        g_reaperEngine->GetAudioEngine()->GetAnalyzerService()->DestroyAnalyzer(analyzerId);
+    }
+}
+
+// Heap address of the latest snapshot; stable until the next call for this analyzer
+EMSCRIPTEN_KEEPALIVE
+uintptr_t reaper_analyzer_get_snapshot(int analyzerId) {
+    if (g_reaperEngine && g_reaperEngine->GetAudioEngine()) {
+        return reinterpret_cast<uintptr_t>(
+            g_reaperEngine->GetAudioEngine()->GetAnalyzerService()->AcquireSnapshot(analyzerId));
+    }
+    return 0;
+}
+
+// Heap address of the band centre frequencies; stable for the analyzer's lifetime
+EMSCRIPTEN_KEEPALIVE
+uintptr_t reaper_analyzer_get_band_frequencies(int analyzerId) {
+    if (g_reaperEngine && g_reaperEngine->GetAudioEngine()) {
+        return reinterpret_cast<uintptr_t>(
+            g_reaperEngine->GetAudioEngine()->GetAnalyzerService()->GetBandFrequencies(analyzerId));
+    }
+    return 0;
+}
+
 } // extern "C"
 
 // Emscripten bindings for C++ classes (for more advanced JS interaction)
@@ -546,10 +729,20 @@ EMSCRIPTEN_BINDINGS(reaper_engine) {
     
     // Effects functions
     function("addEffect", &reaper_track_add_effect);
+    function("addEffectAsync", &reaper_track_add_effect_async);
+    function("getPendingEffectLoads", &reaper_track_get_pending_effect_loads);
     function("removeEffect", &reaper_track_remove_effect);
     function("setEffectParameter", &reaper_effect_set_parameter);
     function("getEffectParameter", &reaper_effect_get_parameter);
     function("setEffectBypass", &reaper_effect_set_bypass);
+    function("isEffectWatchdogTripped", &reaper_effect_is_watchdog_tripped);
+    function("resetEffectWatchdog", &reaper_effect_reset_watchdog);
+    function("getWatchdogTrips", &reaper_get_watchdog_trips);
+    function("setEffectProfiling", &reaper_effect_set_profiling);
+    function("resetEffectProfile", &reaper_effect_reset_profile);
+    function("getEffectProfileReport", optional_override([](int trackId, int effectId, int maxRows) {
+        return std::string(reaper_effect_get_profile_report(trackId, effectId, maxRows));
+    }));
     
     // Media item functions
     function("createMediaItem", &reaper_media_item_create);
@@ -575,4 +768,10 @@ EMSCRIPTEN_BINDINGS(reaper_engine) {
     function("getCPUUsage", &reaper_get_cpu_usage);
     function("getAudioDropouts", &reaper_get_audio_dropouts);
     function("resetPerformanceCounters", &reaper_reset_performance_counters);
+    
+    // Analyzers
+    function("createAnalyzer", &reaper_analyzer_create);
+    function("destroyAnalyzer", &reaper_analyzer_destroy);
+    function("getAnalyzerSnapshot", &reaper_analyzer_get_snapshot);
+    function("getAnalyzerBandFrequencies", &reaper_analyzer_get_band_frequencies);
 }
\ No newline at end of file
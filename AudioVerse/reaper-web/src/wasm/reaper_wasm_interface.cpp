@@ -154,6 +154,21 @@ void reaper_engine_set_metronome(int enabled) {
     if (g_engine) g_engine->SetMetronome(enabled != 0);
 }
 
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_set_click_volume(int volume) {
+    if (g_engine) g_engine->SetClickVolume(volume);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_set_count_in(int enabled, int bars) {
+    if (g_engine) g_engine->SetCountIn(enabled != 0, bars);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void reaper_engine_set_loop_splice_fade(double seconds) {
+    if (g_engine) g_engine->SetLoopSpliceFade(seconds);
+}
+
 // Audio settings
 EMSCRIPTEN_KEEPALIVE
 void reaper_engine_set_sample_rate(double rate) {
@@ -0,0 +1,274 @@
+/*
+ * REAPER Web - Analyzer Service Test Application
+ * Spectrum calibration, correlation, snapshot stability and audio-thread cost of the analyzers
+ */
+
+#include "src/core/analyzer_service.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Generator = std::function<void(int64_t index, float& left, float& right)>;
+
+    // Stand-ins for tracks: the service only compares the pointers
+    const Track* FakeTrack(int index) {
+        static char tracks[64];
+        return reinterpret_cast<const Track*>(&tracks[index]);
+    }
+}
+
+/**
+ * Analyzer service tests
+ */
+class AnalyzerTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Analyzer Service Test ===\n";
+
+        bool ok = true;
+        ok &= TestCalibration();
+        ok &= TestCorrelation();
+        ok &= TestSnapshotStability();
+        ok &= TestSharedTaps();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 128;
+
+    // Feeds 'length' samples to the master tap, analysing as the thread would
+    void Feed(AnalyzerService& service, const Generator& generator, int64_t length, int64_t start = 0) {
+        AudioBuffer buffer(2, kBlockSize);
+        for (int64_t position = 0; position < length; position += kBlockSize) {
+            for (int i = 0; i < kBlockSize; ++i) {
+                generator(start + position + i, buffer.GetChannelData(0)[i], buffer.GetChannelData(1)[i]);
+            }
+            service.CaptureMaster(buffer);
+            service.EndBlock();
+            if ((position / kBlockSize) % 8 == 7) service.ProcessPending();
+        }
+        service.ProcessPending();
+    }
+
+    // A bin-centred sine at -6 dBFS reads -6 dB in its band; distant bands stay quiet
+    bool TestCalibration() {
+        std::cout << "\n--- Testing Spectrum Calibration (-6 dBFS sine) ---\n";
+
+        AnalyzerService service;
+        service.Prepare(kSampleRate);
+
+        bool ok = true;
+        for (int fftSize : {1024, 4096, 16384}) {
+            AnalyzerService::Settings settings;
+            settings.fftSize = fftSize;
+            settings.numBands = 120;
+            int id = service.CreateAnalyzer(nullptr, settings);
+            service.Stop();     // Drive the analysis by hand for a deterministic result
+
+            double frequency = std::round(1000.0 * fftSize / kSampleRate) * kSampleRate / fftSize;
+            Feed(service, [frequency](int64_t n, float& left, float& right) {
+                left = right = static_cast<float>(0.5 * std::sin(2.0 * M_PI * frequency * n / kSampleRate));
+            }, fftSize * 4);
+
+            const AnalyzerService::Snapshot* snapshot = service.AcquireSnapshot(id);
+            const float* centres = service.GetBandFrequencies(id);
+            int toneBand = 0, farBand = 0;
+            for (int b = 0; b < snapshot->numBands; ++b) {
+                if (std::abs(std::log(centres[b] / frequency)) < std::abs(std::log(centres[toneBand] / frequency))) toneBand = b;
+                if (std::abs(std::log(centres[b] / 100.0)) < std::abs(std::log(centres[farBand] / 100.0))) farBand = b;
+            }
+            float tone = snapshot->bandsDb[toneBand];
+            float far = snapshot->bandsDb[farBand];
+            bool pass = std::abs(tone + 6.02f) < 0.1f && far < -80.0f && std::abs(snapshot->peakDb[0] + 6.02f) < 0.05f &&
+                        std::abs(snapshot->rmsDb[0] + 9.03f) < 0.1f;
+            std::cout << (pass ? "✓ " : "✗ ") << "FFT " << fftSize << ": " << std::fixed << std::setprecision(2)
+                      << frequency << " Hz band " << tone << " dB, 100 Hz band " << far << " dB, peak "
+                      << snapshot->peakDb[0] << " dBFS, RMS " << snapshot->rmsDb[0] << " dBFS\n";
+            std::cout.unsetf(std::ios::fixed);
+            ok &= pass;
+            service.DestroyAnalyzer(id);
+        }
+        return ok;
+    }
+
+    bool TestCorrelation() {
+        std::cout << "\n--- Testing Stereo Correlation ---\n";
+
+        struct Case {
+            const char* name;
+            double expected;
+            Generator generator;
+        };
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+        std::vector<Case> cases = {
+            {"Mono", 1.0, [](int64_t n, float& l, float& r) { l = r = static_cast<float>(std::sin(0.03 * n)); }},
+            {"Inverted", -1.0, [](int64_t n, float& l, float& r) { l = static_cast<float>(std::sin(0.03 * n)); r = -l; }},
+            {"Independent noise", 0.0, [&](int64_t, float& l, float& r) { l = noise(random); r = noise(random); }},
+        };
+
+        bool ok = true;
+        for (const Case& test : cases) {
+            AnalyzerService service;
+            service.Prepare(kSampleRate);
+            int id = service.CreateAnalyzer(nullptr);
+            service.Stop();
+            Feed(service, test.generator, static_cast<int64_t>(kSampleRate * 3));
+
+            float correlation = service.AcquireSnapshot(id)->correlation;
+            bool pass = std::abs(correlation - test.expected) < 0.05;
+            std::cout << (pass ? "✓ " : "✗ ") << test.name << ": correlation " << std::fixed << std::setprecision(3)
+                      << correlation << "\n";
+            std::cout.unsetf(std::ios::fixed);
+            ok &= pass;
+        }
+        return ok;
+    }
+
+    // The acquired snapshot never changes under the reader, even as updates land
+    bool TestSnapshotStability() {
+        std::cout << "\n--- Testing Snapshot Stability (analysis thread running) ---\n";
+
+        AnalyzerService service;
+        service.Prepare(kSampleRate);
+        AnalyzerService::Settings settings;
+        settings.fftSize = 1024;
+        int id = service.CreateAnalyzer(nullptr, settings);
+
+        std::atomic<bool> feeding{true};
+        std::thread audio([&]() {
+            AudioBuffer buffer(2, kBlockSize);
+            int64_t position = 0;
+            while (feeding.load()) {
+                for (int i = 0; i < kBlockSize; ++i, ++position) {
+                    buffer.GetChannelData(0)[i] = buffer.GetChannelData(1)[i] = static_cast<float>(std::sin(0.01 * position));
+                }
+                service.CaptureMaster(buffer);
+                service.EndBlock();
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        });
+
+        int changedUnderReader = 0, fresh = 0;
+        uint32_t lastSequence = 0;
+        for (int frame = 0; frame < 200; ++frame) {
+            const AnalyzerService::Snapshot* snapshot = service.AcquireSnapshot(id);
+            uint32_t sequence = snapshot->sequence;
+            float band = snapshot->bandsDb[10];
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            if (snapshot->sequence != sequence || snapshot->bandsDb[10] != band) changedUnderReader++;
+            if (sequence > lastSequence) fresh++;
+            lastSequence = std::max(lastSequence, sequence);
+        }
+        feeding = false;
+        audio.join();
+
+        bool pass = changedUnderReader == 0 && fresh > 20;
+        std::cout << (pass ? "✓ " : "✗ ") << fresh << " fresh snapshots in 200 reads, "
+                  << changedUnderReader << " changed while held\n";
+        return pass;
+    }
+
+    // Many analyzers on one source share a single tap and a single FFT
+    bool TestSharedTaps() {
+        std::cout << "\n--- Testing Shared Taps ---\n";
+
+        AnalyzerService service;
+        service.Prepare(kSampleRate);
+        std::vector<int> ids;
+        for (int i = 0; i < 12; ++i) ids.push_back(service.CreateAnalyzer(nullptr));
+        int trackAnalyzer = service.CreateAnalyzer(FakeTrack(3));
+        service.Stop();
+
+        // Master gets a tone, the track stays silent
+        AudioBuffer tone(2, kBlockSize), silence(2, kBlockSize);
+        for (int block = 0; block < 200; ++block) {
+            for (int i = 0; i < kBlockSize; ++i) {
+                tone.GetChannelData(0)[i] = tone.GetChannelData(1)[i] = static_cast<float>(std::sin(0.1 * (block * kBlockSize + i)));
+            }
+            service.CaptureTrack(FakeTrack(3), silence);
+            service.CaptureTrack(FakeTrack(5), tone);       // Untapped: ignored
+            service.CaptureMaster(tone);
+            service.EndBlock();
+            service.ProcessPending();
+        }
+
+        bool identical = true;
+        const AnalyzerService::Snapshot* first = service.AcquireSnapshot(ids[0]);
+        for (int id : ids) {
+            const AnalyzerService::Snapshot* snapshot = service.AcquireSnapshot(id);
+            identical &= std::equal(snapshot->bandsDb, snapshot->bandsDb + snapshot->numBands, first->bandsDb);
+        }
+        const AnalyzerService::Snapshot* track = service.AcquireSnapshot(trackAnalyzer);
+        float trackMax = *std::max_element(track->bandsDb, track->bandsDb + track->numBands);
+        bool pass = identical && first->peakDb[0] > -1.0f && trackMax == AnalyzerService::kFloorDb;
+        std::cout << (pass ? "✓ " : "✗ ") << "12 master analyzers agree, silent track reads "
+                  << trackMax << " dB\n";
+        return pass;
+    }
+
+    // Audio-thread cost per block with the analysis thread live
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: audio-thread capture cost, 128-sample blocks ---\n";
+
+        for (int analyzersPerSource : {0, 1, 6}) {
+            AnalyzerService service;
+            service.Prepare(kSampleRate);
+            const int tracks = 8;
+            for (int i = 0; i < analyzersPerSource; ++i) {
+                service.CreateAnalyzer(nullptr);
+                for (int t = 0; t < tracks; ++t) service.CreateAnalyzer(FakeTrack(t));
+            }
+
+            AudioBuffer buffer(2, kBlockSize);
+            for (int i = 0; i < kBlockSize; ++i) {
+                buffer.GetChannelData(0)[i] = buffer.GetChannelData(1)[i] = static_cast<float>(std::sin(0.05 * i));
+            }
+
+            // Paced at twice real time so the analysis thread keeps up
+            const int blocks = 4000;
+            double captureSeconds = 0.0;
+            auto blockDuration = std::chrono::duration<double>(kBlockSize / kSampleRate / 2.0);
+            auto next = std::chrono::steady_clock::now();
+            for (int block = 0; block < blocks; ++block) {
+                auto start = std::chrono::steady_clock::now();
+                for (int t = 0; t < tracks; ++t) service.CaptureTrack(FakeTrack(t), buffer);
+                service.CaptureMaster(buffer);
+                service.EndBlock();
+                captureSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(blockDuration);
+                std::this_thread::sleep_until(next);
+            }
+            service.Stop();
+
+            int id = analyzersPerSource > 0 ? 1 : 0;
+            const AnalyzerService::Snapshot* snapshot = id ? service.AcquireSnapshot(id) : nullptr;
+            std::cout << analyzersPerSource * (tracks + 1) << " analyzers on " << tracks << " tracks + master: "
+                      << std::fixed << std::setprecision(3) << 1e6 * captureSeconds / blocks << " us per block"
+                      << ", dropped " << (snapshot ? snapshot->droppedFrames : 0) << " frames\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Analyzer Service Test\n";
+    std::cout << "==================================\n";
+
+    AnalyzerTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
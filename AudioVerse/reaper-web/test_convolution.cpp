@@ -0,0 +1,215 @@
+/*
+ * REAPER Web - Convolution Test Application
+ * Partitioned convolution against direct convolution, plus CPU per reverb instance
+ */
+
+#include "src/effects/reaper_effects.hpp"
+#include "src/effects/native_effects.hpp"
+#include "src/effects/convolution_engine.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // Decaying noise, a different tail per channel like a measured room
+    std::vector<std::vector<float>> MakeImpulse(int numChannels, size_t length, double) {
+        std::vector<std::vector<float>> impulse(numChannels, std::vector<float>(length));
+        for (int ch = 0; ch < numChannels; ++ch) {
+            uint32_t seed = 12345u + ch * 977u;
+            for (size_t i = 0; i < length; ++i) {
+                seed = seed * 1664525u + 1013904223u;
+                double noise = (seed >> 8) / 16777216.0 - 0.5;
+                impulse[ch][i] = static_cast<float>(noise * std::exp(-3.0 * i / (double)length) * 0.05);
+            }
+            impulse[ch][0] = 1.0f;
+        }
+        return impulse;
+    }
+
+    std::vector<float> MakeSignal(size_t length, int channel) {
+        std::vector<float> signal(length);
+        uint32_t seed = 777u + channel * 31u;
+        for (size_t i = 0; i < length; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            signal[i] = static_cast<float>((seed >> 8) / 16777216.0 - 0.5);
+        }
+        return signal;
+    }
+}
+
+/**
+ * Convolution tests
+ */
+class ConvolutionTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Convolution Test ===\n";
+
+        bool ok = true;
+        ok &= TestEngine(true);
+        ok &= TestEngine(false);
+        ok &= TestEffect();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr double kTolerance = 1e-3;     // Relative to the output peak
+
+    BuiltinEffectsManager m_effectsManager;
+
+    bool TestEngine(bool backgroundThreads) {
+        std::cout << "\n--- Testing Engine vs Direct Convolution ("
+                  << (backgroundThreads ? "background threads" : "inline") << ") ---\n";
+
+        // Long enough to reach the last stage; sizes that straddle partitions
+        const size_t impulseLength = 70001;
+        const size_t signalLength = 150000;
+        auto impulse = MakeImpulse(2, impulseLength, kSampleRate);
+        std::vector<float> input[2] = {MakeSignal(signalLength, 0), MakeSignal(signalLength, 1)};
+        std::vector<float> output[2] = {std::vector<float>(signalLength), std::vector<float>(signalLength)};
+
+        ConvolutionEngine engine;
+        ConvolutionEngine::Settings settings;
+        settings.backgroundThreads = backgroundThreads;
+        if (!engine.Load(impulse, 2, settings)) {
+            std::cout << "✗ Load failed\n";
+            return false;
+        }
+
+        // Block sizes vary so partial 64-sample blocks are covered
+        const int blockSizes[] = {512, 1, 100, 64, 1000, 37};
+        size_t position = 0;
+        for (int block = 0; position < signalLength; ++block) {
+            int count = static_cast<int>(std::min<size_t>(blockSizes[block % 6], signalLength - position));
+            const float* inputs[2] = {input[0].data() + position, input[1].data() + position};
+            float* outputs[2] = {output[0].data() + position, output[1].data() + position};
+            engine.Process(inputs, outputs, count);
+            position += count;
+        }
+
+        // Direct convolution at sampled positions, including the first samples
+        double maxError = 0.0;
+        double peak = 0.0;
+        for (int ch = 0; ch < 2; ++ch) {
+            for (size_t n = 0; n < signalLength; n += (n < 256 ? 1 : 997)) {
+                double expected = 0.0;
+                for (size_t k = 0; k <= n && k < impulseLength; ++k) {
+                    expected += static_cast<double>(impulse[ch][k]) * input[ch][n - k];
+                }
+                maxError = std::max(maxError, std::abs(output[ch][n] - expected));
+                peak = std::max(peak, std::abs(expected));
+            }
+        }
+
+        bool zeroLatency = std::abs(output[0][0] - input[0][0] * impulse[0][0]) < 1e-6;
+        bool ok = zeroLatency && maxError <= kTolerance * peak;
+        std::cout << (zeroLatency ? "✓ " : "✗ ") << "Zero latency\n";
+        std::cout << (ok ? "✓ " : "✗ ") << engine.GetStageCount() << " stages, max error " << maxError
+                  << " (peak " << peak << ")\n";
+        return ok;
+    }
+
+    bool TestEffect() {
+        std::cout << "\n--- Testing Convolution Reverb Effect ---\n";
+
+        auto effect = m_effectsManager.CreateEffect("Convolution Reverb");
+        auto* reverb = dynamic_cast<NativeConvolutionEffect*>(effect.get());
+        bool registered = reverb && effect->IsNative() &&
+                          m_effectsManager.GetEffectScript("Convolution Reverb").empty();
+        std::cout << (registered ? "✓ " : "✗ ") << "Registered as a native-only effect\n";
+        if (!registered) return false;
+
+        // A unit impulse at 24 kHz delayed by 10 samples is 20 samples at 48 kHz
+        std::vector<std::vector<float>> impulse(1, std::vector<float>(100, 0.0f));
+        impulse[0][10] = 1.0f;
+        reverb->LoadImpulseResponse(impulse, kSampleRate / 2);
+        effect->Initialize(kSampleRate, 256);
+        effect->SetParameter(0, 0.0);       // Wet 0 dB
+        effect->SetParameter(1, -120.0);    // Dry off
+
+        AudioBuffer buffer(2, 256);
+        buffer.Clear();
+        buffer.GetChannelData(0)[0] = 1.0f;
+        buffer.GetChannelData(1)[0] = 1.0f;
+        effect->ProcessBlock(buffer);
+
+        // Resampling scales by 1/2, so the response keeps its summed gain
+        float left = buffer.GetChannelData(0)[20];
+        float right = buffer.GetChannelData(1)[20];
+        bool resampled = reverb->GetImpulseLength() == 200 && std::abs(left - 0.5f) < 1e-4f &&
+                         std::abs(right - 0.5f) < 1e-4f && std::abs(buffer.GetChannelData(0)[0]) < 1e-5f;
+        std::cout << (resampled ? "✓ " : "✗ ") << "Response resampled to the session rate (tap "
+                  << left << ")\n";
+        return resampled;
+    }
+
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: stereo IR, 256-sample blocks, 48 kHz ---\n";
+        std::cout << std::left << std::setw(10) << "IR" << std::right
+                  << std::setw(18) << "audio thread %" << std::setw(18) << "total CPU %" << "\n";
+
+        for (double seconds : {2.0, 6.0, 12.0}) {
+            double audioPercent = 0.0, totalPercent = 0.0;
+            TimeInstance(seconds, audioPercent, totalPercent);
+            std::cout << std::left << std::setw(10) << (std::to_string(static_cast<int>(seconds)) + " s")
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(18) << audioPercent << std::setw(18) << totalPercent << "\n";
+            std::cout.unsetf(std::ios::fixed);
+            std::cout << std::setprecision(6);
+        }
+    }
+
+    // Percent of one core per instance: wall time spent in ProcessBlock on the
+    // calling thread, and process CPU time including the stage workers
+    void TimeInstance(double impulseSeconds, double& audioPercent, double& totalPercent) {
+        const int blockSize = 256;
+        const double renderSeconds = 10.0;
+
+        auto effect = m_effectsManager.CreateEffect("Convolution Reverb");
+        auto* reverb = static_cast<NativeConvolutionEffect*>(effect.get());
+        reverb->LoadImpulseResponse(MakeImpulse(2, static_cast<size_t>(impulseSeconds * kSampleRate), kSampleRate),
+                                    kSampleRate);
+        effect->Initialize(kSampleRate, blockSize);
+
+        AudioBuffer source(2, blockSize);
+        AudioBuffer buffer(2, blockSize);
+        auto left = MakeSignal(blockSize, 0);
+        auto right = MakeSignal(blockSize, 1);
+        std::copy(left.begin(), left.end(), source.GetChannelData(0));
+        std::copy(right.begin(), right.end(), source.GetChannelData(1));
+
+        int blocks = static_cast<int>(renderSeconds * kSampleRate / blockSize);
+        double audioSeconds = 0.0;
+        std::clock_t cpuStart = std::clock();
+        for (int block = 0; block < blocks; ++block) {
+            buffer.CopyFrom(source);
+            auto start = std::chrono::steady_clock::now();
+            effect->ProcessBlock(buffer);
+            audioSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+        audioPercent = 100.0 * audioSeconds / renderSeconds;
+        totalPercent = 100.0 * cpuSeconds / renderSeconds;
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Convolution Test\n";
+    std::cout << "=============================\n";
+
+    ConvolutionTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
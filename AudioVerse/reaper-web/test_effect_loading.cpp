@@ -0,0 +1,268 @@
+/*
+ * REAPER Web - Effect Loading Test Application
+ * Asynchronous effect loading, hot-swap into a running chain and off-thread reclamation
+ */
+
+#include "src/effects/effect_chain.hpp"
+#include "src/effects/reaper_effects.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+    // A script long enough that compiling it takes milliseconds; 'variant'
+    // keeps each one out of the program cache
+    std::string MakeHeavyScript(int variant, int lines) {
+        std::ostringstream script;
+        script << "desc:Heavy " << variant << "\n@init\n";
+        for (int i = 0; i < lines; ++i) {
+            script << "v" << i << " = sin(" << i << " * 0.001) * cos(" << variant << " + " << i << ") + v" << i / 2 << ";\n";
+        }
+        script << "@sample\nspl0 = spl0;\n";
+        return script.str();
+    }
+
+    // Records the thread it was destroyed on
+    class TrackedEffect : public JSFXEffect {
+    public:
+        explicit TrackedEffect(std::thread::id* destroyedOn) : m_destroyedOn(destroyedOn) {}
+        ~TrackedEffect() override { *m_destroyedOn = std::this_thread::get_id(); }
+
+    private:
+        std::thread::id* m_destroyedOn;
+    };
+}
+
+/**
+ * Effect loading tests
+ */
+class EffectLoadingTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Effect Loading Test ===\n";
+
+        bool ok = true;
+        ok &= TestAsyncInsertion();
+        ok &= TestHotSwapDuringPlayback();
+        ok &= TestReclaimOffAudioThread();
+        ok &= TestReinitializeDuringPlayback();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 256;
+
+    std::shared_ptr<BuiltinEffectsManager> m_effectsManager = std::make_shared<BuiltinEffectsManager>();
+
+    // Runs blocks on a stand-in audio thread until stopped; tracks the slowest block
+    class AudioThread {
+    public:
+        explicit AudioThread(EffectChain& chain) : m_chain(chain) {
+            m_thread = std::thread([this] {
+                AudioBuffer buffer(2, kBlockSize);
+                while (m_running.load()) {
+                    for (int ch = 0; ch < 2; ++ch) {
+                        std::fill(buffer.GetChannelData(ch), buffer.GetChannelData(ch) + kBlockSize, 0.25f);
+                    }
+                    auto start = std::chrono::steady_clock::now();
+                    m_chain.ProcessAudio(buffer);
+                    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    m_worstBlock = std::max(m_worstBlock, seconds);
+                    m_blocks++;
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            });
+        }
+
+        ~AudioThread() { Stop(); }
+
+        void Stop() {
+            m_running = false;
+            if (m_thread.joinable()) m_thread.join();
+        }
+
+        std::thread::id GetId() const { return m_thread.get_id(); }
+        double GetWorstBlockSeconds() const { return m_worstBlock; }
+        int GetBlockCount() const { return m_blocks; }
+
+    private:
+        EffectChain& m_chain;
+        std::thread m_thread;
+        std::atomic<bool> m_running{true};
+        double m_worstBlock = 0.0;
+        int m_blocks = 0;
+    };
+
+    // Loaded effects land at their index, initialized at the chain's format
+    bool TestAsyncInsertion() {
+        std::cout << "\n--- Testing Asynchronous Insertion ---\n";
+
+        EffectChain chain;
+        chain.Prepare(kSampleRate, kBlockSize);
+        chain.AddEffect(m_effectsManager->CreateEffect("DC Remove"));
+
+        std::atomic<int> loaded{0};
+        auto gain = [this] {
+            auto effect = m_effectsManager->CreateEffect("Simple Gain", false);
+            effect->SetParameter(0, 6.0);
+            return effect;
+        };
+        chain.LoadEffectAsync(gain, 0, [&loaded](bool ok) { loaded += ok ? 1 : 0; });
+        chain.LoadEffectAsync([] { return std::unique_ptr<JSFXEffect>(); }, 0, [&loaded](bool ok) { loaded += ok ? 0 : 10; });
+        EffectLoader::Instance().WaitIdle();
+
+        // The gain runs after @init and @slider at 48 kHz: +6 dB on a constant
+        AudioBuffer buffer(2, kBlockSize);
+        std::fill(buffer.GetChannelData(0), buffer.GetChannelData(0) + kBlockSize, 0.25f);
+        std::fill(buffer.GetChannelData(1), buffer.GetChannelData(1) + kBlockSize, 0.25f);
+        chain.RemoveEffect(1);
+        chain.ProcessAudio(buffer);
+
+        bool pass = loaded == 11 && chain.GetPendingLoadCount() == 0 && chain.GetEffectCount() == 1 &&
+                    chain.GetEffect(0)->GetName() == "Simple Gain" &&
+                    std::abs(buffer.GetChannelData(0)[0] - 0.25f * std::pow(10.0f, 6.0f / 20.0f)) < 1e-5f;
+        std::cout << (pass ? "✓ " : "✗ ") << "Gain loaded at index 0 and initialized, failed factory reported, output "
+                  << buffer.GetChannelData(0)[0] << "\n";
+        return pass;
+    }
+
+    // Effects come and go while the audio thread runs, in any order
+    bool TestHotSwapDuringPlayback() {
+        std::cout << "\n--- Testing Hot-Swap During Playback ---\n";
+
+        EffectChain chain;
+        chain.Prepare(kSampleRate, kBlockSize);
+        AudioThread audio(chain);
+
+        const char* names[] = {"Simple Compressor", "Resonant Lowpass", "Simple Delay", "High Pass Filter"};
+        for (int round = 0; round < 40; ++round) {
+            chain.LoadEffectAsync([this, &names, round] { return m_effectsManager->CreateEffect(names[round % 4], round % 2 == 0); },
+                                  static_cast<size_t>(round % 3));
+            if (round % 5 == 4) {
+                EffectLoader::Instance().WaitIdle();
+                chain.RemoveEffect(0);
+                chain.MoveEffect(0, chain.GetEffectCount() - 1);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(300));
+        }
+        EffectLoader::Instance().WaitIdle();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        audio.Stop();
+
+        bool pass = chain.GetEffectCount() == 32 && audio.GetBlockCount() > 0;
+        std::cout << (pass ? "✓ " : "✗ ") << "40 loads and 8 removals over " << audio.GetBlockCount()
+                  << " blocks, " << chain.GetEffectCount() << " effects in the chain\n";
+        return pass;
+    }
+
+    // A removed effect is destroyed by a control thread, never the audio thread
+    bool TestReclaimOffAudioThread() {
+        std::cout << "\n--- Testing Reclamation Off the Audio Thread ---\n";
+
+        std::thread::id destroyedOn;
+        EffectChain chain;
+        chain.Prepare(kSampleRate, kBlockSize);
+        chain.AddEffect(std::make_unique<TrackedEffect>(&destroyedOn));
+
+        AudioThread audio(chain);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        chain.RemoveEffect(0);
+
+        // Reclaimed once the audio thread has finished a block without it
+        for (int attempt = 0; attempt < 100 && destroyedOn == std::thread::id(); ++attempt) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            chain.CollectRetired();
+        }
+        std::thread::id audioId = audio.GetId();
+        audio.Stop();
+
+        bool pass = destroyedOn == std::this_thread::get_id() && destroyedOn != audioId;
+        std::cout << (pass ? "✓ " : "✗ ") << "Removed effect destroyed on the control thread\n";
+        return pass;
+    }
+
+    // Oversampling changes and Prepare() re-initialize effects the audio
+    // thread is running; the callback reports each latency change
+    bool TestReinitializeDuringPlayback() {
+        std::cout << "\n--- Testing Re-Initialization During Playback ---\n";
+
+        EffectChain chain;
+        chain.Prepare(kSampleRate, kBlockSize);
+        chain.AddEffect(m_effectsManager->CreateEffect("Simple Compressor"));
+        chain.AddEffect(m_effectsManager->CreateEffect("Resonant Lowpass", false));
+        std::atomic<int> latencyChanges{0};
+        chain.SetLatencyCallback([&latencyChanges] { latencyChanges++; });
+
+        AudioThread audio(chain);
+        const int factors[] = {2, 4, 8, 1};
+        for (int round = 0; round < 20; ++round) {
+            chain.SetEffectOversampling(round % 2, factors[round % 4]);
+            if (round % 5 == 4) {
+                chain.Prepare(round % 10 == 4 ? 44100.0 : kSampleRate, kBlockSize);
+            }
+            chain.CollectRetired();
+            std::this_thread::sleep_for(std::chrono::microseconds(300));
+        }
+        audio.Stop();
+
+        bool pass = latencyChanges == 20 && chain.GetEffectCount() == 2 && chain.GetEffect(0)->IsInitialized() &&
+                    chain.GetEffectOversampling(0) == 8 && chain.GetEffectOversampling(1) == 1 &&
+                    chain.GetLatencySamples() > 0 && audio.GetBlockCount() > 0;
+        std::cout << (pass ? "✓ " : "✗ ") << "20 oversampling changes and 4 re-prepares over " << audio.GetBlockCount()
+                  << " blocks, " << latencyChanges << " latency notifications\n";
+        return pass;
+    }
+
+    // Caller stall: synchronous add versus queueing an asynchronous load
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: adding an uncompiled 2000-line script during playback ---\n";
+
+        EffectChain chain;
+        chain.Prepare(kSampleRate, kBlockSize);
+        AudioThread audio(chain);
+
+        auto start = std::chrono::steady_clock::now();
+        auto effect = std::make_unique<JSFXEffect>();
+        effect->LoadEffect(MakeHeavyScript(1, 2000));
+        chain.AddEffect(std::move(effect));
+        double syncSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        chain.LoadEffectAsync([] {
+            auto loaded = std::make_unique<JSFXEffect>();
+            loaded->LoadEffect(MakeHeavyScript(2, 2000));
+            return loaded;
+        });
+        double asyncSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        EffectLoader::Instance().WaitIdle();
+        audio.Stop();
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Synchronous AddEffect: " << 1e3 * syncSeconds << " ms on the caller\n"
+                  << "LoadEffectAsync:       " << 1e6 * asyncSeconds << " us on the caller\n"
+                  << "Slowest audio block:   " << 1e6 * audio.GetWorstBlockSeconds() << " us\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Effect Loading Test\n";
+    std::cout << "================================\n";
+
+    EffectLoadingTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
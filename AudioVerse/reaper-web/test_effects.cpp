@@ -138,7 +138,7 @@ private:
             }
             
             // Process the buffer
-            m_effectProcessor->ProcessTrackAudio(testBuffer, 0.0);
+            m_effectProcessor->ProcessTrackAudio(testBuffer, EffectChain::BlockInfo());
             std::cout << "✓ Processed audio through effect chain\n";
             
             // Check that audio was modified (simple peak check)
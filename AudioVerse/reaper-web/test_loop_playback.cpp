@@ -0,0 +1,363 @@
+/*
+ * REAPER Web - Loop Playback Test Application
+ * Block splitting at loop wraps, short loops, the splice fade and recording across the wrap
+ */
+
+#include "src/core/loop_playback.hpp"
+#include "src/media/recording_pipeline.hpp"
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr double kSampleRate = 48000.0;
+
+    // Timeline signal: every project sample has a distinct, non-zero value
+    float TimelineSample(int64_t sample) {
+        return static_cast<float>(sample % 9973 + 1) / 10000.0f;
+    }
+
+    // Keeps everything written after the WAV header
+    class MemorySink : public RecordingFileSink {
+    public:
+        explicit MemorySink(std::vector<float>& samples) : m_samples(samples) {}
+
+        bool Open(const std::string&) override { return true; }
+
+        bool Write(const void* data, size_t bytes) override {
+            if (!m_headerSeen) {
+                m_headerSeen = true;
+                return true;
+            }
+            const float* samples = static_cast<const float*>(data);
+            m_samples.insert(m_samples.end(), samples, samples + bytes / sizeof(float));
+            return true;
+        }
+
+        bool WriteAt(uint64_t, const void*, size_t) override { return true; }
+        void Close() override {}
+
+    private:
+        std::vector<float>& m_samples;
+        bool m_headerSeen = false;
+    };
+
+    struct LoopRegion {
+        double start = 0.0;
+        double end = 0.0;
+    };
+
+    /**
+     * Reference transport, one sample at a time: a pass starting at 'passStart'
+     * lasts ceil((loopEnd - passStart) * sampleRate) samples, sample k of it is
+     * project sample round(passStart * sampleRate) + k
+     */
+    class ReferenceTransport {
+    public:
+        ReferenceTransport(double position, LoopRegion loop) : m_passStart(position), m_loop(loop) {
+            m_passLength = PassLength();
+        }
+
+        struct Step {
+            int64_t projectSample = 0;
+            int64_t samplesToLoopEnd = 0;   // Including this one
+            int64_t samplesSinceWrap = -1;  // -1 before the first wrap
+        };
+
+        Step Next() {
+            if (m_k >= m_passLength) {
+                m_passStart = m_loop.start;
+                m_passLength = PassLength();
+                m_k = 0;
+                m_wrapped = true;
+            }
+            Step step;
+            step.projectSample = std::llround(m_passStart * kSampleRate) + m_k;
+            step.samplesToLoopEnd = m_passLength - m_k;
+            step.samplesSinceWrap = m_wrapped ? m_k : -1;
+            m_k++;
+            return step;
+        }
+
+    private:
+        double m_passStart;
+        LoopRegion m_loop;
+        int64_t m_passLength = 0;
+        int64_t m_k = 0;
+        bool m_wrapped = false;
+
+        int64_t PassLength() const {
+            return static_cast<int64_t>(std::ceil((m_loop.end - m_passStart) * kSampleRate - 1e-6));
+        }
+    };
+
+    float SpliceCurve(double x) {
+        double s = std::sin(0.5 * M_PI * x);
+        return static_cast<float>(s * s);
+    }
+}
+
+/**
+ * Loop playback tests
+ */
+class LoopPlaybackTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Loop Playback Test ===\n";
+
+        bool ok = true;
+        ok &= TestWrapMidBlock();
+        ok &= TestShortLoop();
+        ok &= TestSpliceFade();
+        ok &= TestRecordingAcrossWrap();
+        return ok;
+    }
+
+private:
+    struct RenderResult {
+        std::vector<float> output;
+        std::vector<int> segmentsPerBlock;
+        std::vector<double> blockEndPositions;
+    };
+
+    /**
+     * Renders blocks the way ReaperEngine::ProcessAudioBlock does: each segment
+     * reads the timeline from its own start time, gets the splice fade, and the
+     * device input of that segment is captured at the segment's project sample
+     */
+    RenderResult Render(double position, LoopRegion loop, int blockSize, int numBlocks,
+                        double spliceFade, bool constantSource = false,
+                        RecordingPipeline* pipeline = nullptr) {
+        LoopPlayback playback;
+        playback.Prepare(kSampleRate);
+        playback.SetSpliceFade(spliceFade);
+
+        RenderResult result;
+        std::vector<float> block(blockSize);
+        std::vector<float> input(blockSize);
+        float* outputs[1] = {block.data()};
+        int64_t deviceSample = 0;
+
+        for (int b = 0; b < numBlocks; ++b) {
+            for (int i = 0; i < blockSize; ++i) {
+                input[i] = static_cast<float>(deviceSample++);
+            }
+
+            playback.BeginBlock(position, blockSize, true, loop.start, loop.end);
+            int segments = 0;
+            LoopPlayback::Segment segment;
+            while (playback.NextSegment(segment)) {
+                int64_t startSample = std::llround(segment.startTime * kSampleRate);
+                for (int i = 0; i < segment.numSamples; ++i) {
+                    block[segment.offset + i] = constantSource ? 1.0f : TimelineSample(startSample + i);
+                }
+                playback.ApplySpliceFade(outputs, 1, segment);
+                if (pipeline && segment.numSamples > 0) {
+                    const float* segmentInputs[1] = {input.data() + segment.offset};
+                    pipeline->Capture(segmentInputs, 1, startSample, segment.numSamples);
+                }
+                segments++;
+            }
+            position = playback.GetPosition();
+
+            result.output.insert(result.output.end(), block.begin(), block.end());
+            result.segmentsPerBlock.push_back(segments);
+            result.blockEndPositions.push_back(position);
+        }
+        return result;
+    }
+
+    static bool CheckTimeline(const std::string& label, const RenderResult& result, double position, LoopRegion loop) {
+        ReferenceTransport reference(position, loop);
+        int64_t mismatch = -1;
+        for (size_t n = 0; n < result.output.size() && mismatch < 0; ++n) {
+            if (result.output[n] != TimelineSample(reference.Next().projectSample)) {
+                mismatch = static_cast<int64_t>(n);
+            }
+        }
+        std::cout << (mismatch < 0 ? "✓" : "✗") << " " << label;
+        if (mismatch >= 0) std::cout << " (first wrong sample " << mismatch << ")";
+        std::cout << "\n";
+        return mismatch < 0;
+    }
+
+    bool TestWrapMidBlock() {
+        std::cout << "\n--- Testing a Loop Wrap Inside a Block ---\n";
+
+        bool ok = true;
+
+        // 1 s loop, playback from 0.9 s: the first wrap falls 52800 samples in,
+        // 64 samples into block 103, then every 48000 samples
+        LoopRegion loop{1.0, 2.0};
+        RenderResult result = Render(0.9, loop, 512, 400, 0.0);
+        ok &= CheckTimeline("Sample-aligned loop plays loopEnd - 1 then loopStart in the same block", result, 0.9, loop);
+
+        int splitBlocks = static_cast<int>(std::count(result.segmentsPerBlock.begin(), result.segmentsPerBlock.end(), 2));
+        bool splitOk = result.segmentsPerBlock[103] == 2 && splitBlocks == 4 &&
+                       std::all_of(result.segmentsPerBlock.begin(), result.segmentsPerBlock.end(),
+                                   [](int segments) { return segments <= 2; });
+        std::cout << (splitOk ? "✓" : "✗") << " Only the " << splitBlocks << " blocks containing a wrap are split\n";
+        ok &= splitOk;
+
+        // Loop points between samples
+        LoopRegion fractional{0.5 + 0.37 / kSampleRate, 1.25 + 0.61 / kSampleRate};
+        ok &= CheckTimeline("Fractional loop points wrap on the first sample at or past loopEnd",
+                            Render(0.2, fractional, 333, 300, 0.0), 0.2, fractional);
+        return ok;
+    }
+
+    bool TestShortLoop() {
+        std::cout << "\n--- Testing Loops Shorter Than a Block ---\n";
+
+        bool ok = true;
+
+        // 100-sample loop in 512-sample blocks: five or six wraps per block
+        LoopRegion loop{0.5, 0.5 + 100.0 / kSampleRate};
+        RenderResult result = Render(0.5 - 50.0 / kSampleRate, loop, 512, 50, 0.0);
+        ok &= CheckTimeline("100-sample loop repeats seamlessly in 512-sample blocks", result, 0.5 - 50.0 / kSampleRate, loop);
+
+        int fewest = *std::min_element(result.segmentsPerBlock.begin() + 1, result.segmentsPerBlock.end());
+        bool wrapsOk = fewest >= 6;
+        std::cout << (wrapsOk ? "✓" : "✗") << " At least " << fewest << " segments per block after the first\n";
+        ok &= wrapsOk;
+
+        // 128-sample loop: every block ends exactly on the loop end and must wrap there
+        LoopRegion aligned{1.0, 1.0 + 128.0 / kSampleRate};
+        RenderResult alignedResult = Render(1.0, aligned, 512, 20, 0.0);
+        ok &= CheckTimeline("128-sample loop in 512-sample blocks", alignedResult, 1.0, aligned);
+
+        bool restartOk = std::all_of(alignedResult.blockEndPositions.begin(), alignedResult.blockEndPositions.end(),
+                                     [&](double position) { return position == aligned.start; }) &&
+                         std::all_of(alignedResult.segmentsPerBlock.begin(), alignedResult.segmentsPerBlock.end(),
+                                     [](int segments) { return segments == 4; });
+        std::cout << (restartOk ? "✓" : "✗") << " A wrap on the last sample of a block starts the next block at loopStart\n";
+        ok &= restartOk;
+        return ok;
+    }
+
+    bool TestSpliceFade() {
+        std::cout << "\n--- Testing the Loop Splice Fade ---\n";
+
+        const double fadeSeconds = 0.001;
+        const int fadeLength = static_cast<int>(fadeSeconds * kSampleRate);
+        bool ok = true;
+
+        struct Case {
+            const char* label;
+            double position;
+            LoopRegion loop;
+            int blockSize;
+            int numBlocks;
+        };
+        const Case cases[] = {
+            {"Fades span 32-sample blocks around a 1000-sample loop", 1.0 - 500.0 / kSampleRate,
+             LoopRegion{1.0, 1.0 + 1000.0 / kSampleRate}, 32, 400},
+            {"Fades on a 100-sample loop wrapping several times per block", 0.5,
+             LoopRegion{0.5, 0.5 + 100.0 / kSampleRate}, 512, 20},
+        };
+
+        for (const Case& test : cases) {
+            RenderResult result = Render(test.position, test.loop, test.blockSize, test.numBlocks, fadeSeconds, true);
+
+            // Unity source, so every output sample is the fade gain itself
+            ReferenceTransport reference(test.position, test.loop);
+            double worstError = 0.0;
+            int faded = 0;
+            for (float value : result.output) {
+                ReferenceTransport::Step step = reference.Next();
+                float gain = 1.0f;
+                if (step.samplesSinceWrap >= 0 && step.samplesSinceWrap < fadeLength) {
+                    gain *= SpliceCurve(static_cast<double>(step.samplesSinceWrap + 1) / fadeLength);
+                }
+                if (step.samplesToLoopEnd <= fadeLength) {
+                    gain *= SpliceCurve(static_cast<double>(step.samplesToLoopEnd) / fadeLength);
+                }
+                if (gain != 1.0f) faded++;
+                worstError = std::max(worstError, std::abs(static_cast<double>(value) - gain));
+            }
+
+            bool caseOk = worstError < 1e-6 && faded > 0;
+            std::cout << (caseOk ? "✓" : "✗") << " " << test.label << " (" << faded
+                      << " faded samples, max error " << worstError << ")\n";
+            ok &= caseOk;
+        }
+
+        // No fade: the splice is hard
+        RenderResult hard = Render(1.0 - 500.0 / kSampleRate, LoopRegion{1.0, 1.0 + 1000.0 / kSampleRate}, 32, 100, 0.0, true);
+        bool hardOk = std::all_of(hard.output.begin(), hard.output.end(), [](float value) { return value == 1.0f; });
+        std::cout << (hardOk ? "✓" : "✗") << " A zero fade leaves the splice untouched\n";
+        return ok && hardOk;
+    }
+
+    bool TestRecordingAcrossWrap() {
+        std::cout << "\n--- Testing Recording Across Loop Wraps ---\n";
+
+        // 1000-sample loop, punch window inside it: each pass records
+        // [punchIn, punchOut) and the passes append to one take
+        LoopRegion loop{1.0, 1.0 + 1000.0 / kSampleRate};
+        const int64_t loopStartSample = 48000;
+        const int64_t punchIn = loopStartSample + 10;
+        const int64_t punchOut = loopStartSample + 990;
+        const double position = 1.0 - 300.0 / kSampleRate;
+        const int blockSize = 256;
+        const int numBlocks = 40;
+
+        std::vector<float> recorded;
+        RecordingPipeline::Settings settings;
+        settings.sampleRate = kSampleRate;
+        settings.maxBlockSize = blockSize;
+        settings.writeChunkFrames = 1024;
+
+        RecordingPipeline::TrackInput input;
+        input.trackIndex = 0;
+        input.numChannels = 1;
+        input.filePath = "loop_take.wav";
+
+        RecordingPipeline pipeline;
+        pipeline.SetSinkFactory([&]() -> std::unique_ptr<RecordingFileSink> {
+            return std::make_unique<MemorySink>(recorded);
+        });
+        if (!pipeline.Start(settings, {input}, punchIn, punchOut)) {
+            std::cout << "✗ Failed to start recording\n";
+            return false;
+        }
+
+        Render(position, loop, blockSize, numBlocks, 0.0, false, &pipeline);
+        auto takes = pipeline.Stop();
+
+        // Device sample d plays at the reference transport's project sample
+        std::vector<float> expected;
+        ReferenceTransport reference(position, loop);
+        for (int64_t d = 0; d < static_cast<int64_t>(blockSize) * numBlocks; ++d) {
+            int64_t projectSample = reference.Next().projectSample;
+            if (projectSample >= punchIn && projectSample < punchOut) {
+                expected.push_back(static_cast<float>(d));
+            }
+        }
+
+        bool takeOk = takes.size() == 1 && takes[0].startSample == punchIn &&
+                      takes[0].lengthSamples == static_cast<int64_t>(expected.size());
+        std::cout << (takeOk ? "✓" : "✗") << " One take from the punch-in with "
+                  << (takes.empty() ? 0 : takes[0].lengthSamples) << " samples (expected "
+                  << expected.size() << ")\n";
+
+        bool dataOk = recorded == expected;
+        std::cout << (dataOk ? "✓" : "✗") << " Every pass captures exactly the inputs played inside the punch window\n";
+        return takeOk && dataOk;
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Loop Playback Test\n";
+    std::cout << "===============================\n";
+
+    LoopPlaybackTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/*
+ * REAPER Web - Master Limiter Test Application
+ * Ceiling, latency and transient handling of the master limiter, plus a benchmark
+ */
+
+#include "src/core/master_limiter.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace {
+    using Generator = std::function<float(int channel, int64_t index)>;
+
+    // Reference true peak: 16x windowed-sinc reconstruction between samples
+    double MeasureTruePeak(const std::vector<float>& signal, size_t start) {
+        const int oversample = 16;
+        const int halfWidth = 32;
+        double peak = 0.0;
+        for (size_t n = start + halfWidth; n + halfWidth < signal.size(); ++n) {
+            for (int f = 0; f < oversample; ++f) {
+                double t = static_cast<double>(f) / oversample;
+                double value = 0.0;
+                for (int k = -halfWidth + 1; k <= halfWidth; ++k) {
+                    double x = k - t;
+                    double sinc = (x == 0.0) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+                    double window = 0.5 + 0.5 * std::cos(M_PI * x / halfWidth);
+                    value += signal[n + k] * sinc * window;
+                }
+                peak = std::max(peak, std::abs(value));
+            }
+        }
+        return peak;
+    }
+
+    double ToDb(double value) { return 20.0 * std::log10(std::max(value, 1e-12)); }
+}
+
+/**
+ * Master limiter tests
+ */
+class MasterLimiterTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Master Limiter Test ===\n";
+
+        bool ok = true;
+        ok &= TestTransparency();
+        ok &= TestCeiling();
+        ok &= TestTransient();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 128;
+
+    // Renders 'length' samples of 'generator' through a limiter, stereo
+    std::vector<float> Render(MasterLimiter& limiter, const Generator& generator, int64_t length,
+                              std::vector<float>* input = nullptr) {
+        std::vector<float> output;
+        AudioBuffer buffer(2, kBlockSize);
+        for (int64_t position = 0; position < length; position += kBlockSize) {
+            for (int ch = 0; ch < 2; ++ch) {
+                for (int i = 0; i < kBlockSize; ++i) {
+                    buffer.GetChannelData(ch)[i] = generator(ch, position + i);
+                }
+            }
+            if (input) input->insert(input->end(), buffer.GetChannelData(0), buffer.GetChannelData(0) + kBlockSize);
+            limiter.Process(buffer);
+            output.insert(output.end(), buffer.GetChannelData(0), buffer.GetChannelData(0) + kBlockSize);
+        }
+        return output;
+    }
+
+    // Below the ceiling the limiter is a pure delay of the reported latency
+    bool TestTransparency() {
+        std::cout << "\n--- Testing Transparency and Latency ---\n";
+
+        bool ok = true;
+        for (float lookaheadMs : {0.5f, 1.5f, 5.0f}) {
+            MasterLimiter limiter;
+            limiter.SetLookahead(lookaheadMs);
+            limiter.Prepare(kSampleRate, 2);
+            int latency = limiter.GetLatencySamples();
+
+            std::vector<float> input;
+            auto output = Render(limiter, [](int ch, int64_t n) {
+                return static_cast<float>(0.5 * std::sin(2.0 * M_PI * (440.0 + 220.0 * ch) * n / kSampleRate));
+            }, 48000, &input);
+
+            double maxError = 0.0;
+            for (size_t i = latency; i < output.size(); ++i) {
+                maxError = std::max(maxError, static_cast<double>(std::abs(output[i] - input[i - latency])));
+            }
+            bool pass = maxError == 0.0;
+            std::cout << (pass ? "✓ " : "✗ ") << lookaheadMs << " ms look-ahead: latency " << latency
+                      << " samples, max error " << maxError << "\n";
+            ok &= pass;
+        }
+        return ok;
+    }
+
+    // Sine at fs/4 with 45 degree phase: sample peaks are 3 dB below the true peak
+    bool TestCeiling() {
+        std::cout << "\n--- Testing True-Peak Ceiling (-1 dBTP) ---\n";
+
+        MasterLimiter limiter;
+        limiter.SetCeiling(-1.0f);
+        limiter.Prepare(kSampleRate, 2);
+
+        auto output = Render(limiter, [](int ch, int64_t n) {
+            double envelope = 1.0 + 3.0 * (0.5 + 0.5 * std::sin(2.0 * M_PI * 3.0 * n / kSampleRate));
+            double carrier = std::sin(2.0 * M_PI * n / 4.0 + M_PI / 4.0) + 0.3 * std::sin(2.0 * M_PI * 997.0 * n / kSampleRate);
+            return static_cast<float>(envelope * carrier * (ch ? 0.8 : 1.0));
+        }, 48000);
+
+        double samplePeak = 0.0;
+        for (float value : output) samplePeak = std::max(samplePeak, static_cast<double>(std::abs(value)));
+        double truePeak = MeasureTruePeak(output, 0);
+
+        bool samplePass = ToDb(samplePeak) <= -1.0 + 1e-4;
+        // Four phases can miss the crest between them by up to ~0.2 dB near fs/4
+        bool truePass = ToDb(truePeak) <= -1.0 + 0.2;
+        std::cout << (samplePass ? "✓ " : "✗ ") << "Sample peak " << std::fixed << std::setprecision(3)
+                  << ToDb(samplePeak) << " dBFS\n";
+        std::cout << (truePass ? "✓ " : "✗ ") << "True peak " << ToDb(truePeak) << " dBTP (0.2 dB tolerance)\n";
+        std::cout.unsetf(std::ios::fixed);
+        return samplePass && truePass;
+    }
+
+    // A step from silence to +10 dBFS is caught by the look-ahead
+    bool TestTransient() {
+        std::cout << "\n--- Testing Transient (silence to +10 dBFS) ---\n";
+
+        MasterLimiter limiter;
+        limiter.SetCeiling(-0.3f);
+        limiter.SetRelease(50.0f);
+        limiter.Prepare(kSampleRate, 2);
+
+        auto output = Render(limiter, [](int, int64_t n) {
+            if (n < 10000 || n > 20000) return 0.0f;
+            return static_cast<float>(3.16 * ((n / 7) % 2 ? 1.0 : -1.0));
+        }, 48000);
+
+        double samplePeak = 0.0;
+        for (float value : output) samplePeak = std::max(samplePeak, static_cast<double>(std::abs(value)));
+        bool pass = ToDb(samplePeak) <= -0.3 + 1e-4 && limiter.GetGainReduction() <= 0.0f;
+        std::cout << (pass ? "✓ " : "✗ ") << "Sample peak " << std::fixed << std::setprecision(3)
+                  << ToDb(samplePeak) << " dBFS\n";
+        std::cout.unsetf(std::ios::fixed);
+        return pass;
+    }
+
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: stereo, 128-sample blocks, 48 kHz ---\n";
+
+        MasterLimiter limiter;
+        limiter.Prepare(kSampleRate, 2);
+        AudioBuffer buffer(2, kBlockSize);
+
+        const double seconds = 60.0;
+        int blocks = static_cast<int>(seconds * kSampleRate / kBlockSize);
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < blocks; ++block) {
+            for (int ch = 0; ch < 2; ++ch) {
+                float* samples = buffer.GetChannelData(ch);
+                for (int i = 0; i < kBlockSize; ++i) {
+                    samples[i] = static_cast<float>(2.0 * std::sin(0.05 * (block * kBlockSize + i)));
+                }
+            }
+            limiter.Process(buffer);
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::fixed << std::setprecision(3) << 100.0 * elapsed / seconds
+                  << "% CPU (including signal generation), latency " << limiter.GetLatencySamples() << " samples\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Master Limiter Test\n";
+    std::cout << "================================\n";
+
+    MasterLimiterTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
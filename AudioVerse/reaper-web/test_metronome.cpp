@@ -0,0 +1,240 @@
+/*
+ * REAPER Web - Metronome Test Application
+ * Sample-accurate click onsets across block splits, tempo changes and click tails
+ */
+
+#include "src/core/metronome.hpp"
+#include "src/core/tempo_map.hpp"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr double kSampleRate = 48000.0;
+    constexpr float kGain = 0.8f;
+
+    // 4/4 at 120 BPM, 137 BPM from beat 5, 3/4 from bar 3 (beat 12) ramping to 90 BPM at beat 21
+    std::vector<TempoMarker> TestMarkers() {
+        return {
+            TempoMarker{0.0, 120.0, false, 4, 4},
+            TempoMarker{5.0, 137.0, false, 0, 0},
+            TempoMarker{12.0, 137.0, true, 3, 4},
+            TempoMarker{21.0, 90.0, false, 0, 0},
+        };
+    }
+
+    struct Onset {
+        int64_t sample = 0;
+        bool accent = false;
+    };
+}
+
+/**
+ * Metronome tests
+ */
+class MetronomeTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Metronome Test ===\n";
+
+        m_map = TempoMap(TestMarkers());
+        m_length = static_cast<int64_t>(12.0 * kSampleRate);
+        ExtractClicks();
+        BuildExpected();
+
+        bool ok = true;
+        ok &= TestSingleRange();
+        ok &= TestBlockSplits();
+        ok &= TestTempoChangeMidBlock();
+        ok &= TestCarryOver();
+        return ok;
+    }
+
+private:
+    TempoMap m_map;
+    int64_t m_length = 0;
+    std::vector<float> m_accentClick;
+    std::vector<float> m_normalClick;
+    std::vector<Onset> m_onsets;
+    std::vector<float> m_expected;
+
+    // Renders the timeline on channel 0/1 in consecutive ranges of the given sizes (cycled)
+    std::vector<float> RenderTimeline(const TempoMap& map, const std::vector<int64_t>& splits, float gain,
+                                      int64_t length, bool* channelsMatch = nullptr) {
+        std::vector<float> left(length, 0.0f);
+        std::vector<float> right(length, 0.0f);
+        float* outputs[2] = {left.data(), right.data()};
+
+        Metronome metronome;
+        metronome.Prepare(kSampleRate);
+
+        int64_t start = 0;
+        for (size_t i = 0; start < length; ++i) {
+            int64_t size = std::min(splits[i % splits.size()], length - start);
+            metronome.Render(outputs, 2, static_cast<int>(start), static_cast<int>(size),
+                             start / kSampleRate, map, gain);
+            start += size;
+        }
+
+        if (channelsMatch) *channelsMatch = left == right;
+        return left;
+    }
+
+    // The click shapes as the metronome renders them, isolated on a single-click map
+    void ExtractClicks() {
+        TempoMap slow(std::vector<TempoMarker>{TempoMarker{0.0, 30.0, false, 4, 4}});
+        std::vector<float> clicks = RenderTimeline(slow, {4 * static_cast<int64_t>(kSampleRate)}, 1.0f,
+                                                   4 * static_cast<int64_t>(kSampleRate));
+
+        auto end = [&](int64_t from) {
+            int64_t i = from;
+            while (i < static_cast<int64_t>(clicks.size()) && (i == from || clicks[i] != 0.0f || clicks[i - 1] != 0.0f)) ++i;
+            return i;
+        };
+        // Beat 0 is the accent, beat 1 (2 s at 30 BPM) a normal click
+        int64_t normalStart = static_cast<int64_t>(2.0 * kSampleRate);
+        m_accentClick.assign(clicks.begin(), clicks.begin() + end(0));
+        m_normalClick.assign(clicks.begin() + normalStart, clicks.begin() + end(normalStart));
+    }
+
+    // Expected onsets straight from the tempo map: every quarter note, accent on the bar line
+    void BuildExpected() {
+        m_onsets.clear();
+        for (int beat = 0; ; ++beat) {
+            double seconds = m_map.BeatsToSeconds(beat);
+            int64_t sample = static_cast<int64_t>(std::ceil(seconds * kSampleRate - 1e-6));
+            if (sample >= m_length) break;
+            double bars = m_map.BeatsToBars(beat);
+            m_onsets.push_back(Onset{sample, std::abs(bars - std::round(bars)) < 1e-9});
+        }
+
+        m_expected.assign(m_length, 0.0f);
+        for (size_t i = 0; i < m_onsets.size(); ++i) {
+            const std::vector<float>& click = m_onsets[i].accent ? m_accentClick : m_normalClick;
+            int64_t end = std::min<int64_t>(m_length, m_onsets[i].sample + static_cast<int64_t>(click.size()));
+            if (i + 1 < m_onsets.size()) end = std::min(end, m_onsets[i + 1].sample);
+            for (int64_t n = m_onsets[i].sample; n < end; ++n) {
+                m_expected[n] += click[n - m_onsets[i].sample] * kGain;
+            }
+        }
+    }
+
+    // First sample where two renders differ, or -1
+    static int64_t FirstMismatch(const std::vector<float>& a, const std::vector<float>& b) {
+        auto it = std::mismatch(a.begin(), a.end(), b.begin());
+        return it.first == a.end() ? -1 : static_cast<int64_t>(it.first - a.begin());
+    }
+
+    bool Check(const std::string& label, const std::vector<int64_t>& splits) {
+        bool channelsMatch = false;
+        std::vector<float> output = RenderTimeline(m_map, splits, kGain, m_length, &channelsMatch);
+        int64_t mismatch = FirstMismatch(output, m_expected);
+        bool ok = mismatch < 0 && channelsMatch;
+        std::cout << (ok ? "✓" : "✗") << " " << label;
+        if (mismatch >= 0) std::cout << " (first wrong sample " << mismatch << ")";
+        std::cout << "\n";
+        return ok;
+    }
+
+    bool TestSingleRange() {
+        std::cout << "\n--- Testing Onsets in One Range ---\n";
+
+        int accents = static_cast<int>(std::count_if(m_onsets.begin(), m_onsets.end(),
+                                                     [](const Onset& onset) { return onset.accent; }));
+        bool shapesOk = !m_accentClick.empty() && !m_normalClick.empty() && accents > 3;
+        std::cout << (shapesOk ? "✓" : "✗") << " " << m_onsets.size() << " clicks, " << accents
+                  << " accented, over 12 s\n";
+
+        return shapesOk & Check("Every click starts on ceil(onset * sampleRate)", {m_length});
+    }
+
+    bool TestBlockSplits() {
+        std::cout << "\n--- Testing Block Splits ---\n";
+
+        bool ok = true;
+        ok &= Check("512-sample blocks", {512});
+        ok &= Check("Odd 333-sample blocks", {333});
+
+        // Irregular split sizes, as loop wraps and the count-in produce
+        std::vector<int64_t> irregular;
+        uint32_t seed = 12345;
+        for (int i = 0; i < 257; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            irregular.push_back(1 + (seed >> 8) % 3000);
+        }
+        ok &= Check("Irregular 1..3000-sample splits", irregular);
+
+        // Ranges that end exactly on an onset and one sample before it
+        for (int64_t before : {0, 1}) {
+            std::vector<int64_t> splits;
+            int64_t start = 0;
+            for (const auto& onset : m_onsets) {
+                if (onset.sample - before > start) {
+                    splits.push_back(onset.sample - before - start);
+                    start = onset.sample - before;
+                }
+            }
+            splits.push_back(m_length - start);
+            ok &= Check(before == 0 ? "Splits exactly on every onset" : "Splits one sample before every onset", splits);
+        }
+        return ok;
+    }
+
+    bool TestTempoChangeMidBlock() {
+        std::cout << "\n--- Testing Tempo Changes Inside a Block ---\n";
+
+        // One-second blocks: the 120 -> 137 BPM change at 2.5 s and the 3/4 ramp
+        // start both fall inside a block with clicks on either side of them
+        double change = m_map.BeatsToSeconds(5.0);
+        double rampStart = m_map.BeatsToSeconds(12.0);
+        bool inside = std::fmod(change, 1.0) > 0.0 && std::fmod(rampStart, 1.0) > 0.0;
+        std::cout << (inside ? "✓" : "✗") << " Tempo change at " << change << " s and ramp at "
+                  << rampStart << " s are not block-aligned\n";
+
+        return inside & Check("One-second blocks across tempo and meter changes",
+                              {static_cast<int64_t>(kSampleRate)});
+    }
+
+    bool TestCarryOver() {
+        std::cout << "\n--- Testing Click Tails Across Blocks ---\n";
+
+        // Every range ends 100 samples into a click, so each click finishes in the next range
+        std::vector<int64_t> splits;
+        int64_t start = 0;
+        for (const auto& onset : m_onsets) {
+            if (onset.sample + 100 > start) {
+                splits.push_back(onset.sample + 100 - start);
+                start = onset.sample + 100;
+            }
+        }
+        splits.push_back(m_length - start);
+        bool ok = Check("Clicks split 100 samples after their onset continue seamlessly", splits);
+
+        // A stop in the middle of a click drops its tail
+        std::vector<float> left(2048, 0.0f);
+        std::vector<float> right(2048, 0.0f);
+        float* outputs[2] = {left.data(), right.data()};
+        Metronome metronome;
+        metronome.Prepare(kSampleRate);
+        metronome.Render(outputs, 2, 0, 100, 0.0, m_map, kGain);
+        metronome.Reset();
+        metronome.Render(outputs, 2, 100, 1948, 100 / kSampleRate, m_map, kGain);
+        bool resetOk = std::all_of(left.begin() + 100, left.end(), [](float value) { return value == 0.0f; });
+        std::cout << (resetOk ? "✓" : "✗") << " Reset() drops a click tail\n";
+        return ok && resetOk;
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Metronome Test\n";
+    std::cout << "===========================\n";
+
+    MetronomeTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
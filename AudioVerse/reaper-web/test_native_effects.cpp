@@ -0,0 +1,203 @@
+/*
+ * REAPER Web - Native Effects Test Application
+ * Parity of the native built-in effects against their JSFX scripts, plus a benchmark
+ */
+
+#include "src/effects/reaper_effects.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // Sine, noise and a DC offset so every effect has something to act on
+    void FillTestSignal(AudioBuffer& buffer, int64_t startSample, double sampleRate) {
+        for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
+            float* samples = buffer.GetChannelData(ch);
+            uint32_t seed = static_cast<uint32_t>(startSample * 31 + ch * 7919 + 1);
+            for (int i = 0; i < buffer.GetSampleCount(); ++i) {
+                seed = seed * 1664525u + 1013904223u;
+                double noise = (seed >> 8) / 16777216.0 - 0.5;
+                double t = (startSample + i) / sampleRate;
+                double envelope = 0.5 + 0.5 * std::sin(2.0 * M_PI * 1.5 * t);
+                samples[i] = static_cast<float>(envelope * (0.6 * std::sin(2.0 * M_PI * (220.0 + 110.0 * ch) * t) + 0.3 * noise) + 0.1);
+            }
+        }
+    }
+
+    struct ParityCase {
+        const char* name;
+        std::vector<double> parameters;     // Non-default slider values
+    };
+}
+
+/**
+ * Native vs JSFX tests
+ */
+class NativeEffectsTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Native Effects Test ===\n";
+
+        bool ok = true;
+        ok &= TestSliderLayout();
+        ok &= TestParity(2);
+        ok &= TestParity(1);
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 44100.0;
+    static constexpr double kTolerance = 1e-4;
+
+    BuiltinEffectsManager m_effectsManager;
+
+    const std::vector<ParityCase> m_cases = {
+        {"Simple Gain", {6.0}},
+        {"Resonant Lowpass", {2500.0, 0.6}},
+        {"Simple Delay", {25.0, -4.0, 0.0, -3.0, -1.0}},
+        {"Simple Compressor", {-24.0, 6.0, 2.0, 80.0, 4.0}},
+        {"High Pass Filter", {300.0, 1.4}},
+        {"DC Remove", {}}
+    };
+
+    bool TestSliderLayout() {
+        std::cout << "\n--- Testing Slider Layout ---\n";
+
+        bool ok = true;
+        for (const auto& name : m_effectsManager.GetAvailableEffects()) {
+            if (m_effectsManager.GetEffectScript(name).empty()) {
+                continue;   // Native-only, nothing to compare against
+            }
+            auto native = m_effectsManager.CreateEffect(name);
+            auto script = m_effectsManager.CreateEffect(name, false);
+            if (!native || !script || !native->IsNative() || script->IsNative()) {
+                std::cout << "✗ " << name << ": native and JSFX versions not both available\n";
+                ok = false;
+                continue;
+            }
+
+            const auto& nativeSliders = native->GetInfo().sliders;
+            const auto& scriptSliders = script->GetInfo().sliders;
+            bool same = nativeSliders.size() == scriptSliders.size() && native->GetName() == script->GetName();
+            for (size_t i = 0; same && i < nativeSliders.size(); ++i) {
+                same = nativeSliders[i].name == scriptSliders[i].name &&
+                       nativeSliders[i].defaultValue == scriptSliders[i].defaultValue &&
+                       nativeSliders[i].minValue == scriptSliders[i].minValue &&
+                       nativeSliders[i].maxValue == scriptSliders[i].maxValue &&
+                       native->GetParameter(static_cast<int>(i)) == script->GetParameter(static_cast<int>(i));
+            }
+            std::cout << (same ? "✓ " : "✗ ") << name << ": " << nativeSliders.size() << " sliders\n";
+            ok &= same;
+        }
+        return ok;
+    }
+
+    bool TestParity(int numChannels) {
+        std::cout << "\n--- Testing Output Parity (" << numChannels << " channel"
+                  << (numChannels > 1 ? "s" : "") << ", tolerance " << kTolerance << ") ---\n";
+
+        // Block sizes vary so state carry-over between blocks is covered
+        const int blockSizes[] = {512, 64, 333, 1};
+        const int64_t totalSamples = static_cast<int64_t>(kSampleRate);
+
+        bool ok = true;
+        for (const auto& testCase : m_cases) {
+            auto native = m_effectsManager.CreateEffect(testCase.name);
+            auto script = m_effectsManager.CreateEffect(testCase.name, false);
+            native->Initialize(kSampleRate, 512);
+            script->Initialize(kSampleRate, 512);
+            for (size_t i = 0; i < testCase.parameters.size(); ++i) {
+                native->SetParameter(static_cast<int>(i), testCase.parameters[i]);
+                script->SetParameter(static_cast<int>(i), testCase.parameters[i]);
+            }
+
+            double maxError = 0.0;
+            double maxLevel = 0.0;
+            int64_t position = 0;
+            for (int block = 0; position < totalSamples; ++block) {
+                int blockSize = static_cast<int>(std::min<int64_t>(blockSizes[block % 4], totalSamples - position));
+                AudioBuffer nativeBuffer(numChannels, blockSize);
+                AudioBuffer scriptBuffer(numChannels, blockSize);
+                FillTestSignal(nativeBuffer, position, kSampleRate);
+                FillTestSignal(scriptBuffer, position, kSampleRate);
+
+                native->ProcessBlock(nativeBuffer);
+                script->ProcessBlock(scriptBuffer);
+
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    for (int i = 0; i < blockSize; ++i) {
+                        double expected = scriptBuffer.GetChannelData(ch)[i];
+                        maxError = std::max(maxError, std::abs(nativeBuffer.GetChannelData(ch)[i] - expected));
+                        maxLevel = std::max(maxLevel, std::abs(expected));
+                    }
+                }
+                position += blockSize;
+            }
+
+            bool same = maxError <= kTolerance && maxLevel > 0.0;
+            std::cout << (same ? "✓ " : "✗ ") << testCase.name << ": max error " << maxError
+                      << " (peak " << maxLevel << ")\n";
+            ok &= same;
+        }
+        return ok;
+    }
+
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: stereo, 512-sample blocks, 44.1 kHz ---\n";
+        std::cout << std::left << std::setw(20) << "Effect" << std::right
+                  << std::setw(14) << "JSFX ms/s" << std::setw(14) << "native ms/s" << std::setw(10) << "speedup\n";
+
+        for (const auto& testCase : m_cases) {
+            double scriptMs = TimeEffect(testCase, false, 1.0);
+            double nativeMs = TimeEffect(testCase, true, 20.0);
+            std::cout << std::left << std::setw(20) << testCase.name << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(14) << scriptMs << std::setw(14) << nativeMs
+                      << std::setprecision(0) << std::setw(9) << scriptMs / nativeMs << "x\n";
+            std::cout.unsetf(std::ios::fixed);
+            std::cout << std::setprecision(6);
+        }
+    }
+
+    // Milliseconds of processing per second of audio
+    double TimeEffect(const ParityCase& testCase, bool preferNative, double seconds) {
+        const int blockSize = 512;
+        auto effect = m_effectsManager.CreateEffect(testCase.name, preferNative);
+        effect->Initialize(kSampleRate, blockSize);
+        for (size_t i = 0; i < testCase.parameters.size(); ++i) {
+            effect->SetParameter(static_cast<int>(i), testCase.parameters[i]);
+        }
+
+        AudioBuffer source(2, blockSize);
+        AudioBuffer buffer(2, blockSize);
+        FillTestSignal(source, 0, kSampleRate);
+
+        int blocks = static_cast<int>(seconds * kSampleRate / blockSize);
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < blocks; ++block) {
+            buffer.CopyFrom(source);
+            effect->ProcessBlock(buffer);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double elapsedMs = std::chrono::duration<double, std::milli>(end - start).count();
+        return elapsedMs / (blocks * blockSize / kSampleRate);
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Native Effects Test\n";
+    std::cout << "================================\n";
+
+    NativeEffectsTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
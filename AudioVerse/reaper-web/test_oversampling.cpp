@@ -0,0 +1,253 @@
+/*
+ * REAPER Web - Oversampling Test Application
+ * Latency, passband accuracy and alias rejection of the Oversampler, plus a benchmark
+ */
+
+#include "src/effects/oversampler.hpp"
+#include "src/effects/reaper_effects.hpp"
+#include "src/effects/effect_chain.hpp"
+#include "src/core/tempo_map.hpp"
+#include "src/core/audio_buffer.hpp"
+#include "src/core/fft.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // Hard clipper: harmonics well past Nyquist, the worst case for aliasing
+    constexpr const char* kClipperScript = R"(
+desc:Test Clipper
+slider1:0.25<0,1>Ceiling
+
+@sample
+spl0 = max(-slider1, min(slider1, spl0));
+spl1 = max(-slider1, min(slider1, spl1));
+)";
+
+    void FillSine(AudioBuffer& buffer, int64_t startSample, double frequency, double sampleRate) {
+        for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
+            float* samples = buffer.GetChannelData(ch);
+            for (int i = 0; i < buffer.GetSampleCount(); ++i) {
+                samples[i] = static_cast<float>(std::sin(2.0 * M_PI * frequency * (startSample + i) / sampleRate));
+            }
+        }
+    }
+}
+
+/**
+ * Oversampling tests
+ */
+class OversamplingTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Oversampling Test ===\n";
+
+        bool ok = true;
+        ok &= TestLatency();
+        ok &= TestAliasing();
+        ok &= TestTransport();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 256;
+
+    BuiltinEffectsManager m_effectsManager;
+
+    // Runs 'effect' (null: none) at 'factor' over 'input', like EffectChain does
+    std::vector<float> Render(JSFXEffect* effect, int factor, const std::vector<float>& input, bool bypassed = false) {
+        Oversampler oversampler(factor, 2, kBlockSize);
+        if (effect) {
+            effect->Initialize(kSampleRate * factor, kBlockSize * factor);
+        }
+
+        std::vector<float> output(input.size());
+        AudioBuffer buffer(2, kBlockSize);
+        for (size_t position = 0; position + kBlockSize <= input.size(); position += kBlockSize) {
+            for (int ch = 0; ch < 2; ++ch) {
+                std::copy(input.begin() + position, input.begin() + position + kBlockSize, buffer.GetChannelData(ch));
+            }
+            if (bypassed) {
+                oversampler.ProcessBypassed(buffer);
+            } else {
+                AudioBuffer& high = oversampler.Upsample(buffer);
+                if (effect) effect->ProcessBlock(high);
+                oversampler.Downsample(buffer);
+            }
+            std::copy(buffer.GetChannelData(0), buffer.GetChannelData(0) + kBlockSize, output.begin() + position);
+        }
+        return output;
+    }
+
+    // A 1 kHz sine comes back delayed by exactly the reported latency
+    bool TestLatency() {
+        std::cout << "\n--- Testing Reported Latency (1 kHz sine, pass-through) ---\n";
+
+        const size_t length = 48 * kBlockSize;
+        AudioBuffer source(1, static_cast<int>(length));
+        FillSine(source, 0, 1000.0, kSampleRate);
+        std::vector<float> input(source.GetChannelData(0), source.GetChannelData(0) + length);
+
+        bool ok = true;
+        for (int factor : {2, 4, 8}) {
+            int latency = Oversampler(factor, 2, kBlockSize).GetLatencySamples();
+            for (bool bypassed : {false, true}) {
+                std::vector<float> output = Render(nullptr, factor, input, bypassed);
+                double maxError = 0.0;
+                for (size_t i = 2048; i < length; ++i) {
+                    maxError = std::max(maxError, static_cast<double>(std::abs(output[i] - input[i - latency])));
+                }
+                bool pass = maxError < 1e-3;
+                std::cout << (pass ? "✓ " : "✗ ") << factor << "x" << (bypassed ? " bypassed" : "")
+                          << ": latency " << latency << " samples, max error " << maxError << "\n";
+                ok &= pass;
+            }
+        }
+        return ok;
+    }
+
+    // Energy outside the clipped sine's harmonic bins is aliasing
+    double AliasLevelDb(int factor) {
+        const int size = 65536;
+        const int bin = 10923;                         // ~8 kHz, harmonics land on exact bins
+        double frequency = bin * kSampleRate / size;
+
+        const size_t length = size * 2;
+        AudioBuffer source(1, static_cast<int>(length));
+        FillSine(source, 0, frequency, kSampleRate);
+        std::vector<float> input(source.GetChannelData(0), source.GetChannelData(0) + length);
+
+        auto clipper = std::make_unique<JSFXEffect>();
+        clipper->LoadEffect(kClipperScript);
+        std::vector<float> output;
+        if (factor == 1) {
+            clipper->Initialize(kSampleRate, kBlockSize);
+            output = input;
+            AudioBuffer buffer(2, kBlockSize);
+            for (size_t position = 0; position < length; position += kBlockSize) {
+                std::copy(input.begin() + position, input.begin() + position + kBlockSize, buffer.GetChannelData(0));
+                std::copy(input.begin() + position, input.begin() + position + kBlockSize, buffer.GetChannelData(1));
+                clipper->ProcessBlock(buffer);
+                std::copy(buffer.GetChannelData(0), buffer.GetChannelData(0) + kBlockSize, output.begin() + position);
+            }
+        } else {
+            output = Render(clipper.get(), factor, input);
+        }
+
+        FFT fft(size);
+        std::vector<float> re(fft.GetNumBins()), im(fft.GetNumBins());
+        fft.Forward(output.data() + size, re.data(), im.data());
+
+        double harmonic = 0.0, alias = 0.0;
+        for (int k = 1; k < fft.GetNumBins(); ++k) {
+            double power = static_cast<double>(re[k]) * re[k] + static_cast<double>(im[k]) * im[k];
+            // Above ~20 kHz the anti-imaging filters roll off the harmonics too
+            if (k * kSampleRate / size > 20000.0) continue;
+            (k % bin == 0 ? harmonic : alias) += power;
+        }
+        return 10.0 * std::log10(alias / harmonic);
+    }
+
+    bool TestAliasing() {
+        std::cout << "\n--- Testing Alias Rejection (8 kHz sine into a hard clipper) ---\n";
+
+        double previous = 0.0;
+        double base = 0.0;
+        bool ok = true;
+        for (int factor : {1, 2, 4, 8}) {
+            double level = AliasLevelDb(factor);
+            bool pass = factor == 1 || level < previous - 6.0;
+            if (factor == 1) base = level;
+            std::cout << (pass ? "✓ " : "✗ ") << factor << "x: aliasing " << std::fixed << std::setprecision(1)
+                      << level << " dB relative to the harmonics\n";
+            std::cout.unsetf(std::ios::fixed);
+            previous = level;
+            ok &= pass;
+        }
+
+        bool overall = previous < base - 30.0;
+        std::cout << (overall ? "✓ " : "✗ ") << "8x is at least 30 dB below 1x\n";
+        return ok && overall;
+    }
+
+    // beat_position inside a 4x slot ends the block where the session's does,
+    // on a steady tempo and on a ramp
+    bool TestTransport() {
+        std::cout << "\n--- Testing Transport in an Oversampled Slot ---\n";
+
+        TempoMap map(std::vector<TempoMarker>{
+            TempoMarker{0.0, 120.0, false, 4, 4},
+            TempoMarker{8.0, 90.0, true, 0, 0},
+            TempoMarker{16.0, 180.0, false, 0, 0},
+        });
+
+        bool ok = true;
+        for (double start : {1.0, map.BeatsToSeconds(10.0)}) {
+            EffectChain chain;
+            chain.Prepare(kSampleRate, kBlockSize);
+            auto effect = std::make_unique<JSFXEffect>();
+            effect->LoadEffect(kClipperScript);
+            chain.AddEffect(std::move(effect));
+            chain.SetEffectOversampling(0, 4);
+
+            EffectChain::BlockInfo info;
+            info.hasTransport = true;
+            info.transport = map.GetBlockCursor(start, kSampleRate);
+            info.playState = 1.0;
+            AudioBuffer buffer(2, kBlockSize);
+            chain.ProcessAudio(buffer, info);
+
+            double beat = chain.GetEffect(0)->GetInterpreter()->GetContext().beat_position;
+            double expected = map.SecondsToBeats(start + kBlockSize / kSampleRate);
+            double error = std::abs(beat - expected);
+            bool pass = error < 1e-9;
+            std::cout << std::setprecision(12) << (pass ? "✓ " : "✗ ")
+                      << (info.transport.incrementDelta != 0.0 ? "Ramp" : "Steady tempo")
+                      << ": beat_position " << beat << " after one block, expected " << expected
+                      << " (error " << std::setprecision(3) << error << ")\n" << std::setprecision(6);
+            ok &= pass;
+        }
+        return ok;
+    }
+
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: stereo resampling round trip, 256-sample blocks, 48 kHz ---\n";
+
+        for (int factor : {2, 4, 8}) {
+            Oversampler oversampler(factor, 2, kBlockSize);
+            AudioBuffer buffer(2, kBlockSize);
+            FillSine(buffer, 0, 440.0, kSampleRate);
+
+            const double seconds = 20.0;
+            int blocks = static_cast<int>(seconds * kSampleRate / kBlockSize);
+            auto start = std::chrono::steady_clock::now();
+            for (int block = 0; block < blocks; ++block) {
+                oversampler.Upsample(buffer);
+                oversampler.Downsample(buffer);
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << factor << "x: " << std::fixed << std::setprecision(3) << 100.0 * elapsed / seconds
+                      << "% CPU, latency " << oversampler.GetLatencySamples() << " samples\n";
+            std::cout.unsetf(std::ios::fixed);
+            std::cout << std::setprecision(6);
+        }
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Oversampling Test\n";
+    std::cout << "==============================\n";
+
+    OversamplingTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
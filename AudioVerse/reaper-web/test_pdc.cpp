@@ -0,0 +1,139 @@
+/*
+ * REAPER Web - Delay Compensation Test Application
+ * Tracks with different effect latencies leave the engine sample-aligned
+ */
+
+#include "src/core/audio_engine.hpp"
+#include "src/core/track_manager.hpp"
+#include "src/core/reaper_engine.hpp"
+#include "src/effects/effect_chain.hpp"
+#include "src/media/media_item.hpp"
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// The engine is driven directly; tracks fall back to the default session rate
+ReaperEngine* g_reaperEngine = nullptr;
+
+namespace {
+    constexpr double kSampleRate = 48000.0;
+    constexpr int kBlockSize = 512;
+    constexpr int kImpulseSample = 1000;
+
+    // A unit impulse at kImpulseSample on one channel, silence elsewhere
+    std::string ImpulseScript(int channel) {
+        return std::string(R"(
+desc:Test Impulse
+
+@init
+n = 0;
+
+@sample
+spl0 = 0;
+spl1 = 0;
+)") + "spl" + std::to_string(channel) + " = n == " + std::to_string(kImpulseSample) + R"( ? 1 : 0;
+n += 1;
+)";
+    }
+
+    constexpr const char* kPassScript = R"(
+desc:Test Pass
+
+@sample
+spl0 = spl0;
+spl1 = spl1;
+)";
+
+    std::unique_ptr<JSFXEffect> MakeEffect(const std::string& source) {
+        auto effect = std::make_unique<JSFXEffect>();
+        effect->LoadEffect(source);
+        return effect;
+    }
+
+    int PeakIndex(const std::vector<float>& samples) {
+        int peak = 0;
+        for (int i = 1; i < static_cast<int>(samples.size()); ++i) {
+            if (std::abs(samples[i]) > std::abs(samples[peak])) peak = i;
+        }
+        return peak;
+    }
+}
+
+/**
+ * Plugin delay compensation tests
+ */
+class PDCTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Delay Compensation Test ===\n";
+
+        bool ok = true;
+        ok &= TestAlignment(4);
+        ok &= TestAlignment(8);
+        return ok;
+    }
+
+private:
+    // Track 1 plays an impulse on the left channel straight through; track 2
+    // plays the same impulse on the right through an oversampled effect
+    bool TestAlignment(int factor) {
+        std::cout << "\n--- Testing Alignment Against a " << factor << "x Oversampled Track ---\n";
+
+        AudioEngine engine;
+        engine.Initialize(kSampleRate, kBlockSize, 2);
+        engine.SetMasterLimiterEnabled(false);
+        TrackManager trackManager;
+        trackManager.Initialize(&engine);
+        MediaItemManager mediaManager;
+
+        Track* direct = trackManager.CreateTrack("Direct");
+        Track* delayed = trackManager.CreateTrack("Oversampled");
+        direct->GetEffectsChain()->Prepare(kSampleRate, kBlockSize);
+        delayed->GetEffectsChain()->Prepare(kSampleRate, kBlockSize);
+        direct->GetEffectsChain()->AddEffect(MakeEffect(ImpulseScript(0)));
+        delayed->GetEffectsChain()->AddEffect(MakeEffect(ImpulseScript(1)));
+        delayed->GetEffectsChain()->AddEffect(MakeEffect(kPassScript));
+        delayed->GetEffectsChain()->SetEffectOversampling(1, factor);
+
+        // Without a ReaperEngine nothing forwards the latency change
+        engine.CompensateLatency();
+        int latency = delayed->GetEffectsChain()->GetLatencySamples();
+
+        std::vector<float> left(kBlockSize * 16, 0.0f);
+        std::vector<float> right(left.size(), 0.0f);
+        for (int position = 0; position < static_cast<int>(left.size()); position += kBlockSize) {
+            float* outputs[2] = {left.data() + position, right.data() + position};
+            engine.ProcessBlock(nullptr, outputs, 2, kBlockSize, &mediaManager, &trackManager,
+                                position / kSampleRate, kBlockSize / kSampleRate);
+            engine.ProcessMasterOutput(outputs, 2, kBlockSize);
+        }
+
+        int leftPeak = PeakIndex(left);
+        int rightPeak = PeakIndex(right);
+        // The disabled limiter keeps its lookahead delay, common to both tracks
+        int expected = kImpulseSample + engine.CalculatePDCDelay() + engine.GetMasterLimiter()->GetLatencySamples();
+        bool latencyOk = latency > 0 && engine.CalculatePDCDelay() == latency;
+        std::cout << (latencyOk ? "✓" : "✗") << " Oversampled track reports " << latency << " samples of latency\n";
+
+        bool alignedOk = leftPeak == rightPeak && leftPeak == expected && std::abs(left[leftPeak] - 1.0f) < 1e-6f;
+        std::cout << (alignedOk ? "✓" : "✗") << " Impulses leave at samples " << leftPeak << " and " << rightPeak
+                  << " (expected " << expected << ")\n";
+
+        engine.Shutdown();
+        return latencyOk && alignedOk;
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Delay Compensation Test\n";
+    std::cout << "====================================\n";
+
+    PDCTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/*
+ * REAPER Web - JSFX Profiler Test Application
+ * Per-line and per-node hot spots, exact counts, and the cost of profiling
+ */
+
+#include "src/effects/reaper_effects.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // Line 6 is the hot spot; the comment checks line numbers after comments
+    constexpr const char* kHotLoop = R"(desc:Profile Hot Loop
+@sample
+// 32 sines per sample on one line
+i = 0;
+acc = 0;
+while (i < 32) ( acc += sin(i * 0.1); i += 1; );
+spl0 = spl0 * 0.5 + acc * 0.0001;
+spl1 *= 0.5;
+)";
+
+    void FillSine(AudioBuffer& buffer, int block) {
+        for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
+            float* samples = buffer.GetChannelData(ch);
+            for (int i = 0; i < buffer.GetSampleCount(); ++i) {
+                samples[i] = static_cast<float>(0.5 * std::sin(0.01 * (block * buffer.GetSampleCount() + i)));
+            }
+        }
+    }
+
+    const JSFXHotSpot* FindLine(const std::vector<JSFXHotSpot>& spots, int line) {
+        for (const auto& spot : spots) {
+            if (spot.line == line) return &spot;
+        }
+        return nullptr;
+    }
+}
+
+/**
+ * Profiler tests
+ */
+class ProfilerTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web JSFX Profiler Test ===\n";
+
+        bool ok = true;
+        ok &= TestHotLine();
+        ok &= TestNodeCounts();
+        ok &= TestOutputUnchanged();
+        ok &= TestResetAndDisable();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 256;
+    static constexpr int kBlocks = 40;
+
+    BuiltinEffectsManager m_effectsManager;
+
+    void Run(JSFXEffect& effect, int blocks) {
+        AudioBuffer buffer(2, kBlockSize);
+        for (int block = 0; block < blocks; ++block) {
+            FillSine(buffer, block);
+            effect.ProcessBlock(buffer);
+        }
+    }
+
+    // The loop line ranks first; every @sample line runs once per sample
+    bool TestHotLine() {
+        std::cout << "\n--- Testing Per-Line Hot Spots ---\n";
+
+        JSFXEffect effect;
+        effect.LoadEffect(kHotLoop);
+        effect.SetProfilingEnabled(true);
+        effect.Initialize(kSampleRate, kBlockSize);
+        Run(effect, kBlocks);
+
+        auto spots = effect.GetInterpreter()->GetHotSpots();
+        const uint64_t samples = static_cast<uint64_t>(kBlocks) * kBlockSize;
+        const JSFXHotSpot* first = FindLine(spots, 4);
+        const JSFXHotSpot* last = FindLine(spots, 8);
+
+        bool pass = !spots.empty() && spots[0].line == 6 && spots[0].code.compare(0, 5, "while") == 0 &&
+                    spots[0].percent > 50.0 && first && first->executions == samples &&
+                    last && last->executions == samples && last->code == "spl1 *= 0.5;";
+        std::cout << (pass ? "✓ " : "✗ ") << "Line " << (spots.empty() ? 0 : spots[0].line) << " hottest at "
+                  << std::fixed << std::setprecision(1) << (spots.empty() ? 0.0 : spots[0].percent)
+                  << "%, straight-line code ran " << samples << " times\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << effect.GetProfileReport(5);
+        return pass;
+    }
+
+    // Node rows: the loop body's sin() runs 32 times per sample, at its column
+    bool TestNodeCounts() {
+        std::cout << "\n--- Testing Per-Node Counts ---\n";
+
+        JSFXEffect effect;
+        effect.LoadEffect(kHotLoop);
+        effect.SetProfilingEnabled(true);
+        effect.Initialize(kSampleRate, kBlockSize);
+        Run(effect, kBlocks);
+
+        const uint64_t samples = static_cast<uint64_t>(kBlocks) * kBlockSize;
+        uint64_t sinCalls = 0;
+        int sinColumn = 0;
+        for (const auto& spot : effect.GetInterpreter()->GetHotSpots(false)) {
+            if (spot.code == "sin()") {
+                sinCalls = spot.executions;
+                sinColumn = spot.column;
+            }
+        }
+
+        bool pass = sinCalls == 32 * samples && sinColumn == 25;
+        std::cout << (pass ? "✓ " : "✗ ") << "sin() at 6:" << sinColumn << " ran " << sinCalls
+                  << " times (expected " << 32 * samples << ")\n";
+        return pass;
+    }
+
+    // Profiling observes only: output is bit-identical
+    bool TestOutputUnchanged() {
+        std::cout << "\n--- Testing Output Unchanged ---\n";
+
+        auto plain = m_effectsManager.CreateEffect("Simple Compressor", false);
+        auto profiled = m_effectsManager.CreateEffect("Simple Compressor", false);
+        profiled->SetProfilingEnabled(true);
+        plain->Initialize(kSampleRate, kBlockSize);
+        profiled->Initialize(kSampleRate, kBlockSize);
+
+        AudioBuffer a(2, kBlockSize), b(2, kBlockSize);
+        bool identical = true;
+        for (int block = 0; block < kBlocks; ++block) {
+            FillSine(a, block);
+            FillSine(b, block);
+            plain->ProcessBlock(a);
+            profiled->ProcessBlock(b);
+            for (int ch = 0; ch < 2; ++ch) {
+                identical &= std::equal(a.GetChannelData(ch), a.GetChannelData(ch) + kBlockSize, b.GetChannelData(ch));
+            }
+        }
+
+        std::cout << (identical ? "✓ " : "✗ ") << "Profiled compressor output matches the unprofiled one\n";
+        return identical;
+    }
+
+    // Reset clears the counters; disabled, nothing more is counted
+    bool TestResetAndDisable() {
+        std::cout << "\n--- Testing Reset and Disable ---\n";
+
+        JSFXEffect effect;
+        effect.LoadEffect(kHotLoop);
+        effect.Initialize(kSampleRate, kBlockSize);
+        Run(effect, 4);
+        bool emptyWhenOff = effect.GetInterpreter()->GetHotSpots().empty();
+
+        effect.SetProfilingEnabled(true);
+        Run(effect, 4);
+        bool counted = !effect.GetInterpreter()->GetHotSpots().empty();
+
+        effect.ResetProfile();
+        bool cleared = effect.GetInterpreter()->GetHotSpots().empty();
+
+        Run(effect, 2);
+        effect.SetProfilingEnabled(false);
+        uint64_t before = effect.GetInterpreter()->GetHotSpots()[0].executions;
+        Run(effect, 2);
+        uint64_t after = effect.GetInterpreter()->GetHotSpots()[0].executions;
+
+        bool pass = emptyWhenOff && counted && cleared && before == after && !effect.IsProfilingEnabled();
+        std::cout << (pass ? "✓ " : "✗ ") << "Nothing counted before enabling or after disabling; reset clears\n";
+        return pass;
+    }
+
+    // Cost of the profiler, off and on
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: Simple Compressor (JSFX), 10 s of stereo audio ---\n";
+
+        for (bool profiling : {false, true}) {
+            auto effect = m_effectsManager.CreateEffect("Simple Compressor", false);
+            effect->SetProfilingEnabled(profiling);
+            effect->Initialize(kSampleRate, kBlockSize);
+            AudioBuffer buffer(2, kBlockSize);
+
+            const int blocks = static_cast<int>(10 * kSampleRate / kBlockSize);
+            auto start = std::chrono::steady_clock::now();
+            for (int block = 0; block < blocks; ++block) {
+                FillSine(buffer, block);
+                effect->ProcessBlock(buffer);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << (profiling ? "Profiling on:  " : "Profiling off: ") << std::fixed << std::setprecision(1)
+                      << 1e3 * seconds / 10.0 << " ms per second of audio\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - JSFX Profiler Test\n";
+    std::cout << "===============================\n";
+
+    ProfilerTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+/*
+ * REAPER Web - JSFX Program Cache Test Application
+ * Shared compiled programs, per-instance state and instantiation cost of JSFX effects
+ */
+
+#include "src/effects/reaper_effects.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// Counts heap allocations while g_countAllocations is set
+static std::atomic<bool> g_countAllocations{false};
+static std::atomic<int> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    if (g_countAllocations.load(std::memory_order_relaxed)) g_allocations++;
+    if (void* pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace {
+    // Every sample writes to the next page, so one block visits all of them
+    constexpr const char* kPageWalkScript = R"(
+desc:Page Walk
+
+@init
+n = 0;
+
+@sample
+addr = (n * 4096 + n) % 65536;
+addr[0] = n + 1;
+n += 1;
+)";
+
+    void FillTestSignal(AudioBuffer& buffer, int64_t startSample, double sampleRate) {
+        for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
+            float* samples = buffer.GetChannelData(ch);
+            for (int i = 0; i < buffer.GetSampleCount(); ++i) {
+                double t = (startSample + i) / sampleRate;
+                samples[i] = static_cast<float>((0.5 + 0.4 * std::sin(2.0 * M_PI * 2.0 * t)) *
+                                                std::sin(2.0 * M_PI * (330.0 + 50.0 * ch) * t));
+            }
+        }
+    }
+
+    // Renders 'blocks' blocks and returns the left channel
+    std::vector<float> Render(JSFXEffect& effect, double sampleRate, int blocks) {
+        const int blockSize = 256;
+        AudioBuffer buffer(2, blockSize);
+        std::vector<float> output;
+        for (int block = 0; block < blocks; ++block) {
+            FillTestSignal(buffer, static_cast<int64_t>(block) * blockSize, sampleRate);
+            effect.ProcessBlock(buffer);
+            output.insert(output.end(), buffer.GetChannelData(0), buffer.GetChannelData(0) + blockSize);
+        }
+        return output;
+    }
+}
+
+/**
+ * Program cache tests
+ */
+class ProgramCacheTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web JSFX Program Cache Test ===\n";
+
+        bool ok = true;
+        ok &= TestSharedPrograms();
+        ok &= TestInstanceState();
+        ok &= TestLazyMemory();
+        ok &= TestNoAllocationInSample();
+        ok &= TestProgramLifetime();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kPageCount = JSFXMemory::MEMORY_SIZE / JSFXMemory::PAGE_SIZE;
+
+    BuiltinEffectsManager m_effectsManager;
+
+    // Every instance of a script runs the same program
+    bool TestSharedPrograms() {
+        std::cout << "\n--- Testing Shared Programs ---\n";
+
+        std::vector<std::unique_ptr<JSFXEffect>> effects;
+        for (int i = 0; i < 20; ++i) {
+            effects.push_back(m_effectsManager.CreateEffect("Simple Compressor", false));
+            effects.push_back(m_effectsManager.CreateEffect("Resonant Lowpass", false));
+        }
+
+        bool shared = true;
+        for (size_t i = 2; i < effects.size(); ++i) {
+            shared &= effects[i]->GetInterpreter()->GetProgram() == effects[i % 2]->GetInterpreter()->GetProgram();
+        }
+        bool distinct = effects[0]->GetInterpreter()->GetProgram() != effects[1]->GetInterpreter()->GetProgram();
+        bool pass = shared && distinct && effects[0]->GetInfo().sliders.size() == 5;
+        std::cout << (pass ? "✓ " : "✗ ") << "40 instances of 2 scripts share 2 programs, cache holds "
+                  << JSFXProgramCache::Instance().GetProgramCount() << "\n";
+        return pass;
+    }
+
+    // Instances keep their own variables: a shared program must not leak state
+    bool TestInstanceState() {
+        std::cout << "\n--- Testing Per-Instance State ---\n";
+
+        auto first = m_effectsManager.CreateEffect("Simple Delay", false);
+        auto second = m_effectsManager.CreateEffect("Simple Delay", false);
+        auto quiet = m_effectsManager.CreateEffect("Simple Delay", false);
+        for (auto* effect : {first.get(), second.get(), quiet.get()}) {
+            effect->Initialize(kSampleRate, 256);
+        }
+        quiet->SetParameter(0, 120.0);      // Different delay time on one instance
+
+        // Reference: a program compiled outside the cache
+        JSFXInterpreter reference;
+        reference.LoadProgram(JSFXProgram::Compile(m_effectsManager.GetEffectScript("Simple Delay")));
+        bool uncached = reference.GetProgram() != first->GetInterpreter()->GetProgram();
+        reference.GetContext().srate = kSampleRate;
+        reference.ExecuteInit();
+        reference.ExecuteSlider();
+        std::vector<float> expected;
+        AudioBuffer buffer(2, 256);
+        for (int block = 0; block < 40; ++block) {
+            FillTestSignal(buffer, static_cast<int64_t>(block) * 256, kSampleRate);
+            reference.ExecuteBlock(buffer);
+            expected.insert(expected.end(), buffer.GetChannelData(0), buffer.GetChannelData(0) + 256);
+        }
+
+        // Interleave the instances so any shared state would show
+        std::vector<float> a, b, c;
+        for (int block = 0; block < 40; ++block) {
+            for (auto pair : {std::make_pair(first.get(), &a), std::make_pair(quiet.get(), &c), std::make_pair(second.get(), &b)}) {
+                FillTestSignal(buffer, static_cast<int64_t>(block) * 256, kSampleRate);
+                pair.first->ProcessBlock(buffer);
+                pair.second->insert(pair.second->end(), buffer.GetChannelData(0), buffer.GetChannelData(0) + 256);
+            }
+        }
+
+        bool pass = uncached && a == b && a == expected && a != c;
+        std::cout << (pass ? "✓ " : "✗ ") << "Instances match each other and an uncached compile bit for bit; "
+                  << "a retuned instance differs\n";
+        return pass;
+    }
+
+    // Memory pages exist only for scripts that write memory, from the start
+    bool TestLazyMemory() {
+        std::cout << "\n--- Testing Memory Pages Per Script ---\n";
+
+        auto compressor = m_effectsManager.CreateEffect("Simple Compressor", false);
+        auto delay = m_effectsManager.CreateEffect("Simple Delay", false);
+        compressor->Initialize(kSampleRate, 256);
+        delay->Initialize(kSampleRate, 256);
+        int delayPagesBefore = delay->GetInterpreter()->GetContext().memory.GetAllocatedPageCount();
+        Render(*compressor, kSampleRate, 200);
+        Render(*delay, kSampleRate, 200);
+
+        int compressorPages = compressor->GetInterpreter()->GetContext().memory.GetAllocatedPageCount();
+        int delayPages = delay->GetInterpreter()->GetContext().memory.GetAllocatedPageCount();
+        bool pass = compressorPages == 0 && delayPages == kPageCount && delayPagesBefore == delayPages;
+        std::cout << (pass ? "✓ " : "✗ ") << "Compressor " << compressorPages << " pages, delay " << delayPages
+                  << " of " << kPageCount << " pages, all there before the first block\n";
+        return pass;
+    }
+
+    // @sample writing a fresh page every sample never reaches the allocator
+    bool TestNoAllocationInSample() {
+        std::cout << "\n--- Testing Memory Writes in @sample ---\n";
+
+        JSFXEffect effect;
+        effect.LoadEffect(kPageWalkScript);
+        effect.Initialize(kSampleRate, 256);
+        const JSFXMemory& memory = effect.GetInterpreter()->GetContext().memory;
+
+        AudioBuffer buffer(2, 256);
+        FillTestSignal(buffer, 0, kSampleRate);
+        g_allocations = 0;
+        g_countAllocations = true;
+        effect.ProcessBlock(buffer);
+        g_countAllocations = false;
+
+        // Sample n wrote n + 1 at address (n * PAGE_SIZE + n) mod MEMORY_SIZE
+        bool written = true;
+        for (int n = 0; n < 256; ++n) {
+            int address = (n * JSFXMemory::PAGE_SIZE + n) % JSFXMemory::MEMORY_SIZE;
+            written &= memory.Read(address) == n + 1;
+        }
+        bool pass = g_allocations == 0 && written;
+        std::cout << (pass ? "✓ " : "✗ ") << "256 samples over " << kPageCount << " pages: " << g_allocations
+                  << " allocations, every write read back\n";
+        return pass;
+    }
+
+    // A program goes away with its last instance; the cache never keeps it
+    bool TestProgramLifetime() {
+        std::cout << "\n--- Testing Program Lifetime ---\n";
+
+        JSFXProgramCache& cache = JSFXProgramCache::Instance();
+        auto kept = m_effectsManager.CreateEffect("High Pass Filter", false);
+        auto dropped = m_effectsManager.CreateEffect("DC Remove", false);
+        std::weak_ptr<const JSFXProgram> droppedProgram = dropped->GetInterpreter()->GetProgram();
+        size_t loaded = cache.GetProgramCount();
+        dropped.reset();
+
+        auto reloaded = m_effectsManager.CreateEffect("High Pass Filter", false);
+        bool pass = droppedProgram.expired() && cache.GetProgramCount() == loaded - 1 &&
+                    reloaded->GetInterpreter()->GetProgram() == kept->GetInterpreter()->GetProgram();
+        std::cout << (pass ? "✓ " : "✗ ") << loaded << " programs, " << cache.GetProgramCount()
+                  << " after the last DC Remove went away\n";
+        return pass;
+    }
+
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: 300 Simple Compressor instances (JSFX) ---\n";
+
+        const int instances = 300;
+        std::string script = m_effectsManager.GetEffectScript("Simple Compressor");
+
+        // Uncached: parse and compile every instance, as before the cache
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<JSFXInterpreter>> uncached;
+        for (int i = 0; i < instances; ++i) {
+            uncached.push_back(std::make_unique<JSFXInterpreter>());
+            uncached.back()->LoadProgram(JSFXProgram::Compile(script));
+        }
+        double compileSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<JSFXEffect>> effects;
+        for (int i = 0; i < instances; ++i) {
+            effects.push_back(m_effectsManager.CreateEffect("Simple Compressor", false));
+        }
+        double cachedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "Compile per instance: " << 1e6 * compileSeconds / instances << " us per instance\n"
+                  << "Cached program:       " << 1e6 * cachedSeconds / instances << " us per instance\n";
+        std::cout.unsetf(std::ios::fixed);
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - JSFX Program Cache Test\n";
+    std::cout << "====================================\n";
+
+    ProgramCacheTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
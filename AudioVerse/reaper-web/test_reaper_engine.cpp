@@ -0,0 +1,252 @@
+/*
+ * REAPER Web - Engine Test Application
+ * The full ReaperEngine block path: the master output and record transport
+ */
+
+#include "src/core/reaper_engine.hpp"
+#include "src/core/audio_engine.hpp"
+#include "src/core/project_manager.hpp"
+#include "src/core/track_manager.hpp"
+#include "src/effects/effect_chain.hpp"
+#include "src/media/media_item.hpp"
+#include "src/media/recording_pipeline.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ProjectManager has no implementation in this tree; the engine only needs
+// it to link and to report success
+ProjectManager::ProjectManager() = default;
+ProjectManager::~ProjectManager() = default;
+bool ProjectManager::Initialize() { return true; }
+void ProjectManager::Shutdown() {}
+bool ProjectManager::NewProject() { return true; }
+bool ProjectManager::LoadProject(const std::string&) { return false; }
+bool ProjectManager::SaveProject(const std::string&) { return false; }
+
+namespace {
+    constexpr double kSampleRate = 48000.0;
+    constexpr int kBlockSize = 512;
+
+    // Near full-scale 1 kHz sine
+    constexpr const char* kSineScript = R"(
+desc:Test Sine
+
+@init
+phase = 0;
+
+@sample
+spl0 = 0.95 * sin(phase + 0.785398);
+spl1 = spl0;
+phase += 2 * $pi * 1000 / srate;
+)";
+
+    // Reference true peak: 16x windowed-sinc reconstruction between samples
+    double MeasureTruePeak(const std::vector<float>& signal, size_t start) {
+        const int oversample = 16;
+        const int halfWidth = 32;
+        double peak = 0.0;
+        for (size_t n = start + halfWidth; n + halfWidth < signal.size(); ++n) {
+            for (int f = 0; f < oversample; ++f) {
+                double t = static_cast<double>(f) / oversample;
+                double value = 0.0;
+                for (int k = -halfWidth + 1; k <= halfWidth; ++k) {
+                    double x = k - t;
+                    double sinc = (x == 0.0) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+                    double window = 0.5 + 0.5 * std::cos(M_PI * x / halfWidth);
+                    value += signal[n + k] * sinc * window;
+                }
+                peak = std::max(peak, std::abs(value));
+            }
+        }
+        return peak;
+    }
+
+    double ToDb(double value) { return 20.0 * std::log10(std::max(value, 1e-12)); }
+
+    // Device input as a function of the project sample it is heard at
+    float TestInput(int64_t sample) { return static_cast<float>(sample % 10007) / 10007.0f; }
+
+    // Keeps the frames of a mono take in memory instead of a file
+    class MemorySink : public RecordingFileSink {
+    public:
+        MemorySink(std::vector<float>& frames, std::mutex& mutex) : m_frames(frames), m_mutex(mutex) {}
+
+        bool Open(const std::string&) override { return true; }
+
+        bool Write(const void* data, size_t bytes) override {
+            if (!m_headerSeen) {
+                m_headerSeen = true;
+                return true;                    // WAV header
+            }
+            const float* samples = static_cast<const float*>(data);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_frames.insert(m_frames.end(), samples, samples + bytes / sizeof(float));
+            return true;
+        }
+
+        bool WriteAt(uint64_t, const void*, size_t) override { return true; }
+        void Close() override {}
+
+    private:
+        std::vector<float>& m_frames;
+        std::mutex& m_mutex;
+        bool m_headerSeen = false;
+    };
+
+    std::unique_ptr<ReaperEngine> MakeEngine() {
+        auto engine = std::make_unique<ReaperEngine>();
+        ReaperEngine::GlobalSettings settings;
+        settings.sampleRate = kSampleRate;
+        settings.bufferSize = kBlockSize;
+        settings.maxChannels = 2;
+        engine->Initialize(settings);
+        return engine;
+    }
+
+    // Runs 'blocks' device blocks through the engine; returns the left channel
+    std::vector<float> Render(ReaperEngine& engine, int blocks) {
+        std::vector<float> output;
+        std::vector<float> left(kBlockSize), right(kBlockSize);
+        for (int block = 0; block < blocks; ++block) {
+            float* outputs[2] = {left.data(), right.data()};
+            engine.ProcessAudioBlock(nullptr, outputs, 2, kBlockSize);
+            output.insert(output.end(), left.begin(), left.end());
+        }
+        return output;
+    }
+}
+
+/**
+ * Engine tests
+ */
+class ReaperEngineTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Engine Test ===\n";
+
+        bool ok = true;
+        ok &= TestMasterOutputCeiling();
+        ok &= TestPunchIn(false);
+        ok &= TestPunchIn(true);
+        return ok;
+    }
+
+private:
+    // Master gain +6 dB and full-volume metronome clicks on top of a
+    // full-scale track: the limiter still has the last word
+    bool TestMasterOutputCeiling() {
+        std::cout << "\n--- Testing Output Ceiling With Master Gain and Clicks ---\n";
+
+        auto engine = MakeEngine();
+        float ceilingDb = engine->GetAudioEngine()->GetMasterLimiter()->GetCeiling();
+
+        Track* track = engine->GetTrackManager()->CreateTrack("Sine");
+        EffectChain* chain = track->GetEffectsChain();
+        chain->Prepare(kSampleRate, kBlockSize);
+        auto sine = std::make_unique<JSFXEffect>();
+        sine->LoadEffect(kSineScript);
+        chain->AddEffect(std::move(sine));
+
+        engine->SetMasterVolume(2.0);
+        engine->SetMetronome(true);
+        engine->SetClickVolume(100);
+        engine->Play();
+
+        std::vector<float> output = Render(*engine, static_cast<int>(2.0 * kSampleRate / kBlockSize));
+        engine->Shutdown();
+
+        double samplePeak = 0.0;
+        for (float value : output) samplePeak = std::max(samplePeak, static_cast<double>(std::abs(value)));
+        double truePeak = MeasureTruePeak(output, 0);
+
+        bool samplePass = ToDb(samplePeak) <= ceilingDb + 1e-4;
+        // Same tolerance as the limiter's own test: four phases near fs/4
+        bool truePass = ToDb(truePeak) <= ceilingDb + 0.2;
+        std::cout << (samplePass ? "✓ " : "✗ ") << "Sample peak " << std::fixed << std::setprecision(3)
+                  << ToDb(samplePeak) << " dBFS (ceiling " << ceilingDb << " dB)\n";
+        std::cout << (truePass ? "✓ " : "✗ ") << "True peak " << ToDb(truePeak) << " dBTP (0.2 dB tolerance)\n";
+        std::cout.unsetf(std::ios::fixed);
+        return samplePass && truePass;
+    }
+
+    // Runs device blocks with TestInput on the inputs, aligned to the play position
+    static void RenderWithInput(ReaperEngine& engine, int blocks) {
+        std::vector<float> input(kBlockSize), left(kBlockSize), right(kBlockSize);
+        for (int block = 0; block < blocks; ++block) {
+            int64_t start = std::llround(engine.GetTransportState().playPosition.load() * kSampleRate);
+            for (int i = 0; i < kBlockSize; ++i) input[i] = TestInput(start + i);
+            float* inputs[2] = {input.data(), input.data()};
+            float* outputs[2] = {left.data(), right.data()};
+            engine.ProcessAudioBlock(inputs, outputs, 2, kBlockSize);
+        }
+    }
+
+    // Record pressed while playing (or paused): the take starts at the play
+    // position, and a punch-out set during the take ends it on that sample
+    bool TestPunchIn(bool fromPause) {
+        std::cout << "\n--- Testing Record From " << (fromPause ? "Pause" : "Play") << " ---\n";
+
+        auto engine = MakeEngine();
+        std::vector<float> frames;
+        std::mutex framesMutex;
+        engine->GetRecordingPipeline()->SetSinkFactory([&]() -> std::unique_ptr<RecordingFileSink> {
+            return std::make_unique<MemorySink>(frames, framesMutex);
+        });
+        Track* track = engine->GetTrackManager()->CreateTrack("Vocal");
+        track->SetInputChannel(0);
+        track->SetRecordArm(true);
+
+        engine->Play();
+        RenderWithInput(*engine, 10);
+        if (fromPause) {
+            engine->Pause();
+            RenderWithInput(*engine, 5);
+        }
+
+        int64_t punchIn = std::llround(engine->GetTransportState().playPosition.load() * kSampleRate);
+        engine->Record();
+        bool recording = engine->GetRecordingPipeline()->IsActive() &&
+                         engine->GetTransportState().playState.load() == ReaperEngine::PlayState::RECORDING;
+        RenderWithInput(*engine, 8);
+
+        // A punch-out in the middle of a later block
+        int64_t punchOut = punchIn + 12 * kBlockSize + 123;
+        engine->SetPunchPoints(-1.0, punchOut / kSampleRate);
+        RenderWithInput(*engine, 10);
+        engine->Stop();
+
+        std::vector<MediaItem*> items = engine->GetMediaItemManager()->GetItemsOnTrack(track);
+        double itemPosition = items.empty() ? -1.0 : items.front()->GetPosition();
+        engine->Shutdown();
+
+        bool startOk = recording && items.size() == 1 && std::abs(itemPosition * kSampleRate - punchIn) < 1e-6;
+        std::cout << (startOk ? "✓" : "✗") << " Pipeline started; take placed at sample "
+                  << std::llround(itemPosition * kSampleRate) << " (play position " << punchIn << ")\n";
+
+        bool framesOk = static_cast<int64_t>(frames.size()) == punchOut - punchIn;
+        for (size_t i = 0; framesOk && i < frames.size(); ++i) {
+            framesOk = frames[i] == TestInput(punchIn + static_cast<int64_t>(i));
+        }
+        std::cout << (framesOk ? "✓" : "✗") << " " << frames.size() << " frames captured, expected "
+                  << punchOut - punchIn << " from the play position to the punch-out\n";
+        return startOk && framesOk;
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Engine Test\n";
+    std::cout << "========================\n";
+
+    ReaperEngineTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,311 @@
+/*
+ * REAPER Web - Recording Pipeline Test Application
+ * Punch accuracy, WAV output and a 64-track stress run against a slow disk
+ */
+
+#include "src/media/recording_pipeline.hpp"
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+    // Deterministic test signal: every track/sample pair has a known value
+    float TestSample(int track, int channel, int64_t sample) {
+        return static_cast<float>(((sample * 7 + track * 13 + channel * 5) % 2000) - 1000) / 1000.0f;
+    }
+
+    /**
+     * Slow disk - one shared spindle: writes serialize, each costs a fixed
+     * latency plus bandwidth, and the whole disk stalls periodically.
+     * Data is verified as it arrives instead of being stored.
+     */
+    class SlowDisk {
+    public:
+        double writeLatencyMs = 1.0;
+        double bytesPerMs = 80000.0;         // 80 MB/s
+        int stallEveryWrites = 400;
+        double stallMs = 500.0;
+
+        void Write(size_t bytes) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            double ms = writeLatencyMs + bytes / bytesPerMs;
+            if (++m_writes % stallEveryWrites == 0) {
+                ms += stallMs;
+                m_stalls++;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(ms * 1000.0)));
+        }
+
+        int GetStallCount() const { return m_stalls; }
+
+    private:
+        std::mutex m_mutex;
+        int m_writes = 0;
+        int m_stalls = 0;
+    };
+
+    class VerifyingSlowSink : public RecordingFileSink {
+    public:
+        VerifyingSlowSink(SlowDisk& disk, int track, int channels, int64_t firstSample, int& errors, std::mutex& errorMutex)
+            : m_disk(disk), m_track(track), m_channels(channels), m_nextSample(firstSample),
+              m_errors(errors), m_errorMutex(errorMutex) {}
+
+        bool Open(const std::string&) override { return true; }
+
+        bool Write(const void* data, size_t bytes) override {
+            m_disk.Write(bytes);
+            if (!m_headerSeen) {
+                m_headerSeen = true;
+                return true;                    // 94-byte WAV header
+            }
+
+            const float* samples = static_cast<const float*>(data);
+            size_t frames = bytes / (sizeof(float) * m_channels);
+            for (size_t i = 0; i < frames; ++i, ++m_nextSample) {
+                for (int ch = 0; ch < m_channels; ++ch) {
+                    if (samples[i * m_channels + ch] != TestSample(m_track, ch, m_nextSample)) {
+                        std::lock_guard<std::mutex> lock(m_errorMutex);
+                        m_errors++;
+                        return true;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool WriteAt(uint64_t, const void*, size_t) override { return true; }
+        void Close() override {}
+
+    private:
+        SlowDisk& m_disk;
+        int m_track;
+        int m_channels;
+        int64_t m_nextSample;
+        bool m_headerSeen = false;
+        int& m_errors;
+        std::mutex& m_errorMutex;
+    };
+
+    uint32_t ReadU32(const uint8_t* source) {
+        return source[0] | (source[1] << 8) | (source[2] << 16) | (static_cast<uint32_t>(source[3]) << 24);
+    }
+}
+
+/**
+ * Recording pipeline tests
+ */
+class RecordingTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Recording Test ===\n";
+
+        bool ok = true;
+        ok &= TestPunchAccuracy();
+        ok &= TestSlowDiskStress();
+        return ok;
+    }
+
+private:
+    // Fills per-channel input buffers with the test signal of one track
+    static void FillInputs(std::vector<std::vector<float>>& inputs, int channelsPerTrack,
+                           int64_t blockStart, int numSamples) {
+        for (size_t channel = 0; channel < inputs.size(); ++channel) {
+            int track = static_cast<int>(channel) / channelsPerTrack;
+            int trackChannel = static_cast<int>(channel) % channelsPerTrack;
+            for (int i = 0; i < numSamples; ++i) {
+                inputs[channel][i] = TestSample(track, trackChannel, blockStart + i);
+            }
+        }
+    }
+
+    bool TestPunchAccuracy() {
+        std::cout << "\n--- Testing Punch Accuracy and WAV Output ---\n";
+
+        const int blockSize = 333;                // Deliberately not aligned to the punch points
+        const int64_t punchIn = 1000;
+        const int64_t punchOut = 50017;
+        const std::string filePath = "test_recording_punch.wav";
+
+        RecordingPipeline::Settings settings;
+        settings.sampleRate = 44100.0;
+        settings.maxBlockSize = blockSize;
+        settings.writeChunkFrames = 4096;
+        settings.samplesPerPeak = 512;
+
+        RecordingPipeline::TrackInput input;
+        input.trackIndex = 0;
+        input.firstInputChannel = 0;
+        input.numChannels = 2;
+        input.filePath = filePath;
+
+        RecordingPipeline pipeline;
+        if (!pipeline.Start(settings, {input}, punchIn, punchOut)) {
+            std::cout << "✗ Failed to start recording\n";
+            return false;
+        }
+
+        std::vector<std::vector<float>> inputs(2, std::vector<float>(blockSize));
+        const float* channels[2] = {inputs[0].data(), inputs[1].data()};
+        for (int64_t blockStart = 0; blockStart < 60000; blockStart += blockSize) {
+            FillInputs(inputs, 2, blockStart, blockSize);
+            pipeline.Capture(channels, 2, blockStart, blockSize);
+        }
+
+        auto takes = pipeline.Stop();
+        if (takes.size() != 1) {
+            std::cout << "✗ Expected one take, got " << takes.size() << "\n";
+            return false;
+        }
+
+        const auto& take = takes[0];
+        bool ok = take.startSample == punchIn && take.lengthSamples == punchOut - punchIn && !take.writeError;
+        std::cout << (ok ? "✓" : "✗") << " Take starts at sample " << take.startSample
+                  << " with " << take.lengthSamples << " samples (expected "
+                  << punchIn << ", " << (punchOut - punchIn) << ")\n";
+
+        int expectedPeaks = static_cast<int>((punchOut - punchIn + 511) / 512);
+        bool peaksOk = take.peaks.numPeaks == expectedPeaks;
+        std::cout << (peaksOk ? "✓" : "✗") << " Built " << take.peaks.numPeaks << " peaks while recording\n";
+        ok &= peaksOk;
+
+        // Read the file back and check header and content
+        std::vector<uint8_t> file;
+        if (FILE* f = std::fopen(filePath.c_str(), "rb")) {
+            uint8_t buffer[65536];
+            size_t read;
+            while ((read = std::fread(buffer, 1, sizeof(buffer), f)) > 0) {
+                file.insert(file.end(), buffer, buffer + read);
+            }
+            std::fclose(f);
+        }
+        std::remove(filePath.c_str());
+
+        uint64_t dataBytes = static_cast<uint64_t>(punchOut - punchIn) * 2 * sizeof(float);
+        bool headerOk = file.size() == 94 + dataBytes &&
+                        std::memcmp(file.data(), "RIFF", 4) == 0 &&
+                        ReadU32(file.data() + 4) == file.size() - 8 &&
+                        ReadU32(file.data() + 52) == 18 &&
+                        std::memcmp(file.data() + 74, "fact", 4) == 0 &&
+                        ReadU32(file.data() + 82) == static_cast<uint32_t>(punchOut - punchIn) &&
+                        std::memcmp(file.data() + 86, "data", 4) == 0 &&
+                        ReadU32(file.data() + 90) == dataBytes;
+        std::cout << (headerOk ? "✓" : "✗") << " WAV header sizes and float fact chunk patched on close\n";
+        ok &= headerOk;
+
+        bool dataOk = headerOk;
+        for (int64_t i = 0; dataOk && i < punchOut - punchIn; ++i) {
+            for (int ch = 0; ch < 2; ++ch) {
+                float value;
+                std::memcpy(&value, file.data() + 94 + (i * 2 + ch) * sizeof(float), sizeof(float));
+                dataOk &= value == TestSample(0, ch, punchIn + i);
+            }
+        }
+        std::cout << (dataOk ? "✓" : "✗") << " Recorded samples match the input exactly\n";
+        return ok && dataOk;
+    }
+
+    bool TestSlowDiskStress() {
+        std::cout << "\n--- Stress: 64 tracks, 96 kHz, 32-bit float, slow disk ---\n";
+
+        const int numTracks = 64;
+        const int blockSize = 256;
+        const double sampleRate = 96000.0;
+        const double seconds = 6.0;
+        const double blockPeriodMs = blockSize * 1000.0 / sampleRate;
+
+        SlowDisk disk;
+        int dataErrors = 0;
+        std::mutex errorMutex;
+
+        RecordingPipeline::Settings settings;
+        settings.sampleRate = sampleRate;
+        settings.maxBlockSize = blockSize;
+        settings.ringSeconds = 2.0;
+
+        std::vector<RecordingPipeline::TrackInput> inputs;
+        for (int track = 0; track < numTracks; ++track) {
+            RecordingPipeline::TrackInput input;
+            input.trackIndex = track;
+            input.firstInputChannel = track;
+            input.numChannels = 1;
+            input.filePath = "track" + std::to_string(track) + ".wav";
+            inputs.push_back(input);
+        }
+
+        // Sinks are created in track order
+        int nextTrack = 0;
+        RecordingPipeline pipeline;
+        pipeline.SetSinkFactory([&]() -> std::unique_ptr<RecordingFileSink> {
+            return std::make_unique<VerifyingSlowSink>(disk, nextTrack++, 1, 0, dataErrors, errorMutex);
+        });
+
+        if (!pipeline.Start(settings, inputs, 0)) {
+            std::cout << "✗ Failed to start recording\n";
+            return false;
+        }
+
+        // Simulated audio callback, paced in real time
+        std::vector<std::vector<float>> buffers(numTracks, std::vector<float>(blockSize));
+        std::vector<const float*> channels(numTracks);
+        for (int track = 0; track < numTracks; ++track) channels[track] = buffers[track].data();
+
+        int64_t totalBlocks = static_cast<int64_t>(seconds * sampleRate / blockSize);
+        double worstCaptureMs = 0.0;
+        int lateBlocks = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int64_t block = 0; block < totalBlocks; ++block) {
+            int64_t blockStart = block * blockSize;
+            FillInputs(buffers, 1, blockStart, blockSize);
+
+            auto captureStart = std::chrono::steady_clock::now();
+            pipeline.Capture(channels.data(), numTracks, blockStart, blockSize);
+            auto captureEnd = std::chrono::steady_clock::now();
+
+            double captureMs = std::chrono::duration<double, std::milli>(captureEnd - captureStart).count();
+            worstCaptureMs = std::max(worstCaptureMs, captureMs);
+            if (captureMs > blockPeriodMs * 0.25) lateBlocks++;
+
+            std::this_thread::sleep_until(start + std::chrono::microseconds(
+                static_cast<int64_t>((block + 1) * blockPeriodMs * 1000.0)));
+        }
+
+        auto takes = pipeline.Stop();
+
+        int64_t expectedLength = totalBlocks * blockSize;
+        bool lengthsOk = takes.size() == static_cast<size_t>(numTracks);
+        for (const auto& take : takes) {
+            lengthsOk &= take.lengthSamples == expectedLength;
+        }
+
+        std::cout << "Disk stalls simulated: " << disk.GetStallCount()
+                  << ", worst ring fill: " << static_cast<int>(pipeline.GetMaxRingFill() * 100.0) << "%\n";
+        std::cout << "Worst capture time: " << worstCaptureMs << " ms (block period "
+                  << blockPeriodMs << " ms), slow callbacks: " << lateBlocks << "\n";
+
+        bool noOverruns = pipeline.GetOverrunFrames() == 0;
+        std::cout << (noOverruns ? "✓" : "✗") << " Overrun frames: " << pipeline.GetOverrunFrames() << "\n";
+        std::cout << (lengthsOk ? "✓" : "✗") << " All " << numTracks << " takes complete ("
+                  << expectedLength << " samples each)\n";
+        std::cout << (dataErrors == 0 ? "✓" : "✗") << " Data verified on the writer side\n";
+
+        return noOverruns && lengthsOk && dataErrors == 0;
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Recording Pipeline Test\n";
+    std::cout << "====================================\n";
+
+    RecordingTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,215 @@
+/*
+ * REAPER Web - Reverb Test Application
+ * Decay time and stability of the FDN reverb, plus CPU per instance
+ */
+
+#include "src/effects/reaper_effects.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // Slider indices of BuiltinJSFX::FDN_REVERB
+    enum FDNSlider { kDecay = 0, kSize, kDamping, kDepth, kRate, kWet, kDry, kLines, kMatrix };
+
+    struct FDNConfig {
+        const char* name;
+        double lines;       // 0 = 8, 1 = 16
+        double matrix;      // 0 = Householder, 1 = Hadamard
+    };
+
+    const FDNConfig kConfigs[] = {
+        {"8 lines, Householder", 0.0, 0.0},
+        {"8 lines, Hadamard", 0.0, 1.0},
+        {"16 lines, Householder", 1.0, 0.0},
+        {"16 lines, Hadamard", 1.0, 1.0}
+    };
+}
+
+/**
+ * Reverb tests
+ */
+class ReverbTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Reverb Test ===\n";
+
+        bool ok = true;
+        ok &= TestRegistration();
+        ok &= TestDecayTime();
+        ok &= TestStability();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 256;
+
+    BuiltinEffectsManager m_effectsManager;
+
+    std::unique_ptr<JSFXEffect> CreateReverb(const FDNConfig& config, double decay, double damping) {
+        auto effect = m_effectsManager.CreateEffect("FDN Reverb");
+        effect->Initialize(kSampleRate, kBlockSize);
+        effect->SetParameter(kLines, config.lines);
+        effect->SetParameter(kMatrix, config.matrix);
+        effect->SetParameter(kDecay, decay);
+        effect->SetParameter(kDamping, damping);
+        effect->SetParameter(kWet, 0.0);
+        effect->SetParameter(kDry, -120.0);
+        return effect;
+    }
+
+    bool TestRegistration() {
+        std::cout << "\n--- Testing Registration ---\n";
+
+        auto effect = m_effectsManager.CreateEffect("FDN Reverb");
+        bool registered = effect && effect->IsNative() && m_effectsManager.GetEffectScript("FDN Reverb").empty();
+        std::cout << (registered ? "✓ " : "✗ ") << "Registered as a native-only effect\n";
+        if (!registered) return false;
+
+        const auto& sliders = effect->GetInfo().sliders;
+        bool layout = sliders.size() == 9 && sliders[kLines].enumValues.size() == 2 &&
+                      sliders[kLines].enumValues[1] == "16" && sliders[kMatrix].enumValues[0] == "Householder";
+        std::cout << (layout ? "✓ " : "✗ ") << sliders.size() << " sliders with enumerated line count and matrix\n";
+        return layout;
+    }
+
+    // Energy of the impulse response falls 60 dB over the Decay time
+    bool TestDecayTime() {
+        std::cout << "\n--- Testing Decay Time (RT60 1 s, no damping) ---\n";
+
+        bool ok = true;
+        for (const auto& config : kConfigs) {
+            auto effect = CreateReverb(config, 1.0, 0.0);
+
+            const int totalBlocks = static_cast<int>(1.5 * kSampleRate / kBlockSize);
+            const int windowBlocks = static_cast<int>(0.1 * kSampleRate / kBlockSize);
+            const int earlyStart = static_cast<int>(0.2 * kSampleRate / kBlockSize);
+            const int lateStart = static_cast<int>(1.2 * kSampleRate / kBlockSize);
+            double earlyEnergy = 0.0, lateEnergy = 0.0;
+
+            AudioBuffer buffer(2, kBlockSize);
+            for (int block = 0; block < totalBlocks; ++block) {
+                buffer.Clear();
+                if (block == 0) {
+                    buffer.GetChannelData(0)[0] = 1.0f;
+                    buffer.GetChannelData(1)[0] = 1.0f;
+                }
+                effect->ProcessBlock(buffer);
+
+                double energy = 0.0;
+                for (int ch = 0; ch < 2; ++ch) {
+                    for (int i = 0; i < kBlockSize; ++i) {
+                        energy += buffer.GetChannelData(ch)[i] * buffer.GetChannelData(ch)[i];
+                    }
+                }
+                if (block >= earlyStart && block < earlyStart + windowBlocks) earlyEnergy += energy;
+                if (block >= lateStart && block < lateStart + windowBlocks) lateEnergy += energy;
+            }
+
+            double dropDb = 10.0 * std::log10(earlyEnergy / std::max(lateEnergy, 1e-30));
+            bool pass = std::isfinite(dropDb) && dropDb > 50.0 && dropDb < 70.0;
+            std::cout << (pass ? "✓ " : "✗ ") << config.name << ": " << std::fixed << std::setprecision(1)
+                      << dropDb << " dB over 1 s\n";
+            std::cout.unsetf(std::ios::fixed);
+            ok &= pass;
+        }
+        return ok;
+    }
+
+    // Longest decay with full modulation on continuous noise stays bounded
+    bool TestStability() {
+        std::cout << "\n--- Testing Stability (RT60 20 s, 30 s of noise) ---\n";
+
+        bool ok = true;
+        for (const auto& config : kConfigs) {
+            auto effect = CreateReverb(config, 20.0, 0.0);
+            effect->SetParameter(kDepth, 3.0);
+            effect->SetParameter(kRate, 5.0);
+
+            AudioBuffer buffer(2, kBlockSize);
+            uint32_t seed = 1;
+            double peak = 0.0;
+            bool finite = true;
+            int blocks = static_cast<int>(30.0 * kSampleRate / kBlockSize);
+            for (int block = 0; block < blocks; ++block) {
+                for (int ch = 0; ch < 2; ++ch) {
+                    float* samples = buffer.GetChannelData(ch);
+                    for (int i = 0; i < kBlockSize; ++i) {
+                        seed = seed * 1664525u + 1013904223u;
+                        samples[i] = static_cast<float>((seed >> 8) / 16777216.0 - 0.5) * 0.1f;
+                    }
+                }
+                effect->ProcessBlock(buffer);
+                for (int ch = 0; ch < 2; ++ch) {
+                    for (int i = 0; i < kBlockSize; ++i) {
+                        float value = buffer.GetChannelData(ch)[i];
+                        finite &= std::isfinite(value);
+                        peak = std::max(peak, static_cast<double>(std::abs(value)));
+                    }
+                }
+            }
+
+            bool pass = finite && peak < 100.0;
+            std::cout << (pass ? "✓ " : "✗ ") << config.name << ": peak " << peak << "\n";
+            ok &= pass;
+        }
+        return ok;
+    }
+
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: 32 stereo instances, 256-sample blocks, 48 kHz ---\n";
+
+        for (const auto& config : kConfigs) {
+            const int instances = 32;
+            const double seconds = 5.0;
+
+            std::vector<std::unique_ptr<JSFXEffect>> effects;
+            std::vector<std::unique_ptr<AudioBuffer>> buffers;
+            for (int n = 0; n < instances; ++n) {
+                effects.push_back(CreateReverb(config, 2.5, 0.4));
+                effects.back()->SetParameter(kDry, 0.0);
+                buffers.push_back(std::make_unique<AudioBuffer>(2, kBlockSize));
+            }
+
+            int blocks = static_cast<int>(seconds * kSampleRate / kBlockSize);
+            auto start = std::chrono::steady_clock::now();
+            for (int block = 0; block < blocks; ++block) {
+                for (int n = 0; n < instances; ++n) {
+                    float* left = buffers[n]->GetChannelData(0);
+                    float* right = buffers[n]->GetChannelData(1);
+                    for (int i = 0; i < kBlockSize; ++i) {
+                        uint32_t hash = static_cast<uint32_t>(block * kBlockSize + i) * 2654435761u;
+                        left[i] = right[i] = static_cast<float>(hash >> 8) / 16777216.0f - 0.5f;
+                    }
+                    effects[n]->ProcessBlock(*buffers[n]);
+                }
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            double percent = 100.0 * elapsed / seconds / instances;
+            std::cout << (percent < 1.0 ? "✓ " : "✗ ") << config.name << ": " << std::fixed
+                      << std::setprecision(3) << percent << "% CPU per instance\n";
+            std::cout.unsetf(std::ios::fixed);
+            std::cout << std::setprecision(6);
+        }
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Reverb Test\n";
+    std::cout << "========================\n";
+
+    ReverbTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/*
+ * REAPER Web - Tempo Map Test Application
+ * Beat/time round trips, ramp accuracy and the per-sample block cursor
+ */
+
+#include "src/core/tempo_map.hpp"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // 120 BPM 4/4, 90 BPM 3/4 at beat 8, a 100 -> 160 BPM ramp from beat 14, 7/8 at beat 30
+    std::vector<TempoMarker> TestMarkers() {
+        return {
+            TempoMarker{0.0, 120.0, false, 4, 4},
+            TempoMarker{8.0, 90.0, false, 3, 4},
+            TempoMarker{14.0, 100.0, true, 0, 0},
+            TempoMarker{30.0, 160.0, false, 7, 8},
+        };
+    }
+
+    // Ramp from beat 14: 100 -> 160 BPM over 16 beats, linear in time
+    constexpr double kRampStartTime = 4.0 + 6.0 * 60.0 / 90.0;
+    constexpr double kRampDuration = 120.0 * 16.0 / (100.0 + 160.0);
+    constexpr double kRampSlope = (160.0 - 100.0) / kRampDuration;
+}
+
+/**
+ * Tempo map tests
+ */
+class TempoMapTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web Tempo Map Test ===\n";
+
+        bool ok = true;
+        ok &= TestMarkerPositions();
+        ok &= TestRoundTrips();
+        ok &= TestRampClosedForm();
+        ok &= TestBlockCursor();
+        return ok;
+    }
+
+private:
+    bool TestMarkerPositions() {
+        std::cout << "\n--- Testing Marker Positions ---\n";
+
+        TempoMap map(TestMarkers());
+        double rampEnd = kRampStartTime + kRampDuration;
+
+        double error = 0.0;
+        error = std::max(error, std::abs(map.BeatsToSeconds(8.0) - 4.0));
+        error = std::max(error, std::abs(map.BeatsToSeconds(14.0) - kRampStartTime));
+        error = std::max(error, std::abs(map.BeatsToSeconds(30.0) - rampEnd));
+        error = std::max(error, std::abs(map.BeatsToSeconds(34.0) - (rampEnd + 4.0 * 60.0 / 160.0)));
+        bool timesOk = error < 1e-9;
+        std::cout << (timesOk ? "✓" : "✗") << " Marker times match the hand-computed values (error "
+                  << error << " s)\n";
+
+        // Bars: 2 bars of 4/4, 2 of 3/4, 16 beats of 3/4, then 7/8
+        double barError = 0.0;
+        barError = std::max(barError, std::abs(map.BeatsToBars(8.0) - 2.0));
+        barError = std::max(barError, std::abs(map.BeatsToBars(14.0) - 4.0));
+        barError = std::max(barError, std::abs(map.BeatsToBars(30.0) - (4.0 + 16.0 / 3.0)));
+        barError = std::max(barError, std::abs(map.BeatsToBars(33.5) - (5.0 + 16.0 / 3.0)));
+
+        int numerator = 0;
+        int denominator = 0;
+        map.GetTimeSignatureAt(kRampStartTime + 1.0, numerator, denominator);
+        bool meterOk = numerator == 3 && denominator == 4;
+        map.GetTimeSignatureAt(rampEnd + 0.5, numerator, denominator);
+        meterOk &= numerator == 7 && denominator == 8;
+
+        bool barsOk = barError < 1e-12 && meterOk;
+        std::cout << (barsOk ? "✓" : "✗") << " Bar numbers and meters follow the time signature changes\n";
+        return timesOk && barsOk;
+    }
+
+    bool TestRoundTrips() {
+        std::cout << "\n--- Testing Time/Beat Round Trips ---\n";
+
+        TempoMap map(TestMarkers());
+
+        // Dense sweep across every segment, including exact marker positions
+        double timeError = 0.0;
+        for (int i = 0; i <= 20000; ++i) {
+            double seconds = i * 0.001;
+            timeError = std::max(timeError, std::abs(map.BeatsToSeconds(map.SecondsToBeats(seconds)) - seconds));
+        }
+
+        double beatError = 0.0;
+        double barError = 0.0;
+        for (int i = 0; i <= 4000; ++i) {
+            double beats = i * 0.01;
+            beatError = std::max(beatError, std::abs(map.SecondsToBeats(map.BeatsToSeconds(beats)) - beats));
+            barError = std::max(barError, std::abs(map.BarsToBeats(map.BeatsToBars(beats)) - beats));
+        }
+
+        bool ok = timeError < 1e-9 && beatError < 1e-9 && barError < 1e-9;
+        std::cout << (ok ? "✓" : "✗") << " Round trip errors: time " << timeError << " s, beats "
+                  << beatError << ", bars " << barError << "\n";
+        return ok;
+    }
+
+    bool TestRampClosedForm() {
+        std::cout << "\n--- Testing Tempo Ramp Against the Closed Form ---\n";
+
+        TempoMap map(TestMarkers());
+
+        // b(τ) = 14 + (100·τ + a·τ²/2) / 60, tempo(τ) = 100 + a·τ
+        double beatError = 0.0;
+        double tempoError = 0.0;
+        for (int i = 0; i <= 1000; ++i) {
+            double tau = kRampDuration * i / 1000.0;
+            double expectedBeats = 14.0 + (100.0 * tau + 0.5 * kRampSlope * tau * tau) / 60.0;
+            beatError = std::max(beatError, std::abs(map.SecondsToBeats(kRampStartTime + tau) - expectedBeats));
+            if (i < 1000) {
+                tempoError = std::max(tempoError, std::abs(map.GetTempoAt(kRampStartTime + tau) - (100.0 + kRampSlope * tau)));
+            }
+        }
+
+        bool ok = beatError < 1e-9 && tempoError < 1e-9;
+        std::cout << (ok ? "✓" : "✗") << " Ramp beats and tempo match the closed form (beat error "
+                  << beatError << ", tempo error " << tempoError << " BPM)\n";
+        return ok;
+    }
+
+    bool TestBlockCursor() {
+        std::cout << "\n--- Testing Block Cursor Recurrence ---\n";
+
+        TempoMap map(TestMarkers());
+        const double sampleRate = 48000.0;
+        const int blockSize = 511;              // Odd, so block starts drift against the markers
+
+        std::vector<double> markerTimes;
+        for (const auto& marker : map.GetMarkers()) {
+            markerTimes.push_back(map.BeatsToSeconds(marker.beat));
+        }
+
+        // Advance each block with the two-addition recurrence, the way JSFX
+        // transport does, and compare with a direct conversion at the block end
+        double worstError = 0.0;
+        int blocksChecked = 0;
+        int rampBlocks = 0;
+        for (int64_t start = 0; start < static_cast<int64_t>(20.0 * sampleRate); start += blockSize) {
+            double startTime = start / sampleRate;
+            double endTime = (start + blockSize) / sampleRate;
+
+            // The recurrence is exact inside one segment only
+            bool crossesMarker = std::any_of(markerTimes.begin(), markerTimes.end(),
+                                             [&](double t) { return t > startTime && t < endTime; });
+            if (crossesMarker) continue;
+
+            TempoMap::BlockCursor cursor = map.GetBlockCursor(startTime, sampleRate);
+            double beat = cursor.beat;
+            double increment = cursor.increment;
+            for (int i = 0; i < blockSize; ++i) {
+                beat += increment;
+                increment += cursor.incrementDelta;
+            }
+
+            worstError = std::max(worstError, std::abs(beat - map.SecondsToBeats(endTime)));
+            blocksChecked++;
+            if (cursor.incrementDelta != 0.0) rampBlocks++;
+        }
+
+        bool ok = worstError < 1e-9 && rampBlocks > 0;
+        std::cout << (ok ? "✓" : "✗") << " " << blocksChecked << " blocks (" << rampBlocks
+                  << " on the ramp) end within " << worstError << " beats of SecondsToBeats\n";
+
+        // The cursor itself starts on the direct conversion, with the tempo at that instant
+        TempoMap::BlockCursor mid = map.GetBlockCursor(kRampStartTime + 2.0, sampleRate);
+        bool startOk = std::abs(mid.beat - map.SecondsToBeats(kRampStartTime + 2.0)) < 1e-12 &&
+                       std::abs(mid.tempo - (100.0 + kRampSlope * 2.0)) < 1e-9 &&
+                       mid.timeSigNumerator == 3 && mid.timeSigDenominator == 4;
+        std::cout << (startOk ? "✓" : "✗") << " Cursor beat, tempo and meter at a block start\n";
+        return ok && startOk;
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - Tempo Map Test\n";
+    std::cout << "===========================\n";
+
+    TempoMapTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,284 @@
+/*
+ * REAPER Web - JSFX User Function Test Application
+ * EEL2 user functions: inlining, instance namespaces, locals and load-time checks
+ */
+
+#include "src/effects/reaper_effects.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr const char* kMixFunctions = R"(desc:Mix Functions
+@init
+function sq(x) ( x * x );
+function mix(a, b, t) ( a + (b - a) * t );
+@sample
+spl0 = mix(spl0, sq(spl1), 0.5);
+spl1 = mix(spl1, sq(spl0), 0.25);
+)";
+
+    constexpr const char* kMixInline = R"(desc:Mix Inline
+@init
+@sample
+spl0 = spl0 + (spl1 * spl1 - spl0) * 0.5;
+spl1 = spl1 + (spl0 * spl0 - spl1) * 0.25;
+)";
+
+    // Two biquads sharing one function, state in their namespaces
+    constexpr const char* kBiquadFunctions = R"(desc:Biquad Functions
+@init
+function bq_lowpass(freq q) instance(b0 b1 b2 a1 a2) local(w c alpha norm)
+(
+  w = 2 * $pi * freq / srate;
+  c = cos(w);
+  alpha = sin(w) / (2 * q);
+  norm = 1 / (1 + alpha);
+  b0 = (1 - c) * 0.5 * norm;
+  b1 = (1 - c) * norm;
+  b2 = b0;
+  a1 = -2 * c * norm;
+  a2 = (1 - alpha) * norm;
+);
+function bq(x) instance(b0 b1 b2 a1 a2 x1 x2 y1 y2) local(y)
+(
+  y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+  x2 = x1;
+  x1 = x;
+  y2 = y1;
+  y1 = y;
+  y;
+);
+left.bq_lowpass(800, 0.7);
+right.bq_lowpass(2000, 0.7);
+@sample
+spl0 = left.bq(spl0);
+spl1 = right.bq(spl1);
+)";
+
+    constexpr const char* kBiquadInline = R"(desc:Biquad Inline
+@init
+(
+  w = 2 * $pi * 800 / srate;
+  c = cos(w);
+  alpha = sin(w) / (2 * 0.7);
+  norm = 1 / (1 + alpha);
+  lb0 = (1 - c) * 0.5 * norm;
+  lb1 = (1 - c) * norm;
+  lb2 = lb0;
+  la1 = -2 * c * norm;
+  la2 = (1 - alpha) * norm;
+);
+(
+  w = 2 * $pi * 2000 / srate;
+  c = cos(w);
+  alpha = sin(w) / (2 * 0.7);
+  norm = 1 / (1 + alpha);
+  rb0 = (1 - c) * 0.5 * norm;
+  rb1 = (1 - c) * norm;
+  rb2 = rb0;
+  ra1 = -2 * c * norm;
+  ra2 = (1 - alpha) * norm;
+);
+@sample
+spl0 = (
+  y = lb0 * spl0 + lb1 * lx1 + lb2 * lx2 - la1 * ly1 - la2 * ly2;
+  lx2 = lx1;
+  lx1 = spl0;
+  ly2 = ly1;
+  ly1 = y;
+  y;
+);
+spl1 = (
+  y = rb0 * spl1 + rb1 * rx1 + rb2 * rx2 - ra1 * ry1 - ra2 * ry2;
+  rx2 = rx1;
+  rx1 = spl1;
+  ry2 = ry1;
+  ry1 = y;
+  y;
+);
+)";
+
+    // this.x, instance(), locals, and arguments with side effects
+    constexpr const char* kSemantics = R"(desc:Semantics
+@init
+function smooth_init(coef) instance(a s) ( a = coef; s = 0; );
+function smooth(x) instance(s) ( s += (x - s) * this.a );
+function f(a, b) ( a * 10 + b );
+function g(a, b) local(t) ( t = a; t * 10 + b );
+function twice(x) local(t) ( t = x * 2; t + 1 );
+function count() instance(n) ( n += 1 );
+fast.smooth_init(0.5);
+slow.smooth_init(0.01);
+nested = f(f(1, 2), f(3, 4));
+nestedLocal = g(g(1, 2), g(3, 4));
+k = 0;
+sideEffect = twice(k += 3) + k;
+count(); count();
+obj.count();
+@sample
+spl0 = fast.smooth(spl0);
+spl1 = slow.smooth(spl1);
+)";
+
+    void FillSine(AudioBuffer& buffer, int block) {
+        for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
+            float* samples = buffer.GetChannelData(ch);
+            for (int i = 0; i < buffer.GetSampleCount(); ++i) {
+                samples[i] = static_cast<float>(0.5 * std::sin(0.01 * (block * buffer.GetSampleCount() + i) + ch));
+            }
+        }
+    }
+
+    int NodeCount(const JSFXEffect& effect) {
+        return effect.GetInterpreter()->GetProgram()->GetNodeCount();
+    }
+}
+
+/**
+ * User function tests
+ */
+class UserFunctionTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web JSFX User Function Test ===\n";
+
+        bool ok = true;
+        ok &= TestInlining("Pure functions", kMixFunctions, kMixInline);
+        ok &= TestInlining("Biquads with instance state", kBiquadFunctions, kBiquadInline);
+        ok &= TestSemantics();
+        ok &= TestLoadTimeErrors();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 256;
+    static constexpr int kBlocks = 40;
+
+    // A script with functions compiles to the same number of nodes as the
+    // hand-inlined one, and sounds the same
+    bool TestInlining(const char* label, const char* functions, const char* inlined) {
+        std::cout << "\n--- Testing Inlining: " << label << " ---\n";
+
+        JSFXEffect withFunctions, byHand;
+        bool loaded = withFunctions.LoadEffect(functions) && byHand.LoadEffect(inlined);
+        withFunctions.Initialize(kSampleRate, kBlockSize);
+        byHand.Initialize(kSampleRate, kBlockSize);
+
+        AudioBuffer a(2, kBlockSize), b(2, kBlockSize);
+        float maxError = 0.0f;
+        for (int block = 0; block < kBlocks; ++block) {
+            FillSine(a, block);
+            FillSine(b, block);
+            withFunctions.ProcessBlock(a);
+            byHand.ProcessBlock(b);
+            for (int ch = 0; ch < 2; ++ch) {
+                for (int i = 0; i < kBlockSize; ++i) {
+                    maxError = std::max(maxError, std::abs(a.GetChannelData(ch)[i] - b.GetChannelData(ch)[i]));
+                }
+            }
+        }
+
+        bool pass = loaded && NodeCount(withFunctions) == NodeCount(byHand) && maxError == 0.0f;
+        std::cout << (pass ? "✓ " : "✗ ") << NodeCount(withFunctions) << " nodes with functions, "
+                  << NodeCount(byHand) << " inlined by hand, max difference " << maxError << "\n";
+        return pass;
+    }
+
+    bool TestSemantics() {
+        std::cout << "\n--- Testing Namespaces, Locals and Arguments ---\n";
+
+        JSFXInterpreter interpreter;
+        bool loaded = interpreter.LoadScript(kSemantics);
+        interpreter.ExecuteInit();
+
+        AudioBuffer buffer(2, kBlockSize);
+        std::fill(buffer.GetChannelData(0), buffer.GetChannelData(0) + kBlockSize, 1.0f);
+        std::fill(buffer.GetChannelData(1), buffer.GetChannelData(1) + kBlockSize, 1.0f);
+        interpreter.ExecuteBlock(buffer);
+
+        auto value = [&interpreter](const char* name) { return interpreter.GetContext().GetVariable(name).GetValue(); };
+
+        bool namespaces = value("fast.a") == 0.5 && value("slow.a") == 0.01 &&
+                          std::abs(value("fast.s") - 1.0) < 1e-9 && value("slow.s") < 0.95 &&
+                          buffer.GetChannelData(0)[kBlockSize - 1] > buffer.GetChannelData(1)[kBlockSize - 1];
+        bool nested = value("nested") == 154.0 && value("nestedLocal") == 154.0;
+        bool sideEffects = value("k") == 3.0 && value("sideEffect") == 10.0;
+        bool plainCalls = value("count.n") == 2.0 && value("obj.n") == 1.0;
+
+        bool pass = loaded && namespaces && nested && sideEffects && plainCalls;
+        std::cout << (pass ? "✓ " : "✗ ") << "fast.s " << value("fast.s") << ", slow.s " << value("slow.s")
+                  << "; f(f(1,2),f(3,4)) = " << value("nested") << "; twice(k += 3) + k = " << value("sideEffect")
+                  << "; count.n " << value("count.n") << ", obj.n " << value("obj.n") << "\n";
+        return pass;
+    }
+
+    // Recursion and bad calls fail the load instead of misbehaving at run time
+    bool TestLoadTimeErrors() {
+        std::cout << "\n--- Testing Load-Time Checks ---\n";
+
+        struct Case {
+            const char* script;
+            const char* error;
+        };
+        const Case cases[] = {
+            {"@init\nfunction r(x) ( x > 0 ? r(x - 1) : 0 );\ny = r(3);\n", "Recursive user function call"},
+            {"@init\nfunction a(x) ( b(x) );\nfunction b(x) ( a(x) );\ny = a(1);\n", "Recursive user function call"},
+            {"@init\nfunction two(x y) ( x + y );\ny = two(1);\n", "Wrong number of arguments to a user function"},
+        };
+
+        bool ok = true;
+        for (const Case& test : cases) {
+            JSFXInterpreter interpreter;
+            bool loaded = interpreter.LoadScript(test.script);
+            bool pass = !loaded && interpreter.GetLastError() && std::strcmp(interpreter.GetLastError(), test.error) == 0;
+            ok &= pass;
+            std::cout << (pass ? "✓ " : "✗ ") << "Rejected: " << (interpreter.GetLastError() ? interpreter.GetLastError() : "(loaded)") << "\n";
+        }
+        return ok;
+    }
+
+    // Per-call overhead: the function script against the hand-inlined one
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: two biquads, 10 s of stereo audio ---\n";
+
+        for (const char* script : {kBiquadInline, kBiquadFunctions}) {
+            JSFXEffect effect;
+            effect.LoadEffect(script);
+            effect.Initialize(kSampleRate, kBlockSize);
+            AudioBuffer buffer(2, kBlockSize);
+
+            const int blocks = static_cast<int>(10 * kSampleRate / kBlockSize);
+            auto start = std::chrono::steady_clock::now();
+            for (int block = 0; block < blocks; ++block) {
+                FillSine(buffer, block);
+                effect.ProcessBlock(buffer);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << std::left << std::setw(18) << effect.GetName() << std::right << std::fixed << std::setprecision(1)
+                      << 1e3 * seconds / 10.0 << " ms per second of audio\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - JSFX User Function Test\n";
+    std::cout << "====================================\n";
+
+    UserFunctionTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
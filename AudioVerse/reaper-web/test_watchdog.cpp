@@ -0,0 +1,189 @@
+/*
+ * REAPER Web - JSFX Watchdog Test Application
+ * Instruction budgets: runaway scripts cost one block, heavy legal scripts keep running
+ */
+
+#include "src/effects/reaper_effects.hpp"
+#include "src/core/audio_buffer.hpp"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // Nested loops: 10000 x 10000 iterations per sample without a budget
+    constexpr const char* kRunawaySample = R"(
+desc:Runaway Sample
+@sample
+while (1) while (1) x += 1;
+spl0 *= 0.5;
+spl1 *= 0.5;
+)";
+
+    constexpr const char* kRunawayInit = R"(
+desc:Runaway Init
+@init
+while (1) while (1) x += 1;
+@sample
+spl0 *= 0.5;
+)";
+
+    void FillConstant(AudioBuffer& buffer, float value) {
+        for (int ch = 0; ch < buffer.GetChannelCount(); ++ch) {
+            std::fill(buffer.GetChannelData(ch), buffer.GetChannelData(ch) + buffer.GetSampleCount(), value);
+        }
+    }
+}
+
+/**
+ * Watchdog tests
+ */
+class WatchdogTestApp {
+public:
+    bool RunTests() {
+        std::cout << "\n=== REAPER Web JSFX Watchdog Test ===\n";
+
+        bool ok = true;
+        ok &= TestRunawaySample();
+        ok &= TestRunawayInit();
+        ok &= TestLegalScripts();
+        RunBenchmark();
+        return ok;
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 512;
+
+    BuiltinEffectsManager m_effectsManager;
+
+    // The overrunning block passes dry, the effect is bypassed until reset
+    bool TestRunawaySample() {
+        std::cout << "\n--- Testing Runaway @sample ---\n";
+
+        JSFXEffect effect;
+        effect.LoadEffect(kRunawaySample);
+        effect.Initialize(kSampleRate, kBlockSize);
+        int tripsBefore = JSFXEffect::GetWatchdogTripTotal();
+
+        AudioBuffer buffer(2, kBlockSize);
+        FillConstant(buffer, 0.5f);
+        auto start = std::chrono::steady_clock::now();
+        effect.ProcessBlock(buffer);
+        double blockMs = 1e3 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool dry = buffer.GetChannelData(0)[0] == 0.5f && buffer.GetChannelData(1)[kBlockSize - 1] == 0.5f;
+        bool tripped = effect.IsWatchdogTripped() && effect.IsBypassed() &&
+                       JSFXEffect::GetWatchdogTripTotal() == tripsBefore + 1 &&
+                       effect.GetLastError() && std::strstr(effect.GetLastError(), "@sample");
+
+        // Bypassed blocks cost nothing and pass dry
+        start = std::chrono::steady_clock::now();
+        for (int block = 0; block < 100; ++block) {
+            FillConstant(buffer, 0.5f);
+            effect.ProcessBlock(buffer);
+        }
+        double bypassedMs = 1e3 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Re-enabled from the UI: runs again, and trips again
+        effect.ResetWatchdog();
+        bool reenabled = !effect.IsWatchdogTripped() && !effect.IsBypassed();
+        FillConstant(buffer, 0.5f);
+        effect.ProcessBlock(buffer);
+        bool trippedAgain = effect.IsWatchdogTripped() && JSFXEffect::GetWatchdogTripTotal() == tripsBefore + 2;
+
+        bool pass = dry && tripped && reenabled && trippedAgain && bypassedMs < 5.0;
+        std::cout << (pass ? "✓ " : "✗ ") << "Overrunning block took " << std::fixed << std::setprecision(2) << blockMs
+                  << " ms and passed dry; 100 bypassed blocks " << bypassedMs << " ms; reset re-enabled it\n";
+        std::cout.unsetf(std::ios::fixed);
+        std::cout << "  Reported: " << (effect.GetLastError() ? effect.GetLastError() : "(none)") << "\n";
+        return pass;
+    }
+
+    bool TestRunawayInit() {
+        std::cout << "\n--- Testing Runaway @init ---\n";
+
+        JSFXEffect effect;
+        effect.LoadEffect(kRunawayInit);
+        auto start = std::chrono::steady_clock::now();
+        effect.Initialize(kSampleRate, kBlockSize);
+        double initMs = 1e3 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool pass = effect.IsWatchdogTripped() && effect.IsBypassed() && std::strstr(effect.GetLastError(), "@init");
+        std::cout << (pass ? "✓ " : "✗ ") << "@init abandoned after " << std::fixed << std::setprecision(2)
+                  << initMs << " ms, effect bypassed\n";
+        std::cout.unsetf(std::ios::fixed);
+        return pass;
+    }
+
+    // The default budget leaves every built-in script well alone
+    bool TestLegalScripts() {
+        std::cout << "\n--- Testing Built-in Scripts Within Budget ---\n";
+
+        bool ok = true;
+        for (const auto& name : m_effectsManager.GetAvailableEffects()) {
+            if (m_effectsManager.GetEffectScript(name).empty()) {
+                continue;
+            }
+            auto effect = m_effectsManager.CreateEffect(name, false);
+            effect->Initialize(kSampleRate, kBlockSize);
+            AudioBuffer buffer(2, kBlockSize);
+            for (int block = 0; block < 200; ++block) {
+                FillConstant(buffer, 0.3f);
+                effect->ProcessBlock(buffer);
+                effect->SetParameter(0, effect->GetParameter(0));
+            }
+            bool pass = !effect->IsWatchdogTripped() && !effect->IsBypassed();
+            ok &= pass;
+            if (!pass) {
+                std::cout << "✗ " << name << " tripped the watchdog\n";
+            }
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << "No built-in script trips at " << JSFXInterpreter::kDefaultInstructionBudget
+                  << " nodes per sample\n";
+        return ok;
+    }
+
+    // Cost of the budget check on a legal script: limited vs unlimited
+    void RunBenchmark() {
+        std::cout << "\n--- Benchmark: Simple Compressor (JSFX), 10 s of stereo audio ---\n";
+
+        for (uint64_t budget : {static_cast<uint64_t>(0), JSFXInterpreter::kDefaultInstructionBudget}) {
+            auto effect = m_effectsManager.CreateEffect("Simple Compressor", false);
+            effect->SetInstructionBudget(budget);
+            effect->Initialize(kSampleRate, kBlockSize);
+            AudioBuffer buffer(2, kBlockSize);
+
+            const int blocks = static_cast<int>(10 * kSampleRate / kBlockSize);
+            auto start = std::chrono::steady_clock::now();
+            for (int block = 0; block < blocks; ++block) {
+                for (int ch = 0; ch < 2; ++ch) {
+                    float* samples = buffer.GetChannelData(ch);
+                    for (int i = 0; i < kBlockSize; ++i) {
+                        samples[i] = static_cast<float>(0.5 * std::sin(0.01 * (block * kBlockSize + i)));
+                    }
+                }
+                effect->ProcessBlock(buffer);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << (budget ? "Budget " : "Unlimited") << (budget ? std::to_string(budget) : "")
+                      << ": " << std::fixed << std::setprecision(1) << 1e3 * seconds / 10.0 << " ms per second of audio\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+};
+
+// Main test function
+int main() {
+    std::cout << "REAPER Web - JSFX Watchdog Test\n";
+    std::cout << "===============================\n";
+
+    WatchdogTestApp app;
+    bool ok = app.RunTests();
+
+    std::cout << "\n=== Test " << (ok ? "Complete" : "FAILED") << " ===\n";
+    return ok ? 0 : 1;
+}
@@ -11,6 +11,10 @@ source /tmp/emsdk/emsdk_env.sh
 BUILD_DIR="build"
 PUBLIC_DIR="public"
 
+# Scalar type of the test-particle store and bulk force kernels
+# (THREEBODY_REAL=float ./build.sh for a float32 build)
+THREEBODY_REAL="${THREEBODY_REAL:-double}"
+
 # Create build directory if it doesn't exist
 mkdir -p $BUILD_DIR
 mkdir -p $PUBLIC_DIR
@@ -18,13 +22,15 @@ mkdir -p $PUBLIC_DIR
 # Compile C++ to WebAssembly
 echo "Compiling C++ to WebAssembly..."
 
-emcc src/main.cpp \
+emcc src/main.cpp src/simulation.cpp \
     -o $BUILD_DIR/main.js \
     -s WASM=1 \
-    -s EXPORTED_FUNCTIONS='["_init", "_update", "_reset", "_getBodyX", "_getBodyY", "_getBodyZ", "_getBodyRadius", "_getBodyColor", "_getBodyVX", "_getBodyVY", "_getBodyVZ", "_getBodyMass", "_getBodyCount", "_getTotalEnergy", "_getMomentumX", "_getMomentumY", "_getMomentumZ", "_getCenterOfMassX", "_getCenterOfMassY", "_getCenterOfMassZ", "_setGravitationalConstant", "_getGravitationalConstant", "_setTimeStep", "_getTimeStep", "_setTimeScale", "_getTimeScale", "_setIntegrator", "_getIntegrator", "_setCollisions", "_getCollisions", "_setCollisionDamping", "_loadPreset", "_addBody", "_removeBody", "_clearBodies", "_setBodyPosition", "_setBodyVelocity", "_setBodyMass", "_setBodyColor", "_setBodyCharge", "_getBodyCharge", "_findBodyAtPosition", "_getDistance", "_getKineticEnergy", "_saveState", "_setMergingEnabled", "_getMergingEnabled", "_setTidalForces", "_getTidalForces", "_setSofteningLength", "_getSofteningLength", "_setGravitationalWaves", "_getGravitationalWaves", "_setChargeForces", "_getChargeForces", "_setElectrostaticConstant", "_getElectrostaticConstant", "_setBoundaryMode", "_getBoundaryMode", "_setBoundaryPadding", "_getBoundaryPadding", "_setBoundaryRestitution", "_getBoundaryRestitution", "_getAngularMomentum", "_getAngularMomentumX", "_getAngularMomentumY", "_getAngularMomentumZ", "_getEnergyDrift", "_getMomentumDrift", "_getAngularMomentumDrift", "_startNASAMission", "_getGameMode", "_getMissionState", "_deploySpacecraft", "_getThreatDistance", "_getMissionTime", "_getTimeLimit", "_getClosestApproach", "_getDeltaVBudget", "_getDeltaVUsed", "_getMissionScore", "_getThreatRadius", "_getSafetyMargin", "_getEarthIndex", "_getAsteroidIndex", "_getSpacecraftIndex", "_saveInitialState", "_main"]' \
-    -s EXPORTED_RUNTIME_METHODS='["ccall", "cwrap"]' \
+    -s EXPORTED_FUNCTIONS='["_init", "_update", "_reset", "_getBodyX", "_getBodyY", "_getBodyZ", "_getBodyRadius", "_getBodyColor", "_getBodyVX", "_getBodyVY", "_getBodyVZ", "_getBodyMass", "_getBodyCount", "_getTotalEnergy", "_getMomentumX", "_getMomentumY", "_getMomentumZ", "_getCenterOfMassX", "_getCenterOfMassY", "_getCenterOfMassZ", "_setGravitationalConstant", "_getGravitationalConstant", "_setTimeStep", "_getTimeStep", "_setTimeScale", "_getTimeScale", "_setIntegrator", "_getIntegrator", "_setForceSolver", "_getForceSolver", "_setFMMOrder", "_getFMMOrder", "_setFMMOpeningAngle", "_getFMMOpeningAngle", "_verifyFMMAccuracy", "_setCollisions", "_getCollisions", "_setCollisionDamping", "_loadPreset", "_addBody", "_removeBody", "_clearBodies", "_setBodyPosition", "_setBodyVelocity", "_setBodyMass", "_setBodyColor", "_setBodyCharge", "_getBodyCharge", "_addTestParticle", "_addTestParticleBelt", "_setBodyMassless", "_clearTestParticles", "_getTestParticleCount", "_getTestParticleX", "_getTestParticleY", "_getTestParticleColor", "_getTestParticleXArray", "_getTestParticleYArray", "_getSimulationPrecision", "_findBodyAtPosition", "_getDistance", "_getKineticEnergy", "_saveState", "_setMergingEnabled", "_getMergingEnabled", "_setTidalForces", "_getTidalForces", "_setSofteningLength", "_getSofteningLength", "_setRegularizationRadius", "_getRegularizationRadius", "_setRegularizationSubsteps", "_getRegularizationSubsteps", "_getLastRegularizedSubsteps", "_setTrailCapacity", "_getTrailCapacity", "_setTrailSampleInterval", "_getTrailSampleInterval", "_setTrailTolerance", "_getTrailTolerance", "_clearTrails", "_getTrailBodyCount", "_getTrailPointsBuffer", "_getTrailHeadsBuffer", "_getTrailLengthsBuffer", "_getInteractionCount", "_setGravitationalWaves", "_getGravitationalWaves", "_setChargeForces", "_getChargeForces", "_setElectrostaticConstant", "_getElectrostaticConstant", "_setBoundaryMode", "_getBoundaryMode", "_setBoundaryPadding", "_getBoundaryPadding", "_setBoundaryRestitution", "_getBoundaryRestitution", "_getAngularMomentum", "_getAngularMomentumX", "_getAngularMomentumY", "_getAngularMomentumZ", "_setMonitorInterval", "_getMonitorInterval", "_getEnergyDrift", "_getMomentumDrift", "_getAngularMomentumDrift", "_startNASAMission", "_getGameMode", "_getMissionState", "_deploySpacecraft", "_getThreatDistance", "_getMissionTime", "_getTimeLimit", "_getClosestApproach", "_getDeltaVBudget", "_getDeltaVUsed", "_getMissionScore", "_getThreatRadius", "_getSafetyMargin", "_getEarthIndex", "_getAsteroidIndex", "_getSpacecraftIndex", "_runImpactEnsemble", "_setAsteroidUncertainty", "_setEnsembleThreads", "_getImpactProbability", "_getEnsembleSize", "_getEnsembleClosestApproach", "_getEnsembleClosestApproachPercentile", "_getEnsembleThroughput", "_optimizeDeflection", "_setOptimizerTimeBudget", "_getOptimizedDeployX", "_getOptimizedDeployY", "_getOptimizedDeployVX", "_getOptimizedDeployVY", "_getOptimizedClosestApproach", "_getOptimizerEvaluations", "_deployOptimizedSpacecraft", "_seekToStep", "_getStepCount", "_getOldestCheckpointStep", "_getLatestCheckpointStep", "_getCheckpointCount", "_setCheckpointInterval", "_getCheckpointInterval", "_setCheckpointMemoryBudget", "_getCheckpointMemoryUsed", "_serializeTimeline", "_getTimelineBuffer", "_loadTimeline", "_getStateChecksum", "_saveInitialState", "_malloc", "_free", "_main"]' \
+    -s EXPORTED_RUNTIME_METHODS='["ccall", "cwrap", "HEAPF64", "HEAPF32", "HEAP32"]' \
     -s ALLOW_MEMORY_GROWTH=1 \
     -s NO_EXIT_RUNTIME=1 \
+    -msimd128 \
+    -DTHREEBODY_REAL=$THREEBODY_REAL \
     -O3 \
     --std=c++17
 
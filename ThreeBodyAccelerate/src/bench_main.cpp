@@ -0,0 +1,212 @@
+// Headless benchmark harness for the simulation library.
+//
+// Runs presets for a fixed number of steps and prints one JSON object per run
+// (JSON Lines), so results can be diffed or checked in CI before deploying:
+//
+//   threebody_bench --preset chaotic --method verlet --steps 20000
+//   threebody_bench --preset all --method all --output results.jsonl
+
+#include "simulation.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+const char* PRESET_NAMES[] = {
+    "figure-eight", "stable-orbit", "chaotic", "binary-star",
+    "pythagorean", "lagrange", "solar-system", "nasa-asteroid-defense"
+};
+const int PRESET_COUNT = PRESET_CUSTOM;
+
+const char* METHOD_NAMES[] = {"euler", "verlet", "rk4", "rkf45"};
+const int METHOD_COUNT = 4;
+
+const char* SOLVER_NAMES[] = {"direct", "fmm"};
+
+struct Options {
+    std::vector<int> presets;
+    std::vector<int> methods;
+    long long steps = 10000;
+    double timeStep = -1.0;        // < 0: keep the preset default
+    double softening = -1.0;
+    double regularization = -1.0;
+    int solver = SOLVER_DIRECT;
+    int monitorInterval = 1;
+    int testParticles = 0;
+    const char* output = nullptr;
+};
+
+void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --preset NAME|INDEX|all   preset to run (default chaotic)\n"
+            "  --method NAME|INDEX|all   euler, verlet, rk4, rkf45 (default verlet)\n"
+            "  --steps N                 steps per run (default 10000)\n"
+            "  --dt VALUE                base time step (default: preset value)\n"
+            "  --softening VALUE         Plummer softening length\n"
+            "  --regularization VALUE    close-encounter regularization radius (0 = off)\n"
+            "  --solver direct|fmm       gravity solver (default direct)\n"
+            "  --monitor-interval N      steps between conservation diagnostics (default 1)\n"
+            "  --test-particles N        add an N-particle belt (radius 60-250) around body 0\n"
+            "  --output FILE             write results to FILE instead of stdout\n",
+            program);
+}
+
+// Accepts a name from `names`, an index, or "all"
+bool parseChoice(const char* value, const char* const* names, int count, std::vector<int>& out) {
+    if (strcmp(value, "all") == 0) {
+        for (int i = 0; i < count; i++) {
+            out.push_back(i);
+        }
+        return true;
+    }
+    for (int i = 0; i < count; i++) {
+        if (strcmp(value, names[i]) == 0) {
+            out.push_back(i);
+            return true;
+        }
+    }
+    char* end = nullptr;
+    long index = strtol(value, &end, 10);
+    if (end != value && *end == '\0' && index >= 0 && index < count) {
+        out.push_back(static_cast<int>(index));
+        return true;
+    }
+    return false;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return false;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (strcmp(arg, "--preset") == 0) {
+            ok = parseChoice(value, PRESET_NAMES, PRESET_COUNT, options.presets);
+        } else if (strcmp(arg, "--method") == 0) {
+            ok = parseChoice(value, METHOD_NAMES, METHOD_COUNT, options.methods);
+        } else if (strcmp(arg, "--steps") == 0) {
+            options.steps = atoll(value);
+            ok = options.steps > 0;
+        } else if (strcmp(arg, "--dt") == 0) {
+            options.timeStep = atof(value);
+            ok = options.timeStep > 0.0;
+        } else if (strcmp(arg, "--softening") == 0) {
+            options.softening = atof(value);
+            ok = options.softening >= 0.0;
+        } else if (strcmp(arg, "--regularization") == 0) {
+            options.regularization = atof(value);
+            ok = options.regularization >= 0.0;
+        } else if (strcmp(arg, "--solver") == 0) {
+            std::vector<int> solver;
+            ok = parseChoice(value, SOLVER_NAMES, 2, solver) && solver.size() == 1;
+            options.solver = ok ? solver[0] : SOLVER_DIRECT;
+        } else if (strcmp(arg, "--monitor-interval") == 0) {
+            options.monitorInterval = atoi(value);
+            ok = options.monitorInterval > 0;
+        } else if (strcmp(arg, "--test-particles") == 0) {
+            options.testParticles = atoi(value);
+            ok = options.testParticles >= 0;
+        } else if (strcmp(arg, "--output") == 0) {
+            options.output = value;
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Invalid value for %s: %s\n", arg, value);
+            return false;
+        }
+    }
+    if (options.presets.empty()) {
+        options.presets.push_back(PRESET_CHAOTIC);
+    }
+    if (options.methods.empty()) {
+        options.methods.push_back(METHOD_VERLET);
+    }
+    return true;
+}
+
+void runBenchmark(const Options& options, int preset, int method, FILE* out) {
+    loadPreset(preset);
+    setIntegrator(method);
+    setForceSolver(options.solver);
+    setMonitorInterval(options.monitorInterval);
+    if (options.timeStep > 0.0) {
+        setTimeStep(options.timeStep);
+    }
+    if (options.softening >= 0.0) {
+        setSofteningLength(options.softening);
+    }
+    if (options.regularization >= 0.0) {
+        setRegularizationRadius(options.regularization);
+    }
+    if (options.testParticles > 0 && getBodyCount() > 0) {
+        addTestParticleBelt(options.testParticles, 0, 60.0, 250.0, 0xFFFFFFFF, 1);
+    }
+    // Baselines after the overrides, so drift measures the integration only
+    update();
+    saveInitialState();
+
+    double startInteractions = getInteractionCount();
+    auto start = std::chrono::steady_clock::now();
+    for (long long step = 0; step < options.steps; step++) {
+        update();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double interactions = getInteractionCount() - startInteractions;
+
+    fprintf(out,
+            "{\"preset\":\"%s\",\"method\":\"%s\",\"solver\":\"%s\",\"precision\":%d,\"bodies\":%d,"
+            "\"test_particles\":%d,\"steps\":%lld,\"dt\":%.17g,\"softening\":%.17g,"
+            "\"seconds\":%.6f,\"steps_per_sec\":%.6g,\"interactions\":%.17g,"
+            "\"interactions_per_sec\":%.6g,\"energy_drift\":%.6e,\"momentum_drift\":%.6e,"
+            "\"angular_momentum_drift\":%.6e,\"checksum\":%u}\n",
+            PRESET_NAMES[preset], METHOD_NAMES[method], SOLVER_NAMES[options.solver],
+            getSimulationPrecision(), getBodyCount(), getTestParticleCount(), options.steps, getTimeStep(),
+            getSofteningLength(), seconds, options.steps / seconds, interactions,
+            interactions / seconds, getEnergyDrift(), getMomentumDrift(),
+            getAngularMomentumDrift(), getStateChecksum());
+    fflush(out);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // The library prints status messages to stdout; send those to stderr so
+    // the result stream holds nothing but JSON
+    FILE* out = options.output ? fopen(options.output, "w") : fdopen(dup(STDOUT_FILENO), "w");
+    if (!out) {
+        fprintf(stderr, "Cannot open %s\n", options.output ? options.output : "stdout");
+        return 1;
+    }
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+
+    for (int preset : options.presets) {
+        for (int method : options.methods) {
+            runBenchmark(options, preset, method, out);
+        }
+    }
+
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,500 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <array>
+
+/**
+ * PHYSICS: Fast Multipole Method (FMM) for softened gravity (3D)
+ *
+ * O(N) alternative to the pairwise loop in calculateForces(). Bodies are
+ * sorted into an adaptive octree; each cell carries a Cartesian multipole
+ * expansion about its center of mass and a local (Taylor) expansion about
+ * the same point. A dual tree walk pairs cells that are well separated,
+ * (r_A + r_B) < theta * |c_A - c_B|, and converts multipoles to locals
+ * (M2L); all other leaf pairs are summed directly (P2P).
+ *
+ * Expansions are truncated at total order p (|k| + |l| <= p). The kernel
+ * derivatives use the Plummer-softened recurrence
+ *   |k| (R² + ε²) a_k - (2|k| - 1) Σ R_i a_{k-e_i} + (|k| - 1) Σ a_{k-2e_i} = 0
+ * with a_0 = 1 / sqrt(R² + ε²), so softening (ε > 0) or pure Newtonian
+ * gravity (ε = 0) are both handled exactly like the direct sum.
+ */
+class FMMSolver {
+public:
+    static constexpr int MAX_ORDER = 8;
+
+    FMMSolver() { setOrder(4); }
+
+    void setOrder(int order) {
+        order = std::max(1, std::min(order, MAX_ORDER));
+        if (order != m_order || m_terms.empty()) {
+            m_order = order;
+            buildTables();
+        }
+    }
+    int getOrder() const { return m_order; }
+
+    void setOpeningAngle(double theta) { m_theta = std::max(0.05, std::min(theta, 1.0)); }
+    double getOpeningAngle() const { return m_theta; }
+
+    void setLeafSize(int bodies) { m_leafSize = std::max(1, bodies); }
+
+    /**
+     * Computes accelerations per unit G, a_i = Σ_j m_j d_ij / (|d_ij|² + ε²)^(3/2),
+     * and potentials per unit G, phi_i = Σ_j m_j / sqrt(|d_ij|² + ε²), j != i.
+     * Multiply both by G (and phi by -m_i) for physical units.
+     */
+    void compute(const double* x, const double* y, const double* z, const double* mass, size_t count,
+                 double softening, double* ax, double* ay, double* az, double* phi) {
+        m_softSq = softening * softening;
+        std::fill(ax, ax + count, 0.0);
+        std::fill(ay, ay + count, 0.0);
+        std::fill(az, az + count, 0.0);
+        std::fill(phi, phi + count, 0.0);
+        if (count == 0) {
+            return;
+        }
+
+        buildTree(x, y, z, mass, count);
+        upwardPass();
+        interact(0, 0);
+        downwardPass();
+
+        for (size_t s = 0; s < count; s++) {
+            size_t original = m_treeOrder[s];
+            ax[original] = m_ax[s];
+            ay[original] = m_ay[s];
+            az[original] = m_az[s];
+            phi[original] = m_phi[s];
+        }
+    }
+
+private:
+    struct Cell {
+        double cx, cy, cz;        // Geometric center (tree subdivision)
+        double halfSize;
+        double mx, my, mz;        // Expansion center (center of mass)
+        double radius;            // Max distance from expansion center to any body
+        double mass;
+        size_t first, count;      // Body range in tree order
+        int firstChild, childCount;
+    };
+
+    typedef std::array<int, 3> MultiIndex;  // (kx, ky, kz)
+
+    struct Term {
+        int k, l, sum;            // Multi-index table positions
+        double coef;
+    };
+
+    // ---- Multi-index tables -------------------------------------------------
+
+    int indexOf(int kx, int ky, int kz) const {
+        return m_indexTable[(kx * (MAX_ORDER + 1) + ky) * (MAX_ORDER + 1) + kz];
+    }
+
+    static double factorial(int n) {
+        double f = 1.0;
+        for (int i = 2; i <= n; i++) {
+            f *= i;
+        }
+        return f;
+    }
+
+    void buildTables() {
+        m_terms.clear();
+        m_indexTable.assign((MAX_ORDER + 1) * (MAX_ORDER + 1) * (MAX_ORDER + 1), -1);
+        // Graded order: every index appears after all indices of lower total order
+        for (int n = 0; n <= m_order; n++) {
+            for (int kx = n; kx >= 0; kx--) {
+                for (int ky = n - kx; ky >= 0; ky--) {
+                    int kz = n - kx - ky;
+                    m_indexTable[(kx * (MAX_ORDER + 1) + ky) * (MAX_ORDER + 1) + kz] = m_terms.size();
+                    m_terms.push_back({kx, ky, kz});
+                }
+            }
+        }
+        size_t T = m_terms.size();
+
+        m_lower.assign(T * 3, -1);
+        m_lower2.assign(T * 3, -1);
+        m_powerAxis.assign(T, 0);
+        m_powerPrev.assign(T, -1);
+        m_parity.assign(T, 1.0);
+        for (size_t t = 0; t < T; t++) {
+            const auto& k = m_terms[t];
+            m_parity[t] = ((k[0] + k[1] + k[2]) % 2 == 0) ? 1.0 : -1.0;
+            for (int i = 0; i < 3; i++) {
+                int d[3] = {k[0], k[1], k[2]};
+                if (d[i] >= 1) {
+                    d[i] -= 1;
+                    m_lower[t * 3 + i] = indexOf(d[0], d[1], d[2]);
+                }
+                if (d[i] >= 1) {
+                    d[i] -= 1;
+                    m_lower2[t * 3 + i] = indexOf(d[0], d[1], d[2]);
+                }
+            }
+            for (int i = 0; i < 3; i++) {
+                if (k[i] > 0) {
+                    m_powerAxis[t] = i;
+                    m_powerPrev[t] = m_lower[t * 3 + i];
+                    break;
+                }
+            }
+        }
+
+        auto binomial = [](const MultiIndex& a, const MultiIndex& b) {
+            double c = 1.0;
+            for (int i = 0; i < 3; i++) {
+                c *= factorial(a[i]) / (factorial(b[i]) * factorial(a[i] - b[i]));
+            }
+            return c;
+        };
+
+        m_m2l.clear();
+        m_m2m.clear();
+        for (size_t ki = 0; ki < T; ki++) {
+            for (size_t li = 0; li < T; li++) {
+                const auto& k = m_terms[ki];
+                const auto& l = m_terms[li];
+                int kl[3] = {k[0] + l[0], k[1] + l[1], k[2] + l[2]};
+                if (kl[0] + kl[1] + kl[2] <= m_order) {
+                    MultiIndex sum = {kl[0], kl[1], kl[2]};
+                    int lOrder = l[0] + l[1] + l[2];
+                    double sign = (lOrder % 2 == 0) ? 1.0 : -1.0;
+                    m_m2l.push_back({(int)ki, (int)li, indexOf(kl[0], kl[1], kl[2]), sign * binomial(sum, l)});
+                }
+                // M2M / L2L pair (k >= l componentwise): shift by s^(k-l) with C(k, l)
+                if (k[0] >= l[0] && k[1] >= l[1] && k[2] >= l[2]) {
+                    m_m2m.push_back({(int)ki, (int)li, indexOf(k[0] - l[0], k[1] - l[1], k[2] - l[2]),
+                                     binomial(k, l)});
+                }
+            }
+        }
+    }
+
+    void powers(double sx, double sy, double sz, double* out) const {
+        const double s[3] = {sx, sy, sz};
+        out[0] = 1.0;
+        for (size_t t = 1; t < m_terms.size(); t++) {
+            out[t] = out[m_powerPrev[t]] * s[m_powerAxis[t]];
+        }
+    }
+
+    // Taylor coefficients a_k(R) = (-1)^|k| / k! * D^k (1 / sqrt(R² + ε²))
+    void kernelDerivatives(double rx, double ry, double rz, double* a) const {
+        const double r[3] = {rx, ry, rz};
+        double rSq = rx * rx + ry * ry + rz * rz + m_softSq;
+        double invRSq = 1.0 / rSq;
+        a[0] = sqrt(invRSq);
+        for (size_t t = 1; t < m_terms.size(); t++) {
+            const auto& k = m_terms[t];
+            int n = k[0] + k[1] + k[2];
+            double first = 0.0, second = 0.0;
+            for (int i = 0; i < 3; i++) {
+                if (m_lower[t * 3 + i] >= 0) {
+                    first += r[i] * a[m_lower[t * 3 + i]];
+                }
+                if (m_lower2[t * 3 + i] >= 0) {
+                    second += a[m_lower2[t * 3 + i]];
+                }
+            }
+            a[t] = ((2 * n - 1) * first - (n - 1) * second) * invRSq / n;
+        }
+    }
+
+    // ---- Tree construction and expansions ------------------------------------
+
+    void buildTree(const double* x, const double* y, const double* z, const double* mass, size_t count) {
+        m_treeOrder.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            m_treeOrder[i] = i;
+        }
+        m_scratch.resize(count);
+
+        double minX = x[0], maxX = x[0], minY = y[0], maxY = y[0], minZ = z[0], maxZ = z[0];
+        for (size_t i = 1; i < count; i++) {
+            minX = std::min(minX, x[i]); maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]); maxY = std::max(maxY, y[i]);
+            minZ = std::min(minZ, z[i]); maxZ = std::max(maxZ, z[i]);
+        }
+        double half = 0.5 * std::max({maxX - minX, maxY - minY, maxZ - minZ}) * 1.0001 + 1e-9;
+
+        m_cells.clear();
+        m_cells.push_back({0.5 * (minX + maxX), 0.5 * (minY + maxY), 0.5 * (minZ + maxZ), half,
+                           0, 0, 0, 0, 0, 0, count, -1, 0});
+        subdivide(0, x, y, z, 0);
+
+        // Bodies in tree order, so leaves are contiguous SoA ranges
+        m_x.resize(count); m_y.resize(count); m_z.resize(count); m_m.resize(count);
+        m_ax.assign(count, 0.0); m_ay.assign(count, 0.0); m_az.assign(count, 0.0); m_phi.assign(count, 0.0);
+        for (size_t s = 0; s < count; s++) {
+            size_t i = m_treeOrder[s];
+            m_x[s] = x[i]; m_y[s] = y[i]; m_z[s] = z[i]; m_m[s] = mass[i];
+        }
+
+        size_t T = m_terms.size();
+        m_multipoles.assign(m_cells.size() * T, 0.0);
+        m_locals.assign(m_cells.size() * T, 0.0);
+    }
+
+    void subdivide(int cellIndex, const double* x, const double* y, const double* z, int depth) {
+        Cell cell = m_cells[cellIndex];
+        if (cell.count <= (size_t)m_leafSize || depth >= 48) {
+            return;
+        }
+
+        // Counting sort of the body range into octants
+        size_t counts[8] = {0};
+        auto octant = [&](size_t i) {
+            return (x[i] > cell.cx ? 1 : 0) | (y[i] > cell.cy ? 2 : 0) | (z[i] > cell.cz ? 4 : 0);
+        };
+        for (size_t s = cell.first; s < cell.first + cell.count; s++) {
+            counts[octant(m_treeOrder[s])]++;
+        }
+        size_t offsets[8];
+        size_t running = cell.first;
+        for (int o = 0; o < 8; o++) {
+            offsets[o] = running;
+            running += counts[o];
+        }
+        size_t cursor[8];
+        std::copy(offsets, offsets + 8, cursor);
+        for (size_t s = cell.first; s < cell.first + cell.count; s++) {
+            size_t i = m_treeOrder[s];
+            m_scratch[cursor[octant(i)]++] = i;
+        }
+        std::copy(m_scratch.begin() + cell.first, m_scratch.begin() + cell.first + cell.count,
+                  m_treeOrder.begin() + cell.first);
+
+        int firstChild = m_cells.size();
+        double quarter = 0.5 * cell.halfSize;
+        for (int o = 0; o < 8; o++) {
+            if (counts[o] == 0) {
+                continue;
+            }
+            m_cells.push_back({cell.cx + ((o & 1) ? quarter : -quarter),
+                               cell.cy + ((o & 2) ? quarter : -quarter),
+                               cell.cz + ((o & 4) ? quarter : -quarter),
+                               quarter, 0, 0, 0, 0, 0, offsets[o], counts[o], -1, 0});
+        }
+        int childCount = m_cells.size() - firstChild;
+        m_cells[cellIndex].firstChild = firstChild;
+        m_cells[cellIndex].childCount = childCount;
+        for (int c = 0; c < childCount; c++) {
+            subdivide(firstChild + c, x, y, z, depth + 1);
+        }
+    }
+
+    // P2M at leaves, M2M upward (children always come after their parent)
+    void upwardPass() {
+        size_t T = m_terms.size();
+        std::vector<double> pw(T);
+        for (int c = (int)m_cells.size() - 1; c >= 0; c--) {
+            Cell& cell = m_cells[c];
+            double* M = &m_multipoles[c * T];
+
+            double mass = 0.0, sx = 0.0, sy = 0.0, sz = 0.0;
+            for (size_t s = cell.first; s < cell.first + cell.count; s++) {
+                mass += m_m[s];
+                sx += m_m[s] * m_x[s];
+                sy += m_m[s] * m_y[s];
+                sz += m_m[s] * m_z[s];
+            }
+            cell.mass = mass;
+            if (mass > 0.0) {
+                cell.mx = sx / mass; cell.my = sy / mass; cell.mz = sz / mass;
+            } else {
+                cell.mx = cell.cx; cell.my = cell.cy; cell.mz = cell.cz;
+            }
+
+            double radius = 0.0;
+            if (cell.childCount == 0) {
+                for (size_t s = cell.first; s < cell.first + cell.count; s++) {
+                    double dx = m_x[s] - cell.mx, dy = m_y[s] - cell.my, dz = m_z[s] - cell.mz;
+                    radius = std::max(radius, sqrt(dx * dx + dy * dy + dz * dz));
+                    powers(dx, dy, dz, pw.data());
+                    for (size_t t = 0; t < T; t++) {
+                        M[t] += m_m[s] * pw[t];
+                    }
+                }
+            } else {
+                for (int ch = cell.firstChild; ch < cell.firstChild + cell.childCount; ch++) {
+                    const Cell& child = m_cells[ch];
+                    double dx = child.mx - cell.mx, dy = child.my - cell.my, dz = child.mz - cell.mz;
+                    radius = std::max(radius, sqrt(dx * dx + dy * dy + dz * dz) + child.radius);
+                    powers(dx, dy, dz, pw.data());
+                    const double* childM = &m_multipoles[ch * T];
+                    for (const auto& term : m_m2m) {
+                        M[term.k] += term.coef * childM[term.l] * pw[term.sum];
+                    }
+                }
+            }
+            cell.radius = radius;
+        }
+    }
+
+    // L2L downward, L2P at leaves
+    void downwardPass() {
+        size_t T = m_terms.size();
+        std::vector<double> pw(T);
+        for (size_t c = 0; c < m_cells.size(); c++) {
+            const Cell& cell = m_cells[c];
+            const double* L = &m_locals[c * T];
+            if (cell.childCount > 0) {
+                for (int ch = cell.firstChild; ch < cell.firstChild + cell.childCount; ch++) {
+                    const Cell& child = m_cells[ch];
+                    powers(child.mx - cell.mx, child.my - cell.my, child.mz - cell.mz, pw.data());
+                    double* childL = &m_locals[ch * T];
+                    for (const auto& term : m_m2m) {
+                        childL[term.l] += term.coef * L[term.k] * pw[term.sum];
+                    }
+                }
+                continue;
+            }
+
+            for (size_t s = cell.first; s < cell.first + cell.count; s++) {
+                powers(m_x[s] - cell.mx, m_y[s] - cell.my, m_z[s] - cell.mz, pw.data());
+                double potential = 0.0, gx = 0.0, gy = 0.0, gz = 0.0;
+                for (size_t t = 0; t < T; t++) {
+                    potential += L[t] * pw[t];
+                    const auto& l = m_terms[t];
+                    if (l[0] > 0) gx += L[t] * l[0] * pw[m_lower[t * 3 + 0]];
+                    if (l[1] > 0) gy += L[t] * l[1] * pw[m_lower[t * 3 + 1]];
+                    if (l[2] > 0) gz += L[t] * l[2] * pw[m_lower[t * 3 + 2]];
+                }
+                m_phi[s] += potential;
+                m_ax[s] += gx;
+                m_ay[s] += gy;
+                m_az[s] += gz;
+            }
+        }
+    }
+
+    // ---- Interactions --------------------------------------------------------
+
+    void m2l(int source, int target) {
+        size_t T = m_terms.size();
+        const Cell& a = m_cells[source];
+        const Cell& b = m_cells[target];
+        m_derivatives.resize(T);
+        kernelDerivatives(b.mx - a.mx, b.my - a.my, b.mz - a.mz, m_derivatives.data());
+
+        // Both directions from one set of derivatives: a_k(-R) = (-1)^|k| a_k(R)
+        const double* Ma = &m_multipoles[source * T];
+        const double* Mb = &m_multipoles[target * T];
+        double* La = &m_locals[source * T];
+        double* Lb = &m_locals[target * T];
+        for (const auto& term : m_m2l) {
+            double d = term.coef * m_derivatives[term.sum];
+            Lb[term.l] += Ma[term.k] * d;
+            La[term.l] += Mb[term.k] * d * m_parity[term.sum];
+        }
+    }
+
+    void p2p(const Cell& a, const Cell& b) {
+        for (size_t i = a.first; i < a.first + a.count; i++) {
+            double xi = m_x[i], yi = m_y[i], zi = m_z[i], mi = m_m[i];
+            double axi = 0.0, ayi = 0.0, azi = 0.0, phii = 0.0;
+            for (size_t j = b.first; j < b.first + b.count; j++) {
+                double dx = m_x[j] - xi, dy = m_y[j] - yi, dz = m_z[j] - zi;
+                double invDist = 1.0 / sqrt(dx * dx + dy * dy + dz * dz + m_softSq);
+                double invDist3 = invDist * invDist * invDist;
+                axi += m_m[j] * dx * invDist3;
+                ayi += m_m[j] * dy * invDist3;
+                azi += m_m[j] * dz * invDist3;
+                phii += m_m[j] * invDist;
+                m_ax[j] -= mi * dx * invDist3;
+                m_ay[j] -= mi * dy * invDist3;
+                m_az[j] -= mi * dz * invDist3;
+                m_phi[j] += mi * invDist;
+            }
+            m_ax[i] += axi; m_ay[i] += ayi; m_az[i] += azi; m_phi[i] += phii;
+        }
+    }
+
+    void p2pSelf(const Cell& a) {
+        for (size_t i = a.first; i < a.first + a.count; i++) {
+            double xi = m_x[i], yi = m_y[i], zi = m_z[i], mi = m_m[i];
+            double axi = 0.0, ayi = 0.0, azi = 0.0, phii = 0.0;
+            for (size_t j = i + 1; j < a.first + a.count; j++) {
+                double dx = m_x[j] - xi, dy = m_y[j] - yi, dz = m_z[j] - zi;
+                double invDist = 1.0 / sqrt(dx * dx + dy * dy + dz * dz + m_softSq);
+                double invDist3 = invDist * invDist * invDist;
+                axi += m_m[j] * dx * invDist3;
+                ayi += m_m[j] * dy * invDist3;
+                azi += m_m[j] * dz * invDist3;
+                phii += m_m[j] * invDist;
+                m_ax[j] -= mi * dx * invDist3;
+                m_ay[j] -= mi * dy * invDist3;
+                m_az[j] -= mi * dz * invDist3;
+                m_phi[j] += mi * invDist;
+            }
+            m_ax[i] += axi; m_ay[i] += ayi; m_az[i] += azi; m_phi[i] += phii;
+        }
+    }
+
+    // Dual tree walk (each unordered cell pair visited once)
+    void interact(int a, int b) {
+        const Cell& A = m_cells[a];
+        const Cell& B = m_cells[b];
+        if (a == b) {
+            if (A.childCount == 0) {
+                p2pSelf(A);
+                return;
+            }
+            for (int i = A.firstChild; i < A.firstChild + A.childCount; i++) {
+                for (int j = i; j < A.firstChild + A.childCount; j++) {
+                    interact(i, j);
+                }
+            }
+            return;
+        }
+
+        double dx = B.mx - A.mx, dy = B.my - A.my, dz = B.mz - A.mz;
+        double dist = sqrt(dx * dx + dy * dy + dz * dz);
+        if (A.radius + B.radius < m_theta * dist) {
+            m2l(a, b);
+            return;
+        }
+        if (A.childCount == 0 && B.childCount == 0) {
+            p2p(A, B);
+            return;
+        }
+
+        bool splitA = B.childCount == 0 || (A.childCount > 0 && A.radius >= B.radius);
+        int split = splitA ? a : b;
+        int other = splitA ? b : a;
+        int first = m_cells[split].firstChild;
+        int children = m_cells[split].childCount;
+        for (int c = first; c < first + children; c++) {
+            interact(c, other);
+        }
+    }
+
+    int m_order = 0;
+    double m_theta = 0.5;
+    int m_leafSize = 32;
+    double m_softSq = 0.0;
+
+    std::vector<MultiIndex> m_terms;    // Graded by total order |k|
+    std::vector<int> m_indexTable;      // (kx, ky, kz) -> position in m_terms
+    std::vector<int> m_lower;           // [t * 3 + i] -> index of k - e_i, or -1
+    std::vector<int> m_lower2;          // [t * 3 + i] -> index of k - 2e_i, or -1
+    std::vector<int> m_powerAxis;       // s^k = s^(k - e_axis) * s_axis
+    std::vector<int> m_powerPrev;
+    std::vector<double> m_parity;       // (-1)^|k|
+    std::vector<Term> m_m2l;            // (k, l, k + l, (-1)^|l| C(k + l, l))
+    std::vector<Term> m_m2m;            // (k, l, k - l, C(k, l)), shared by M2M and L2L
+
+    std::vector<Cell> m_cells;
+    std::vector<size_t> m_treeOrder;  // Tree order -> original index
+    std::vector<size_t> m_scratch;
+    std::vector<double> m_x, m_y, m_z, m_m;
+    std::vector<double> m_ax, m_ay, m_az, m_phi;
+    std::vector<double> m_multipoles, m_locals, m_derivatives;
+};
@@ -0,0 +1,3855 @@
+#include "simulation.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <thread>
+#include <type_traits>
+
+#include "fmm_solver.hpp"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// NASA Game Mode: Mission states (must be declared before global variables)
+enum GameMode {
+    GAME_MODE_DISABLED,        // Academic simulation mode (default)
+    GAME_MODE_ACTIVE          // NASA asteroid defense game
+};
+
+enum MissionState {
+    MISSION_SETUP,             // Planning phase, can place spacecraft
+    MISSION_RUNNING,           // Simulation in progress
+    MISSION_SUCCESS,           // Asteroid deflected successfully
+    MISSION_FAILURE,           // Asteroid hit Earth or mission failed
+    MISSION_WARNING            // Close approach warning
+};
+
+// Structure to represent a celestial body
+struct Body {
+    double x, y, z;      // Position (3D as per PDF requirement)
+    double vx, vy, vz;    // Velocity (3D)
+    double ax, ay, az;    // Acceleration (3D)
+    double mass;
+    double radius;
+    unsigned int color; // RGBA color
+    double charge;
+    
+    // Computed properties
+    double kineticEnergy;
+    double potentialEnergy;
+};
+
+// Massless bodies: feel the massive bodies but do not act on them or on each
+// other. Stored as SoA so the O(N·M) kernel vectorizes over particles.
+template <typename Real>
+struct TestParticleStore {
+    std::vector<Real> x, y, z;
+    std::vector<Real> vx, vy, vz;
+    std::vector<Real> ax, ay, az;  // From the last force pass; not checkpointed
+    std::vector<unsigned int> color;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    void push(double px, double py, double pz, double pvx, double pvy, double pvz, unsigned int c) {
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+        vx.push_back(pvx);
+        vy.push_back(pvy);
+        vz.push_back(pvz);
+        color.push_back(c);
+    }
+
+    // Copy of the particle state without the derived accelerations
+    TestParticleStore withoutForces() const {
+        TestParticleStore copy;
+        copy.x = x;
+        copy.y = y;
+        copy.z = z;
+        copy.vx = vx;
+        copy.vy = vy;
+        copy.vz = vz;
+        copy.color = color;
+        return copy;
+    }
+
+    void clear() {
+        for (auto* v : {&x, &y, &z, &vx, &vy, &vz, &ax, &ay, &az}) {
+            v->clear();
+        }
+        color.clear();
+    }
+};
+
+typedef TestParticleStore<SimReal> TestParticles;
+
+// Simulation state
+std::vector<Body> bodies;
+std::vector<Body> initialBodies; // Store initial state for reset
+TestParticles testParticles;
+TestParticles initialTestParticles;
+bool initialTestParticlesStale = false; // Copied lazily so bulk adds stay O(n)
+bool testParticleForcesCurrent = false; // Test particle ax/ay/az match current positions
+
+// Physics parameters (scaled for a livelier but still stable simulation)
+double G = 6.0;         // Gravitational constant (scaled for simulation)
+double dt = 0.008;      // Base time step (smaller for stability)
+double timeScale = 2.0; // Run a bit faster so orbital motion is noticeable
+
+IntegrationMethod currentMethod = METHOD_VERLET;
+
+ForceSolver forceSolver = SOLVER_DIRECT;
+int fmmOrder = 4;              // Expansion order p
+double fmmOpeningAngle = 0.5;  // Multipole acceptance: (r_A + r_B) < theta * distance
+size_t fmmMinBodies = 256;     // Below this the direct sum is cheaper and exact
+
+bool enableCollisions = false;
+double collisionDamping = 0.8; // Coefficient of restitution
+bool enableMerging = true;     // Allow bodies to merge on collision
+bool enableTidalForces = false; // Tidal deformation effects
+double softeningLength = 0.5;   // Small Plummer softening keeps close passes stable by default
+double regularizationRadius = 20.0;     // Pair separation that switches to regularized stepping (0 = off)
+int regularizationSubsteps = 16;        // Regularized substeps per step away from the close pair
+const size_t REGULARIZATION_MAX_BODIES = 16; // Few-body systems only; each substep is O(n²)
+const double REGULARIZATION_STEP_FRACTION = 0.05; // Relative pair motion per step that counts as a close pass
+int lastRegularizedSubsteps = 0;        // Substeps taken by the last step (0 = not regularized)
+double interactionCount = 0.0;          // Pairwise force evaluations so far (direct-sum equivalent for FMM)
+bool conserveAngularMomentum = true; // Enforce angular momentum conservation
+bool enableGravitationalWaves = false; // Energy loss from GW radiation
+bool enableChargeForces = false;       // Electrostatic repulsion/attraction
+double electrostaticConstant = 1.0;    // Coulomb-like strength factor
+double fragmentationEnergyScale = 0.75; // Energy ratio threshold that triggers breakup
+bool enableBoundaryMode = false;        // Keep bodies inside a perimeter
+double boundaryPadding = 40.0;          // Padding from canvas edges
+double boundaryRestitution = 0.9;       // Energy preserved during boundary bounce
+
+// RKF45 adaptive parameters
+double rkfTolerance = 1e-6;     // Error tolerance for adaptive stepping
+double minDt = 0.001;           // Minimum time step
+double maxDt = 0.1;             // Maximum time step
+
+// NASA Game Mode parameters
+GameMode gameMode = GAME_MODE_DISABLED;
+MissionState missionState = MISSION_SETUP;
+int earthBodyIndex = -1;        // Index of Earth in bodies array
+int asteroidBodyIndex = -1;     // Index of threat asteroid
+int spacecraftBodyIndex = -1;   // Index of player's deflection spacecraft
+double earthRadius = 6371.0;    // Earth radius in km (scaled for display)
+double safetyMargin = 10.0;     // Required miss distance (Earth radii)
+double threatRadius = 50.0;     // Collision detection radius
+double missionTime = 0.0;       // Elapsed mission time
+double timeLimit = 1000.0;      // Mission time limit
+double closestApproach = 1e10;  // Closest distance achieved
+double impactProbability = 0.0; // Calculated collision probability
+bool trajectoryPredicted = false;
+int missionScore = 0;
+double deltaVBudget = 5.0;      // Available delta-v for spacecraft (km/s)
+double deltaVUsed = 0.0;        // Delta-v consumed
+double spacecraftMass = 0.0001; // Deployed spacecraft mass (small)
+
+// Monte Carlo impact ensemble (1-sigma uncertainty ellipsoid of the asteroid state)
+double asteroidSigmaPos[3] = {2.0, 2.0, 0.0};     // Position uncertainty per axis
+double asteroidSigmaVel[3] = {0.02, 0.02, 0.0};   // Velocity uncertainty per axis
+int ensembleThreads = 0;                           // 0 = use all hardware threads
+std::vector<double> ensembleClosestApproaches;     // Sorted closest approach per member
+double ensembleThroughput = 0.0;                   // Ensemble member-steps per second
+
+// System properties (3D vectors as per PDF Section 2.2)
+double totalEnergy = 0.0;
+double totalMomentumX = 0.0;
+double totalMomentumY = 0.0;
+double totalMomentumZ = 0.0;
+double centerOfMassX = 0.0;
+double centerOfMassY = 0.0;
+double centerOfMassZ = 0.0;
+double angularMomentumX = 0.0;  // L_x component
+double angularMomentumY = 0.0;  // L_y component
+double angularMomentumZ = 0.0;  // L_z component
+
+// Conservation monitoring
+double initialEnergy = 0.0;
+double initialMomentumX = 0.0;
+double initialMomentumY = 0.0;
+double initialMomentumZ = 0.0;
+double initialAngularMomentumX = 0.0;
+double initialAngularMomentumY = 0.0;
+double initialAngularMomentumZ = 0.0;
+double energyDrift = 0.0;
+double momentumDrift = 0.0;
+double angularMomentumDrift = 0.0;
+int monitorInterval = 1;                // Steps between conservation diagnostics
+double forcePassPotentialEnergy = 0.0;  // Potential energy from the last calculateForces()
+bool forcePassCurrent = false;          // Positions unchanged since that force pass
+
+// Timeline (checkpoint ring for scrubbing and replay)
+long long stepCount = 0;        // Steps integrated since the timeline was reset
+int checkpointInterval = 60;    // Steps between automatic checkpoints
+bool replayingTimeline = false; // Re-integrating from a checkpoint; don't record
+
+// Canvas properties (match public canvas default 900x700)
+int canvasWidth = 900;
+int canvasHeight = 700;
+
+
+
+// Preset: Figure-eight orbit (discovered by Cris Moore, 1993)
+// This is a stable periodic orbit where three equal masses chase each other
+// Classic three-body problem solution with m1 = m2 = m3
+void loadFigureEight() {
+    bodies.clear();
+    
+    // Figure-eight initial conditions (scaled for visualization)
+    // Equal masses - fundamental to classical three-body problem
+    double mass = 1.0;  // Equal mass for all three bodies
+    double compactScale = 0.75; // Pull bodies closer together for stronger forces
+    double velocityBoost = 1.35; // Keep orbit period short under the higher G default
+    double centerX = 400.0;
+    double centerY = 300.0;
+    double spreadX = 50.0 * compactScale;
+    double spreadY = 87.0 * compactScale;
+    
+    bodies.push_back({
+        centerX - spreadX, centerY, 0.0,         // x, y, z (3D, z=0 for 2D view)
+        0.3471168 * velocityBoost, 0.5327706 * velocityBoost, 0.0, // vx, vy, vz
+        0.0, 0.0, 0.0,             // ax, ay, az
+        mass, 8.0,            // mass (equal), radius
+        0x4A90E2FF,           // Earth blue
+        0.0, 0.0              // energies
+    });
+    
+    bodies.push_back({
+        centerX + spreadX, centerY, 0.0,         // x, y, z
+        0.3471168 * velocityBoost, 0.5327706 * velocityBoost, 0.0, // vx, vy, vz (same as body 1)
+        0.0, 0.0, 0.0,             // ax, ay, az
+        mass, 8.0,            // mass (equal), radius
+        0xE74C3CFF,           // Mars red
+        0.0, 0.0              // energies
+    });
+    
+    bodies.push_back({
+        centerX, centerY - spreadY, 0.0,         // x, y, z
+        -0.6942336 * velocityBoost, -1.0655412 * velocityBoost, 0.0, // vx, vy, vz (opposite of others)
+        0.0, 0.0, 0.0,             // ax, ay, az
+        mass, 8.0,            // mass (equal), radius
+        0xF39C12FF,           // Venus yellow/orange
+        0.0, 0.0              // energies
+    });
+}
+
+// Preset: Stable circular orbit system
+void loadStableOrbit() {
+    bodies.clear();
+    
+    // Central massive body (Sun-like - scaled mass)
+    bodies.push_back({
+        400.0, 300.0, 0.0,    // x, y, z (center)
+        0.0, 0.0, 0.0,        // vx, vy, vz (stationary)
+        0.0, 0.0, 0.0,        // ax, ay, az
+        333.0,           // large mass (Sun-like, scaled from 333,000)
+        20.0,            // radius
+        0xFDB813FF,      // Sun yellow
+        0.0, 0.0
+    });
+    
+    // Orbiting body 1 (Earth-like planet)
+    // v = sqrt(G*M/r) for circular orbit
+    double r1 = 150.0;
+    double v1 = sqrt(G * 333.0 / r1);
+    bodies.push_back({
+        400.0 + r1, 300.0, 0.0,
+        0.0, v1, 0.0,
+        0.0, 0.0, 0.0,
+        1.0, 7.5,        // 1 Earth mass
+        0x3498DBFF,      // Earth blue
+        0.0, 0.0
+    });
+    
+    // Orbiting body 2 (Jupiter-like planet)
+    double r2 = 220.0;
+    double v2 = sqrt(G * 333.0 / r2);
+    bodies.push_back({
+        400.0, 300.0 - r2, 0.0,
+        v2, 0.0, 0.0,
+        0.0, 0.0, 0.0,
+        317.8, 16.0,     // Jupiter mass
+        0xE67E22FF,      // Jupiter orange
+        0.0, 0.0
+    });
+}
+
+// Preset: Chaotic system
+void loadChaotic() {
+    bodies.clear();
+    
+    // Using planetary masses for chaotic interactions
+    bodies.push_back({
+        300.0, 250.0, 0.0,
+        0.5, -0.3, 0.0,
+        0.0, 0.0, 0.0,
+        17.1, 10.0,      // Neptune mass
+        0x9B59B6FF,      // Purple (Neptune-like)
+        0.0, 0.0
+    });
+    
+    bodies.push_back({
+        500.0, 350.0, 0.0,
+        -0.4, 0.6, 0.0,
+        0.0, 0.0, 0.0,
+        14.5, 9.5,       // Uranus mass
+        0x1ABC9CFF,      // Turquoise (Uranus-like)
+        0.0, 0.0
+    });
+    
+    bodies.push_back({
+        400.0, 200.0, 0.0,
+        0.2, 0.8, 0.0,
+        0.0, 0.0, 0.0,
+        95.2, 14.0,      // Saturn mass
+        0xE74C3CFF,      // Red (stylized)
+        0.0, 0.0
+    });
+}
+
+// Preset: Binary star system with planet
+void loadBinaryStar() {
+    bodies.clear();
+    
+    // Binary star system - two stars orbiting their barycenter
+    // Star 1 (Yellow star - scaled solar mass)
+    bodies.push_back({
+        350.0, 300.0, 0.0,
+        0.0, 1.2, 0.0,
+        0.0, 0.0, 0.0,
+        333.0, 18.0,     // Solar mass (scaled)
+        0xFFF3B0FF,      // Bright yellow star
+        0.0, 0.0
+    });
+    
+    // Star 2 (Orange star - slightly smaller)
+    bodies.push_back({
+        450.0, 300.0, 0.0,
+        0.0, -1.2, 0.0,
+        0.0, 0.0, 0.0,
+        250.0, 16.0,     // 0.75 solar masses (scaled)
+        0xFF8C42FF,      // Orange star
+        0.0, 0.0
+    });
+    
+    // Planet in far orbit (Super-Earth)
+    bodies.push_back({
+        400.0, 150.0, 0.0,
+        2.0, 0.0, 0.0,
+        0.0, 0.0, 0.0,
+        5.0, 6.0,        // Super-Earth (5 Earth masses)
+        0xA2D5F2FF,      // Pale blue ice planet
+        0.0, 0.0
+    });
+}
+
+// Preset: Pythagorean three-body problem
+void loadPythagorean() {
+    bodies.clear();
+    
+    // Classic Pythagorean problem: masses in ratio 3:4:5
+    // Using gas giant masses
+    bodies.push_back({
+        250.0, 300.0, 0.0,
+        0.0, 0.0, 0.0,
+        0.0, 0.0, 0.0,
+        95.2, 16.0,      // Saturn mass (represents 3)
+        0xE67E22FF,      // Jupiter orange
+        0.0, 0.0
+    });
+    
+    bodies.push_back({
+        550.0, 300.0, 0.0,
+        0.0, 0.0, 0.0,
+        0.0, 0.0, 0.0,
+        126.9, 17.0,     // ~4/3 * Saturn (represents 4)
+        0xF4D03FFF,      // Saturn yellow
+        0.0, 0.0
+    });
+    
+    bodies.push_back({
+        400.0, 100.0, 0.0,
+        0.0, 1.5, 0.0,
+        0.0, 0.0, 0.0,
+        158.7, 18.0,     // ~5/3 * Saturn (represents 5)
+        0x5DADE2FF,      // Neptune blue
+        0.0, 0.0
+    });
+}
+
+// Preset: Lagrange Equilateral Triangle Configuration
+// Classic three-body solution where bodies orbit in equilateral triangle
+// One of the simplest periodic solutions to the three-body problem
+void loadLagrange() {
+    bodies.clear();
+    
+    // Three equal masses at vertices of equilateral triangle
+    // Rotating about their common center of mass
+    double mass = 1.0;      // Equal masses (fundamental to this solution)
+    double radius = 150.0;  // Distance from center
+    
+    // Angular velocity for stable orbit
+    double omega = sqrt(3.0 * G * mass / (radius * radius * radius));
+    
+    // Body 1 at 0 degrees
+    double angle1 = 0.0;
+    bodies.push_back({
+        400.0 + radius * cos(angle1), 300.0 + radius * sin(angle1), 0.0,
+        -omega * radius * sin(angle1), omega * radius * cos(angle1), 0.0,
+        0.0, 0.0, 0.0,
+        mass, 8.0,
+        0x4A90E2FF,  // Blue
+        0.0, 0.0
+    });
+    
+    // Body 2 at 120 degrees
+    double angle2 = 2.0 * M_PI / 3.0;
+    bodies.push_back({
+        400.0 + radius * cos(angle2), 300.0 + radius * sin(angle2), 0.0,
+        -omega * radius * sin(angle2), omega * radius * cos(angle2), 0.0,
+        0.0, 0.0, 0.0,
+        mass, 8.0,
+        0xE74C3CFF,  // Red
+        0.0, 0.0
+    });
+    
+    // Body 3 at 240 degrees
+    double angle3 = 4.0 * M_PI / 3.0;
+    bodies.push_back({
+        400.0 + radius * cos(angle3), 300.0 + radius * sin(angle3), 0.0,
+        -omega * radius * sin(angle3), omega * radius * cos(angle3), 0.0,
+        0.0, 0.0, 0.0,
+        mass, 8.0,
+        0xF39C12FF,  // Yellow
+        0.0, 0.0
+    });
+}
+
+// Scatters test particles on circular orbits around bodies[centerIndex],
+// uniform in area between the two radii and moving counter-clockwise
+void addTestParticleBeltInternal(int count, int centerIndex, double innerRadius, double outerRadius,
+                                 unsigned int color, unsigned int seed) {
+    if (centerIndex < 0 || centerIndex >= static_cast<int>(bodies.size()) || count <= 0) {
+        return;
+    }
+    const Body& center = bodies[centerIndex];
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    double innerSq = innerRadius * innerRadius;
+    double outerSq = outerRadius * outerRadius;
+    for (int i = 0; i < count; i++) {
+        double r = sqrt(innerSq + (outerSq - innerSq) * unit(rng));
+        double theta = 2.0 * M_PI * unit(rng);
+        double speed = sqrt(G * center.mass / r);
+        testParticles.push(center.x + r * cos(theta), center.y + r * sin(theta), center.z,
+                           center.vx - speed * sin(theta), center.vy + speed * cos(theta), center.vz,
+                           color);
+    }
+    initialTestParticlesStale = true;
+}
+
+// Preset: Solar System simulation
+// Uses realistic planetary mass ratios (Earth = 1.0)
+// Sun ≈ 333,000 Earth masses (scaled down for simulation stability)
+void loadSolarSystem() {
+    bodies.clear();
+    testParticles.clear();
+    
+    // Sun at center (mass scaled to 1000 for simulation)
+    bodies.push_back({
+        400.0, 300.0, 0.0,    // x, y, z (center)
+        0.0, 0.0, 0.0,        // vx, vy, vz (stationary)
+        0.0, 0.0, 0.0,        // ax, ay, az
+        1000.0,          // mass (Sun - scaled from 333,000)
+        25.0,            // radius
+        0xFDB813FF,      // Sun yellow
+        0.0, 0.0
+    });
+    
+    // Mercury (mass 0.055 Earth masses)
+    // Orbital radius ~58M km = 0.39 AU, speed ~47.9 km/s
+    double mercuryR = 60.0;
+    double mercuryV = sqrt(G * 1000.0 / mercuryR);
+    bodies.push_back({
+        400.0 + mercuryR, 300.0, 0.0,
+        0.0, mercuryV, 0.0,
+        0.0, 0.0, 0.0,
+        0.055, 3.5,      // Small mass, small radius
+        0x8C7853FF,      // Mercury gray-brown
+        0.0, 0.0
+    });
+    
+    // Venus (mass 0.815 Earth masses)
+    // Orbital radius ~108M km = 0.72 AU, speed ~35 km/s
+    double venusR = 90.0;
+    double venusV = sqrt(G * 1000.0 / venusR);
+    bodies.push_back({
+        400.0, 300.0 - venusR, 0.0,
+        venusV, 0.0, 0.0,
+        0.0, 0.0, 0.0,
+        0.815, 7.0,
+        0xFFC649FF,      // Venus yellowish
+        0.0, 0.0
+    });
+    
+    // Earth (mass 1.0 Earth mass)
+    // Orbital radius ~150M km = 1 AU, speed ~30 km/s
+    double earthR = 120.0;
+    double earthV = sqrt(G * 1000.0 / earthR);
+    bodies.push_back({
+        400.0 - earthR, 300.0, 0.0,
+        0.0, -earthV, 0.0,
+        0.0, 0.0, 0.0,
+        1.0, 7.5,        // Earth mass = 1.0
+        0x4A90E2FF,      // Earth blue
+        0.0, 0.0
+    });
+    
+    // Mars (mass 0.107 Earth masses)
+    // Orbital radius ~228M km = 1.52 AU, speed ~24 km/s
+    double marsR = 160.0;
+    double marsV = sqrt(G * 1000.0 / marsR);
+    bodies.push_back({
+        400.0, 300.0 + marsR, 0.0,
+        -marsV, 0.0, 0.0,
+        0.0, 0.0, 0.0,
+        0.107, 4.5,
+        0xE74C3CFF,      // Mars red
+        0.0, 0.0
+    });
+    
+    // Jupiter (mass 317.8 Earth masses)
+    // Orbital radius ~778M km = 5.2 AU, speed ~13 km/s
+    double jupiterR = 240.0;
+    double jupiterV = sqrt(G * 1000.0 / jupiterR);
+    bodies.push_back({
+        400.0 + jupiterR, 300.0, 0.0,
+        0.0, jupiterV, 0.0,
+        0.0, 0.0, 0.0,
+        317.8, 18.0,     // Jupiter - gas giant
+        0xE67E22FF,      // Jupiter orange with bands
+        0.0, 0.0
+    });
+    
+    // Saturn (mass 95.2 Earth masses)
+    // Orbital radius ~1.4B km = 9.5 AU, speed ~9.7 km/s
+    double saturnR = 290.0;
+    double saturnV = sqrt(G * 1000.0 / saturnR);
+    bodies.push_back({
+        400.0 - saturnR * 0.7, 300.0 - saturnR * 0.7, 0.0,
+        saturnV * 0.7, -saturnV * 0.7, 0.0,
+        0.0, 0.0, 0.0,
+        95.2, 16.0,
+        0xF4D03FFF,      // Saturn pale yellow
+        0.0, 0.0
+    });
+
+    // Asteroid belt between Mars and Jupiter as massless test particles
+    addTestParticleBeltInternal(2000, 0, 180.0, 215.0, 0x9E9A91FF, 1801);
+    
+    // Uranus (mass 14.5 Earth masses)
+    // Orbital radius ~2.9B km = 19.2 AU, speed ~6.8 km/s (optional - far out)
+    /*double uranusR = 340.0;
+    double uranusV = sqrt(G * 1000.0 / uranusR);
+    bodies.push_back({
+        400.0, 300.0 - uranusR, 0.0,
+        uranusV, 0.0, 0.0,
+        0.0, 0.0, 0.0,
+        14.5, 10.0,
+        0x4FD5D6FF,      // Uranus cyan
+        0.0, 0.0
+    });*/
+    
+    // Neptune (mass 17.1 Earth masses) 
+    // Orbital radius ~4.5B km = 30 AU, speed ~5.4 km/s (optional - very far)
+    /*double neptuneR = 380.0;
+    double neptuneV = sqrt(G * 1000.0 / neptuneR);
+    bodies.push_back({
+        400.0 + neptuneR, 300.0, 0.0,
+        0.0, neptuneV, 0.0,
+        0.0, 0.0, 0.0,
+        17.1, 10.0,
+        0x5DADE2FF,      // Neptune blue
+        0.0, 0.0
+    });*/
+}
+
+/**
+ * NASA GAME MODE: Asteroid Defense Scenario
+ * Earth + incoming asteroid + player spacecraft
+ * Realistic three-body problem with mission objectives
+ */
+void loadNASAAsteroidDefense(int difficulty) {
+    bodies.clear();
+    gameMode = GAME_MODE_ACTIVE;
+    missionState = MISSION_SETUP;
+    missionTime = 0.0;
+    closestApproach = 1e10;
+    deltaVUsed = 0.0;
+    missionScore = 0;
+    impactProbability = 0.0;
+    ensembleClosestApproaches.clear();
+
+    // Earth at center (mass = 1.0 Earth mass, scaled)
+    double earthMass = 5.972;  // Scaled Earth mass
+    bodies.push_back({
+        400.0, 300.0, 0.0,     // x, y, z (center of screen)
+        0.0, 0.0, 0.0,         // vx, vy, vz (stationary for simplicity)
+        0.0, 0.0, 0.0,         // ax, ay, az
+        earthMass,             // mass
+        15.0,                  // radius (visual)
+        0x4A90E2FF,            // Earth blue
+        0.0, 0.0
+    });
+    earthBodyIndex = 0;
+    
+    // Incoming asteroid - difficulty determines speed and angle
+    double asteroidDistance = 300.0;  // Starting distance
+    double asteroidSpeed = 0.0;
+    double asteroidAngle = 0.0;
+    double asteroidMass = 0.001;  // Small compared to Earth
+    
+    switch(difficulty) {
+        case 0: // Easy - slow, direct approach
+            asteroidSpeed = 0.5;
+            asteroidAngle = 0.0;  // Straight from right
+            timeLimit = 800.0;
+            threatRadius = 30.0;
+            deltaVBudget = 3.0;
+            break;
+        case 1: // Medium - faster, angled
+            asteroidSpeed = 1.2;
+            asteroidAngle = M_PI / 6.0;  // 30 degree angle
+            timeLimit = 500.0;
+            threatRadius = 25.0;
+            deltaVBudget = 2.0;
+            break;
+        case 2: // Hard - fast, sharp angle
+            asteroidSpeed = 2.0;
+            asteroidAngle = M_PI / 4.0;  // 45 degree angle
+            timeLimit = 300.0;
+            threatRadius = 20.0;
+            deltaVBudget = 1.5;
+            break;
+        case 3: // Expert - very fast, near miss trajectory
+            asteroidSpeed = 3.0;
+            asteroidAngle = M_PI / 3.0;  // 60 degree angle
+            timeLimit = 200.0;
+            threatRadius = 18.0;
+            deltaVBudget = 1.0;
+            asteroidMass = 0.002;  // Heavier asteroid
+            break;
+    }
+    
+    // Position asteroid at distance, approaching Earth
+    double asteroidX = 400.0 + asteroidDistance;
+    double asteroidY = 300.0;
+    double asteroidVx = -asteroidSpeed * cos(asteroidAngle);
+    double asteroidVy = -asteroidSpeed * sin(asteroidAngle);
+    
+    bodies.push_back({
+        asteroidX, asteroidY, 0.0,
+        asteroidVx, asteroidVy, 0.0,
+        0.0, 0.0, 0.0,
+        asteroidMass,
+        5.0,                   // Small visual size
+        0xA0522DFF,            // Brown asteroid
+        0.0, 0.0
+    });
+    asteroidBodyIndex = 1;
+    
+    // No spacecraft yet - player will deploy it
+    spacecraftBodyIndex = -1;
+    
+    printf("NASA Asteroid Defense Mission Started - Difficulty: %d\\n", difficulty);
+    printf("Objective: Deflect asteroid using gravity or kinetic impact\\n");
+    printf("Delta-V Budget: %.2f km/s, Time Limit: %.1f units\\n", deltaVBudget, timeLimit);
+}
+
+// Default initialization
+void initBodies() {
+    loadFigureEight(); // Default to figure-eight
+}
+
+FMMSolver fmmSolver;
+std::vector<double> fmmScratch;  // SoA positions, masses and results for the solver
+
+// Fast multipole gravity for all bodies; pairwise extras need the direct path
+bool useFMMSolver() {
+    return forceSolver == SOLVER_FMM && bodies.size() >= fmmMinBodies &&
+           !enableChargeForces && !enableTidalForces && !enableGravitationalWaves;
+}
+
+void calculateForcesFMM() {
+    size_t n = bodies.size();
+    fmmScratch.resize(n * 8);
+    double* x = &fmmScratch[0];
+    double* y = &fmmScratch[n];
+    double* z = &fmmScratch[2 * n];
+    double* m = &fmmScratch[3 * n];
+    double* ax = &fmmScratch[4 * n];
+    double* ay = &fmmScratch[5 * n];
+    double* az = &fmmScratch[6 * n];
+    double* phi = &fmmScratch[7 * n];
+    for (size_t i = 0; i < n; i++) {
+        x[i] = bodies[i].x;
+        y[i] = bodies[i].y;
+        z[i] = bodies[i].z;
+        m[i] = bodies[i].mass;
+    }
+
+    fmmSolver.setOrder(fmmOrder);
+    fmmSolver.setOpeningAngle(fmmOpeningAngle);
+    fmmSolver.compute(x, y, z, m, n, softeningLength, ax, ay, az, phi);
+
+    double potentialE = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        bodies[i].ax = G * ax[i];
+        bodies[i].ay = G * ay[i];
+        bodies[i].az = G * az[i];
+        potentialE -= 0.5 * G * m[i] * phi[i];  // Each pair is counted from both ends
+    }
+    forcePassPotentialEnergy = potentialE;
+    forcePassCurrent = true;
+}
+
+/**
+ * RMS relative acceleration error of the FMM against direct summation,
+ * sampled over up to `samples` bodies (each checked against all bodies).
+ */
+double verifyFMMAccuracyInternal(int samples) {
+    size_t n = bodies.size();
+    if (n < 2) {
+        return 0.0;
+    }
+    std::vector<Body> saved = bodies;
+    calculateForcesFMM();
+
+    double softSq = softeningLength * softeningLength;
+    size_t stride = std::max<size_t>(1, n / std::max(1, samples));
+    double sumSqError = 0.0;
+    int checked = 0;
+    for (size_t i = 0; i < n; i += stride) {
+        double ax = 0.0, ay = 0.0, az = 0.0;
+        for (size_t j = 0; j < n; j++) {
+            if (j == i) continue;
+            double dx = bodies[j].x - bodies[i].x;
+            double dy = bodies[j].y - bodies[i].y;
+            double dz = bodies[j].z - bodies[i].z;
+            double softenedDistSq = dx * dx + dy * dy + dz * dz + softSq;
+            double scale = G * bodies[j].mass / (softenedDistSq * sqrt(softenedDistSq));
+            ax += scale * dx;
+            ay += scale * dy;
+            az += scale * dz;
+        }
+        double ex = bodies[i].ax - ax, ey = bodies[i].ay - ay, ez = bodies[i].az - az;
+        double reference = sqrt(ax * ax + ay * ay + az * az);
+        if (reference > 0.0) {
+            sumSqError += (ex * ex + ey * ey + ez * ez) / (reference * reference);
+            checked++;
+        }
+    }
+
+    bodies = saved;
+    forcePassCurrent = false;
+    return checked > 0 ? sqrt(sumSqError / checked) : 0.0;
+}
+
+/**
+ * PRECISION: Compensated accumulation for float32 builds
+ *
+ * With SimReal = float the bulk kernels sum accelerations with Kahan
+ * (per lane, across attractors) or pairwise (across a body's partners)
+ * summation, so the result carries close to double-precision error despite
+ * twice the SIMD width. Double builds take the plain sums.
+ */
+const bool COMPENSATED_SUMS = std::is_same<SimReal, float>::value;
+
+template <typename Real>
+inline void kahanAdd(Real& sum, Real& compensation, Real term) {
+    Real corrected = term - compensation;
+    Real next = sum + corrected;
+    compensation = (next - sum) - corrected;
+    sum = next;
+}
+
+// Pairwise summation: O(log n) error growth instead of O(n)
+template <typename Real>
+Real pairwiseSum(const Real* values, size_t count) {
+    if (count <= 16) {
+        Real sum = 0;
+        for (size_t i = 0; i < count; i++) {
+            sum += values[i];
+        }
+        return sum;
+    }
+    size_t half = count / 2;
+    return pairwiseSum(values, half) + pairwiseSum(values + half, count - half);
+}
+
+// Pure-gravity direct sum in SimReal over SoA copies of the bodies. Each body
+// sums its own row, so the terms can be added pairwise; the result goes back
+// to Body in double. Potential energy is left to the double diagnostic pass.
+std::vector<SimReal> directScratch;
+
+void calculateForcesDirectSoA() {
+    size_t n = bodies.size();
+    directScratch.resize(n * 7);
+    SimReal* x = &directScratch[0];
+    SimReal* y = &directScratch[n];
+    SimReal* z = &directScratch[2 * n];
+    SimReal* m = &directScratch[3 * n];
+    SimReal* __restrict tx = &directScratch[4 * n];
+    SimReal* __restrict ty = &directScratch[5 * n];
+    SimReal* __restrict tz = &directScratch[6 * n];
+    for (size_t i = 0; i < n; i++) {
+        x[i] = bodies[i].x;
+        y[i] = bodies[i].y;
+        z[i] = bodies[i].z;
+        m[i] = bodies[i].mass;
+    }
+
+    SimReal softSq = softeningLength * softeningLength;
+    for (size_t i = 0; i < n; i++) {
+        SimReal xi = x[i], yi = y[i], zi = z[i];
+        auto row = [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; j++) {
+                SimReal dx = x[j] - xi;
+                SimReal dy = y[j] - yi;
+                SimReal dz = z[j] - zi;
+                SimReal distSq = dx * dx + dy * dy + dz * dz + softSq;
+                SimReal s = m[j] / (distSq * std::sqrt(distSq));
+                tx[j] = s * dx;
+                ty[j] = s * dy;
+                tz[j] = s * dz;
+            }
+        };
+        row(0, i);
+        row(i + 1, n);
+        tx[i] = ty[i] = tz[i] = 0;
+        bodies[i].ax = G * pairwiseSum(tx, n);
+        bodies[i].ay = G * pairwiseSum(ty, n);
+        bodies[i].az = G * pairwiseSum(tz, n);
+    }
+    forcePassCurrent = false;
+}
+
+/**
+ * PHYSICS: Gravitational Force Calculation
+ * 
+ * Newton's Law of Universal Gravitation:
+ * F = G * (m1 * m2) / r²
+ * 
+ * Where:
+ * - G is the gravitational constant
+ * - m1, m2 are the masses of the two bodies
+ * - r is the distance between their centers
+ * 
+ * The force is a vector pointing from one mass to the other:
+ * F_vec = F * (r_vec / |r_vec|)
+ */
+/**
+ * PHYSICS: Gravitational Force Calculation (3D)
+ * 
+ * Newton's Law of Universal Gravitation (PDF equations 1-4):
+ * F = G * m1 * m2 / r²
+ * 
+ * Optional Plummer softening to prevent singularities:
+ * F = G * m1 * m2 / (r² + ε²)^(3/2)
+ * 
+ * Softening length ε prevents infinite forces at r→0 (disabled by default)
+ * Also includes optional tidal force approximation
+ */
+void calculateForces() {
+    interactionCount += 0.5 * bodies.size() * (bodies.size() - 1.0);
+    if (useFMMSolver()) {
+        calculateForcesFMM();
+        return;
+    }
+    if (COMPENSATED_SUMS && !enableChargeForces && !enableTidalForces && !enableGravitationalWaves) {
+        calculateForcesDirectSoA();
+        return;
+    }
+
+    double potentialE = 0.0;
+
+    // Reset accelerations
+    for (auto& body : bodies) {
+        body.ax = 0.0;
+        body.ay = 0.0;
+        body.az = 0.0;
+    }
+    
+    // Calculate forces between all pairs (O(n²) algorithm)
+    for (size_t i = 0; i < bodies.size(); i++) {
+        for (size_t j = i + 1; j < bodies.size(); j++) {
+            double dx = bodies[j].x - bodies[i].x;
+            double dy = bodies[j].y - bodies[i].y;
+            double dz = bodies[j].z - bodies[i].z;
+            double distSq = dx * dx + dy * dy + dz * dz;
+            double dist = sqrt(distSq);
+            
+            // Optional Plummer softening: F = G*m1*m2 / (r² + ε²)^(3/2)
+            // Only applied if softeningLength > 0
+            double softenedDistSq = distSq + softeningLength * softeningLength;
+            double softenedDist = sqrt(softenedDistSq);
+            
+            // Gravitational force magnitude, plus the pair's (equally softened) potential energy
+            double forceMag = G * bodies[i].mass * bodies[j].mass / softenedDistSq;
+            potentialE -= forceMag * softenedDist;
+            
+            // Force components (3D)
+            double fx = forceMag * dx / softenedDist;
+            double fy = forceMag * dy / softenedDist;
+            double fz = forceMag * dz / softenedDist;
+            
+            // Apply forces (Newton's 2nd & 3rd laws: F = ma, F_ij = -F_ji)
+            bodies[i].ax += fx / bodies[i].mass;
+            bodies[i].ay += fy / bodies[i].mass;
+            bodies[i].az += fz / bodies[i].mass;
+            bodies[j].ax -= fx / bodies[j].mass;
+            bodies[j].ay -= fy / bodies[j].mass;
+            bodies[j].az -= fz / bodies[j].mass;
+
+            // Electrostatic forces (optional)
+            if (enableChargeForces && (bodies[i].charge != 0.0 || bodies[j].charge != 0.0)) {
+                double chargeForceMag = electrostaticConstant * bodies[i].charge * bodies[j].charge / softenedDistSq;
+                double fxCharge = chargeForceMag * dx / softenedDist;
+                double fyCharge = chargeForceMag * dy / softenedDist;
+                double fzCharge = chargeForceMag * dz / softenedDist;
+                // Repulsion: subtract from i, add to j (direction handled via sign of q1*q2)
+                bodies[i].ax -= fxCharge / bodies[i].mass;
+                bodies[i].ay -= fyCharge / bodies[i].mass;
+                bodies[i].az -= fzCharge / bodies[i].mass;
+                bodies[j].ax += fxCharge / bodies[j].mass;
+                bodies[j].ay += fyCharge / bodies[j].mass;
+                bodies[j].az += fzCharge / bodies[j].mass;
+            }
+            
+            // Optional: Tidal forces (quadrupole approximation)
+            // Causes tidal deformation and heating
+            if (enableTidalForces && dist < bodies[i].radius * 5 && dist < bodies[j].radius * 5) {
+                // Tidal acceleration ~ G*M*R/r³ (simplified)
+                double tidalFactor = 0.01; // Damping factor
+                double tidalAccel1 = tidalFactor * G * bodies[j].mass * bodies[i].radius / (dist * dist * dist);
+                double tidalAccel2 = tidalFactor * G * bodies[i].mass * bodies[j].radius / (dist * dist * dist);
+                
+                // Apply small damping to simulate tidal dissipation
+                bodies[i].vx *= (1.0 - tidalAccel1 * dt * 0.001);
+                bodies[i].vy *= (1.0 - tidalAccel1 * dt * 0.001);
+                bodies[i].vz *= (1.0 - tidalAccel1 * dt * 0.001);
+                bodies[j].vx *= (1.0 - tidalAccel2 * dt * 0.001);
+                bodies[j].vy *= (1.0 - tidalAccel2 * dt * 0.001);
+                bodies[j].vz *= (1.0 - tidalAccel2 * dt * 0.001);
+            }
+            
+            // Optional: Gravitational wave energy loss (post-Newtonian)
+            // dE/dt = -(32/5) * G⁴/c⁵ * (m1*m2)²*(m1+m2)/r⁵
+            if (enableGravitationalWaves && dist < 100.0) {
+                double c = 300.0; // Speed of light (scaled)
+                double m1m2 = bodies[i].mass * bodies[j].mass;
+                double gwFactor = (32.0/5.0) * pow(G, 4) / pow(c, 5);
+                double energyLoss = gwFactor * m1m2 * m1m2 * (bodies[i].mass + bodies[j].mass) / pow(dist, 5);
+                
+                // Apply energy loss as velocity damping
+                double dampingFactor = 1.0 - energyLoss * dt * 0.0001;
+                bodies[i].vx *= dampingFactor;
+                bodies[i].vy *= dampingFactor;
+                bodies[i].vz *= dampingFactor;
+                bodies[j].vx *= dampingFactor;
+                bodies[j].vy *= dampingFactor;
+                bodies[j].vz *= dampingFactor;
+            }
+        }
+    }
+
+    forcePassPotentialEnergy = potentialE;
+    forcePassCurrent = true;
+}
+
+/**
+ * PHYSICS: Collision Detection and Response (3D)
+ * 
+ * Realistic collision mechanics:
+ * 1. Conservation of linear momentum: m1*v1 + m2*v2 = (m1+m2)*v_final
+ * 2. Conservation of angular momentum: L1 + L2 = L_final
+ * 3. Energy dissipation through coefficient of restitution
+ * 4. Merging for catastrophic collisions (high velocity/mass ratio)
+ * 
+ * Elastic collision formula:
+ * v1' = ((m1 - m2) * v1 + 2 * m2 * v2) / (m1 + m2)
+ * v2' = ((m2 - m1) * v2 + 2 * m1 * v1) / (m1 + m2)
+ */
+void handleCollisions() {
+    if (!enableCollisions) return;
+    
+    std::vector<bool> removed(bodies.size(), false);
+    std::vector<Body> fragmentsToAdd;
+    
+    auto blendColor = [](unsigned int c1, unsigned int c2, double ratio) -> unsigned int {
+        ratio = std::clamp(ratio, 0.0, 1.0);
+        auto channel = [&](int shift) {
+            double v1 = (c1 >> shift) & 0xFF;
+            double v2 = (c2 >> shift) & 0xFF;
+            return static_cast<unsigned int>(v1 * ratio + v2 * (1.0 - ratio));
+        };
+        unsigned int r = channel(24);
+        unsigned int g = channel(16);
+        unsigned int b = channel(8);
+        return (r << 24) | (g << 16) | (b << 8) | 0xFF;
+    };
+    
+    auto lightenColor = [](unsigned int color, double amount) -> unsigned int {
+        amount = std::clamp(amount, 0.0, 1.0);
+        auto channel = [&](int shift) {
+            double base = (color >> shift) & 0xFF;
+            double boosted = base + (255.0 - base) * amount;
+            return static_cast<unsigned int>(std::min(255.0, boosted));
+        };
+        unsigned int r = channel(24);
+        unsigned int g = channel(16);
+        unsigned int b = channel(8);
+        return (r << 24) | (g << 16) | (b << 8) | 0xFF;
+    };
+    
+    auto spawnFragments = [&](const Body& first, const Body& second, double relSpeed) {
+        double totalMass = first.mass + second.mass;
+        if (totalMass <= 0.0) {
+            return;
+        }
+        double totalCharge = first.charge + second.charge;
+        double comX = (first.x * first.mass + second.x * second.mass) / totalMass;
+        double comY = (first.y * first.mass + second.y * second.mass) / totalMass;
+        double comZ = (first.z * first.mass + second.z * second.mass) / totalMass;
+        double comVx = (first.vx * first.mass + second.vx * second.mass) / totalMass;
+        double comVy = (first.vy * first.mass + second.vy * second.mass) / totalMass;
+        double comVz = (first.vz * first.mass + second.vz * second.mass) / totalMass;
+        unsigned int baseColor = blendColor(first.color, second.color, first.mass / totalMass);
+        int fragmentCount = std::clamp(static_cast<int>(std::round(totalMass / 5.0)), 3, 6);
+        double angleStep = (2.0 * M_PI) / fragmentCount;
+        double assignedMass = 0.0;
+        for (int f = 0; f < fragmentCount; ++f) {
+            double massShare = totalMass / fragmentCount;
+            if (f == fragmentCount - 1) {
+                massShare = std::max(0.01, totalMass - assignedMass);
+            }
+            assignedMass += massShare;
+            double angle = angleStep * f;
+            double offset = (first.radius + second.radius) * 0.35;
+            double kick = relSpeed * 0.5;
+            Body fragment{};
+            fragment.mass = massShare;
+            fragment.radius = std::max(3.0, 4.0 + pow(fragment.mass / 10.0, 0.4) * 4.0);
+            fragment.x = comX + cos(angle) * offset;
+            fragment.y = comY + sin(angle) * offset;
+            fragment.z = comZ;
+            fragment.vx = comVx + cos(angle) * kick;
+            fragment.vy = comVy + sin(angle) * kick;
+            fragment.vz = comVz + ((f % 2 == 0) ? 0.2 : -0.2) * kick;
+            fragment.ax = fragment.ay = fragment.az = 0.0;
+            fragment.color = lightenColor(baseColor, 0.15 + 0.1 * f);
+            fragment.charge = (totalCharge / totalMass) * fragment.mass;
+            fragment.kineticEnergy = 0.0;
+            fragment.potentialEnergy = 0.0;
+            fragmentsToAdd.push_back(fragment);
+        }
+    };
+    
+    for (size_t i = 0; i < bodies.size(); i++) {
+        if (removed[i]) continue;
+        for (size_t j = i + 1; j < bodies.size(); j++) {
+            if (removed[j]) continue;
+            double dx = bodies[j].x - bodies[i].x;
+            double dy = bodies[j].y - bodies[i].y;
+            double dz = bodies[j].z - bodies[i].z;
+            double dist = sqrt(dx * dx + dy * dy + dz * dz);
+            double minDist = bodies[i].radius + bodies[j].radius;
+            
+            if (dist < minDist) {
+                double m1 = bodies[i].mass;
+                double m2 = bodies[j].mass;
+                double totalMass = m1 + m2;
+                double dvx = bodies[j].vx - bodies[i].vx;
+                double dvy = bodies[j].vy - bodies[i].vy;
+                double dvz = bodies[j].vz - bodies[i].vz;
+                double relSpeed = sqrt(dvx * dvx + dvy * dvy + dvz * dvz);
+                double reducedMass = (m1 * m2) / std::max(totalMass, 1e-6);
+                double kineticImpact = 0.5 * reducedMass * relSpeed * relSpeed;
+                double bindingEnergy = G * m1 * m2 / std::max(dist, 1.0);
+                double largerMass = std::max(m1, m2);
+                double escapeVel = sqrt(2.0 * G * largerMass / std::max(minDist, 1.0));
+                bool boundContact = kineticImpact < bindingEnergy && relSpeed < escapeVel;
+                bool shouldFragment = relSpeed > escapeVel * 1.2 || kineticImpact > bindingEnergy * fragmentationEnergyScale;
+                
+                if (shouldFragment) {
+                    spawnFragments(bodies[i], bodies[j], relSpeed);
+                    removed[i] = true;
+                    removed[j] = true;
+                    break; // body i destroyed, move to next i
+                }
+                
+                bool gentleMerge = enableMerging && boundContact && relSpeed < escapeVel * 0.5;
+                if (gentleMerge) {
+                    double newVx = (m1 * bodies[i].vx + m2 * bodies[j].vx) / totalMass;
+                    double newVy = (m1 * bodies[i].vy + m2 * bodies[j].vy) / totalMass;
+                    double newVz = (m1 * bodies[i].vz + m2 * bodies[j].vz) / totalMass;
+                    double newX = (m1 * bodies[i].x + m2 * bodies[j].x) / totalMass;
+                    double newY = (m1 * bodies[i].y + m2 * bodies[j].y) / totalMass;
+                    double newZ = (m1 * bodies[i].z + m2 * bodies[j].z) / totalMass;
+                    double newRadius = pow(pow(bodies[i].radius, 3) + pow(bodies[j].radius, 3), 1.0/3.0);
+                    unsigned int newColor = blendColor(bodies[i].color, bodies[j].color, m1 / totalMass);
+                    bodies[i].x = newX;
+                    bodies[i].y = newY;
+                    bodies[i].z = newZ;
+                    bodies[i].vx = newVx;
+                    bodies[i].vy = newVy;
+                    bodies[i].vz = newVz;
+                    bodies[i].mass = totalMass;
+                    bodies[i].radius = newRadius;
+                    bodies[i].color = newColor;
+                    bodies[i].charge = bodies[i].charge + bodies[j].charge;
+                    removed[j] = true;
+                    continue;
+                }
+                
+                // Otherwise bounce with restitution
+                double nx = dx / std::max(dist, 1e-6);
+                double ny = dy / std::max(dist, 1e-6);
+                double nz = dz / std::max(dist, 1e-6);
+                double vrel = dvx * nx + dvy * ny + dvz * nz;
+                if (vrel < 0) {
+                    double impulse = -(1.0 + collisionDamping) * vrel / (1.0/m1 + 1.0/m2);
+                    bodies[i].vx -= impulse * nx / m1;
+                    bodies[i].vy -= impulse * ny / m1;
+                    bodies[i].vz -= impulse * nz / m1;
+                    bodies[j].vx += impulse * nx / m2;
+                    bodies[j].vy += impulse * ny / m2;
+                    bodies[j].vz += impulse * nz / m2;
+                    double overlap = minDist - dist;
+                    double totalInvMass = 1.0/m1 + 1.0/m2;
+                    double sep1 = overlap * (1.0/m1) / totalInvMass;
+                    double sep2 = overlap * (1.0/m2) / totalInvMass;
+                    bodies[i].x -= nx * sep1;
+                    bodies[i].y -= ny * sep1;
+                    bodies[i].z -= nz * sep1;
+                    bodies[j].x += nx * sep2;
+                    bodies[j].y += ny * sep2;
+                    bodies[j].z += nz * sep2;
+                }
+            }
+        }
+    }
+    
+    for (int idx = static_cast<int>(bodies.size()) - 1; idx >= 0; --idx) {
+        if (idx >= 0 && idx < static_cast<int>(removed.size()) && removed[idx]) {
+            bodies.erase(bodies.begin() + idx);
+        }
+    }
+    bodies.insert(bodies.end(), fragmentsToAdd.begin(), fragmentsToAdd.end());
+}
+
+void enforceBoundaryBounce() {
+    if (!enableBoundaryMode) return;
+    double minX = boundaryPadding;
+    double maxX = std::max(boundaryPadding + 10.0, canvasWidth - boundaryPadding);
+    double minY = boundaryPadding;
+    double maxY = std::max(boundaryPadding + 10.0, canvasHeight - boundaryPadding);
+    for (auto& body : bodies) {
+        // X axis
+        if (body.x - body.radius < minX) {
+            body.x = minX + body.radius;
+            body.vx = fabs(body.vx) * boundaryRestitution;
+            forcePassCurrent = false;
+            testParticleForcesCurrent = false;
+        } else if (body.x + body.radius > maxX) {
+            body.x = maxX - body.radius;
+            body.vx = -fabs(body.vx) * boundaryRestitution;
+            forcePassCurrent = false;
+            testParticleForcesCurrent = false;
+        }
+        // Y axis
+        if (body.y - body.radius < minY) {
+            body.y = minY + body.radius;
+            body.vy = fabs(body.vy) * boundaryRestitution;
+            forcePassCurrent = false;
+            testParticleForcesCurrent = false;
+        } else if (body.y + body.radius > maxY) {
+            body.y = maxY - body.radius;
+            body.vy = -fabs(body.vy) * boundaryRestitution;
+            forcePassCurrent = false;
+            testParticleForcesCurrent = false;
+        }
+    }
+
+    // Test particles are points
+    SimReal* px = testParticles.x.data();
+    SimReal* py = testParticles.y.data();
+    SimReal* pvx = testParticles.vx.data();
+    SimReal* pvy = testParticles.vy.data();
+    for (size_t i = 0; i < testParticles.size(); i++) {
+        if (px[i] < minX) {
+            px[i] = minX;
+            pvx[i] = fabs(pvx[i]) * boundaryRestitution;
+            testParticleForcesCurrent = false;
+        } else if (px[i] > maxX) {
+            px[i] = maxX;
+            pvx[i] = -fabs(pvx[i]) * boundaryRestitution;
+            testParticleForcesCurrent = false;
+        }
+        if (py[i] < minY) {
+            py[i] = minY;
+            pvy[i] = fabs(pvy[i]) * boundaryRestitution;
+            testParticleForcesCurrent = false;
+        } else if (py[i] > maxY) {
+            py[i] = maxY;
+            pvy[i] = -fabs(pvy[i]) * boundaryRestitution;
+            testParticleForcesCurrent = false;
+        }
+    }
+}
+
+/**
+ * PHYSICS: Test-Particle Gravity (O(N·M))
+ *
+ * Each massless particle feels the softened pull of every massive body and
+ * nothing else; charge, tidal and GW terms only act on massive bodies.
+ * Particles are processed in cache-sized chunks: for each chunk the inner
+ * loop runs over particles once per massive body, which has no dependencies
+ * between iterations and compiles to SIMD, and the chunk is kicked by kickDt
+ * while it is still in L1.
+ */
+template <typename Real>
+void accumulateTestParticleAttraction(const Real* __restrict x, const Real* __restrict y,
+                                      const Real* __restrict z, Real* __restrict ax,
+                                      Real* __restrict ay, Real* __restrict az,
+                                      Real* __restrict cx, Real* __restrict cy,
+                                      Real* __restrict cz, size_t count,
+                                      const std::array<double, 4>& attractor, Real softSq) {
+    Real bx = attractor[0], by = attractor[1], bz = attractor[2], gm = attractor[3];
+    for (size_t i = 0; i < count; i++) {
+        Real dx = bx - x[i];
+        Real dy = by - y[i];
+        Real dz = bz - z[i];
+        Real distSq = dx * dx + dy * dy + dz * dz + softSq;
+        Real s = gm / (distSq * std::sqrt(distSq));
+        if (COMPENSATED_SUMS) {
+            kahanAdd(ax[i], cx[i], s * dx);
+            kahanAdd(ay[i], cy[i], s * dy);
+            kahanAdd(az[i], cz[i], s * dz);
+        } else {
+            ax[i] += s * dx;
+            ay[i] += s * dy;
+            az[i] += s * dz;
+        }
+    }
+}
+
+void calculateTestParticleForces(double kickDt) {
+    const size_t CHUNK = 256;
+    SimReal softSq = softeningLength * softeningLength;
+    SimReal kick = kickDt;
+    SimReal cx[CHUNK], cy[CHUNK], cz[CHUNK];  // Kahan compensation terms
+
+    std::vector<std::array<double, 4>> attractors;  // x, y, z, G·m
+    for (const auto& body : bodies) {
+        if (body.mass != 0.0) {
+            attractors.push_back({body.x, body.y, body.z, G * body.mass});
+        }
+    }
+
+    size_t n = testParticles.size();
+    interactionCount += static_cast<double>(n) * attractors.size();
+    testParticles.ax.resize(n);
+    testParticles.ay.resize(n);
+    testParticles.az.resize(n);
+    for (size_t start = 0; start < n; start += CHUNK) {
+        size_t count = std::min(CHUNK, n - start);
+        const SimReal* __restrict x = testParticles.x.data() + start;
+        const SimReal* __restrict y = testParticles.y.data() + start;
+        const SimReal* __restrict z = testParticles.z.data() + start;
+        SimReal* __restrict vx = testParticles.vx.data() + start;
+        SimReal* __restrict vy = testParticles.vy.data() + start;
+        SimReal* __restrict vz = testParticles.vz.data() + start;
+        SimReal* __restrict ax = testParticles.ax.data() + start;
+        SimReal* __restrict ay = testParticles.ay.data() + start;
+        SimReal* __restrict az = testParticles.az.data() + start;
+
+        std::fill(ax, ax + count, SimReal(0));
+        std::fill(ay, ay + count, SimReal(0));
+        std::fill(az, az + count, SimReal(0));
+        if (COMPENSATED_SUMS) {
+            std::fill(cx, cx + count, SimReal(0));
+            std::fill(cy, cy + count, SimReal(0));
+            std::fill(cz, cz + count, SimReal(0));
+        }
+        for (const auto& attractor : attractors) {
+            accumulateTestParticleAttraction(x, y, z, ax, ay, az, cx, cy, cz, count, attractor, softSq);
+        }
+        for (size_t i = 0; i < count; i++) {
+            vx[i] += ax[i] * kick;
+            vy[i] += ay[i] * kick;
+            vz[i] += az[i] * kick;
+        }
+    }
+    testParticleForcesCurrent = true;
+}
+
+// Opening kick and drift of the kick-drift-kick step. The accelerations left
+// by the previous step's closing kick are reused unless something moved since.
+void kickDriftTestParticles(double kickDt, double driftDt) {
+    size_t n = testParticles.size();
+    if (!testParticleForcesCurrent || testParticles.ax.size() != n) {
+        calculateTestParticleForces(0.0);
+    }
+    SimReal kick = kickDt;
+    SimReal drift = driftDt;
+    SimReal* __restrict x = testParticles.x.data();
+    SimReal* __restrict y = testParticles.y.data();
+    SimReal* __restrict z = testParticles.z.data();
+    SimReal* __restrict vx = testParticles.vx.data();
+    SimReal* __restrict vy = testParticles.vy.data();
+    SimReal* __restrict vz = testParticles.vz.data();
+    const SimReal* __restrict ax = testParticles.ax.data();
+    const SimReal* __restrict ay = testParticles.ay.data();
+    const SimReal* __restrict az = testParticles.az.data();
+    for (size_t i = 0; i < n; i++) {
+        vx[i] += ax[i] * kick;
+        vy[i] += ay[i] * kick;
+        vz[i] += az[i] * kick;
+        x[i] += vx[i] * drift;
+        y[i] += vy[i] * drift;
+        z[i] += vz[i] * drift;
+    }
+    testParticleForcesCurrent = false;
+}
+
+/**
+ * PHYSICS: Euler Method Integration (PDF Section 3.2, equations 9-10)
+ * 
+ * Basic first-order integration - pedagogical foundation method
+ * Gets more inaccurate as n gets large (as noted in PDF)
+ * 
+ * Algorithm:
+ * v(t + dt) = v(t) + a(t) * dt
+ * x(t + dt) = x(t) + v(t) * dt
+ */
+void updateBodiesEuler() {
+    double effectiveDt = dt * timeScale;
+    
+    calculateForces();
+    
+    for (auto& body : bodies) {
+        // Update velocity using current acceleration
+        body.vx += body.ax * effectiveDt;
+        body.vy += body.ay * effectiveDt;
+        body.vz += body.az * effectiveDt;
+        
+        // Update position using updated velocity
+        body.x += body.vx * effectiveDt;
+        body.y += body.vy * effectiveDt;
+        body.z += body.vz * effectiveDt;
+    }
+    forcePassCurrent = false;
+    
+    handleCollisions();
+}
+
+/**
+ * PHYSICS: Velocity Verlet Integration (Symplectic, 2nd order, 3D)
+ * 
+ * More stable than Euler method, conserves energy better.
+ * Algorithm:
+ * 1. v(t + dt/2) = v(t) + a(t) * dt/2
+ * 2. x(t + dt) = x(t) + v(t + dt/2) * dt
+ * 3. Calculate a(t + dt) from new positions
+ * 4. v(t + dt) = v(t + dt/2) + a(t + dt) * dt/2
+ */
+void updateBodiesVerlet() {
+    double effectiveDt = dt * timeScale;
+    
+    calculateForces();
+    
+    for (auto& body : bodies) {
+        // Update velocity (half step)
+        body.vx += body.ax * effectiveDt * 0.5;
+        body.vy += body.ay * effectiveDt * 0.5;
+        body.vz += body.az * effectiveDt * 0.5;
+        
+        // Update position
+        body.x += body.vx * effectiveDt;
+        body.y += body.vy * effectiveDt;
+        body.z += body.vz * effectiveDt;
+    }
+    
+    handleCollisions();
+    calculateForces();
+    
+    for (auto& body : bodies) {
+        // Update velocity (second half step)
+        body.vx += body.ax * effectiveDt * 0.5;
+        body.vy += body.ay * effectiveDt * 0.5;
+        body.vz += body.az * effectiveDt * 0.5;
+    }
+}
+
+/**
+ * PHYSICS: Runge-Kutta 4th Order Integration (RK4, 3D)
+ * 
+ * Higher accuracy than Verlet, 4th order method.
+ * More computationally expensive but better for chaotic systems.
+ * 
+ * k1 = f(t, y)
+ * k2 = f(t + dt/2, y + k1*dt/2)
+ * k3 = f(t + dt/2, y + k2*dt/2)
+ * k4 = f(t + dt, y + k3*dt)
+ * y(t+dt) = y(t) + (k1 + 2*k2 + 2*k3 + k4) * dt/6
+ */
+struct State {
+    double x, y, z, vx, vy, vz;
+};
+
+struct Derivative {
+    double dx, dy, dz, dvx, dvy, dvz;
+};
+
+Derivative evaluate(const State& initial, double dt, const Derivative& d, std::vector<Body>& tempBodies, size_t bodyIndex) {
+    interactionCount += tempBodies.size() - 1;
+    State state;
+    state.x = initial.x + d.dx * dt;
+    state.y = initial.y + d.dy * dt;
+    state.z = initial.z + d.dz * dt;
+    state.vx = initial.vx + d.dvx * dt;
+    state.vy = initial.vy + d.dvy * dt;
+    state.vz = initial.vz + d.dvz * dt;
+    
+    // Update temp body with new state
+    tempBodies[bodyIndex].x = state.x;
+    tempBodies[bodyIndex].y = state.y;
+    tempBodies[bodyIndex].z = state.z;
+    
+    Derivative output;
+    output.dx = state.vx;
+    output.dy = state.vy;
+    output.dz = state.vz;
+    
+    // Calculate acceleration at this state
+    double ax = 0, ay = 0, az = 0;
+    for (size_t j = 0; j < tempBodies.size(); j++) {
+        if (bodyIndex != j) {
+            double dx = tempBodies[j].x - state.x;
+            double dy = tempBodies[j].y - state.y;
+            double dz = tempBodies[j].z - state.z;
+            double distSq = dx * dx + dy * dy + dz * dz;
+            double dist = sqrt(distSq);
+            dist = fmax(dist, 1.0);
+            
+            // Optional softening
+            double softenedDistSq = distSq + softeningLength * softeningLength;
+            double softenedDist = sqrt(softenedDistSq);
+            
+            double force = G * tempBodies[j].mass / softenedDistSq;
+            ax += force * dx / softenedDist;
+            ay += force * dy / softenedDist;
+            az += force * dz / softenedDist;
+        }
+    }
+    
+    output.dvx = ax;
+    output.dvy = ay;
+    output.dvz = az;
+    return output;
+}
+
+void updateBodiesRK4() {
+    double effectiveDt = dt * timeScale;
+    std::vector<Body> tempBodies = bodies;
+    
+    for (size_t i = 0; i < bodies.size(); i++) {
+        State state = {bodies[i].x, bodies[i].y, bodies[i].z, 
+                       bodies[i].vx, bodies[i].vy, bodies[i].vz};
+        
+        Derivative k1 = evaluate(state, 0.0, {0,0,0,0,0,0}, tempBodies, i);
+        Derivative k2 = evaluate(state, effectiveDt*0.5, k1, tempBodies, i);
+        Derivative k3 = evaluate(state, effectiveDt*0.5, k2, tempBodies, i);
+        Derivative k4 = evaluate(state, effectiveDt, k3, tempBodies, i);
+        
+        // Combine derivatives
+        double dxdt = (k1.dx + 2.0*k2.dx + 2.0*k3.dx + k4.dx) / 6.0;
+        double dydt = (k1.dy + 2.0*k2.dy + 2.0*k3.dy + k4.dy) / 6.0;
+        double dzdt = (k1.dz + 2.0*k2.dz + 2.0*k3.dz + k4.dz) / 6.0;
+        double dvxdt = (k1.dvx + 2.0*k2.dvx + 2.0*k3.dvx + k4.dvx) / 6.0;
+        double dvydt = (k1.dvy + 2.0*k2.dvy + 2.0*k3.dvy + k4.dvy) / 6.0;
+        double dvzdt = (k1.dvz + 2.0*k2.dvz + 2.0*k3.dvz + k4.dvz) / 6.0;
+        
+        bodies[i].x += dxdt * effectiveDt;
+        bodies[i].y += dydt * effectiveDt;
+        bodies[i].z += dzdt * effectiveDt;
+        bodies[i].vx += dvxdt * effectiveDt;
+        bodies[i].vy += dvydt * effectiveDt;
+        bodies[i].vz += dvzdt * effectiveDt;
+    }
+    
+    handleCollisions();
+}
+
+/**
+ * PHYSICS: Runge-Kutta-Fehlberg Adaptive Time-Stepping (RKF45, PDF Section 3.3)
+ * 
+ * Adaptive method that balances accuracy and efficiency
+ * Uses 4th and 5th order estimates to control error
+ * Automatically adjusts time step based on local truncation error
+ */
+void updateBodiesRKF45() {
+    double effectiveDt = dt * timeScale;
+    std::vector<Body> tempBodies = bodies;
+    std::vector<Body> nextBodies = bodies;
+    
+    // RKF45 Butcher tableau coefficients
+    const double a2 = 1.0/4.0, a3 = 3.0/8.0, a4 = 12.0/13.0, a5 = 1.0, a6 = 1.0/2.0;
+    
+    // For each body, perform RKF45 integration
+    for (size_t i = 0; i < bodies.size(); i++) {
+        State state = {bodies[i].x, bodies[i].y, bodies[i].z,
+                       bodies[i].vx, bodies[i].vy, bodies[i].vz};
+        
+        // Calculate k1 through k6 (Fehlberg coefficients)
+        Derivative k1 = evaluate(state, 0.0, {0,0,0,0,0,0}, tempBodies, i);
+        Derivative k2 = evaluate(state, effectiveDt * a2, k1, tempBodies, i);
+        Derivative k3 = evaluate(state, effectiveDt * a3, k2, tempBodies, i);
+        Derivative k4 = evaluate(state, effectiveDt * a4, k3, tempBodies, i);
+        Derivative k5 = evaluate(state, effectiveDt * a5, k4, tempBodies, i);
+        Derivative k6 = evaluate(state, effectiveDt * a6, k5, tempBodies, i);
+        
+        // 4th order solution
+        double dx4 = (25.0/216.0*k1.dx + 1408.0/2565.0*k3.dx + 2197.0/4104.0*k4.dx - 1.0/5.0*k5.dx) * effectiveDt;
+        double dy4 = (25.0/216.0*k1.dy + 1408.0/2565.0*k3.dy + 2197.0/4104.0*k4.dy - 1.0/5.0*k5.dy) * effectiveDt;
+        double dz4 = (25.0/216.0*k1.dz + 1408.0/2565.0*k3.dz + 2197.0/4104.0*k4.dz - 1.0/5.0*k5.dz) * effectiveDt;
+        
+        // 5th order solution
+        double dx5 = (16.0/135.0*k1.dx + 6656.0/12825.0*k3.dx + 28561.0/56430.0*k4.dx - 9.0/50.0*k5.dx + 2.0/55.0*k6.dx) * effectiveDt;
+        double dy5 = (16.0/135.0*k1.dy + 6656.0/12825.0*k3.dy + 28561.0/56430.0*k4.dy - 9.0/50.0*k5.dy + 2.0/55.0*k6.dy) * effectiveDt;
+        double dz5 = (16.0/135.0*k1.dz + 6656.0/12825.0*k3.dz + 28561.0/56430.0*k4.dz - 9.0/50.0*k5.dz + 2.0/55.0*k6.dz) * effectiveDt;
+        
+        // Error estimate
+        double error = sqrt((dx5-dx4)*(dx5-dx4) + (dy5-dy4)*(dy5-dy4) + (dz5-dz4)*(dz5-dz4));
+        
+        // Use 5th order solution (more accurate)
+        nextBodies[i].x = bodies[i].x + dx5;
+        nextBodies[i].y = bodies[i].y + dy5;
+        nextBodies[i].z = bodies[i].z + dz5;
+        
+        // Update velocities similarly
+        double dvx5 = (16.0/135.0*k1.dvx + 6656.0/12825.0*k3.dvx + 28561.0/56430.0*k4.dvx - 9.0/50.0*k5.dvx + 2.0/55.0*k6.dvx) * effectiveDt;
+        double dvy5 = (16.0/135.0*k1.dvy + 6656.0/12825.0*k3.dvy + 28561.0/56430.0*k4.dvy - 9.0/50.0*k5.dvy + 2.0/55.0*k6.dvy) * effectiveDt;
+        double dvz5 = (16.0/135.0*k1.dvz + 6656.0/12825.0*k3.dvz + 28561.0/56430.0*k4.dvz - 9.0/50.0*k5.dvz + 2.0/55.0*k6.dvz) * effectiveDt;
+        
+        nextBodies[i].vx = bodies[i].vx + dvx5;
+        nextBodies[i].vy = bodies[i].vy + dvy5;
+        nextBodies[i].vz = bodies[i].vz + dvz5;
+        
+        // Adaptive step size control (for future enhancement)
+        // Could adjust dt based on error, but kept simple for now
+        if (error > rkfTolerance && effectiveDt > minDt) {
+            // Step too large, should reduce (handled by user dt control for now)
+        } else if (error < rkfTolerance * 0.1 && effectiveDt < maxDt) {
+            // Could increase step size
+        }
+    }
+    
+    bodies = nextBodies;
+    handleCollisions();
+}
+
+/**
+ * PHYSICS: Algorithmic Regularization (logarithmic Hamiltonian leapfrog)
+ *
+ * Mikkola & Tanikawa (1999) / Preto & Tremaine (1999). With H = T - U and
+ * B = -H, stepping in a fictitious time s with
+ *   drift: dt = ds / (T + B),  x += v dt
+ *   kick:  dt = ds / U,        v += a dt
+ * makes the physical step shrink in proportion to the separation of the
+ * closest pair. Two-body encounters are then integrated with only a phase
+ * (timing) error, even through near-collisions with zero softening, while
+ * the rest of the system keeps the global dt.
+ *
+ * Used for a whole few-body system while any pair closer than
+ * regularizationRadius is under-resolved by the global step. It integrates
+ * pure (softened) gravity; runs with charge, tidal or GW forces always use
+ * the selected integrator. Switching is not time-symmetric, so each pass
+ * locks in part of the selected integrator's oscillating energy error.
+ */
+double regularizedAccelerations(std::vector<Body>& system) {
+    double softSq = softeningLength * softeningLength;
+    double potential = 0.0;  // U = sum G m_i m_j / r_ij (positive)
+    interactionCount += 0.5 * system.size() * (system.size() - 1.0);
+    for (auto& body : system) {
+        body.ax = body.ay = body.az = 0.0;
+    }
+    for (size_t i = 0; i < system.size(); i++) {
+        for (size_t j = i + 1; j < system.size(); j++) {
+            double dx = system[j].x - system[i].x;
+            double dy = system[j].y - system[i].y;
+            double dz = system[j].z - system[i].z;
+            double distSq = dx * dx + dy * dy + dz * dz + softSq;
+            double invDist = 1.0 / sqrt(distSq);
+            double s = G * invDist * invDist * invDist;
+            system[i].ax += s * system[j].mass * dx;
+            system[i].ay += s * system[j].mass * dy;
+            system[i].az += s * system[j].mass * dz;
+            system[j].ax -= s * system[i].mass * dx;
+            system[j].ay -= s * system[i].mass * dy;
+            system[j].az -= s * system[i].mass * dz;
+            potential += G * system[i].mass * system[j].mass * invDist;
+        }
+    }
+    return potential;
+}
+
+double regularizedKineticEnergy(const std::vector<Body>& system) {
+    double kinetic = 0.0;
+    for (const auto& body : system) {
+        kinetic += 0.5 * body.mass * (body.vx * body.vx + body.vy * body.vy + body.vz * body.vz);
+    }
+    return kinetic;
+}
+
+// One drift-kick-drift substep of length ds; returns the physical time advanced
+double regularizedSubstep(std::vector<Body>& system, double ds, double binding) {
+    double elapsed = 0.0;
+    auto drift = [&](double fraction) {
+        double step = fraction * ds / (regularizedKineticEnergy(system) + binding);
+        for (auto& body : system) {
+            body.x += body.vx * step;
+            body.y += body.vy * step;
+            body.z += body.vz * step;
+        }
+        elapsed += step;
+    };
+    drift(0.5);
+    double step = ds / regularizedAccelerations(system);
+    for (auto& body : system) {
+        body.vx += body.ax * step;
+        body.vy += body.ay * step;
+        body.vz += body.az * step;
+    }
+    drift(0.5);
+    return elapsed;
+}
+
+bool needsRegularization() {
+    if (regularizationRadius <= 0.0 || bodies.size() < 2 || bodies.size() > REGULARIZATION_MAX_BODIES ||
+        enableChargeForces || enableTidalForces || enableGravitationalWaves) {
+        return false;
+    }
+    double radiusSq = regularizationRadius * regularizationRadius;
+    double effectiveDt = dt * timeScale;
+    for (size_t i = 0; i < bodies.size(); i++) {
+        for (size_t j = i + 1; j < bodies.size(); j++) {
+            double dx = bodies[j].x - bodies[i].x;
+            double dy = bodies[j].y - bodies[i].y;
+            double dz = bodies[j].z - bodies[i].z;
+            double distSq = dx * dx + dy * dy + dz * dz;
+            if (distSq >= radiusSq) {
+                continue;
+            }
+            // Only under-resolved passes: the pair moves a sizeable fraction of its
+            // separation in one step. Well-resolved binaries keep the selected integrator.
+            double dvx = bodies[j].vx - bodies[i].vx;
+            double dvy = bodies[j].vy - bodies[i].vy;
+            double dvz = bodies[j].vz - bodies[i].vz;
+            double stepSq = (dvx * dvx + dvy * dvy + dvz * dvz) * effectiveDt * effectiveDt;
+            if (stepSq > REGULARIZATION_STEP_FRACTION * REGULARIZATION_STEP_FRACTION * distSq) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void updateBodiesRegularized() {
+    double effectiveDt = dt * timeScale;
+    const int maxSubsteps = 1000000;
+
+    double potential = regularizedAccelerations(bodies);
+    double binding = potential - regularizedKineticEnergy(bodies);  // B = -H, fixed for the step
+    // Fictitious step sized so a substep covers effectiveDt / regularizationSubsteps at
+    // the current configuration; it shrinks in physical time as the pair closes in
+    double ds = potential * effectiveDt / std::max(1, regularizationSubsteps);
+
+    double elapsed = 0.0;
+    int substeps = 0;
+    std::vector<Body> saved;
+    while (elapsed < effectiveDt && substeps < maxSubsteps) {
+        saved = bodies;
+        double advanced = regularizedSubstep(bodies, ds, binding);
+        substeps++;
+        if (elapsed + advanced <= effectiveDt) {
+            elapsed += advanced;
+            continue;
+        }
+
+        // Overshot: secant on the substep length so the step ends exactly at effectiveDt
+        double remaining = effectiveDt - elapsed;
+        double lowDs = 0.0, lowError = -remaining;
+        double highDs = ds, highError = advanced - remaining;
+        for (int iteration = 0; iteration < 8; iteration++) {
+            if (highError == lowError) {
+                break;
+            }
+            double trialDs = lowDs - lowError * (highDs - lowDs) / (highError - lowError);
+            bodies = saved;
+            double trialError = regularizedSubstep(bodies, trialDs, binding) - remaining;
+            if (fabs(trialError) <= 1e-12 * effectiveDt) {
+                break;
+            }
+            lowDs = highDs;
+            lowError = highError;
+            highDs = trialDs;
+            highError = trialError;
+        }
+        elapsed = effectiveDt;
+    }
+    lastRegularizedSubsteps = substeps;
+
+    handleCollisions();
+}
+
+/**
+ * Potential energy with the same Plummer softening as calculateForces():
+ * PE = -G * m1 * m2 / sqrt(r² + ε²)
+ * Only needed when no force pass has run on the current positions.
+ */
+double calculatePotentialEnergy() {
+    double potentialE = 0.0;
+    double softSq = softeningLength * softeningLength;
+    for (size_t i = 0; i < bodies.size(); i++) {
+        for (size_t j = i + 1; j < bodies.size(); j++) {
+            double dx = bodies[j].x - bodies[i].x;
+            double dy = bodies[j].y - bodies[i].y;
+            double dz = bodies[j].z - bodies[i].z;
+            double softenedDist = sqrt(dx * dx + dy * dy + dz * dz + softSq);
+            potentialE -= G * bodies[i].mass * bodies[j].mass / softenedDist;
+        }
+    }
+    return potentialE;
+}
+
+/**
+ * Calculate system properties for physics analysis (3D, PDF Section 2.2)
+ * Implements conservation law monitoring as per classical mechanics
+ * Tracks all 10 conserved quantities: E, Px, Py, Pz, Lx, Ly, Lz, CMx, CMy, CMz
+ *
+ * Mass, momentum, kinetic energy and angular momentum are reduced in one
+ * O(n) sweep; the O(n²) potential energy is passed in, normally taken from
+ * the force pass that already visited every pair.
+ */
+void reduceSystemProperties(double potentialE) {
+    double totalMass = 0.0;
+    double cmX = 0.0, cmY = 0.0, cmZ = 0.0;
+    double momX = 0.0, momY = 0.0, momZ = 0.0;
+    double kineticE = 0.0;
+    double angularMomX = 0.0, angularMomY = 0.0, angularMomZ = 0.0;
+    
+    // Calculate center of mass and momentum
+    for (const auto& body : bodies) {
+        totalMass += body.mass;
+        cmX += body.x * body.mass;
+        cmY += body.y * body.mass;
+        cmZ += body.z * body.mass;
+        momX += body.vx * body.mass;
+        momY += body.vy * body.mass;
+        momZ += body.vz * body.mass;
+        
+        // Kinetic energy: KE = (1/2) * m * v²
+        double speedSq = body.vx * body.vx + body.vy * body.vy + body.vz * body.vz;
+        kineticE += 0.5 * body.mass * speedSq;
+        
+        // Angular momentum: L = r × p (3D vector)
+        // L_x = y * p_z - z * p_y
+        // L_y = z * p_x - x * p_z  
+        // L_z = x * p_y - y * p_x
+        double px = body.mass * body.vx;
+        double py = body.mass * body.vy;
+        double pz = body.mass * body.vz;
+        angularMomX += body.y * pz - body.z * py;
+        angularMomY += body.z * px - body.x * pz;
+        angularMomZ += body.x * py - body.y * px;
+    }
+    
+    centerOfMassX = cmX / totalMass;
+    centerOfMassY = cmY / totalMass;
+    centerOfMassZ = cmZ / totalMass;
+    totalMomentumX = momX;
+    totalMomentumY = momY;
+    totalMomentumZ = momZ;
+    angularMomentumX = angularMomX;
+    angularMomentumY = angularMomY;
+    angularMomentumZ = angularMomZ;
+    
+    totalEnergy = kineticE + potentialE;
+    
+    // Calculate conservation drift (deviation from initial values)
+    if (initialEnergy != 0.0) {
+        energyDrift = fabs((totalEnergy - initialEnergy) / initialEnergy);
+    }
+    
+    // Momentum drift (magnitude)
+    double momentumMag = sqrt(totalMomentumX * totalMomentumX + 
+                             totalMomentumY * totalMomentumY + 
+                             totalMomentumZ * totalMomentumZ);
+    double initialMomentumMag = sqrt(initialMomentumX * initialMomentumX + 
+                                     initialMomentumY * initialMomentumY + 
+                                     initialMomentumZ * initialMomentumZ);
+    if (initialMomentumMag > 1e-6) {
+        momentumDrift = fabs((momentumMag - initialMomentumMag) / initialMomentumMag);
+    } else {
+        momentumDrift = momentumMag;  // Absolute drift if initial is ~zero
+    }
+    
+    // Angular momentum drift (magnitude)
+    double angMomMag = sqrt(angularMomentumX * angularMomentumX + 
+                           angularMomentumY * angularMomentumY + 
+                           angularMomentumZ * angularMomentumZ);
+    double initialAngMomMag = sqrt(initialAngularMomentumX * initialAngularMomentumX + 
+                                   initialAngularMomentumY * initialAngularMomentumY + 
+                                   initialAngularMomentumZ * initialAngularMomentumZ);
+    if (initialAngMomMag > 1e-6) {
+        angularMomentumDrift = fabs((angMomMag - initialAngMomMag) / initialAngMomMag);
+    } else {
+        angularMomentumDrift = angMomMag;
+    }
+}
+
+void calculateSystemProperties() {
+    reduceSystemProperties(calculatePotentialEnergy());
+}
+
+/**
+ * NASA GAME MODE: Threat Assessment and Mission Evaluation
+ * Monitors asteroid trajectory and evaluates mission status
+ */
+void evaluateMissionStatus() {
+    if (gameMode != GAME_MODE_ACTIVE || missionState == MISSION_SUCCESS || missionState == MISSION_FAILURE) {
+        return;
+    }
+    
+    // Update mission time
+    missionTime += dt * timeScale;
+    
+    // Check if bodies still exist
+    if (earthBodyIndex < 0 || earthBodyIndex >= static_cast<int>(bodies.size()) || 
+        asteroidBodyIndex < 0 || asteroidBodyIndex >= static_cast<int>(bodies.size())) {
+        return;
+    }
+    
+    // Calculate distance between Earth and asteroid
+    double dx = bodies[asteroidBodyIndex].x - bodies[earthBodyIndex].x;
+    double dy = bodies[asteroidBodyIndex].y - bodies[earthBodyIndex].y;
+    double dz = bodies[asteroidBodyIndex].z - bodies[earthBodyIndex].z;
+    double distance = sqrt(dx * dx + dy * dy + dz * dz);
+    
+    // Track closest approach
+    if (distance < closestApproach) {
+        closestApproach = distance;
+    }
+    
+    // Check for collision
+    if (distance < threatRadius) {
+        missionState = MISSION_FAILURE;
+        printf("MISSION FAILED: Asteroid impact! Distance: %.2f km\n", distance);
+        return;
+    }
+    
+    // Check for close approach warning
+    if (distance < threatRadius * 3.0 && missionState == MISSION_RUNNING) {
+        missionState = MISSION_WARNING;
+    }
+    
+    // Check time limit
+    if (missionTime > timeLimit) {
+        if (closestApproach > threatRadius * safetyMargin) {
+            missionState = MISSION_SUCCESS;
+            // impactProbability is only non-zero if an ensemble was run after deployment
+            missionScore = (int)(1000.0 * (closestApproach / (threatRadius * safetyMargin)) *
+                                 (1.0 - deltaVUsed / deltaVBudget) *
+                                 (1.0 - missionTime / timeLimit) *
+                                 (1.0 - impactProbability));
+            printf("MISSION SUCCESS! Closest approach: %.2f km, Score: %d\n", closestApproach, missionScore);
+        } else {
+            missionState = MISSION_FAILURE;
+            printf("MISSION FAILED: Asteroid too close (%.2f km)\n", closestApproach);
+        }
+    }
+}
+
+/**
+ * NASA GAME MODE: Batched Trajectory Integration
+ *
+ * The impact ensemble and the deflection optimizer both need many forward
+ * simulations of the same small system that differ only in a few initial
+ * states. Those are integrated ENSEMBLE_LANES at a time in structure-of-arrays
+ * form, one trajectory per lane, so the pair loop vectorizes across
+ * trajectories. Batches are spread over worker threads. Dynamics are pure
+ * gravity with the same Plummer softening as calculateForces(), integrated
+ * with velocity Verlet at dt * timeScale until the mission time limit.
+ */
+const int ENSEMBLE_LANES = 8;
+
+struct EnsembleLanes {
+    double v[ENSEMBLE_LANES];
+};
+
+struct EnsembleBatch {
+    std::vector<EnsembleLanes> x, y, z, vx, vy, vz, ax, ay, az;  // [body].v[lane]
+    double closest[ENSEMBLE_LANES];  // Earth-asteroid closest approach so far
+    double cutoff[ENSEMBLE_LANES];   // Lane is settled once closest drops below this
+};
+
+// Sizes the batch for `states` and copies them into every lane
+void initEnsembleBatch(EnsembleBatch& batch, const std::vector<Body>& states) {
+    size_t n = states.size();
+    std::vector<EnsembleLanes>* fields[9] = {&batch.x, &batch.y, &batch.z, &batch.vx, &batch.vy,
+                                             &batch.vz, &batch.ax, &batch.ay, &batch.az};
+    for (auto* field : fields) {
+        field->resize(n);
+    }
+    for (int l = 0; l < ENSEMBLE_LANES; l++) {
+        for (size_t i = 0; i < n; i++) {
+            batch.x[i].v[l] = states[i].x;
+            batch.y[i].v[l] = states[i].y;
+            batch.z[i].v[l] = states[i].z;
+            batch.vx[i].v[l] = states[i].vx;
+            batch.vy[i].v[l] = states[i].vy;
+            batch.vz[i].v[l] = states[i].vz;
+        }
+        batch.closest[l] = 1e10;
+        batch.cutoff[l] = 0.0;
+    }
+}
+
+void calculateEnsembleForces(EnsembleBatch& batch, const std::vector<double>& masses, double softSq) {
+    size_t n = masses.size();
+    for (size_t i = 0; i < n; i++) {
+        for (int l = 0; l < ENSEMBLE_LANES; l++) {
+            batch.ax[i].v[l] = 0.0;
+            batch.ay[i].v[l] = 0.0;
+            batch.az[i].v[l] = 0.0;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = i + 1; j < n; j++) {
+            double gmi = G * masses[i];
+            double gmj = G * masses[j];
+            EnsembleLanes& axi = batch.ax[i];
+            EnsembleLanes& ayi = batch.ay[i];
+            EnsembleLanes& azi = batch.az[i];
+            EnsembleLanes& axj = batch.ax[j];
+            EnsembleLanes& ayj = batch.ay[j];
+            EnsembleLanes& azj = batch.az[j];
+            // Lane loop carries no dependencies: one trajectory per SIMD lane
+            for (int l = 0; l < ENSEMBLE_LANES; l++) {
+                double dx = batch.x[j].v[l] - batch.x[i].v[l];
+                double dy = batch.y[j].v[l] - batch.y[i].v[l];
+                double dz = batch.z[j].v[l] - batch.z[i].v[l];
+                double softenedDistSq = dx * dx + dy * dy + dz * dz + softSq;
+                double invDist3 = 1.0 / (softenedDistSq * sqrt(softenedDistSq));
+                axi.v[l] += gmj * dx * invDist3;
+                ayi.v[l] += gmj * dy * invDist3;
+                azi.v[l] += gmj * dz * invDist3;
+                axj.v[l] -= gmi * dx * invDist3;
+                ayj.v[l] -= gmi * dy * invDist3;
+                azj.v[l] -= gmi * dz * invDist3;
+            }
+        }
+    }
+}
+
+/**
+ * Integrates one batch for up to `steps` steps, tracking the Earth-asteroid
+ * closest approach per lane. Stops early once every active lane is settled
+ * (closest approach below its cutoff), since nothing later can change how
+ * that lane is classified. Returns the number of steps taken.
+ */
+long long integrateEnsembleBatch(EnsembleBatch& batch, const std::vector<double>& masses,
+                                 int activeLanes, long long steps, double h) {
+    double softSq = softeningLength * softeningLength;
+    size_t n = masses.size();
+    size_t e = static_cast<size_t>(earthBodyIndex);
+    size_t a = static_cast<size_t>(asteroidBodyIndex);
+
+    calculateEnsembleForces(batch, masses, softSq);
+
+    long long step = 0;
+    for (; step < steps; step++) {
+        for (size_t i = 0; i < n; i++) {
+            for (int l = 0; l < ENSEMBLE_LANES; l++) {
+                batch.vx[i].v[l] += batch.ax[i].v[l] * h * 0.5;
+                batch.vy[i].v[l] += batch.ay[i].v[l] * h * 0.5;
+                batch.vz[i].v[l] += batch.az[i].v[l] * h * 0.5;
+                batch.x[i].v[l] += batch.vx[i].v[l] * h;
+                batch.y[i].v[l] += batch.vy[i].v[l] * h;
+                batch.z[i].v[l] += batch.vz[i].v[l] * h;
+            }
+        }
+
+        calculateEnsembleForces(batch, masses, softSq);
+
+        for (size_t i = 0; i < n; i++) {
+            for (int l = 0; l < ENSEMBLE_LANES; l++) {
+                batch.vx[i].v[l] += batch.ax[i].v[l] * h * 0.5;
+                batch.vy[i].v[l] += batch.ay[i].v[l] * h * 0.5;
+                batch.vz[i].v[l] += batch.az[i].v[l] * h * 0.5;
+            }
+        }
+
+        bool allSettled = true;
+        for (int l = 0; l < ENSEMBLE_LANES; l++) {
+            double dx = batch.x[a].v[l] - batch.x[e].v[l];
+            double dy = batch.y[a].v[l] - batch.y[e].v[l];
+            double dz = batch.z[a].v[l] - batch.z[e].v[l];
+            double distance = sqrt(dx * dx + dy * dy + dz * dz);
+            batch.closest[l] = std::min(batch.closest[l], distance);
+            allSettled = allSettled && (batch.closest[l] < batch.cutoff[l] || l >= activeLanes);
+        }
+        if (allSettled) {
+            step++;
+            break;
+        }
+    }
+    return step;
+}
+
+void runEnsembleBatches(int batchCount, const std::function<void(int)>& runBatch) {
+    int threadCount = ensembleThreads > 0 ? ensembleThreads
+                                          : static_cast<int>(std::thread::hardware_concurrency());
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    threadCount = 1;  // No worker threads without -pthread
+#endif
+    threadCount = std::clamp(threadCount, 1, std::max(1, batchCount));
+
+    if (threadCount == 1) {
+        for (int b = 0; b < batchCount; b++) {
+            runBatch(b);
+        }
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&, t]() {
+            for (int b = t; b < batchCount; b += threadCount) {
+                runBatch(b);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * NASA GAME MODE: Monte Carlo Impact Ensemble
+ *
+ * The asteroid state is only known to within an uncertainty ellipsoid, so a
+ * single deterministic run cannot give an impact probability. Each member is
+ * a copy of the current system with the asteroid's position and velocity drawn
+ * from a Gaussian with per-axis sigmas (asteroidSigmaPos/Vel).
+ *
+ * Member k always draws its perturbation from seed + k, so results do not
+ * depend on thread count. Returns the impact fraction, or -1 if no mission
+ * is loaded.
+ */
+double runImpactEnsembleInternal(int members, unsigned int seed) {
+    if (gameMode != GAME_MODE_ACTIVE || members <= 0 ||
+        earthBodyIndex < 0 || earthBodyIndex >= static_cast<int>(bodies.size()) ||
+        asteroidBodyIndex < 0 || asteroidBodyIndex >= static_cast<int>(bodies.size())) {
+        return -1.0;
+    }
+
+    double h = dt * timeScale;
+    long long steps = static_cast<long long>(ceil(std::max(0.0, timeLimit - missionTime) / h));
+    size_t n = bodies.size();
+    std::vector<double> masses(n);
+    for (size_t i = 0; i < n; i++) {
+        masses[i] = bodies[i].mass;
+    }
+
+    int batchCount = (members + ENSEMBLE_LANES - 1) / ENSEMBLE_LANES;
+    std::vector<double> closest(members, 1e10);
+    std::vector<long long> memberSteps(batchCount, 0);
+
+    auto runBatch = [&](int batchIndex) {
+        EnsembleBatch batch;
+        initEnsembleBatch(batch, bodies);
+
+        int firstMember = batchIndex * ENSEMBLE_LANES;
+        int activeLanes = std::min(ENSEMBLE_LANES, members - firstMember);
+        size_t a = static_cast<size_t>(asteroidBodyIndex);
+        for (int l = 0; l < activeLanes; l++) {
+            std::mt19937_64 rng(static_cast<uint64_t>(seed) + static_cast<uint64_t>(firstMember + l));
+            std::normal_distribution<double> normal(0.0, 1.0);
+            batch.x[a].v[l] += normal(rng) * asteroidSigmaPos[0];
+            batch.y[a].v[l] += normal(rng) * asteroidSigmaPos[1];
+            batch.z[a].v[l] += normal(rng) * asteroidSigmaPos[2];
+            batch.vx[a].v[l] += normal(rng) * asteroidSigmaVel[0];
+            batch.vy[a].v[l] += normal(rng) * asteroidSigmaVel[1];
+            batch.vz[a].v[l] += normal(rng) * asteroidSigmaVel[2];
+            batch.cutoff[l] = threatRadius;  // Impacted members are settled
+        }
+
+        long long taken = integrateEnsembleBatch(batch, masses, activeLanes, steps, h);
+        memberSteps[batchIndex] = taken * activeLanes;
+        for (int l = 0; l < activeLanes; l++) {
+            closest[firstMember + l] = batch.closest[l];
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    runEnsembleBatches(batchCount, runBatch);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long totalSteps = 0;
+    for (long long s : memberSteps) {
+        totalSteps += s;
+    }
+    int impacts = 0;
+    for (double distance : closest) {
+        impacts += distance < threatRadius ? 1 : 0;
+    }
+
+    std::sort(closest.begin(), closest.end());
+    ensembleClosestApproaches = closest;
+    ensembleThroughput = seconds > 0.0 ? totalSteps / seconds : 0.0;
+    impactProbability = static_cast<double>(impacts) / members;
+
+    printf("Impact ensemble: %d members, P(impact) = %.4f, %.3g member-steps/sec\n",
+           members, impactProbability, ensembleThroughput);
+    return impactProbability;
+}
+
+/**
+ * NASA GAME MODE: Deflection Optimizer (differential evolution, DE/rand/1/bin)
+ *
+ * Searches deployment position and velocity for the plan that maximizes the
+ * Earth-asteroid closest approach. Velocity is encoded as (fraction of
+ * deltaVBudget, heading) so every candidate is within budget by construction.
+ * Each candidate is a forward simulation of the mission with the spacecraft
+ * added; a generation's trial vectors are integrated together as lanes of
+ * EnsembleBatch. A trial only replaces its target if it ends up farther from
+ * Earth, so its lane is abandoned as soon as its closest approach drops below
+ * the target's fitness.
+ */
+const int OPTIMIZER_POPULATION = 4 * ENSEMBLE_LANES;
+const int OPTIMIZER_DIMENSIONS = 4;  // x, y, speed fraction, heading
+
+double optimizedDeploy[4] = {0.0, 0.0, 0.0, 0.0};  // x, y, vx, vy of best plan
+double optimizedClosestApproach = 0.0;
+int optimizerEvaluations = 0;
+double optimizerTimeBudget = 0.8;  // seconds
+
+double optimizeDeflectionInternal(int maxGenerations, unsigned int seed) {
+    if (gameMode != GAME_MODE_ACTIVE || missionState != MISSION_SETUP ||
+        earthBodyIndex < 0 || earthBodyIndex >= static_cast<int>(bodies.size()) ||
+        asteroidBodyIndex < 0 || asteroidBodyIndex >= static_cast<int>(bodies.size())) {
+        return -1.0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    double h = dt * timeScale;
+    long long steps = static_cast<long long>(ceil(std::max(0.0, timeLimit - missionTime) / h));
+
+    std::vector<Body> states = bodies;
+    states.push_back({0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+                      spacecraftMass, 3.0, 0xFFFFFFFF, 0.0, 0.0});
+    size_t craft = states.size() - 1;
+    std::vector<double> masses(states.size());
+    for (size_t i = 0; i < states.size(); i++) {
+        masses[i] = states[i].mass;
+    }
+
+    const double lower[OPTIMIZER_DIMENSIONS] = {0.0, 0.0, 0.0, 0.0};
+    const double upper[OPTIMIZER_DIMENSIONS] = {(double)canvasWidth, (double)canvasHeight, 1.0, 2.0 * M_PI};
+    typedef std::array<double, OPTIMIZER_DIMENSIONS> Genome;
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<Genome> population(OPTIMIZER_POPULATION);
+    std::vector<double> fitness(OPTIMIZER_POPULATION, 0.0);
+    for (auto& genome : population) {
+        for (int d = 0; d < OPTIMIZER_DIMENSIONS; d++) {
+            genome[d] = lower[d] + unit(rng) * (upper[d] - lower[d]);
+        }
+    }
+
+    // Evaluates `candidates`; a lane stops once it can no longer beat cutoffs[k]
+    auto evaluate = [&](const std::vector<Genome>& candidates, const std::vector<double>& cutoffs,
+                        std::vector<double>& results) {
+        int batchCount = OPTIMIZER_POPULATION / ENSEMBLE_LANES;
+        runEnsembleBatches(batchCount, [&](int batchIndex) {
+            EnsembleBatch batch;
+            initEnsembleBatch(batch, states);
+            for (int l = 0; l < ENSEMBLE_LANES; l++) {
+                const Genome& genome = candidates[batchIndex * ENSEMBLE_LANES + l];
+                double speed = genome[2] * deltaVBudget;
+                batch.x[craft].v[l] = genome[0];
+                batch.y[craft].v[l] = genome[1];
+                batch.vx[craft].v[l] = speed * cos(genome[3]);
+                batch.vy[craft].v[l] = speed * sin(genome[3]);
+                batch.cutoff[l] = cutoffs[batchIndex * ENSEMBLE_LANES + l];
+            }
+            integrateEnsembleBatch(batch, masses, ENSEMBLE_LANES, steps, h);
+            for (int l = 0; l < ENSEMBLE_LANES; l++) {
+                results[batchIndex * ENSEMBLE_LANES + l] = batch.closest[l];
+            }
+        });
+        optimizerEvaluations += static_cast<int>(candidates.size());
+    };
+
+    optimizerEvaluations = 0;
+    evaluate(population, std::vector<double>(OPTIMIZER_POPULATION, 0.0), fitness);
+
+    const double F = 0.7;   // Differential weight
+    const double CR = 0.9;  // Crossover probability
+    std::vector<Genome> trials(OPTIMIZER_POPULATION);
+    std::vector<double> trialFitness(OPTIMIZER_POPULATION, 0.0);
+    int generation = 0;
+    for (; generation < maxGenerations; generation++) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed > optimizerTimeBudget) {
+            break;
+        }
+
+        for (int k = 0; k < OPTIMIZER_POPULATION; k++) {
+            int r1, r2, r3;
+            do { r1 = rng() % OPTIMIZER_POPULATION; } while (r1 == k);
+            do { r2 = rng() % OPTIMIZER_POPULATION; } while (r2 == k || r2 == r1);
+            do { r3 = rng() % OPTIMIZER_POPULATION; } while (r3 == k || r3 == r1 || r3 == r2);
+            int forced = rng() % OPTIMIZER_DIMENSIONS;
+            for (int d = 0; d < OPTIMIZER_DIMENSIONS; d++) {
+                double value = population[k][d];
+                if (d == forced || unit(rng) < CR) {
+                    value = population[r1][d] + F * (population[r2][d] - population[r3][d]);
+                }
+                trials[k][d] = std::clamp(value, lower[d], upper[d]);
+            }
+        }
+
+        evaluate(trials, fitness, trialFitness);
+        for (int k = 0; k < OPTIMIZER_POPULATION; k++) {
+            if (trialFitness[k] > fitness[k]) {
+                population[k] = trials[k];
+                fitness[k] = trialFitness[k];
+            }
+        }
+    }
+
+    int best = static_cast<int>(std::max_element(fitness.begin(), fitness.end()) - fitness.begin());
+    double speed = population[best][2] * deltaVBudget;
+    optimizedDeploy[0] = population[best][0];
+    optimizedDeploy[1] = population[best][1];
+    optimizedDeploy[2] = speed * cos(population[best][3]);
+    optimizedDeploy[3] = speed * sin(population[best][3]);
+    optimizedClosestApproach = fitness[best];
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Deflection optimizer: %d generations, %d evaluations in %.3fs, closest approach %.2f\n",
+           generation, optimizerEvaluations, seconds, optimizedClosestApproach);
+    return optimizedClosestApproach;
+}
+
+/**
+ * RENDERING: Orbit Trail Ring Buffers
+ *
+ * Each body owns trailCapacity (x, y) float slots in one contiguous buffer
+ * that JS reads through a typed-array view, together with per-body head
+ * (oldest slot) and length arrays. Positions are sampled every
+ * trailSampleInterval steps, so trails have no gaps at high timeScale.
+ *
+ * Straight runs are decimated as they stream in: the newest point is a
+ * movable tip, and while every raw sample since the last committed point lies
+ * within trailTolerance of the segment from that point to the new sample,
+ * the tip is moved instead of a new point being appended. This is the
+ * streaming form of Douglas–Peucker simplification.
+ */
+const size_t TRAIL_MAX_PENDING = 64;  // Raw samples a single segment may absorb
+
+int trailCapacity = 256;          // Points per body
+int trailSampleInterval = 2;      // Steps between samples
+double trailTolerance = 0.5;      // Max deviation (world units) of dropped samples
+std::vector<float> trailPoints;   // [body][capacity][x, y]
+std::vector<int32_t> trailHeads;  // Slot of each body's oldest point
+std::vector<int32_t> trailLengths;
+std::vector<std::vector<std::array<float, 2>>> trailPending;  // Samples merged into the tip segment
+
+void clearTrailBuffers() {
+    size_t count = bodies.size();
+    trailPoints.assign(count * trailCapacity * 2, 0.0f);
+    trailHeads.assign(count, 0);
+    trailLengths.assign(count, 0);
+    trailPending.assign(count, {});
+}
+
+// Distance from p to segment a-b, squared
+double segmentDistanceSq(const float* p, const float* a, const float* b) {
+    double abx = b[0] - a[0], aby = b[1] - a[1];
+    double apx = p[0] - a[0], apy = p[1] - a[1];
+    double lengthSq = abx * abx + aby * aby;
+    double t = lengthSq > 0.0 ? std::clamp((apx * abx + apy * aby) / lengthSq, 0.0, 1.0) : 0.0;
+    double dx = apx - t * abx, dy = apy - t * aby;
+    return dx * dx + dy * dy;
+}
+
+void appendTrailPoint(size_t body, float x, float y) {
+    float* slots = trailPoints.data() + body * trailCapacity * 2;
+    int32_t& head = trailHeads[body];
+    int32_t& length = trailLengths[body];
+    int32_t slot = (head + length) % trailCapacity;
+    if (length == trailCapacity) {
+        head = (head + 1) % trailCapacity;
+    } else {
+        length++;
+    }
+    slots[slot * 2] = x;
+    slots[slot * 2 + 1] = y;
+}
+
+void sampleTrails() {
+    if (trailLengths.size() != bodies.size()) {
+        clearTrailBuffers();  // Bodies merged, fragmented, added or removed
+    }
+    double toleranceSq = trailTolerance * trailTolerance;
+    for (size_t i = 0; i < bodies.size(); i++) {
+        float sample[2] = {static_cast<float>(bodies[i].x), static_cast<float>(bodies[i].y)};
+        int32_t length = trailLengths[i];
+        if (length < 2) {
+            appendTrailPoint(i, sample[0], sample[1]);
+            continue;
+        }
+
+        float* slots = trailPoints.data() + i * trailCapacity * 2;
+        float* tip = slots + ((trailHeads[i] + length - 1) % trailCapacity) * 2;
+        const float* anchor = slots + ((trailHeads[i] + length - 2) % trailCapacity) * 2;
+        auto& pending = trailPending[i];
+        bool straight = pending.size() < TRAIL_MAX_PENDING &&
+                        segmentDistanceSq(tip, anchor, sample) <= toleranceSq;
+        for (size_t k = 0; straight && k < pending.size(); k++) {
+            straight = segmentDistanceSq(pending[k].data(), anchor, sample) <= toleranceSq;
+        }
+
+        if (straight) {
+            pending.push_back({tip[0], tip[1]});
+            tip[0] = sample[0];
+            tip[1] = sample[1];
+        } else {
+            pending.clear();
+            appendTrailPoint(i, sample[0], sample[1]);
+        }
+    }
+}
+
+void recordCheckpoint();
+
+void updateBodies() {
+    // Only velocity Verlet ends on a force pass over the final positions
+    forcePassCurrent = false;
+
+    // Test particles always use kick-drift-kick, with the first kick taken
+    // against the massive bodies before they move and the second after
+    double effectiveDt = dt * timeScale;
+    bool hasTestParticles = !testParticles.empty();
+    if (hasTestParticles) {
+        kickDriftTestParticles(effectiveDt * 0.5, effectiveDt);
+    }
+
+    lastRegularizedSubsteps = 0;
+    if (needsRegularization()) {
+        updateBodiesRegularized();
+    } else {
+        switch (currentMethod) {
+            case METHOD_EULER:
+                updateBodiesEuler();
+                break;
+            case METHOD_VERLET:
+                updateBodiesVerlet();
+                break;
+            case METHOD_RK4:
+                updateBodiesRK4();
+                break;
+            case METHOD_RKF45:
+                updateBodiesRKF45();
+                break;
+        }
+    }
+    if (hasTestParticles) {
+        calculateTestParticleForces(effectiveDt * 0.5);
+    }
+    enforceBoundaryBounce();
+    if (stepCount % trailSampleInterval == 0) {
+        sampleTrails();
+    }
+    if (stepCount % monitorInterval == 0) {
+        reduceSystemProperties(forcePassCurrent ? forcePassPotentialEnergy : calculatePotentialEnergy());
+    }
+    evaluateMissionStatus();
+
+    stepCount++;
+    if (!replayingTimeline && stepCount % checkpointInterval == 0) {
+        recordCheckpoint();
+    }
+}
+
+/**
+ * TIMELINE: Checkpoint Ring and Deterministic Replay
+ *
+ * Every checkpointInterval steps the full simulation state (bodies, physics
+ * parameters, mission state and conservation baselines) is copied into a
+ * ring bounded by checkpointMemoryBudget bytes, dropping the oldest entries
+ * first. Stepping is deterministic, so any intermediate step is reproduced
+ * exactly by restoring the nearest earlier checkpoint and re-integrating.
+ *
+ * Anything that changes the dynamics between steps (parameter setters, body
+ * edits, spacecraft deployment) calls markTimelineEdit(), which discards the
+ * recorded future and checkpoints the edited state so replays stay exact.
+ */
+struct Checkpoint {
+    long long step;
+    std::vector<double> scalars;  // Values from visitTimelineScalars, in order
+    std::vector<Body> bodies;
+    TestParticles testParticles;
+};
+
+std::deque<Checkpoint> checkpoints;
+size_t checkpointMemoryBudget = 16 * 1024 * 1024;
+size_t checkpointMemoryUsed = 0;
+bool timelineEditPending = false;
+
+// Order is part of the serialization format: append new fields at the end
+template <typename Visitor>
+void visitTimelineScalars(Visitor&& visit) {
+    // Physics parameters
+    visit(G);
+    visit(dt);
+    visit(timeScale);
+    visit(currentMethod);
+    visit(enableCollisions);
+    visit(collisionDamping);
+    visit(enableMerging);
+    visit(enableTidalForces);
+    visit(softeningLength);
+    visit(enableGravitationalWaves);
+    visit(enableChargeForces);
+    visit(electrostaticConstant);
+    visit(fragmentationEnergyScale);
+    visit(enableBoundaryMode);
+    visit(boundaryPadding);
+    visit(boundaryRestitution);
+    visit(canvasWidth);
+    visit(canvasHeight);
+
+    // Mission state
+    visit(gameMode);
+    visit(missionState);
+    visit(earthBodyIndex);
+    visit(asteroidBodyIndex);
+    visit(spacecraftBodyIndex);
+    visit(safetyMargin);
+    visit(threatRadius);
+    visit(missionTime);
+    visit(timeLimit);
+    visit(closestApproach);
+    visit(impactProbability);
+    visit(missionScore);
+    visit(deltaVBudget);
+    visit(deltaVUsed);
+
+    // Conservation baselines
+    visit(initialEnergy);
+    visit(initialMomentumX);
+    visit(initialMomentumY);
+    visit(initialMomentumZ);
+    visit(initialAngularMomentumX);
+    visit(initialAngularMomentumY);
+    visit(initialAngularMomentumZ);
+
+    // Force solver
+    visit(forceSolver);
+    visit(fmmOrder);
+    visit(fmmOpeningAngle);
+
+    // Close-encounter regularization
+    visit(regularizationRadius);
+    visit(regularizationSubsteps);
+}
+
+size_t checkpointBytes(const Checkpoint& checkpoint) {
+    return sizeof(Checkpoint) + checkpoint.scalars.size() * sizeof(double) +
+           checkpoint.bodies.size() * sizeof(Body) +
+           checkpoint.testParticles.size() * (6 * sizeof(SimReal) + sizeof(unsigned int));
+}
+
+void recordCheckpoint() {
+    Checkpoint checkpoint;
+    checkpoint.step = stepCount;
+    checkpoint.bodies = bodies;
+    checkpoint.testParticles = testParticles.withoutForces();
+    visitTimelineScalars([&](auto& value) {
+        checkpoint.scalars.push_back(static_cast<double>(value));
+    });
+
+    if (!checkpoints.empty() && checkpoints.back().step == stepCount) {
+        checkpointMemoryUsed -= checkpointBytes(checkpoints.back());
+        checkpoints.pop_back();
+    }
+    checkpointMemoryUsed += checkpointBytes(checkpoint);
+    checkpoints.push_back(std::move(checkpoint));
+
+    while (checkpointMemoryUsed > checkpointMemoryBudget && checkpoints.size() > 1) {
+        checkpointMemoryUsed -= checkpointBytes(checkpoints.front());
+        checkpoints.pop_front();
+    }
+}
+
+void restoreCheckpoint(const Checkpoint& checkpoint) {
+    size_t index = 0;
+    visitTimelineScalars([&](auto& value) {
+        typedef typename std::remove_reference<decltype(value)>::type ValueType;
+        if (index < checkpoint.scalars.size()) {
+            value = static_cast<ValueType>(checkpoint.scalars[index]);
+        }
+        index++;
+    });
+    bodies = checkpoint.bodies;
+    testParticles = checkpoint.testParticles;
+    testParticleForcesCurrent = false;
+    stepCount = checkpoint.step;
+    clearTrailBuffers();
+    calculateSystemProperties();
+}
+
+// Drops recorded checkpoints later than `step` (a new branch starts there)
+void truncateTimelineAfter(long long step) {
+    while (!checkpoints.empty() && checkpoints.back().step > step) {
+        checkpointMemoryUsed -= checkpointBytes(checkpoints.back());
+        checkpoints.pop_back();
+    }
+}
+
+// Edits are checkpointed lazily, so bulk edits (e.g. adding a belt body by body) copy state once
+void markTimelineEdit() {
+    testParticleForcesCurrent = false;
+    truncateTimelineAfter(stepCount);
+    timelineEditPending = true;
+}
+
+void flushTimelineEdit() {
+    if (timelineEditPending) {
+        timelineEditPending = false;
+        recordCheckpoint();
+    }
+}
+
+void resetTimeline() {
+    testParticleForcesCurrent = false;
+    clearTrailBuffers();
+    checkpoints.clear();
+    checkpointMemoryUsed = 0;
+    stepCount = 0;
+    timelineEditPending = false;
+    recordCheckpoint();
+}
+
+bool seekToStepInternal(long long target) {
+    flushTimelineEdit();
+    if (target < 0 || checkpoints.empty() || checkpoints.front().step > target) {
+        return false;
+    }
+    auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), target,
+                               [](long long step, const Checkpoint& checkpoint) {
+                                   return step < checkpoint.step;
+                               });
+    restoreCheckpoint(*(it - 1));
+
+    replayingTimeline = true;
+    while (stepCount < target) {
+        updateBodies();
+    }
+    replayingTimeline = false;
+    calculateSystemProperties();  // Diagnostics may be skipped between monitor steps
+    return true;
+}
+
+/**
+ * Binary timeline format (little-endian, version 2):
+ *   u32 magic "TBCK", u32 version, u32 scalar count, i64 current step,
+ *   u32 checkpoint interval, u32 checkpoint count, then per checkpoint:
+ *   i64 step, f64 scalars[scalar count], u32 body count, then per body
+ *   f64 x y z vx vy vz ax ay az mass radius, u32 color, f64 charge KE PE,
+ *   then u32 test particle count and per particle f64 x y z vx vy vz, u32 color.
+ * Fields are written one by one so the format does not depend on struct
+ * layout; files with fewer scalars (older builds) still load, and version 1
+ * files (no test particle block) load with no test particles.
+ */
+const uint32_t TIMELINE_MAGIC = 0x4B434254;  // "TBCK"
+const uint32_t TIMELINE_VERSION = 2;
+std::vector<uint8_t> timelineBuffer;
+
+void writeU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int b = 0; b < 4; b++) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * b)));
+    }
+}
+
+void writeU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int b = 0; b < 8; b++) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * b)));
+    }
+}
+
+void writeF64(std::vector<uint8_t>& out, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeU64(out, bits);
+}
+
+struct TimelineReader {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    bool ok;
+
+    uint64_t readBytes(int count) {
+        if (!ok || offset + count > size) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int b = 0; b < count; b++) {
+            value |= static_cast<uint64_t>(data[offset + b]) << (8 * b);
+        }
+        offset += count;
+        return value;
+    }
+    uint32_t u32() { return static_cast<uint32_t>(readBytes(4)); }
+    uint64_t u64() { return readBytes(8); }
+    double f64() {
+        uint64_t bits = readBytes(8);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+size_t serializeTimelineInternal() {
+    flushTimelineEdit();
+    uint32_t scalarCount = checkpoints.empty() ? 0 : checkpoints.front().scalars.size();
+    timelineBuffer.clear();
+    writeU32(timelineBuffer, TIMELINE_MAGIC);
+    writeU32(timelineBuffer, TIMELINE_VERSION);
+    writeU32(timelineBuffer, scalarCount);
+    writeU64(timelineBuffer, static_cast<uint64_t>(stepCount));
+    writeU32(timelineBuffer, checkpointInterval);
+    writeU32(timelineBuffer, checkpoints.size());
+    for (const auto& checkpoint : checkpoints) {
+        writeU64(timelineBuffer, static_cast<uint64_t>(checkpoint.step));
+        for (double value : checkpoint.scalars) {
+            writeF64(timelineBuffer, value);
+        }
+        writeU32(timelineBuffer, checkpoint.bodies.size());
+        for (const auto& body : checkpoint.bodies) {
+            const double kinematics[11] = {body.x, body.y, body.z, body.vx, body.vy, body.vz,
+                                           body.ax, body.ay, body.az, body.mass, body.radius};
+            for (double value : kinematics) {
+                writeF64(timelineBuffer, value);
+            }
+            writeU32(timelineBuffer, body.color);
+            writeF64(timelineBuffer, body.charge);
+            writeF64(timelineBuffer, body.kineticEnergy);
+            writeF64(timelineBuffer, body.potentialEnergy);
+        }
+        const TestParticles& particles = checkpoint.testParticles;
+        writeU32(timelineBuffer, particles.size());
+        for (size_t i = 0; i < particles.size(); i++) {
+            const double kinematics[6] = {particles.x[i], particles.y[i], particles.z[i],
+                                          particles.vx[i], particles.vy[i], particles.vz[i]};
+            for (double value : kinematics) {
+                writeF64(timelineBuffer, value);
+            }
+            writeU32(timelineBuffer, particles.color[i]);
+        }
+    }
+    return timelineBuffer.size();
+}
+
+bool loadTimelineInternal(const uint8_t* data, size_t size) {
+    TimelineReader reader{data, size, 0, data != nullptr};
+    if (reader.u32() != TIMELINE_MAGIC) {
+        return false;
+    }
+    uint32_t version = reader.u32();
+    if (version < 1 || version > TIMELINE_VERSION) {
+        return false;
+    }
+    uint32_t scalarCount = reader.u32();
+    long long savedStep = static_cast<long long>(reader.u64());
+    uint32_t interval = reader.u32();
+    uint32_t count = reader.u32();
+
+    std::deque<Checkpoint> loaded;
+    for (uint32_t c = 0; c < count && reader.ok; c++) {
+        Checkpoint checkpoint;
+        checkpoint.step = static_cast<long long>(reader.u64());
+        checkpoint.scalars.resize(scalarCount);
+        for (auto& value : checkpoint.scalars) {
+            value = reader.f64();
+        }
+        uint32_t bodyCount = reader.u32();
+        for (uint32_t i = 0; i < bodyCount && reader.ok; i++) {
+            Body body{};
+            double* kinematics[11] = {&body.x, &body.y, &body.z, &body.vx, &body.vy, &body.vz,
+                                      &body.ax, &body.ay, &body.az, &body.mass, &body.radius};
+            for (double* value : kinematics) {
+                *value = reader.f64();
+            }
+            body.color = reader.u32();
+            body.charge = reader.f64();
+            body.kineticEnergy = reader.f64();
+            body.potentialEnergy = reader.f64();
+            checkpoint.bodies.push_back(body);
+        }
+        uint32_t particleCount = version >= 2 ? reader.u32() : 0;
+        for (uint32_t i = 0; i < particleCount && reader.ok; i++) {
+            double kinematics[6];
+            for (double& value : kinematics) {
+                value = reader.f64();
+            }
+            unsigned int color = reader.u32();
+            checkpoint.testParticles.push(kinematics[0], kinematics[1], kinematics[2],
+                                          kinematics[3], kinematics[4], kinematics[5], color);
+        }
+        loaded.push_back(std::move(checkpoint));
+    }
+    if (!reader.ok || loaded.empty()) {
+        return false;
+    }
+
+    checkpoints = std::move(loaded);
+    checkpointInterval = std::max<uint32_t>(1, interval);
+    checkpointMemoryUsed = 0;
+    for (const auto& checkpoint : checkpoints) {
+        checkpointMemoryUsed += checkpointBytes(checkpoint);
+    }
+    return seekToStepInternal(savedStep) || seekToStepInternal(checkpoints.front().step);
+}
+
+// FNV-1a over body state bits, for comparing runs across builds
+uint32_t stateChecksum() {
+    uint32_t hash = 2166136261u;
+    auto mix = [&](double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        for (int b = 0; b < 8; b++) {
+            hash ^= static_cast<uint8_t>(bits >> (8 * b));
+            hash *= 16777619u;
+        }
+    };
+    for (const auto& body : bodies) {
+        mix(body.x);
+        mix(body.y);
+        mix(body.z);
+        mix(body.vx);
+        mix(body.vy);
+        mix(body.vz);
+        mix(body.mass);
+    }
+    for (size_t i = 0; i < testParticles.size(); i++) {
+        mix(testParticles.x[i]);
+        mix(testParticles.y[i]);
+        mix(testParticles.z[i]);
+        mix(testParticles.vx[i]);
+        mix(testParticles.vy[i]);
+        mix(testParticles.vz[i]);
+    }
+    return hash;
+}
+
+
+// Main loop
+extern "C" {
+    EMSCRIPTEN_KEEPALIVE
+    void update() {
+        // Stepping after a scrub starts a new branch from the restored frame
+        truncateTimelineAfter(stepCount);
+        flushTimelineEdit();
+        if (initialTestParticlesStale) {
+            initialTestParticles = testParticles;
+            initialTestParticlesStale = false;
+        }
+        updateBodies();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBodyX(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].x;
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBodyY(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].y;
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBodyZ(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].z;
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBodyRadius(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].radius;
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    unsigned int getBodyColor(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].color;
+        }
+        return 0xFFFFFFFF;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBodyVX(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].vx;
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBodyVY(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].vy;
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBodyVZ(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].vz;
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBodyMass(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].mass;
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getBodyCount() {
+        return bodies.size();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getTotalEnergy() {
+        return totalEnergy;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getMomentumX() {
+        return totalMomentumX;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getMomentumY() {
+        return totalMomentumY;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getMomentumZ() {
+        return totalMomentumZ;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getCenterOfMassX() {
+        return centerOfMassX;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getCenterOfMassY() {
+        return centerOfMassY;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getCenterOfMassZ() {
+        return centerOfMassZ;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setGravitationalConstant(double g) {
+        G = g;
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getGravitationalConstant() {
+        return G;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setTimeStep(double newDt) {
+        dt = newDt;
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getTimeStep() {
+        return dt;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setTimeScale(double scale) {
+        timeScale = scale;
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getTimeScale() {
+        return timeScale;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setIntegrator(int method) {
+        // 0=Euler, 1=Verlet, 2=RK4, 3=RKF45
+        if (method >= 0 && method <= 3) {
+            currentMethod = static_cast<IntegrationMethod>(method);
+            markTimelineEdit();
+        }
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getIntegrator() {
+        return static_cast<int>(currentMethod);
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setForceSolver(int solver) {
+        // 0=Direct, 1=FMM
+        if (solver >= 0 && solver <= 1) {
+            forceSolver = static_cast<ForceSolver>(solver);
+            markTimelineEdit();
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getForceSolver() {
+        return static_cast<int>(forceSolver);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setFMMOrder(int order) {
+        fmmOrder = std::clamp(order, 1, FMMSolver::MAX_ORDER);
+        markTimelineEdit();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getFMMOrder() {
+        return fmmOrder;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setFMMOpeningAngle(double theta) {
+        fmmOpeningAngle = std::clamp(theta, 0.05, 1.0);
+        markTimelineEdit();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getFMMOpeningAngle() {
+        return fmmOpeningAngle;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double verifyFMMAccuracy(int samples) {
+        return verifyFMMAccuracyInternal(samples);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setCollisions(int enabled) {
+        enableCollisions = (enabled != 0);
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getCollisions() {
+        return enableCollisions ? 1 : 0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setCollisionDamping(double damping) {
+        collisionDamping = damping;
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void loadPreset(int presetType) {
+        // Disable game mode for academic presets
+        gameMode = GAME_MODE_DISABLED;
+        testParticles.clear();
+        
+        switch (presetType) {
+            case PRESET_FIGURE_EIGHT:
+                loadFigureEight();
+                break;
+            case PRESET_STABLE_ORBIT:
+                loadStableOrbit();
+                break;
+            case PRESET_CHAOTIC:
+                loadChaotic();
+                break;
+            case PRESET_BINARY_STAR:
+                loadBinaryStar();
+                break;
+            case PRESET_PYTHAGOREAN:
+                loadPythagorean();
+                break;
+            case PRESET_LAGRANGE:
+                loadLagrange();
+                break;
+            case PRESET_SOLAR_SYSTEM:
+                loadSolarSystem();
+                break;
+            case PRESET_NASA_ASTEROID_DEFENSE:
+                loadNASAAsteroidDefense(1);  // Default medium difficulty
+                initialTestParticles.clear();
+                initialTestParticlesStale = false;
+                resetTimeline();
+                return;  // Skip normal initialization for game mode
+        }
+        initialBodies = bodies;
+        initialTestParticles = testParticles;
+        initialTestParticlesStale = false;
+        calculateSystemProperties();
+        saveInitialState();  // Save conservation baselines
+        resetTimeline();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void addBody(double x, double y, double vx, double vy, double mass, double radius, unsigned int color) {
+        bodies.push_back({
+            x, y, 0.0, vx, vy, 0.0, 0.0, 0.0, 0.0,
+            mass, radius, color,
+            0.0, 0.0, 0.0
+        });
+        initialBodies = bodies;
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void removeBody(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            bodies.erase(bodies.begin() + index);
+            initialBodies = bodies;
+            markTimelineEdit();
+        }
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void clearBodies() {
+        bodies.clear();
+        initialBodies.clear();
+        testParticles.clear();
+        initialTestParticles.clear();
+        initialTestParticlesStale = false;
+        resetTimeline();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void init() {
+        initBodies();
+        initialBodies = bodies;
+        testParticles.clear();
+        initialTestParticles.clear();
+        initialTestParticlesStale = false;
+        calculateSystemProperties();
+        saveInitialState();  // Initialize conservation baselines
+        resetTimeline();
+        printf("Three-body simulation initialized with %zu bodies\n", bodies.size());
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void reset() {
+        bodies = initialBodies;
+        if (initialTestParticlesStale) {
+            initialTestParticlesStale = false;
+            initialTestParticles = testParticles;
+        }
+        testParticles = initialTestParticles;
+        calculateSystemProperties();
+        saveInitialState();  // Reset conservation baselines
+        resetTimeline();
+    }
+    
+    // New interactive functions
+    EMSCRIPTEN_KEEPALIVE
+    void setBodyPosition(int index, double x, double y) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            bodies[index].x = x;
+            bodies[index].y = y;
+            // z remains unchanged (0 for 2D view)
+            markTimelineEdit();
+        }
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setBodyVelocity(int index, double vx, double vy) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            bodies[index].vx = vx;
+            bodies[index].vy = vy;
+            // vz remains unchanged (0 for 2D view)
+            markTimelineEdit();
+        }
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setBodyMass(int index, double mass) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            bodies[index].mass = mass;
+            // Update radius based on mass (radius ~ mass^(1/3) for constant density)
+            bodies[index].radius = 5.0 + pow(mass / 10.0, 0.4) * 5.0;
+            markTimelineEdit();
+        }
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setBodyColor(int index, unsigned int color) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            bodies[index].color = color;
+            markTimelineEdit();
+        }
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setBodyCharge(int index, double charge) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            bodies[index].charge = charge;
+            markTimelineEdit();
+        }
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBodyCharge(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            return bodies[index].charge;
+        }
+        return 0.0;
+    }
+    
+    // Test particles (massless bodies, O(N·M) integration)
+    EMSCRIPTEN_KEEPALIVE
+    void addTestParticle(double x, double y, double vx, double vy, unsigned int color) {
+        testParticles.push(x, y, 0.0, vx, vy, 0.0, color);
+        initialTestParticlesStale = true;
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void addTestParticleBelt(int count, int centerIndex, double innerRadius, double outerRadius,
+                             unsigned int color, unsigned int seed) {
+        addTestParticleBeltInternal(count, centerIndex, innerRadius, outerRadius, color, seed);
+        markTimelineEdit();
+    }
+    
+    // Moves a body into the test-particle block; mission bodies stay massive
+    EMSCRIPTEN_KEEPALIVE
+    int setBodyMassless(int index) {
+        if (index < 0 || index >= static_cast<int>(bodies.size())) {
+            return 0;
+        }
+        if (gameMode == GAME_MODE_ACTIVE &&
+            (index == earthBodyIndex || index == asteroidBodyIndex || index == spacecraftBodyIndex)) {
+            return 0;
+        }
+        const Body& body = bodies[index];
+        testParticles.push(body.x, body.y, body.z, body.vx, body.vy, body.vz, body.color);
+        bodies.erase(bodies.begin() + index);
+        for (int* missionIndex : {&earthBodyIndex, &asteroidBodyIndex, &spacecraftBodyIndex}) {
+            if (*missionIndex > index) {
+                (*missionIndex)--;
+            }
+        }
+        initialBodies = bodies;
+        initialTestParticlesStale = true;
+        markTimelineEdit();
+        return 1;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void clearTestParticles() {
+        testParticles.clear();
+        initialTestParticlesStale = true;
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getTestParticleCount() {
+        return testParticles.size();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getTestParticleX(int index) {
+        if (index >= 0 && index < static_cast<int>(testParticles.size())) {
+            return testParticles.x[index];
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getTestParticleY(int index) {
+        if (index >= 0 && index < static_cast<int>(testParticles.size())) {
+            return testParticles.y[index];
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    unsigned int getTestParticleColor(int index) {
+        if (index >= 0 && index < static_cast<int>(testParticles.size())) {
+            return testParticles.color[index];
+        }
+        return 0;
+    }
+    
+    // Position arrays for drawing straight from HEAPF64 (valid until the next add/clear)
+    EMSCRIPTEN_KEEPALIVE
+    const SimReal* getTestParticleXArray() {
+        return testParticles.x.data();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    const SimReal* getTestParticleYArray() {
+        return testParticles.y.data();
+    }
+    
+    // Bits per element of the test-particle arrays (picks HEAPF32 or HEAPF64 in JS)
+    EMSCRIPTEN_KEEPALIVE
+    int getSimulationPrecision() {
+        return sizeof(SimReal) * 8;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int findBodyAtPosition(double x, double y) {
+        for (int i = bodies.size() - 1; i >= 0; i--) {
+            double dx = bodies[i].x - x;
+            double dy = bodies[i].y - y;
+            // Use 2D projection (ignore z for clicking)
+            double dist = sqrt(dx * dx + dy * dy);
+            if (dist <= bodies[i].radius * 1.5) {  // 1.5x for easier clicking
+                return i;
+            }
+        }
+        return -1;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getDistance(int index1, int index2) {
+        if (index1 >= 0 && index1 < static_cast<int>(bodies.size()) && index2 >= 0 && index2 < static_cast<int>(bodies.size())) {
+            double dx = bodies[index2].x - bodies[index1].x;
+            double dy = bodies[index2].y - bodies[index1].y;
+            double dz = bodies[index2].z - bodies[index1].z;
+            return sqrt(dx * dx + dy * dy + dz * dz);
+        }
+        return 0.0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getKineticEnergy(int index) {
+        if (index >= 0 && index < static_cast<int>(bodies.size())) {
+            double speedSq = bodies[index].vx * bodies[index].vx + 
+                            bodies[index].vy * bodies[index].vy + 
+                            bodies[index].vz * bodies[index].vz;
+            return 0.5 * bodies[index].mass * speedSq;
+        }
+        return 0.0;
+    }
+    
+    // Timeline functions
+    EMSCRIPTEN_KEEPALIVE
+    int seekToStep(int step) {
+        return seekToStepInternal(step) ? 1 : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getStepCount() {
+        return static_cast<int>(stepCount);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getOldestCheckpointStep() {
+        return checkpoints.empty() ? 0 : static_cast<int>(checkpoints.front().step);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getLatestCheckpointStep() {
+        return checkpoints.empty() ? 0 : static_cast<int>(checkpoints.back().step);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getCheckpointCount() {
+        return checkpoints.size();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setCheckpointInterval(int steps) {
+        checkpointInterval = std::max(1, steps);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getCheckpointInterval() {
+        return checkpointInterval;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setCheckpointMemoryBudget(double megabytes) {
+        checkpointMemoryBudget = static_cast<size_t>(std::max(0.0, megabytes) * 1024.0 * 1024.0);
+        while (checkpointMemoryUsed > checkpointMemoryBudget && checkpoints.size() > 1) {
+            checkpointMemoryUsed -= checkpointBytes(checkpoints.front());
+            checkpoints.pop_front();
+        }
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getCheckpointMemoryUsed() {
+        return checkpointMemoryUsed / (1024.0 * 1024.0);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int serializeTimeline() {
+        return static_cast<int>(serializeTimelineInternal());
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    const uint8_t* getTimelineBuffer() {
+        return timelineBuffer.data();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int loadTimeline(const uint8_t* data, int size) {
+        return loadTimelineInternal(data, size > 0 ? size : 0) ? 1 : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    unsigned int getStateChecksum() {
+        return stateChecksum();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void saveState() {
+        initialBodies = bodies;
+    }
+    
+    // New physics control functions
+    EMSCRIPTEN_KEEPALIVE
+    void setMergingEnabled(int enabled) {
+        enableMerging = (enabled != 0);
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getMergingEnabled() {
+        return enableMerging ? 1 : 0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setTidalForces(int enabled) {
+        enableTidalForces = (enabled != 0);
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getTidalForces() {
+        return enableTidalForces ? 1 : 0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setSofteningLength(double length) {
+        softeningLength = length;
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getSofteningLength() {
+        return softeningLength;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setRegularizationRadius(double radius) {
+        regularizationRadius = std::max(0.0, radius);
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getRegularizationRadius() {
+        return regularizationRadius;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setRegularizationSubsteps(int substeps) {
+        regularizationSubsteps = std::max(1, substeps);
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getRegularizationSubsteps() {
+        return regularizationSubsteps;
+    }
+    
+    // Orbit trails (see sampleTrails); buffers move when capacity or body count changes
+    EMSCRIPTEN_KEEPALIVE
+    void setTrailCapacity(int points) {
+        trailCapacity = std::clamp(points, 2, 65536);
+        clearTrailBuffers();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getTrailCapacity() {
+        return trailCapacity;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setTrailSampleInterval(int steps) {
+        trailSampleInterval = std::max(1, steps);
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getTrailSampleInterval() {
+        return trailSampleInterval;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setTrailTolerance(double tolerance) {
+        trailTolerance = std::max(0.0, tolerance);
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getTrailTolerance() {
+        return trailTolerance;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void clearTrails() {
+        clearTrailBuffers();
+    }
+    
+    // Bodies covered by the trail buffers (0 until the first sample after a change)
+    EMSCRIPTEN_KEEPALIVE
+    int getTrailBodyCount() {
+        return trailLengths.size();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    const float* getTrailPointsBuffer() {
+        return trailPoints.data();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    const int32_t* getTrailHeadsBuffer() {
+        return trailHeads.data();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    const int32_t* getTrailLengthsBuffer() {
+        return trailLengths.data();
+    }
+    
+    // Pairwise force evaluations since startup, for throughput measurements
+    EMSCRIPTEN_KEEPALIVE
+    double getInteractionCount() {
+        return interactionCount;
+    }
+    
+    // Substeps used by the last update (0 when the selected integrator ran)
+    EMSCRIPTEN_KEEPALIVE
+    int getLastRegularizedSubsteps() {
+        return lastRegularizedSubsteps;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setGravitationalWaves(int enabled) {
+        enableGravitationalWaves = (enabled != 0);
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getGravitationalWaves() {
+        return enableGravitationalWaves ? 1 : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setChargeForces(int enabled) {
+        enableChargeForces = (enabled != 0);
+        markTimelineEdit();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getChargeForces() {
+        return enableChargeForces ? 1 : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setElectrostaticConstant(double value) {
+        electrostaticConstant = std::max(0.0, value);
+        markTimelineEdit();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getElectrostaticConstant() {
+        return electrostaticConstant;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setBoundaryMode(int enabled) {
+        enableBoundaryMode = (enabled != 0);
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getBoundaryMode() {
+        return enableBoundaryMode ? 1 : 0;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setBoundaryPadding(double padding) {
+        boundaryPadding = std::max(0.0, padding);
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBoundaryPadding() {
+        return boundaryPadding;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setBoundaryRestitution(double value) {
+        boundaryRestitution = std::clamp(value, 0.1, 1.0);
+        markTimelineEdit();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getBoundaryRestitution() {
+        return boundaryRestitution;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getAngularMomentum() {
+        // Return magnitude for backward compatibility
+        return sqrt(angularMomentumX * angularMomentumX + 
+                   angularMomentumY * angularMomentumY + 
+                   angularMomentumZ * angularMomentumZ);
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getAngularMomentumX() {
+        return angularMomentumX;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getAngularMomentumY() {
+        return angularMomentumY;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getAngularMomentumZ() {
+        return angularMomentumZ;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void setMonitorInterval(int steps) {
+        monitorInterval = std::max(1, steps);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getMonitorInterval() {
+        return monitorInterval;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getEnergyDrift() {
+        return energyDrift;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getMomentumDrift() {
+        return momentumDrift;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getAngularMomentumDrift() {
+        return angularMomentumDrift;
+    }
+    
+    // NASA Game Mode Functions
+    EMSCRIPTEN_KEEPALIVE
+    void startNASAMission(int difficulty) {
+        loadNASAAsteroidDefense(difficulty);
+        testParticles.clear();
+        initialTestParticles.clear();
+        initialTestParticlesStale = false;
+        resetTimeline();
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getGameMode() {
+        return static_cast<int>(gameMode);
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getMissionState() {
+        return static_cast<int>(missionState);
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void deploySpacecraft(double x, double y, double vx, double vy) {
+        if (gameMode != GAME_MODE_ACTIVE || missionState != MISSION_SETUP) {
+            printf("Cannot deploy spacecraft - wrong game state\n");
+            return;
+        }
+        
+        // Calculate delta-v required
+        double deltaV = sqrt(vx * vx + vy * vy);
+        if (deltaV > deltaVBudget) {
+            printf("Insufficient delta-V budget! Required: %.2f, Available: %.2f\n", deltaV, deltaVBudget);
+            return;
+        }
+        
+        // Deploy spacecraft (kinetic impactor or gravity tractor)
+        bodies.push_back({
+            x, y, 0.0,
+            vx, vy, 0.0,
+            0.0, 0.0, 0.0,
+            spacecraftMass,
+            3.0,  // Small visual size
+            0xFFFFFFFF,  // White spacecraft
+            0.0, 0.0
+        });
+        spacecraftBodyIndex = bodies.size() - 1;
+        deltaVUsed = deltaV;
+        impactProbability = 0.0;  // Pre-deployment ensembles no longer apply
+
+        // Start mission
+        missionState = MISSION_RUNNING;
+        markTimelineEdit();
+        printf("Spacecraft deployed! Delta-V used: %.2f km/s\n", deltaVUsed);
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double runImpactEnsemble(int members, unsigned int seed) {
+        return runImpactEnsembleInternal(members, seed);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setAsteroidUncertainty(double sigmaX, double sigmaY, double sigmaZ,
+                                double sigmaVX, double sigmaVY, double sigmaVZ) {
+        asteroidSigmaPos[0] = fabs(sigmaX);
+        asteroidSigmaPos[1] = fabs(sigmaY);
+        asteroidSigmaPos[2] = fabs(sigmaZ);
+        asteroidSigmaVel[0] = fabs(sigmaVX);
+        asteroidSigmaVel[1] = fabs(sigmaVY);
+        asteroidSigmaVel[2] = fabs(sigmaVZ);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setEnsembleThreads(int threads) {
+        ensembleThreads = std::max(0, threads);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getImpactProbability() {
+        return impactProbability;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getEnsembleSize() {
+        return ensembleClosestApproaches.size();
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getEnsembleClosestApproach(int index) {
+        // Sorted ascending, so index k is the k-th smallest miss distance
+        if (index >= 0 && index < static_cast<int>(ensembleClosestApproaches.size())) {
+            return ensembleClosestApproaches[index];
+        }
+        return 0.0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getEnsembleClosestApproachPercentile(double percentile) {
+        if (ensembleClosestApproaches.empty()) {
+            return 0.0;
+        }
+        double p = std::clamp(percentile, 0.0, 100.0) / 100.0;
+        size_t index = static_cast<size_t>(p * (ensembleClosestApproaches.size() - 1) + 0.5);
+        return ensembleClosestApproaches[index];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getEnsembleThroughput() {
+        return ensembleThroughput;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double optimizeDeflection(int maxGenerations, unsigned int seed) {
+        return optimizeDeflectionInternal(maxGenerations, seed);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void setOptimizerTimeBudget(double seconds) {
+        optimizerTimeBudget = std::max(0.0, seconds);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getOptimizedDeployX() {
+        return optimizedDeploy[0];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getOptimizedDeployY() {
+        return optimizedDeploy[1];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getOptimizedDeployVX() {
+        return optimizedDeploy[2];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getOptimizedDeployVY() {
+        return optimizedDeploy[3];
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getOptimizedClosestApproach() {
+        return optimizedClosestApproach;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    int getOptimizerEvaluations() {
+        return optimizerEvaluations;
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    void deployOptimizedSpacecraft() {
+        deploySpacecraft(optimizedDeploy[0], optimizedDeploy[1], optimizedDeploy[2], optimizedDeploy[3]);
+    }
+
+    EMSCRIPTEN_KEEPALIVE
+    double getThreatDistance() {
+        if (gameMode != GAME_MODE_ACTIVE || earthBodyIndex < 0 || asteroidBodyIndex < 0 ||
+            earthBodyIndex >= static_cast<int>(bodies.size()) || asteroidBodyIndex >= static_cast<int>(bodies.size())) {
+            return -1.0;
+        }
+        
+        double dx = bodies[asteroidBodyIndex].x - bodies[earthBodyIndex].x;
+        double dy = bodies[asteroidBodyIndex].y - bodies[earthBodyIndex].y;
+        double dz = bodies[asteroidBodyIndex].z - bodies[earthBodyIndex].z;
+        return sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getMissionTime() {
+        return missionTime;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getTimeLimit() {
+        return timeLimit;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getClosestApproach() {
+        return closestApproach;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getDeltaVBudget() {
+        return deltaVBudget;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getDeltaVUsed() {
+        return deltaVUsed;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getMissionScore() {
+        return missionScore;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getThreatRadius() {
+        return threatRadius;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    double getSafetyMargin() {
+        return safetyMargin;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getEarthIndex() {
+        return earthBodyIndex;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getAsteroidIndex() {
+        return asteroidBodyIndex;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    int getSpacecraftIndex() {
+        return spacecraftBodyIndex;
+    }
+    
+    EMSCRIPTEN_KEEPALIVE
+    void saveInitialState() {
+        // Save initial conservation values for drift monitoring (3D)
+        initialEnergy = totalEnergy;
+        initialMomentumX = totalMomentumX;
+        initialMomentumY = totalMomentumY;
+        initialMomentumZ = totalMomentumZ;
+        initialAngularMomentumX = angularMomentumX;
+        initialAngularMomentumY = angularMomentumY;
+        initialAngularMomentumZ = angularMomentumZ;
+        energyDrift = 0.0;
+        momentumDrift = 0.0;
+        angularMomentumDrift = 0.0;
+    }
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+// Simulation library API. The same functions are exported to JavaScript in
+// the WebAssembly build (build.sh) and linked directly by native tools.
+
+#include <cstdint>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+
+// Precision of the test-particle store and the bulk force kernels. Build with
+// -DTHREEBODY_REAL=float for float32 visual runs; body state, integration and
+// energy diagnostics stay double either way.
+#ifndef THREEBODY_REAL
+#define THREEBODY_REAL double
+#endif
+typedef THREEBODY_REAL SimReal;
+
+// Integration method selection
+enum IntegrationMethod {
+    METHOD_EULER,        // Basic Euler method (PDF Section 3.2)
+    METHOD_VERLET,       // Velocity Verlet (symplectic)
+    METHOD_RK4,          // Runge-Kutta 4th order
+    METHOD_RKF45         // Runge-Kutta-Fehlberg adaptive (PDF Section 3.3)
+};
+
+// Gravity solver used by calculateForces()
+enum ForceSolver {
+    SOLVER_DIRECT,       // Exact O(n²) pairwise sum
+    SOLVER_FMM           // Fast multipole method, O(n)
+};
+
+// Preset configurations
+enum PresetType {
+    PRESET_FIGURE_EIGHT,        // Classic 3-body equal mass
+    PRESET_STABLE_ORBIT,        // 3-body hierarchical
+    PRESET_CHAOTIC,            // 3-body chaotic
+    PRESET_BINARY_STAR,        // 3-body binary+planet
+    PRESET_PYTHAGOREAN,        // 3-body Pythagorean problem
+    PRESET_LAGRANGE,           // 3-body Lagrange equilateral triangle
+    PRESET_SOLAR_SYSTEM,       // N-body (beyond three-body scope)
+    PRESET_NASA_ASTEROID_DEFENSE,  // NASA game mode: Earth + asteroid + deflector
+    PRESET_CUSTOM
+};
+
+extern "C" {
+    // Stepping and body state
+    void update();
+    double getBodyX(int index);
+    double getBodyY(int index);
+    double getBodyZ(int index);
+    double getBodyRadius(int index);
+    unsigned int getBodyColor(int index);
+    double getBodyVX(int index);
+    double getBodyVY(int index);
+    double getBodyVZ(int index);
+    double getBodyMass(int index);
+    int getBodyCount();
+
+    // System properties
+    double getTotalEnergy();
+    double getMomentumX();
+    double getMomentumY();
+    double getMomentumZ();
+    double getCenterOfMassX();
+    double getCenterOfMassY();
+    double getCenterOfMassZ();
+
+    // Physics parameters and solvers
+    void setGravitationalConstant(double g);
+    double getGravitationalConstant();
+    void setTimeStep(double newDt);
+    double getTimeStep();
+    void setTimeScale(double scale);
+    double getTimeScale();
+    void setIntegrator(int method);
+    int getIntegrator();
+    void setForceSolver(int solver);
+    int getForceSolver();
+    void setFMMOrder(int order);
+    int getFMMOrder();
+    void setFMMOpeningAngle(double theta);
+    double getFMMOpeningAngle();
+    double verifyFMMAccuracy(int samples);
+    void setCollisions(int enabled);
+    int getCollisions();
+    void setCollisionDamping(double damping);
+
+    // Presets and body editing
+    void loadPreset(int presetType);
+    void addBody(double x, double y, double vx, double vy, double mass, double radius,
+                 unsigned int color);
+    void removeBody(int index);
+    void clearBodies();
+    void init();
+    void reset();
+    void setBodyPosition(int index, double x, double y);
+    void setBodyVelocity(int index, double vx, double vy);
+    void setBodyMass(int index, double mass);
+    void setBodyColor(int index, unsigned int color);
+    void setBodyCharge(int index, double charge);
+    double getBodyCharge(int index);
+
+    // Test particles (massless bodies)
+    void addTestParticle(double x, double y, double vx, double vy, unsigned int color);
+    void addTestParticleBelt(int count, int centerIndex, double innerRadius, double outerRadius,
+                             unsigned int color, unsigned int seed);
+    int setBodyMassless(int index);
+    void clearTestParticles();
+    int getTestParticleCount();
+    double getTestParticleX(int index);
+    double getTestParticleY(int index);
+    unsigned int getTestParticleColor(int index);
+    const SimReal* getTestParticleXArray();
+    const SimReal* getTestParticleYArray();
+    int getSimulationPrecision();
+
+    // Queries
+    int findBodyAtPosition(double x, double y);
+    double getDistance(int index1, int index2);
+    double getKineticEnergy(int index);
+
+    // Timeline
+    int seekToStep(int step);
+    int getStepCount();
+    int getOldestCheckpointStep();
+    int getLatestCheckpointStep();
+    int getCheckpointCount();
+    void setCheckpointInterval(int steps);
+    int getCheckpointInterval();
+    void setCheckpointMemoryBudget(double megabytes);
+    double getCheckpointMemoryUsed();
+    int serializeTimeline();
+    const uint8_t* getTimelineBuffer();
+    int loadTimeline(const uint8_t* data, int size);
+    unsigned int getStateChecksum();
+
+    // Physics options
+    void saveState();
+    void setMergingEnabled(int enabled);
+    int getMergingEnabled();
+    void setTidalForces(int enabled);
+    int getTidalForces();
+    void setSofteningLength(double length);
+    double getSofteningLength();
+    void setRegularizationRadius(double radius);
+    double getRegularizationRadius();
+    void setRegularizationSubsteps(int substeps);
+    int getRegularizationSubsteps();
+
+    // Orbit trails
+    void setTrailCapacity(int points);
+    int getTrailCapacity();
+    void setTrailSampleInterval(int steps);
+    int getTrailSampleInterval();
+    void setTrailTolerance(double tolerance);
+    double getTrailTolerance();
+    void clearTrails();
+    int getTrailBodyCount();
+    const float* getTrailPointsBuffer();
+    const int32_t* getTrailHeadsBuffer();
+    const int32_t* getTrailLengthsBuffer();
+
+    double getInteractionCount();
+    int getLastRegularizedSubsteps();
+    void setGravitationalWaves(int enabled);
+    int getGravitationalWaves();
+    void setChargeForces(int enabled);
+    int getChargeForces();
+    void setElectrostaticConstant(double value);
+    double getElectrostaticConstant();
+    void setBoundaryMode(int enabled);
+    int getBoundaryMode();
+    void setBoundaryPadding(double padding);
+    double getBoundaryPadding();
+    void setBoundaryRestitution(double value);
+    double getBoundaryRestitution();
+
+    // Conservation monitoring
+    double getAngularMomentum();
+    double getAngularMomentumX();
+    double getAngularMomentumY();
+    double getAngularMomentumZ();
+    void setMonitorInterval(int steps);
+    int getMonitorInterval();
+    double getEnergyDrift();
+    double getMomentumDrift();
+    double getAngularMomentumDrift();
+
+    // NASA game mode
+    void startNASAMission(int difficulty);
+    int getGameMode();
+    int getMissionState();
+    void deploySpacecraft(double x, double y, double vx, double vy);
+
+    // Impact ensemble and deflection optimizer
+    double runImpactEnsemble(int members, unsigned int seed);
+    void setAsteroidUncertainty(double sigmaX, double sigmaY, double sigmaZ,
+                                double sigmaVX, double sigmaVY, double sigmaVZ);
+    void setEnsembleThreads(int threads);
+    double getImpactProbability();
+    int getEnsembleSize();
+    double getEnsembleClosestApproach(int index);
+    double getEnsembleClosestApproachPercentile(double percentile);
+    double getEnsembleThroughput();
+    double optimizeDeflection(int maxGenerations, unsigned int seed);
+    void setOptimizerTimeBudget(double seconds);
+    double getOptimizedDeployX();
+    double getOptimizedDeployY();
+    double getOptimizedDeployVX();
+    double getOptimizedDeployVY();
+    double getOptimizedClosestApproach();
+    int getOptimizerEvaluations();
+    void deployOptimizedSpacecraft();
+
+    // Mission status
+    double getThreatDistance();
+    double getMissionTime();
+    double getTimeLimit();
+    double getClosestApproach();
+    double getDeltaVBudget();
+    double getDeltaVUsed();
+    int getMissionScore();
+    double getThreatRadius();
+    double getSafetyMargin();
+    int getEarthIndex();
+    int getAsteroidIndex();
+    int getSpacecraftIndex();
+    void saveInitialState();
+}